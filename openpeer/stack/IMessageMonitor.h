@@ -77,6 +77,18 @@ namespace openpeer
 
       static bool handleMessageReceived(message::MessagePtr message);
 
+      //-----------------------------------------------------------------------
+      // PURPOSE: route an incoming message from its scanned envelope; the
+      //          message is only decoded if a monitor is watching its ID (or
+      //          if the envelope could not be scanned)
+      // RETURNS: true if a monitor handled the message, outMessage is set
+      //          whenever the message was decoded
+      static bool handleMessageReceived(
+                                        const message::MessageEnvelope &envelope,
+                                        IMessageSourcePtr messageSource,
+                                        message::MessagePtr &outMessage
+                                        );
+
       virtual PUID getID() const = 0;
 
       virtual bool isComplete() const = 0;
@@ -47,6 +47,8 @@ namespace openpeer
 
     interaction IStack
     {
+      typedef std::list<IMessageQueuePtr> MessageQueueList;
+
       static IStackPtr singleton();
 
       static void setup(
@@ -56,10 +58,26 @@ namespace openpeer
                         IMessageQueuePtr keyGenerationQueue = IMessageQueuePtr()
                         );
 
+      static void setup(
+                        IMessageQueuePtr defaultDelegateMessageQueue,   // if any object does not find a message queue, it will use this queue
+                        const MessageQueueList &stackMessageQueues,     // pool of stack queues, each account (and all it owns) is pinned to one queue from the pool
+                        IMessageQueuePtr servicesQueue = IMessageQueuePtr(),
+                        IMessageQueuePtr keyGenerationQueue = IMessageQueuePtr()
+                        );
+
       static IMessageQueuePtr getStackQueue();
       static IMessageQueuePtr getServicesQueue();
       static IMessageQueuePtr getKeyGenerationQueue();
 
+      //-----------------------------------------------------------------------
+      // PURPOSE: returns a snapshot of the dwell time, execution time and
+      //          depth histograms (plus per delegate method post counts) for
+      //          the delegate, stack, services and key generation queues
+      // NOTE:    statistics are only gathered when the setting
+      //          "openpeer/stack/queue-statistics-enabled" is true at the
+      //          time the stack is setup
+      static ElementPtr getQueueStatistics(bool resetAfterSnapshot = false);
+
       virtual ~IStack() {}  // needed to make polymorphic
     };
   }
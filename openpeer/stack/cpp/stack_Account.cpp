@@ -84,6 +84,9 @@
 #define OPENPEER_STACK_ACCOUNT_FINDER_STARTING_RETRY_AFTER_IN_SECONDS (1)
 #define OPENPEER_STACK_ACCOUNT_FINDER_MAX_RETRY_AFTER_TIME_IN_SECONDS (60)
 
+#define OPENPEER_STACK_ACCOUNT_EPHEMERAL_DH_KEY_POOL_STARTING_RETRY_AFTER_IN_SECONDS (1)
+#define OPENPEER_STACK_ACCOUNT_EPHEMERAL_DH_KEY_POOL_MAX_RETRY_AFTER_TIME_IN_SECONDS (60)
+
 #define OPENPEER_STACK_ACCOUNT_RUDP_TRANSPORT_PROTOCOL_TYPE "rudp/udp"
 #define OPENPEER_STACK_ACCOUNT_MULTIPLEXED_JSON_TCP_TRANSPORT_PROTOCOL_TYPE "multiplexed-json/tcp"
 
@@ -188,8 +191,11 @@ namespace openpeer
 
         mBackgroundingSubscription = IBackgrounding::subscribe(mThisWeak.lock(), services::ISettings::getUInt(OPENPEER_STACK_SETTING_BACKGROUNDING_ACCOUNT_PHASE));
 
+        mEphemeralDHKeyPool = EphemeralDHKeyPool::create(mThisWeak.lock());
+
         mLockboxSession->attach(mThisWeak.lock());
 
+        markAllPeersDirty();
         step();
       }
 
@@ -277,7 +283,7 @@ namespace openpeer
         ZS_THROW_INVALID_ARGUMENT_IF(!delegate);
         ZS_THROW_INVALID_ARGUMENT_IF(!peerContactSession);
 
-        AccountPtr pThis(new Account(UseStack::queueStack(), delegate, ServiceLockboxSession::convert(peerContactSession)));
+        AccountPtr pThis(new Account(UseStack::queueStackShard(), delegate, ServiceLockboxSession::convert(peerContactSession)));
         pThis->mThisWeak = pThis;
         pThis->mDelegate = IAccountDelegateProxy::createWeak(UseStack::queueDelegate(), delegate);
         pThis->init();
@@ -405,7 +411,7 @@ namespace openpeer
         return true;
 
       extract_failure:
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
         mAvailableFinderSRVResult.reset();
         ZS_LOG_WARNING(Detail, log("extract next IP failed") + ZS_PARAM("reason", reason))
         return false;
@@ -730,7 +736,8 @@ namespace openpeer
         peerInfo->findTimeReset();
 
         ZS_LOG_DEBUG(log("received hint about peer location that will be added to hint search") + PeerInfo::toDebug(peerInfo))
-        (IWakeDelegateProxy::create(mThisWeak.lock()))->onWake();
+        markPeerDirty(location->getPeerURI());
+        mWake.wake(mThisWeak.lock());
       }
 
       //-----------------------------------------------------------------------
@@ -936,7 +943,8 @@ namespace openpeer
 
         ++(peerInfo->mTotalSubscribers);
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        markPeerDirty(uri);
+        mWake.wake(mThisWeak.lock());
       }
 
       //-----------------------------------------------------------------------
@@ -973,7 +981,8 @@ namespace openpeer
 
         mPeerSubscriptions.erase(found);
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        markPeerDirty(uri);
+        mWake.wake(mThisWeak.lock());
       }
 
       //-----------------------------------------------------------------------
@@ -1040,6 +1049,8 @@ namespace openpeer
           }
         }
 
+        // finder availability changes what every peer is able to do
+        markAllPeersDirty();
         step();
       }
 
@@ -1073,7 +1084,7 @@ namespace openpeer
           ZS_LOG_DEBUG(log("receiving incoming find peer location request (will respond later)"))
 
           mIncomingFindRequests.push_back(peerLocationFindRequest);
-          IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+          mWake.wake(mThisWeak.lock());
           return;
         }
 
@@ -1248,6 +1259,7 @@ namespace openpeer
           default:  break;
         }
 
+        markPeerDirty(location->getPeerURI());
         step();
       }
 
@@ -1295,7 +1307,7 @@ namespace openpeer
       void Account::notifyServiceLockboxSessionStateChanged()
       {
         // WARNING: DO NOT LOCK HERE
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
       }
 
       //-----------------------------------------------------------------------
@@ -1349,6 +1361,8 @@ namespace openpeer
           }
         }
 
+        // finder resolution changes what every peer is able to do
+        markAllPeersDirty();
         step();
       }
 
@@ -1369,6 +1383,9 @@ namespace openpeer
         ZS_LOG_DEBUG(log("on ice socket state changed"))
 
         AutoRecursiveLock lock(*this);
+
+        // every peer location publishes the socket's candidates
+        markAllPeersDirty();
         step();
       }
 
@@ -1378,6 +1395,9 @@ namespace openpeer
         ZS_LOG_DEBUG(log("on ice socket candidates changed"))
 
         AutoRecursiveLock lock(*this);
+
+        // every peer location publishes the socket's candidates
+        markAllPeersDirty();
         step();
       }
 
@@ -1483,7 +1503,7 @@ namespace openpeer
         handleFindRequestComplete(monitor);
 
         // process any pending incoming find requests that were waiting for the find to complete
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
         return true;
       }
 
@@ -1540,7 +1560,7 @@ namespace openpeer
           handleFinderRelatedFailure();
         }
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
 
         return true;
       }
@@ -1565,7 +1585,7 @@ namespace openpeer
         mFindersGetMonitor.reset();
 
         handleFinderRelatedFailure();
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
         return true;
       }
 
@@ -1581,6 +1601,8 @@ namespace openpeer
       void Account::onWake()
       {
         ZS_LOG_DEBUG(log("on wake"))
+        mWake.woken();
+
         AutoRecursiveLock lock(*this);
         step();
       }
@@ -1604,6 +1626,9 @@ namespace openpeer
           return;
         }
 
+        // time based peer work (keep alives, find retries, inactivity) needs
+        // every peer to be revisited periodically
+        markAllPeersDirty();
         step();
       }
 
@@ -1629,6 +1654,7 @@ namespace openpeer
 
         mBackgroundingNotifier = notifier;
 
+        markAllPeersDirty();
         step();
       }
 
@@ -1652,6 +1678,7 @@ namespace openpeer
         get(mBackgroundingEnabled) = false;
         mBackgroundingNotifier.reset();
 
+        markAllPeersDirty();
         step();
       }
 
@@ -1713,6 +1740,7 @@ namespace openpeer
         ElementPtr resultEl = Element::create("stack::Account");
 
         IHelper::debugAppend(resultEl, "id", mID);
+        IHelper::debugAppend(resultEl, mWake.toDebug());
         IHelper::debugAppend(resultEl, "shutdown reference", (bool)mGracefulShutdownReference);
 
         IHelper::debugAppend(resultEl, "state", IAccount::toString(mCurrentState));
@@ -1742,6 +1770,7 @@ namespace openpeer
         IHelper::debugAppend(resultEl, "repository id", mRepository ? mRepository->getID() : 0);
 
         IHelper::debugAppend(resultEl, "dh key pair templates", mDHKeyPairTemplates.size());
+        IHelper::debugAppend(resultEl, mEphemeralDHKeyPool ? mEphemeralDHKeyPool->toDebug() : ElementPtr());
 
         IHelper::debugAppend(resultEl, "rsa key generator blocked", mBlockRSAKeyGeneration);
         IHelper::debugAppend(resultEl, "rsa key generator id", mRSAKeyGenerator ? mRSAKeyGenerator->getID() : 0);
@@ -1758,6 +1787,10 @@ namespace openpeer
         IHelper::debugAppend(resultEl, "finders dns lookup", (bool)mFinderDNSLookup);
 
         IHelper::debugAppend(resultEl, "peer infos", mPeerInfos.size());
+        IHelper::debugAppend(resultEl, "dirty peers", mDirtyPeers.size());
+        IHelper::debugAppend(resultEl, "all peers dirty", mAllPeersDirty);
+        IHelper::debugAppend(resultEl, "peer sweeps", mTotalPeerSweeps);
+        IHelper::debugAppend(resultEl, "peers stepped", mTotalPeersStepped);
 
         IHelper::debugAppend(resultEl, "subscribers", mPeerSubscriptions.size());
 
@@ -1786,6 +1819,11 @@ namespace openpeer
           mRepository.reset();
         }
 
+        if (mEphemeralDHKeyPool) {
+          mEphemeralDHKeyPool->cancel();
+          mEphemeralDHKeyPool.reset();
+        }
+
         if (mFindersGetMonitor) {
           mFindersGetMonitor->cancel();
           mFindersGetMonitor.reset();
@@ -1922,6 +1960,7 @@ namespace openpeer
           }
 
           mPeerInfos.clear();
+          mDirtyPeers.clear();
         }
 
         if (mTimer) {
@@ -1970,6 +2009,10 @@ namespace openpeer
         if (!stepFinderDNS()) return;
         if (!stepFinder()) return;
 
+        if (AccountState_Ready != mCurrentState) {
+          markAllPeersDirty();
+        }
+
         setState(AccountState_Ready);
 
         if (!stepPeers()) return;
@@ -2240,6 +2283,8 @@ namespace openpeer
             ZS_LOG_DEBUG(log("received incoming peer find request from unknown peer") + PeerInfo::toDebug(peerInfo))
           }
 
+          markPeerDirty(fromPeer->getPeerURI());
+
           UseAccountPeerLocationPtr peerLocation;
           PeerInfo::PeerLocationMap::iterator foundLocation = peerInfo->mLocations.find(fromLocation->getLocationID());
           if (foundLocation != peerInfo->mLocations.end()) {
@@ -2316,10 +2361,26 @@ namespace openpeer
             continue;
           }
 
+          ZS_THROW_BAD_STATE_IF(!mEphemeralDHKeyPool)
+
           IDHPublicKeyPtr newPublicKey;
-          IDHPrivateKeyPtr newPrivateKey = IDHPrivateKey::loadAndGenerateNewEphemeral(templateKeyPair.first, templateKeyPair.second, newPublicKey);
-          ZS_THROW_INVALID_ASSUMPTION_IF(!newPrivateKey)
-          ZS_THROW_INVALID_ASSUMPTION_IF(!newPublicKey)
+          IDHPrivateKeyPtr newPrivateKey;
+          bool generateInline = false;
+          if (!mEphemeralDHKeyPool->take(remoteKeyDomain->getPrecompiledType(), newPrivateKey, newPublicKey, generateInline)) {
+            if (!generateInline) {
+              ZS_LOG_DEBUG(log("waiting for ephemeral DH key pair to be generated before responding to incoming find request"))
+              continue;
+            }
+
+            ZS_LOG_WARNING(Detail, log("ephemeral DH key pool is failing, generating key pair inline"))
+            newPrivateKey = IDHPrivateKey::loadAndGenerateNewEphemeral(templateKeyPair.first, templateKeyPair.second, newPublicKey);
+            if ((!newPrivateKey) ||
+                (!newPublicKey)) {
+              ZS_LOG_ERROR(Detail, log("failed to generate ephemeral DH key pair inline (thus ignoring incoming find request)"))
+              mIncomingFindRequests.erase(current);
+              continue;
+            }
+          }
 
           peerLocation = UseAccountPeerLocation::createFromIncomingPeerLocationFind(
                                                                                     mThisWeak.lock(),
@@ -2386,7 +2447,7 @@ namespace openpeer
             if (mAvailableFinders.size() < 1) {
               handleFinderRelatedFailure();
             }
-            IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+            mWake.wake(mThisWeak.lock());
             return false;
           }
 
@@ -2435,55 +2496,99 @@ namespace openpeer
       {
         if (mPeerInfos.size() < 1) {
           ZS_LOG_TRACE(log("step peers complete as no peers exist"))
+          mDirtyPeers.clear();
+          get(mAllPeersDirty) = false;
           return true;
         }
 
-        bool done = true;
+        // while backgrounding every peer must be revisited until all
+        // locations have shutdown
+        bool sweepAll = (mAllPeersDirty) || (mBackgroundingEnabled);
 
-        for (PeerInfoMap::iterator peerIter = mPeerInfos.begin(); peerIter != mPeerInfos.end(); )
-        {
-          PeerInfoMap::iterator current = peerIter;
-          ++peerIter;
+        PeerURISet dirtyPeers;
+        dirtyPeers.swap(mDirtyPeers);
+        get(mAllPeersDirty) = false;
+
+        if ((!sweepAll) &&
+            (dirtyPeers.size() < 1)) {
+          ZS_LOG_TRACE(log("step peers complete as no peers changed"))
+          return true;
+        }
 
-          const String &peerURI = (*current).first;
-          PeerInfoPtr &peerInfo = (*current).second;
+        ZS_LOG_TRACE(log("stepping peers") + ZS_PARAM("full sweep", sweepAll) + ZS_PARAM("dirty", dirtyPeers.size()) + ZS_PARAM("total", mPeerInfos.size()))
 
-          if (mBackgroundingEnabled) {
-            setFindState(*peerInfo, IPeer::PeerFindState_Completed);
+        bool done = true;
 
-            shutdownAllLocationsDueToBackgrounding(peerURI, peerInfo);
+        if (sweepAll) {
+          ++mTotalPeerSweeps;
 
-            if (peerInfo->mLocations.size() > 0) {
-              ZS_LOG_TRACE(log("some location are still connected thus do not allow backgrounding yet") + PeerInfo::toDebug(peerInfo))
-              done = false;
+          for (PeerInfoMap::iterator peerIter = mPeerInfos.begin(); peerIter != mPeerInfos.end(); )
+          {
+            PeerInfoMap::iterator current = peerIter;
+            ++peerIter;
+
+            if (!stepPeer(current)) done = false;
+          }
+        } else {
+          for (PeerURISet::iterator dirtyIter = dirtyPeers.begin(); dirtyIter != dirtyPeers.end(); ++dirtyIter)
+          {
+            PeerInfoMap::iterator found = mPeerInfos.find(*dirtyIter);
+            if (found == mPeerInfos.end()) {
+              ZS_LOG_TRACE(log("dirty peer no longer exists") + ZS_PARAM("peer uri", *dirtyIter))
+              continue;
             }
-            continue;
+
+            if (!stepPeer(found)) done = false;
           }
+        }
 
-          if (shouldShutdownInactiveLocations(peerURI, peerInfo)) {
+        ZS_LOG_TRACE(log("step peers complete") + ZS_PARAM("done", done))
+        return done;
+      }
 
-            shutdownPeerLocationsNotNeeded(peerURI, peerInfo);
+      //-----------------------------------------------------------------------
+      bool Account::stepPeer(PeerInfoMap::iterator current)
+      {
+        // NOTE: "current" may be erased by this method
 
-            if (peerInfo->mLocations.size() > 0) {
-              ZS_LOG_TRACE(log("some location are still connected thus do not shutdown the peer yet") + PeerInfo::toDebug(peerInfo))
-              continue;
-            }
+        ++mTotalPeersStepped;
 
-            // erase the peer now...
-            ZS_LOG_DEBUG(log("no locations at this peer thus shutting down now") + PeerInfo::toDebug(peerInfo))
+        const String peerURI = (*current).first;
+        PeerInfoPtr peerInfo = (*current).second;
 
-            setFindState(*peerInfo, IPeer::PeerFindState_Completed);
-            mPeerInfos.erase(current);
-            continue;
+        if (mBackgroundingEnabled) {
+          setFindState(*peerInfo, IPeer::PeerFindState_Completed);
+
+          shutdownAllLocationsDueToBackgrounding(peerURI, peerInfo);
+
+          if (peerInfo->mLocations.size() > 0) {
+            ZS_LOG_TRACE(log("some location are still connected thus do not allow backgrounding yet") + PeerInfo::toDebug(peerInfo))
+            return false;
+          }
+          return true;
+        }
+
+        if (shouldShutdownInactiveLocations(peerURI, peerInfo)) {
+
+          shutdownPeerLocationsNotNeeded(peerURI, peerInfo);
+
+          if (peerInfo->mLocations.size() > 0) {
+            ZS_LOG_TRACE(log("some location are still connected thus do not shutdown the peer yet") + PeerInfo::toDebug(peerInfo))
+            return true;
           }
 
-          sendPeerKeepAlives(peerURI, peerInfo);
+          // erase the peer now...
+          ZS_LOG_DEBUG(log("no locations at this peer thus shutting down now") + PeerInfo::toDebug(peerInfo))
 
-          performPeerFind(peerURI, peerInfo);
+          setFindState(*peerInfo, IPeer::PeerFindState_Completed);
+          mPeerInfos.erase(current);
+          return true;
         }
 
-        ZS_LOG_TRACE(log("step peers complete") + ZS_PARAM("done", done))
-        return done;
+        sendPeerKeepAlives(peerURI, peerInfo);
+
+        performPeerFind(peerURI, peerInfo);
+        return true;
       }
 
       //-----------------------------------------------------------------------
@@ -2629,6 +2734,9 @@ namespace openpeer
               ZS_LOG_DEBUG(log("loaded DH public / private key pair template") + ZS_PARAM("private key id", privateTemplate->getID()) + ZS_PARAM("public key id", publicTemplate->getID()))
               DHKeyPair result = DHKeyPair(privateTemplate, publicTemplate);
               mDHKeyPairTemplates[type] = result;
+              if (mEphemeralDHKeyPool) {
+                mEphemeralDHKeyPool->addTemplate(type, result);
+              }
               return result;
             }
 
@@ -2673,6 +2781,9 @@ namespace openpeer
 
         DHKeyPair result = DHKeyPair(privateTemplate, publicTemplate);
         mDHKeyPairTemplates[type] = result;
+        if (mEphemeralDHKeyPool) {
+          mEphemeralDHKeyPool->addTemplate(type, result);
+        }
         return result;
       }
 
@@ -2969,9 +3080,25 @@ namespace openpeer
 
           setFindState(*peerInfo, IPeer::PeerFindState_Completed);
           setFindState(*peerInfo, IPeer::PeerFindState_Idle);
+
+          markPeerDirty((*iter).first);
         }
       }
 
+      //-----------------------------------------------------------------------
+      void Account::markPeerDirty(const PeerURI &peerURI)
+      {
+        if (mAllPeersDirty) return;
+        mDirtyPeers.insert(peerURI);
+      }
+
+      //-----------------------------------------------------------------------
+      void Account::markAllPeersDirty()
+      {
+        get(mAllPeersDirty) = true;
+        mDirtyPeers.clear();
+      }
+
       //-----------------------------------------------------------------------
       void Account::handleFinderRelatedFailure()
       {
@@ -3135,6 +3262,320 @@ namespace openpeer
         return resultEl;
       }
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Account::EphemeralDHKeyPool
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      Account::EphemeralDHKeyPool::Domain::Domain() :
+        mFailing(false),
+        mLastRetryAfterDuration(Seconds(OPENPEER_STACK_ACCOUNT_EPHEMERAL_DH_KEY_POOL_STARTING_RETRY_AFTER_IN_SECONDS))
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      Account::EphemeralDHKeyPool::EphemeralDHKeyPool(
+                                                      IMessageQueuePtr queue,
+                                                      AccountPtr outer
+                                                      ) :
+        MessageQueueAssociator(queue),
+        mOuter(outer),
+        mTargetDepth(services::ISettings::getUInt(OPENPEER_STACK_SETTING_ACCOUNT_EPHEMERAL_DH_KEY_POOL_DEPTH))
+      {
+        if (mTargetDepth < 1) mTargetDepth = 1;
+        ZS_LOG_DEBUG(log("created") + ZS_PARAM("target depth", mTargetDepth))
+      }
+
+      //-----------------------------------------------------------------------
+      Account::EphemeralDHKeyPool::~EphemeralDHKeyPool()
+      {
+        mThisWeak.reset();
+
+        cancel();
+        ZS_LOG_DEBUG(log("destroyed"))
+      }
+
+      //-----------------------------------------------------------------------
+      Account::EphemeralDHKeyPoolPtr Account::EphemeralDHKeyPool::create(AccountPtr outer)
+      {
+        EphemeralDHKeyPoolPtr pThis(new EphemeralDHKeyPool(UseStack::queueKeyGenerationWorker(), outer));
+        pThis->mThisWeak = pThis;
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      void Account::EphemeralDHKeyPool::cancel()
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if (mRetryTimer) {
+          mRetryTimer->cancel();
+          mRetryTimer.reset();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void Account::EphemeralDHKeyPool::addTemplate(
+                                                    KeyDomainPrecompiledTypes type,
+                                                    const DHKeyPair &templateKeyPair
+                                                    )
+      {
+        AutoRecursiveLock lock(mLock);
+
+        Domain &domain = mDomains[type];
+        if ((domain.mTemplate.first == templateKeyPair.first) &&
+            (domain.mTemplate.second == templateKeyPair.second)) return;
+
+        ZS_LOG_DEBUG(log("adding key domain template") + ZS_PARAM("namespace", IDHKeyDomain::toNamespace(type)))
+
+        // key pairs generated from an older template are no longer valid
+        domain.mTemplate = templateKeyPair;
+        domain.mReady.clear();
+
+        // a new template deserves a fresh attempt
+        domain.mFailing = false;
+        domain.mLastRetryAfterDuration = Seconds(OPENPEER_STACK_ACCOUNT_EPHEMERAL_DH_KEY_POOL_STARTING_RETRY_AFTER_IN_SECONDS);
+
+        fill();
+      }
+
+      //-----------------------------------------------------------------------
+      bool Account::EphemeralDHKeyPool::take(
+                                             KeyDomainPrecompiledTypes type,
+                                             IDHPrivateKeyPtr &outPrivateKey,
+                                             IDHPublicKeyPtr &outPublicKey,
+                                             bool &outGenerateInline
+                                             )
+      {
+        outGenerateInline = false;
+
+        AutoRecursiveLock lock(mLock);
+
+        DomainMap::iterator found = mDomains.find(type);
+        if (found == mDomains.end()) {
+          ZS_LOG_WARNING(Detail, log("no template for key domain") + ZS_PARAM("namespace", IDHKeyDomain::toNamespace(type)))
+          return false;
+        }
+
+        Domain &domain = (*found).second;
+
+        if (domain.mReady.size() < 1) {
+          if (domain.mFailing) {
+            ZS_LOG_WARNING(Detail, log("ephemeral key pair generation is failing, caller must generate inline") + ZS_PARAM("namespace", IDHKeyDomain::toNamespace(type)) + ZS_PARAM("retry after", domain.mRetryAfter))
+            outGenerateInline = true;
+            return false;
+          }
+
+          ZS_LOG_DEBUG(log("no ephemeral key pair ready") + ZS_PARAM("namespace", IDHKeyDomain::toNamespace(type)))
+          get(mOuterWaiting) = true;
+          fill();
+          return false;
+        }
+
+        outPrivateKey = domain.mReady.front().first;
+        outPublicKey = domain.mReady.front().second;
+        domain.mReady.pop_front();
+
+        ZS_LOG_TRACE(log("ephemeral key pair taken") + ZS_PARAM("namespace", IDHKeyDomain::toNamespace(type)) + ZS_PARAM("remaining", domain.mReady.size()))
+
+        fill();
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      Log::Params Account::EphemeralDHKeyPool::log(const char *message) const
+      {
+        ElementPtr objectEl = Element::create("stack::Account::EphemeralDHKeyPool");
+        IHelper::debugAppend(objectEl, "id", mID);
+        return Log::Params(message, objectEl);
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr Account::EphemeralDHKeyPool::toDebug() const
+      {
+        AutoRecursiveLock lock(mLock);
+
+        ElementPtr resultEl = Element::create("stack::Account::EphemeralDHKeyPool");
+
+        IHelper::debugAppend(resultEl, "id", mID);
+        IHelper::debugAppend(resultEl, "target depth", mTargetDepth);
+        IHelper::debugAppend(resultEl, "filling", mFilling);
+        IHelper::debugAppend(resultEl, "outer waiting", mOuterWaiting);
+        IHelper::debugAppend(resultEl, "retry timer", (bool)mRetryTimer);
+
+        for (DomainMap::const_iterator iter = mDomains.begin(); iter != mDomains.end(); ++iter) {
+          IHelper::debugAppend(resultEl, IDHKeyDomain::toNamespace((*iter).first), (*iter).second.mReady.size());
+        }
+
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Account::EphemeralDHKeyPool => IWakeDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void Account::EphemeralDHKeyPool::onWake()
+      {
+        KeyDomainPrecompiledTypes type = IDHKeyDomain::KeyDomainPrecompiledType_Unknown;
+        DHKeyPair templateKeyPair;
+
+        {
+          AutoRecursiveLock lock(mLock);
+          if (!needsFill(type)) {
+            get(mFilling) = false;
+            return;
+          }
+          templateKeyPair = mDomains[type].mTemplate;
+        }
+
+        // generate one key pair per wake (outside of the lock) so other key
+        // generation jobs on this queue are not held up behind the pool
+        IDHPublicKeyPtr publicKey;
+        IDHPrivateKeyPtr privateKey = IDHPrivateKey::loadAndGenerateNewEphemeral(templateKeyPair.first, templateKeyPair.second, publicKey);
+
+        AccountPtr outer;
+
+        {
+          AutoRecursiveLock lock(mLock);
+          get(mFilling) = false;
+
+          Domain &domain = mDomains[type];
+          if (domain.mTemplate.first != templateKeyPair.first) {
+            ZS_LOG_WARNING(Detail, log("template changed while generating (discarding key pair)"))
+          } else if ((!privateKey) ||
+                     (!publicKey)) {
+            // back off before trying this domain again; meanwhile the
+            // account generates inline rather than waiting on the pool
+            domain.mFailing = true;
+            domain.mRetryAfter = zsLib::now() + domain.mLastRetryAfterDuration;
+            domain.mLastRetryAfterDuration = domain.mLastRetryAfterDuration * 2;
+            if (domain.mLastRetryAfterDuration > Seconds(OPENPEER_STACK_ACCOUNT_EPHEMERAL_DH_KEY_POOL_MAX_RETRY_AFTER_TIME_IN_SECONDS)) {
+              domain.mLastRetryAfterDuration = Seconds(OPENPEER_STACK_ACCOUNT_EPHEMERAL_DH_KEY_POOL_MAX_RETRY_AFTER_TIME_IN_SECONDS);
+            }
+            ZS_LOG_ERROR(Detail, log("failed to generate ephemeral DH key pair") + ZS_PARAM("namespace", IDHKeyDomain::toNamespace(type)) + ZS_PARAM("retry after", domain.mRetryAfter))
+          } else {
+            domain.mFailing = false;
+            domain.mLastRetryAfterDuration = Seconds(OPENPEER_STACK_ACCOUNT_EPHEMERAL_DH_KEY_POOL_STARTING_RETRY_AFTER_IN_SECONDS);
+            domain.mReady.push_back(DHKeyPair(privateKey, publicKey));
+            ZS_LOG_TRACE(log("ephemeral key pair generated") + ZS_PARAM("namespace", IDHKeyDomain::toNamespace(type)) + ZS_PARAM("ready", domain.mReady.size()))
+          }
+
+          if (mOuterWaiting) {
+            get(mOuterWaiting) = false;
+            outer = mOuter.lock();
+          }
+
+          fill();
+        }
+
+        if (outer) {
+          ZS_LOG_DEBUG(log("waking account waiting on ephemeral key pair"))
+          outer->mWake.wake(outer);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Account::EphemeralDHKeyPool => ITimerDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void Account::EphemeralDHKeyPool::onTimer(TimerPtr timer)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if (timer != mRetryTimer) {
+          ZS_LOG_WARNING(Detail, log("received timer notification on obsolete timer (probably okay)") + ZS_PARAM("timer ID", timer->getID()))
+          return;
+        }
+
+        ZS_LOG_DEBUG(log("retrying ephemeral key pair generation"))
+
+        mRetryTimer.reset();
+        fill();
+      }
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Account::EphemeralDHKeyPool => (internal)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void Account::EphemeralDHKeyPool::fill()
+      {
+        if (mFilling) return;
+
+        KeyDomainPrecompiledTypes type = IDHKeyDomain::KeyDomainPrecompiledType_Unknown;
+        if (needsFill(type)) {
+          get(mFilling) = true;
+          IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+          return;
+        }
+
+        if (mRetryTimer) return;
+
+        Time retryAfter;
+        if (!getNextRetry(retryAfter)) return;
+
+        Time tick = zsLib::now();
+        Duration waitTime = Seconds(0);
+        if (retryAfter > tick) {
+          waitTime = retryAfter - tick;
+        }
+
+        ZS_LOG_DEBUG(log("waiting to retry ephemeral key pair generation") + ZS_PARAM("wait (ms)", waitTime))
+        mRetryTimer = Timer::create(mThisWeak.lock(), waitTime, false);
+      }
+
+      //-----------------------------------------------------------------------
+      bool Account::EphemeralDHKeyPool::needsFill(KeyDomainPrecompiledTypes &outType) const
+      {
+        // fill the emptiest domain first
+        bool found = false;
+        size_t smallest = mTargetDepth;
+        Time tick = zsLib::now();
+
+        for (DomainMap::const_iterator iter = mDomains.begin(); iter != mDomains.end(); ++iter) {
+          const Domain &domain = (*iter).second;
+          if (!domain.mTemplate.first) continue;
+          if ((domain.mFailing) && (tick < domain.mRetryAfter)) continue;
+          if (domain.mReady.size() >= smallest) continue;
+
+          smallest = domain.mReady.size();
+          outType = (*iter).first;
+          found = true;
+        }
+
+        return found;
+      }
+
+      //-----------------------------------------------------------------------
+      bool Account::EphemeralDHKeyPool::getNextRetry(Time &outRetryAfter) const
+      {
+        bool found = false;
+
+        for (DomainMap::const_iterator iter = mDomains.begin(); iter != mDomains.end(); ++iter) {
+          const Domain &domain = (*iter).second;
+          if (!domain.mTemplate.first) continue;
+          if (!domain.mFailing) continue;
+          if (domain.mReady.size() >= mTargetDepth) continue;
+
+          if ((!found) ||
+              (domain.mRetryAfter < outRetryAfter)) {
+            outRetryAfter = domain.mRetryAfter;
+            found = true;
+          }
+        }
+
+        return found;
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -46,6 +46,10 @@
 #include <openpeer/stack/message/peer-finder/PeerLocationFindRequest.h>
 
 #include <openpeer/stack/message/MessageResult.h>
+#include <openpeer/stack/message/MessageEnvelope.h>
+#include <openpeer/stack/message/MessageBinary.h>
+#include <openpeer/stack/message/MessageCompression.h>
+#include <openpeer/stack/message/MessageBatch.h>
 #include <openpeer/stack/IPeerFiles.h>
 #include <openpeer/stack/IPeerFilePublic.h>
 #include <openpeer/stack/IMessageMonitor.h>
@@ -87,6 +91,7 @@ namespace openpeer
     namespace internal
     {
       typedef IStackForInternal UseStack;
+      typedef ITimerWheelForInternal UseTimerWheel;
 
       using services::IHelper;
       using services::IWakeDelegateProxy;
@@ -148,7 +153,7 @@ namespace openpeer
                                    ) :
         MessageQueueAssociator(queue),
         SharedRecursiveLock(*outer),
-        mDelegate(IAccountFinderDelegateProxy::createWeak(UseStack::queueStack(), delegate)),
+        mDelegate(IAccountFinderDelegateProxy::createWeak(queue, delegate)),
         mOuter(outer),
         mCurrentState(IAccount::AccountState_Pending)
       {
@@ -158,7 +163,7 @@ namespace openpeer
       //---------------------------------------------------------------------
       void AccountFinder::init()
       {
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
       }
 
       //---------------------------------------------------------------------
@@ -198,7 +203,7 @@ namespace openpeer
                                                          AccountPtr outer
                                                          )
       {
-        AccountFinderPtr pThis(new AccountFinder(UseStack::queueStack(), delegate, outer));
+        AccountFinderPtr pThis(new AccountFinder(UseStack::queueStackFor(outer), delegate, outer));
         pThis->mThisWeak = pThis;
         pThis->init();
         return pThis;
@@ -255,11 +260,11 @@ namespace openpeer
           return false;
         }
 
-        DocumentPtr document = message->encode();
-
-        boost::shared_array<char> output;
-        size_t length = 0;
-        output = document->writeAsJSON(&length);
+        SecureByteBlockPtr frame = message->encoded(mBinaryEncoding ? Message::EncodedForm_Binary : Message::EncodedForm_JSON, mMessageWriter);
+        if (!frame) {
+          ZS_LOG_WARNING(Detail, log("message failed to encode") + Message::toDebug(message))
+          return false;
+        }
 
         if (ZS_IS_LOGGING(Detail)) {
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
@@ -267,13 +272,32 @@ namespace openpeer
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
           ZS_LOG_BASIC(log("MESSAGE INFO") + Message::toDebug(message))
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
-          ZS_LOG_BASIC(log("FINDER SEND MESSAGE") + ZS_PARAM("json out", ((CSTR)(output.get()))))
+          ZS_LOG_BASIC(log("FINDER SEND MESSAGE") + ZS_PARAM("json out", mBinaryEncoding ? String("(binary)") : String((const char *)(frame->BytePtr()), frame->SizeInBytes())))
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
           ZS_LOG_BASIC(log(">> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >> >"))
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
         }
 
-        mSendStream->write((const BYTE *)(output.get()), length);
+        if (!mBatching) return writeFrame(frame);
+
+        mSendBatch.append(frame->BytePtr(), frame->SizeInBytes());
+        if (message->isRequest()) mSendBatchRequests.push_back(message);
+
+        if (mSendBatch.isFull()) {
+          ZS_LOG_TRACE(log("send batch is full") + ZS_PARAM("frames", mSendBatch.getTotalFrames()) + ZS_PARAM("size", mSendBatch.getSize()))
+          flushSendBatch();
+          return true;
+        }
+
+        if (mSendBatchTimer) return true;
+
+        Duration window = MessageBatch::getWindow();
+        if (Duration() == window) {
+          mWake.wake(mThisWeak.lock());
+          return true;
+        }
+
+        mSendBatchTimer = UseTimerWheel::arm(mThisWeak.lock(), window);
         return true;
       }
 
@@ -329,7 +353,7 @@ namespace openpeer
       void AccountFinder::notifyFinderDNSComplete()
       {
         ZS_LOG_DEBUG(log("notified finder DNS complete"))
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
       }
 
       //-----------------------------------------------------------------------
@@ -343,7 +367,10 @@ namespace openpeer
       //-----------------------------------------------------------------------
       void AccountFinder::onWake()
       {
+        mWake.woken();
+
         AutoRecursiveLock lock(*this);
+        if (!mSendBatchTimer) flushSendBatch();
         step();
       }
 
@@ -451,13 +478,24 @@ namespace openpeer
           return;
         }
 
+        MessageBatch::FrameList frames;
+
         while (true) {
-          SecureByteBlockPtr buffer = mReceiveStream->read();
-          if (!buffer) {
-            ZS_LOG_TRACE(log("no data read"))
-            return;
+          if (frames.size() < 1) {
+            SecureByteBlockPtr received = mReceiveStream->read();
+            if (!received) {
+              ZS_LOG_TRACE(log("no data read"))
+              return;
+            }
+
+            // a batch (possibly compressed as a whole) carries several frames
+            if (!MessageBatch::unpack(received, frames)) continue;
+            if (frames.size() < 1) continue;
           }
 
+          SecureByteBlockPtr buffer = frames.front();
+          frames.pop_front();
+
           const char *bufferStr = (CSTR)(buffer->BytePtr());
 
           if (0 == strcmp(bufferStr, "\n")) {
@@ -465,27 +503,47 @@ namespace openpeer
             continue;
           }
 
-          DocumentPtr document = Document::createFromAutoDetect(bufferStr);
-          message::MessagePtr message = Message::create(document, Location::convert(UseLocation::getForFinder(Account::convert(outer))));
+          IMessageSourcePtr source = Location::convert(UseLocation::getForFinder(Account::convert(outer)));
+
+          MessageEnvelope envelope;
+          bool scanned = MessageEnvelope::scan(buffer, envelope);
 
           if (ZS_IS_LOGGING(Detail)) {
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
             ZS_LOG_BASIC(log("< < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < <"))
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
-            ZS_LOG_BASIC(log("MESSAGE INFO") + Message::toDebug(message))
+            ZS_LOG_BASIC(log("MESSAGE INFO") + envelope.toDebug())
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
-            ZS_LOG_BASIC(log("FINDER RECEIVED MESSAGE") + ZS_PARAM("json in", bufferStr))
+            ZS_LOG_BASIC(log("FINDER RECEIVED MESSAGE") + ZS_PARAM("json in", envelope.logText()))
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
             ZS_LOG_BASIC(log("< < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < <"))
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
           }
 
+          message::MessagePtr message;
+          if (scanned) {
+            if (IMessageMonitor::handleMessageReceived(envelope, source, message)) {
+              ZS_LOG_DEBUG(log("message requester handled the message"))
+              continue;
+            }
+
+            if (!message) {
+              // not monitored, decode for the account
+              message = envelope.decode(source);
+            }
+          } else {
+            // routing attributes could not be scanned so the frame has to be
+            // decoded regardless; decode it once and route the result
+            message = envelope.decode(source);
+          }
+
           if (!message) {
             ZS_LOG_WARNING(Detail, log("failed to create a message from the document"))
             continue;
           }
 
-          if (IMessageMonitor::handleMessageReceived(message)) {
+          if ((!scanned) &&
+              (IMessageMonitor::handleMessageReceived(message))) {
             ZS_LOG_DEBUG(log("message requester handled the message"))
             continue;
           }
@@ -528,7 +586,13 @@ namespace openpeer
         mRelayAccessToken = result->relayAccessToken();
         mRelayAccessSecret = result->relayAccessSecret();
 
-        (IWakeDelegateProxy::create(mThisWeak.lock()))->onWake();
+        // finders which do not understand the offer never answer "binary"
+        get(mBinaryEncoding) = ((MessageBinary::isEnabled()) && (OPENPEER_STACK_MESSAGE_ENCODING_BINARY == result->encoding()));
+        get(mCompression) = ((MessageCompression::isEnabled()) && (OPENPEER_STACK_MESSAGE_COMPRESSION_DEFLATE == result->compression()));
+        get(mBatching) = ((MessageBatch::isEnabled()) && (OPENPEER_STACK_MESSAGE_BATCHING == result->batching()));
+        ZS_LOG_DEBUG(log("session encoding negotiated") + ZS_PARAM("encoding", result->encoding()) + ZS_PARAM("binary", mBinaryEncoding) + ZS_PARAM("compression", result->compression()) + ZS_PARAM("batching", result->batching()))
+
+        mWake.wake(mThisWeak.lock());
         return true;
       }
 
@@ -576,7 +640,7 @@ namespace openpeer
 
         setTimeout(result->expires());
 
-        (IWakeDelegateProxy::create(mThisWeak.lock()))->onWake();
+        mWake.wake(mThisWeak.lock());
         return true;
       }
 
@@ -618,7 +682,7 @@ namespace openpeer
           return false;
         }
 
-        (IWakeDelegateProxy::create(mThisWeak.lock()))->onWake();
+        mWake.wake(mThisWeak.lock());
         return true;
       }
 
@@ -635,7 +699,7 @@ namespace openpeer
           return false;
         }
 
-        (IWakeDelegateProxy::create(mThisWeak.lock()))->onWake();
+        mWake.wake(mThisWeak.lock());
         return true;
       }
 
@@ -671,6 +735,27 @@ namespace openpeer
         mSessionKeepAliveMonitor = sendRequest(IMessageMonitorResultDelegate<SessionKeepAliveResult>::convert(mThisWeak.lock()), request, Seconds(OPENPEER_STACK_SESSION_KEEP_ALIVE_REQUEST_TIMEOUT_IN_SECONDS));
       }
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark AccountFinder => ITimerWheelDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void AccountFinder::onTimerWheelExpired(TimerWheelEntryPtr entry)
+      {
+        AutoRecursiveLock lock(*this);
+        if (entry != mSendBatchTimer) {
+          ZS_LOG_WARNING(Detail, log("received timer event for obsolete timer") + ZS_PARAM("timer", entry->getID()))
+          return;
+        }
+
+        mSendBatchTimer.reset();
+        flushSendBatch();
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -737,6 +822,7 @@ namespace openpeer
         ElementPtr resultEl = Element::create("AccountFinder");
 
         IHelper::debugAppend(resultEl, "id", mID);
+        IHelper::debugAppend(resultEl, mWake.toDebug());
         IHelper::debugAppend(resultEl, "state", IAccount::toString(mCurrentState));
         IHelper::debugAppend(resultEl, "finder connection id", mFinderConnection ? mFinderConnection->getID() : 0);
         IHelper::debugAppend(resultEl, "receive stream id", mReceiveStream ? mReceiveStream->getID() : 0);
@@ -744,6 +830,12 @@ namespace openpeer
         IHelper::debugAppend(resultEl, mFinder.toDebug());
         IHelper::debugAppend(resultEl, "finder IP", !mFinderIP.isAddressEmpty() ? mFinderIP.string() : String());
         IHelper::debugAppend(resultEl, "server agent", mServerAgent);
+        IHelper::debugAppend(resultEl, "binary encoding", (bool)mBinaryEncoding);
+        IHelper::debugAppend(resultEl, "compression", (bool)mCompression);
+        IHelper::debugAppend(resultEl, "batching", (bool)mBatching);
+        IHelper::debugAppend(resultEl, mSendBatch.toDebug());
+        IHelper::debugAppend(resultEl, "send batch requests", mSendBatchRequests.size());
+        IHelper::debugAppend(resultEl, "send batch timer", mSendBatchTimer ? mSendBatchTimer->getID() : 0);
         IHelper::debugAppend(resultEl, "created time", mSessionCreatedTime);
         IHelper::debugAppend(resultEl, "session create monitor", (bool)mSessionCreateMonitor);
         IHelper::debugAppend(resultEl, "session keep alive monitor", (bool)mSessionKeepAliveMonitor);
@@ -774,6 +866,9 @@ namespace openpeer
           mKeepAliveTimer.reset();
         }
 
+        // whatever was queued still goes out ahead of the session delete
+        flushSendBatch();
+
         if (mSessionCreateMonitor) {
           ZS_LOG_DEBUG(log("shutdown for create session request"))
 
@@ -801,6 +896,7 @@ namespace openpeer
                 request->domain(outer->getDomain());
 
                 mSessionDeleteMonitor = sendRequest(IMessageMonitorResultDelegate<SessionDeleteResult>::convert(mThisWeak.lock()), request, Seconds(OPENPEER_STACK_SESSION_DELETE_REQUEST_TIMEOUT_IN_SECONDS));
+                flushSendBatch();
                 return;
               }
             }
@@ -945,6 +1041,10 @@ namespace openpeer
         locationInfo->mCandidates.clear();
         request->locationInfo(locationInfo);
         request->peerFiles(peerFiles);
+        message::StringList encodings = MessageBinary::offeredEncodings();
+        MessageCompression::offerCompression(encodings);
+        MessageBatch::offerBatching(encodings);
+        request->encodings(encodings);
 
         ZS_LOG_DEBUG(log("sending session create request"))
         mSessionCreateMonitor = sendRequest(IMessageMonitorResultDelegate<SessionCreateResult>::convert(mThisWeak.lock()), request, Seconds(OPENPEER_STACK_SESSION_CREATE_REQUEST_TIMEOUT_IN_SECONDS));
@@ -952,6 +1052,54 @@ namespace openpeer
         return false;
       }
 
+      //-----------------------------------------------------------------------
+      bool AccountFinder::writeFrame(SecureByteBlockPtr frame) const
+      {
+        if (!mSendStream) {
+          ZS_LOG_WARNING(Detail, log("send stream is gone"))
+          return false;
+        }
+
+        if (mCompression) {
+          SecureByteBlockPtr compressed = MessageCompression::compress(frame->BytePtr(), frame->SizeInBytes());
+          if (compressed) {
+            ZS_LOG_TRACE(log("frame compressed") + ZS_PARAM("size", frame->SizeInBytes()) + ZS_PARAM("compressed", compressed->SizeInBytes()))
+            frame = compressed;
+          }
+        }
+
+        mSendStream->write(frame);
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      void AccountFinder::flushSendBatch() const
+      {
+        if (mSendBatchTimer) {
+          mSendBatchTimer->cancel();
+          mSendBatchTimer.reset();
+        }
+
+        if (mSendBatch.isEmpty()) return;
+
+        size_t totalFrames = mSendBatch.getTotalFrames();
+        SecureByteBlockPtr frame = mSendBatch.take();
+
+        MessageList requests;
+        requests.swap(mSendBatchRequests);
+
+        ZS_LOG_TRACE(log("flushing send batch") + ZS_PARAM("frames", totalFrames) + ZS_PARAM("size", frame->SizeInBytes()))
+
+        if (!writeFrame(frame)) {
+          ZS_LOG_WARNING(Detail, log("send batch dropped as the send stream is gone") + ZS_PARAM("frames", totalFrames) + ZS_PARAM("requests", requests.size()))
+
+          // send() already reported these as sent so fail their monitors now
+          for (MessageList::iterator iter = requests.begin(); iter != requests.end(); ++iter) {
+            UseMessageMonitorManager::notifyMessageSendFailed(*iter);
+          }
+        }
+      }
+
       //-----------------------------------------------------------------------
       void AccountFinder::setState(IAccount::AccountStates state)
       {
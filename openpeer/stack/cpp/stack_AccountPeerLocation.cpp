@@ -50,6 +50,10 @@
 #include <openpeer/stack/message/peer-finder/ChannelMapNotify.h>
 #include <openpeer/stack/message/peer-finder/PeerLocationFindRequest.h>
 #include <openpeer/stack/message/peer-finder/PeerLocationFindNotify.h>
+#include <openpeer/stack/message/MessageEnvelope.h>
+#include <openpeer/stack/message/MessageBinary.h>
+#include <openpeer/stack/message/MessageCompression.h>
+#include <openpeer/stack/message/MessageBatch.h>
 
 #include <openpeer/services/IHelper.h>
 #include <openpeer/services/IDHPrivateKey.h>
@@ -89,6 +93,7 @@ namespace openpeer
     namespace internal
     {
       typedef IStackForInternal UseStack;
+      typedef ITimerWheelForInternal UseTimerWheel;
 
       using services::IHelper;
       using services::IMessageLayerSecurityChannel;
@@ -170,7 +175,7 @@ namespace openpeer
                                                ) :
         MessageQueueAssociator(queue),
         SharedRecursiveLock(*outer),
-        mDelegate(IAccountPeerLocationDelegateProxy::createWeak(UseStack::queueStack(), delegate)),
+        mDelegate(IAccountPeerLocationDelegateProxy::createWeak(queue, delegate)),
         mOuter(outer),
 
         mCreatedReason(CreatedFromReason_IncomingFind), // INCOMING
@@ -212,7 +217,7 @@ namespace openpeer
                                                ) :
         MessageQueueAssociator(queue),
         SharedRecursiveLock(*outer),
-        mDelegate(IAccountPeerLocationDelegateProxy::createWeak(UseStack::queueStack(), delegate)),
+        mDelegate(IAccountPeerLocationDelegateProxy::createWeak(queue, delegate)),
         mOuter(outer),
 
         mLastCandidateVersionSent(request->locationInfo()->mCandidatesVersion),
@@ -252,10 +257,10 @@ namespace openpeer
 
         // monitor to receive all incoming notifications
         mFindRequestMonitor = IMessageMonitor::monitor(IMessageMonitorResultDelegate<PeerLocationFindNotify>::convert(mThisWeak.lock()), mFindRequest, Duration());
-        mFindRequestTimer = Timer::create(mThisWeak.lock(), Seconds(OPENPEER_STACK_ACCOUNT_PEER_LOCATION_PEER_LOCATION_FIND_TIMEOUT_IN_SECONDS), false);
+        mFindRequestTimer = UseTimerWheel::arm(mThisWeak.lock(), Seconds(OPENPEER_STACK_ACCOUNT_PEER_LOCATION_PEER_LOCATION_FIND_TIMEOUT_IN_SECONDS));
 
         // kick start the object
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
       }
 
       //---------------------------------------------------------------------
@@ -298,7 +303,7 @@ namespace openpeer
                                                                                                  IDHPublicKeyPtr localPublicKey
                                                                                                  )
       {
-        AccountPeerLocationPtr pThis(new AccountPeerLocation(UseStack::queueStack(), delegate, outer, request, localPrivateKey, localPublicKey));
+        AccountPeerLocationPtr pThis(new AccountPeerLocation(UseStack::queueStackFor(outer), delegate, outer, request, localPrivateKey, localPublicKey));
         pThis->mThisWeak = pThis;
         pThis->init();
         return pThis;
@@ -312,7 +317,7 @@ namespace openpeer
                                                                                                LocationInfoPtr locationInfo
                                                                                                )
       {
-        AccountPeerLocationPtr pThis(new AccountPeerLocation(UseStack::queueStack(), delegate, outer, request, locationInfo));
+        AccountPeerLocationPtr pThis(new AccountPeerLocation(UseStack::queueStackFor(outer), delegate, outer, request, locationInfo));
         pThis->mThisWeak = pThis;
         pThis->init();
         return pThis;
@@ -435,32 +440,20 @@ namespace openpeer
           return false;
         }
 
-        DocumentPtr document = message->encode();
-        if (!document) {
+        // the "appid" attribute is never sent peer to peer
+        SecureByteBlockPtr frame = message->encoded(mBinaryEncoding ? Message::EncodedForm_BinaryWithoutAppID : Message::EncodedForm_JSONWithoutAppID, mMessageWriter);
+        if (!frame) {
           ZS_LOG_WARNING(Detail, log("message failed to encode") + Message::toDebug(message))
           return false;
         }
 
-        ElementPtr rootEl = document->getFirstChildElement();
-        if (rootEl) {
-          AttributePtr appID = rootEl->findAttribute("appid");
-          if (appID) {
-            ZS_LOG_TRACE(log("stripping \"appid\" attribute from root element") + ZS_PARAM("appid", appID->getValue()))
-            appID->orphan();
-          }
-        }
-
-        boost::shared_array<char> output;
-        size_t length = 0;
-        output = document->writeAsJSON(&length);
-
         if (ZS_IS_LOGGING(Detail)) {
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
           ZS_LOG_BASIC(log("> > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > >"))
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
           ZS_LOG_BASIC(log("MESSAGE INFO") + Message::toDebug(message))
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
-          ZS_LOG_BASIC(log("PEER SEND MESSAGE") + ZS_PARAM("json out", ((CSTR)(output.get()))))
+          ZS_LOG_BASIC(log("PEER SEND MESSAGE") + ZS_PARAM("json out", mBinaryEncoding ? String("(binary)") : String((const char *)(frame->BytePtr()), frame->SizeInBytes())))
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
           ZS_LOG_BASIC(log("> > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > > >"))
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
@@ -468,35 +461,32 @@ namespace openpeer
 
         mLastActivity = zsLib::now();
 
-        if (mMLSSendStream) {
-          if (mMLSSendStream->isWriterReady()) {
-            if (!mDebugForceMessagesOverRelay) {
-              ZS_LOG_TRACE(log("message sent via RUDP/MLS"))
+        if (!mBatching) return writeFrame(frame);
 
-              mMLSSendStream->write((const BYTE *)(output.get()), length);
-              return true;
-            }
-          }
+        if (!isSendReady()) {
+          ZS_LOG_WARNING(Detail, log("requested to send a message but messaging is not ready"))
+          return false;
         }
 
-        if (mOutgoingRelaySendStream) {
-          if (mOutgoingRelaySendStream->isWriterReady()) {
-            ZS_LOG_TRACE(log("message send via outgoing relay"))
-            mOutgoingRelaySendStream->write((const BYTE *)(output.get()), length);
-            return true;
-          }
+        mSendBatch.append(frame->BytePtr(), frame->SizeInBytes());
+        if (message->isRequest()) mSendBatchRequests.push_back(message);
+
+        if (mSendBatch.isFull()) {
+          ZS_LOG_TRACE(log("send batch is full") + ZS_PARAM("frames", mSendBatch.getTotalFrames()) + ZS_PARAM("size", mSendBatch.getSize()))
+          flushSendBatch();
+          return true;
         }
 
-        if (mIncomingRelaySendStream) {
-          if (mIncomingRelaySendStream->isWriterReady()) {
-            ZS_LOG_TRACE(log("message send via incoming relay"))
-            mIncomingRelaySendStream->write((const BYTE *)(output.get()), length);
-            return true;
-          }
+        if (mSendBatchTimer) return true;
+
+        Duration window = MessageBatch::getWindow();
+        if (Duration() == window) {
+          mWake.wake(mThisWeak.lock());
+          return true;
         }
 
-        ZS_LOG_WARNING(Detail, log("requested to send a message but messaging is not ready"))
-        return false;
+        mSendBatchTimer = UseTimerWheel::arm(mThisWeak.lock(), window);
+        return true;
       }
 
       //-----------------------------------------------------------------------
@@ -660,7 +650,7 @@ namespace openpeer
 
         mIncomingRelayChannel->setIncomingContext(mLocalContext, mDHLocalPrivateKey, mDHLocalPublicKey, Peer::convert(mPeer));
 
-        (IWakeDelegateProxy::create(mThisWeak.lock()))->onWake();
+        mWake.wake(mThisWeak.lock());
       }
 
       //-----------------------------------------------------------------------
@@ -675,8 +665,10 @@ namespace openpeer
       void AccountPeerLocation::onWake()
       {
         ZS_LOG_DEBUG(log("on wake"))
+        mWake.woken();
 
         AutoRecursiveLock lock(*this);
+        if (!mSendBatchTimer) flushSendBatch();
         step();
       }
 
@@ -685,17 +677,23 @@ namespace openpeer
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       #pragma mark
-      #pragma mark AccountPeerLocation => ITimerDelegate
+      #pragma mark AccountPeerLocation => ITimerWheelDelegate
       #pragma mark
 
       //-----------------------------------------------------------------------
-      void AccountPeerLocation::onTimer(TimerPtr timer)
+      void AccountPeerLocation::onTimerWheelExpired(TimerWheelEntryPtr entry)
       {
         ZS_LOG_DEBUG(log("on timer"))
 
         AutoRecursiveLock lock(*this);
-        if (timer != mFindRequestTimer) {
-          ZS_LOG_WARNING(Detail, log("received timer event for obsolete timer") + ZS_PARAM("timer", timer->getID()))
+        if (entry == mSendBatchTimer) {
+          mSendBatchTimer.reset();
+          flushSendBatch();
+          return;
+        }
+
+        if (entry != mFindRequestTimer) {
+          ZS_LOG_WARNING(Detail, log("received timer event for obsolete timer") + ZS_PARAM("timer", entry->getID()))
           return;
         }
 
@@ -968,13 +966,24 @@ namespace openpeer
           return;
         }
 
+        MessageBatch::FrameList frames;
+
         while (true) {
-          SecureByteBlockPtr buffer = reader->read();
-          if (!buffer) {
-            ZS_LOG_TRACE(log("no data to read"))
-            return;
+          if (frames.size() < 1) {
+            SecureByteBlockPtr received = reader->read();
+            if (!received) {
+              ZS_LOG_TRACE(log("no data to read"))
+              return;
+            }
+
+            // a batch (possibly compressed as a whole) carries several frames
+            if (!MessageBatch::unpack(received, frames)) continue;
+            if (frames.size() < 1) continue;
           }
 
+          SecureByteBlockPtr buffer = frames.front();
+          frames.pop_front();
+
           const char *bufferStr = (CSTR)(buffer->BytePtr());
 
           if (0 == strcmp(bufferStr, "\n")) {
@@ -984,28 +993,48 @@ namespace openpeer
 
           mLastActivity = zsLib::now();
 
-          DocumentPtr document = Document::createFromAutoDetect(bufferStr);
-          MessagePtr message = Message::create(document, Location::convert(mLocation));
-          
+          IMessageSourcePtr source = Location::convert(mLocation);
+
+          MessageEnvelope envelope;
+          bool scanned = MessageEnvelope::scan(buffer, envelope);
+
           if (ZS_IS_LOGGING(Detail)) {
             bool viaRelay = (reader == mOutgoingRelayReceiveStream) || (reader == mIncomingRelayReceiveStream);
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
             ZS_LOG_BASIC(log("< < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < <"))
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
-            ZS_LOG_BASIC(log("MESSAGE INFO") + Message::toDebug(message))
+            ZS_LOG_BASIC(log("MESSAGE INFO") + envelope.toDebug())
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
-            ZS_LOG_BASIC(log("PEER RECEIVED MESSAGE") + ZS_PARAM("via", viaRelay ? "RELAY" : "RUDP/MLS") + ZS_PARAM("json in", bufferStr))
+            ZS_LOG_BASIC(log("PEER RECEIVED MESSAGE") + ZS_PARAM("via", viaRelay ? "RELAY" : "RUDP/MLS") + ZS_PARAM("json in", envelope.logText()))
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
             ZS_LOG_BASIC(log("< < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < < <"))
             ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
           }
 
+          MessagePtr message;
+          if (scanned) {
+            if (IMessageMonitor::handleMessageReceived(envelope, source, message)) {
+              ZS_LOG_DEBUG(log("handled message via message handler"))
+              return;
+            }
+
+            if (!message) {
+              // not monitored, decode for local handling
+              message = envelope.decode(source);
+            }
+          } else {
+            // routing attributes could not be scanned so the frame has to be
+            // decoded regardless; decode it once and route the result
+            message = envelope.decode(source);
+          }
+
           if (!message) {
             ZS_LOG_WARNING(Detail, log("failed to create a message object from incoming message"))
             return;
           }
 
-          if (IMessageMonitor::handleMessageReceived(message)) {
+          if ((!scanned) &&
+              (IMessageMonitor::handleMessageReceived(message))) {
             ZS_LOG_DEBUG(log("handled message via message handler"))
             return;
           }
@@ -1096,7 +1125,7 @@ namespace openpeer
                         notify->final()
                         );
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
 
         // request can never be handled because notifies can happen at any time in the future
         return false;
@@ -1174,7 +1203,12 @@ namespace openpeer
 
         mIdentifyTime = zsLib::now();
 
-        (IWakeDelegateProxy::create(mThisWeak.lock()))->onWake();
+        get(mBinaryEncoding) = ((MessageBinary::isEnabled()) && (OPENPEER_STACK_MESSAGE_ENCODING_BINARY == result->encoding()));
+        get(mCompression) = ((MessageCompression::isEnabled()) && (OPENPEER_STACK_MESSAGE_COMPRESSION_DEFLATE == result->compression()));
+        get(mBatching) = ((MessageBatch::isEnabled()) && (OPENPEER_STACK_MESSAGE_BATCHING == result->batching()));
+        ZS_LOG_DEBUG(log("peer encoding negotiated") + ZS_PARAM("encoding", result->encoding()) + ZS_PARAM("binary", mBinaryEncoding) + ZS_PARAM("compression", result->compression()) + ZS_PARAM("batching", result->batching()))
+
+        mWake.wake(mThisWeak.lock());
         return true;
       }
 
@@ -1278,6 +1312,7 @@ namespace openpeer
         ElementPtr resultEl = Element::create("AccountPeerLocation");
 
         IHelper::debugAppend(resultEl, "id", mID);
+        IHelper::debugAppend(resultEl, mWake.toDebug());
 
         IHelper::debugAppend(resultEl, "delegate", (bool)mDelegate);
         IHelper::debugAppend(resultEl, "outer", (bool)mOuter.lock());
@@ -1311,6 +1346,12 @@ namespace openpeer
         IHelper::debugAppend(resultEl, "messaging send stream id", mMessagingSendStream ? mMessagingSendStream->getID() : 0);
         IHelper::debugAppend(resultEl, "candidates final", mCandidatesFinal);
         IHelper::debugAppend(resultEl, "last candidates version sent", mLastCandidateVersionSent);
+        IHelper::debugAppend(resultEl, "binary encoding", (bool)mBinaryEncoding);
+        IHelper::debugAppend(resultEl, "compression", (bool)mCompression);
+        IHelper::debugAppend(resultEl, "batching", (bool)mBatching);
+        IHelper::debugAppend(resultEl, mSendBatch.toDebug());
+        IHelper::debugAppend(resultEl, "send batch requests", mSendBatchRequests.size());
+        IHelper::debugAppend(resultEl, "send batch timer", mSendBatchTimer ? mSendBatchTimer->getID() : 0);
 
         IHelper::debugAppend(resultEl, "mls id", mMLSChannel ? mMLSChannel->getID() : 0);
         IHelper::debugAppend(resultEl, "mls receive stream id", mMLSReceiveStream ? mMLSReceiveStream->getID() : 0);
@@ -1385,6 +1426,9 @@ namespace openpeer
           mFindRequestTimer.reset();
         }
 
+        // whatever was queued still goes out ahead of the shutdown
+        flushSendBatch();
+
         mIncomingRelayChannelNumber = 0;
 
         if (mGracefulShutdownReference) {
@@ -1575,7 +1619,7 @@ namespace openpeer
         }
 
         // ensure the socket has been woken up during the subscription process
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
         return false;
       }
 
@@ -2248,6 +2292,10 @@ namespace openpeer
 
         request->location(selfLocationInfo);
         request->peerFiles(outer->getPeerFiles());
+        message::StringList encodings = MessageBinary::offeredEncodings();
+        MessageCompression::offerCompression(encodings);
+        MessageBatch::offerBatching(encodings);
+        request->encodings(encodings);
 
         mIdentifyMonitor = sendRequest(IMessageMonitorResultDelegate<PeerIdentifyResult>::convert(mThisWeak.lock()), request, Seconds(OPENPEER_STACK_CONNECTION_MANAGER_PEER_IDENTIFY_EXPIRES_IN_SECONDS));
         return false;
@@ -2363,9 +2411,23 @@ namespace openpeer
             info->mCandidates.clear();
 
             result->locationInfo(info);
+
+            String encoding = MessageBinary::selectEncoding(request->encodings());
+            String compression = MessageCompression::selectCompression(request->encodings());
+            String batching = MessageBatch::selectBatching(request->encodings());
+            result->encoding(encoding);
+            result->compression(compression);
+            result->batching(batching);
             send(result);
 
-            IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+            // the result itself still goes out in plain JSON, the negotiated
+            // encoding and compression apply from the next message onwards
+            get(mBinaryEncoding) = (OPENPEER_STACK_MESSAGE_ENCODING_BINARY == encoding);
+            get(mCompression) = (OPENPEER_STACK_MESSAGE_COMPRESSION_DEFLATE == compression);
+            get(mBatching) = (OPENPEER_STACK_MESSAGE_BATCHING == batching);
+            ZS_LOG_DEBUG(log("peer encoding negotiated") + ZS_PARAM("encoding", encoding) + ZS_PARAM("binary", mBinaryEncoding) + ZS_PARAM("compression", compression) + ZS_PARAM("batching", batching))
+
+            mWake.wake(mThisWeak.lock());
             return;
           }
 
@@ -2416,6 +2478,94 @@ namespace openpeer
 
         return false;
       }
+
+      //-----------------------------------------------------------------------
+      bool AccountPeerLocation::isSendReady() const
+      {
+        if (mMLSSendStream) {
+          if ((mMLSSendStream->isWriterReady()) &&
+              (!mDebugForceMessagesOverRelay)) return true;
+        }
+        if (mOutgoingRelaySendStream) {
+          if (mOutgoingRelaySendStream->isWriterReady()) return true;
+        }
+        if (mIncomingRelaySendStream) {
+          if (mIncomingRelaySendStream->isWriterReady()) return true;
+        }
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      bool AccountPeerLocation::writeFrame(SecureByteBlockPtr frame) const
+      {
+        // NOTE: compressed here rather than per channel so the same frame is
+        //       compressed end to end whether it leaves via MLS or a relay
+        if (mCompression) {
+          SecureByteBlockPtr compressed = MessageCompression::compress(frame->BytePtr(), frame->SizeInBytes());
+          if (compressed) {
+            ZS_LOG_TRACE(log("frame compressed") + ZS_PARAM("size", frame->SizeInBytes()) + ZS_PARAM("compressed", compressed->SizeInBytes()))
+            frame = compressed;
+          }
+        }
+
+        if (mMLSSendStream) {
+          if (mMLSSendStream->isWriterReady()) {
+            if (!mDebugForceMessagesOverRelay) {
+              ZS_LOG_TRACE(log("message sent via RUDP/MLS"))
+
+              mMLSSendStream->write(frame);
+              return true;
+            }
+          }
+        }
+
+        if (mOutgoingRelaySendStream) {
+          if (mOutgoingRelaySendStream->isWriterReady()) {
+            ZS_LOG_TRACE(log("message send via outgoing relay"))
+            mOutgoingRelaySendStream->write(frame);
+            return true;
+          }
+        }
+
+        if (mIncomingRelaySendStream) {
+          if (mIncomingRelaySendStream->isWriterReady()) {
+            ZS_LOG_TRACE(log("message send via incoming relay"))
+            mIncomingRelaySendStream->write(frame);
+            return true;
+          }
+        }
+
+        ZS_LOG_WARNING(Detail, log("requested to send a message but messaging is not ready"))
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      void AccountPeerLocation::flushSendBatch() const
+      {
+        if (mSendBatchTimer) {
+          mSendBatchTimer->cancel();
+          mSendBatchTimer.reset();
+        }
+
+        if (mSendBatch.isEmpty()) return;
+
+        size_t totalFrames = mSendBatch.getTotalFrames();
+        SecureByteBlockPtr frame = mSendBatch.take();
+
+        MessageList requests;
+        requests.swap(mSendBatchRequests);
+
+        ZS_LOG_TRACE(log("flushing send batch") + ZS_PARAM("frames", totalFrames) + ZS_PARAM("size", frame->SizeInBytes()))
+
+        if (!writeFrame(frame)) {
+          ZS_LOG_WARNING(Detail, log("send batch dropped as messaging is no longer ready") + ZS_PARAM("frames", totalFrames) + ZS_PARAM("requests", requests.size()))
+
+          // send() already reported these as sent so fail their monitors now
+          for (MessageList::iterator iter = requests.begin(); iter != requests.end(); ++iter) {
+            UseMessageMonitorManager::notifyMessageSendFailed(*iter);
+          }
+        }
+      }
       
       //-----------------------------------------------------------------------
       void AccountPeerLocation::connectLocation(
@@ -2500,7 +2650,7 @@ namespace openpeer
                                                       );
         }
 
-        (IWakeDelegateProxy::create(mThisWeak.lock()))->onWake();
+        mWake.wake(mThisWeak.lock());
       }
       
       //-----------------------------------------------------------------------
@@ -874,8 +874,13 @@ namespace openpeer
 
         ZS_LOG_DEBUG(log("redirecting services get to a new URL") + ZS_PARAM("url", redirectionURL))
 
-        ServicesGetRequestPtr request = ServicesGetRequest::create();
-        request->domain(mDomain);
+        // re-post the same request so the redirect sends the bytes already
+        // encoded for the first post
+        ServicesGetRequestPtr request = ServicesGetRequest::convert(monitor->getMonitoredMessage());
+        if (!request) {
+          request = ServicesGetRequest::create();
+          request->domain(mDomain);
+        }
 
         mServicesGetMonitor = IMessageMonitor::monitor(IMessageMonitorResultDelegate<ServicesGetResult>::convert(mThisWeak.lock()), request, Seconds(OPENPEER_STACK_BOOSTRAPPER_DEFAULT_REQUEST_TIMEOUT_SECONDS));
         mServicesGetQuery = post(redirectionURL, request, getCookieName(BootstrapperRequestType_ServicesGet, mDomain, mRedirectionAttempts), getCacheTime(BootstrapperRequestType_ServicesGet));
@@ -1290,8 +1295,8 @@ namespace openpeer
           query->readData(*rawBuffer, size);
 
           if (size > 0) {
-            DocumentPtr doc = Document::createFromAutoDetect((const char *)((const BYTE *)(*rawBuffer)));
             if (query == mServicesGetQuery) {
+              DocumentPtr doc = Document::createFromAutoDetect((const char *)((const BYTE *)(*rawBuffer)));
               ElementPtr rootEl = doc->getFirstChildElement();
               // This is the only request in the system which could have come
               // from a HTTP GET request where no data was posted. As a result,
@@ -1301,8 +1306,10 @@ namespace openpeer
                 IMessageHelper::setAttributeID(rootEl, originalMesssage->messageID());
               }
               IMessageHelper::setAttributeTimestamp(rootEl, zsLib::now());
+              message = Message::create(doc, mThisWeak.lock());
+            } else {
+              message = Message::create(rawBuffer, mThisWeak.lock());
             }
-            message = Message::create(doc, mThisWeak.lock());
           }
         }
 
@@ -1346,12 +1353,12 @@ namespace openpeer
         SecureByteBlockPtr buffer;
 
         if (message) {
-          DocumentPtr doc = message->encode();
-          buffer = IHelper::convertToBuffer(doc->writeAsJSON(&size), size);
+          buffer = message->encoded(Message::EncodedForm_JSON, mMessageWriter);
+          size = (buffer ? buffer->SizeInBytes() : 0);
         }
 
         if (ZS_IS_LOGGING(Detail)) {
-          const char *output = (buffer ? (const char *)buffer->BytePtr(): NULL);
+          String output = (buffer ? String((const char *)(buffer->BytePtr()), buffer->SizeInBytes()) : String());
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
           ZS_LOG_BASIC(log(">---->---->---->---->---->----   HTTP SEND DATA START   >---->---->---->---->---->---->----"))
           ZS_LOG_BASIC(log("-------------------------------------------------------------------------------------------"))
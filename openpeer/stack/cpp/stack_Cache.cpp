@@ -111,13 +111,9 @@ namespace openpeer
       {
         if (!message) return;
 
-        ElementPtr el = message->creationElement();
-        if (!el) return;
-
-        GeneratorPtr generator = Generator::createJSONGenerator();
-        boost::shared_array<char> output = generator->write(el);
-
-        String result = (const char *)output.get();
+        // kept JSON text is stored as is (never re-parsed just to be written)
+        String result = message->creationJSON();
+        if (result.isEmpty()) return;
 
         ICache::store(cookieNamePath, expires, result);
       }
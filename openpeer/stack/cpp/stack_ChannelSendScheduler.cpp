@@ -0,0 +1,286 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/internal/stack_ChannelSendScheduler.h>
+
+#include <openpeer/services/IHelper.h>
+
+#include <zsLib/XML.h>
+
+namespace openpeer { namespace stack { ZS_DECLARE_SUBSYSTEM(openpeer_stack) } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      using services::IHelper;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelSendScheduler::Queue
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      ChannelSendScheduler::Queue::Queue(
+                                         ChannelNumber channelNumber,
+                                         bool priority
+                                         ) :
+        mChannelNumber(channelNumber),
+        mPriority(priority),
+        mQueuedBytes(0),
+        mDeficit(0),
+        mActive(false),
+        mTotalBuffersQueued(0),
+        mTotalBytesQueued(0),
+        mTotalBuffersSent(0),
+        mTotalBytesSent(0),
+        mTotalBuffersDiscarded(0),
+        mMaxQueuedBuffers(0),
+        mMaxQueuedBytes(0)
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelSendScheduler
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      ChannelSendScheduler::ChannelSendScheduler(size_t quantum) :
+        mQuantum(quantum > 0 ? quantum : 1),
+        mQueuedBytes(0),
+        mTotalRounds(0)
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      ChannelSendScheduler::~ChannelSendScheduler()
+      {
+        clear();
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr ChannelSendScheduler::toDebug(QueuePtr queue)
+      {
+        if (!queue) return ElementPtr();
+
+        ElementPtr resultEl = Element::create("stack::ChannelSendScheduler::Queue");
+
+        IHelper::debugAppend(resultEl, "channel number", queue->mChannelNumber);
+        IHelper::debugAppend(resultEl, "priority", queue->mPriority);
+        IHelper::debugAppend(resultEl, "queued buffers", queue->mBuffers.size());
+        IHelper::debugAppend(resultEl, "queued bytes", queue->mQueuedBytes);
+        IHelper::debugAppend(resultEl, "deficit", queue->mDeficit);
+        IHelper::debugAppend(resultEl, "active", queue->mActive);
+        IHelper::debugAppend(resultEl, "total buffers queued", queue->mTotalBuffersQueued);
+        IHelper::debugAppend(resultEl, "total bytes queued", queue->mTotalBytesQueued);
+        IHelper::debugAppend(resultEl, "total buffers sent", queue->mTotalBuffersSent);
+        IHelper::debugAppend(resultEl, "total bytes sent", queue->mTotalBytesSent);
+        IHelper::debugAppend(resultEl, "total buffers discarded", queue->mTotalBuffersDiscarded);
+        IHelper::debugAppend(resultEl, "max queued buffers", queue->mMaxQueuedBuffers);
+        IHelper::debugAppend(resultEl, "max queued bytes", queue->mMaxQueuedBytes);
+
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      ChannelSendScheduler::QueuePtr ChannelSendScheduler::open(
+                                                                ChannelNumber channelNumber,
+                                                                bool priority
+                                                                )
+      {
+        return QueuePtr(new Queue(channelNumber, priority));
+      }
+
+      //-----------------------------------------------------------------------
+      void ChannelSendScheduler::enqueue(
+                                         QueuePtr queue,
+                                         SecureByteBlockPtr buffer
+                                         )
+      {
+        ZS_THROW_INVALID_ARGUMENT_IF(!queue)
+        ZS_THROW_INVALID_ARGUMENT_IF(!buffer)
+
+        size_t size = buffer->SizeInBytes();
+
+        queue->mBuffers.push_back(buffer);
+        queue->mQueuedBytes += size;
+
+        ++(queue->mTotalBuffersQueued);
+        queue->mTotalBytesQueued += size;
+
+        if (queue->mBuffers.size() > queue->mMaxQueuedBuffers) queue->mMaxQueuedBuffers = queue->mBuffers.size();
+        if (queue->mQueuedBytes > queue->mMaxQueuedBytes) queue->mMaxQueuedBytes = queue->mQueuedBytes;
+
+        mQueuedBytes += size;
+
+        if (queue->mActive) return;
+
+        queue->mActive = true;
+        queue->mDeficit = 0;
+
+        if (queue->mPriority) {
+          mPriority.push_back(queue);
+        } else {
+          mActive.push_back(queue);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void ChannelSendScheduler::discard(QueuePtr queue)
+      {
+        if (!queue) return;
+
+        queue->mTotalBuffersDiscarded += static_cast<ULONG>(queue->mBuffers.size());
+
+        mQueuedBytes -= queue->mQueuedBytes;
+
+        queue->mBuffers.clear();
+        queue->mQueuedBytes = 0;
+        queue->mDeficit = 0;
+
+        if (!queue->mActive) return;
+
+        queue->mActive = false;
+
+        // NOTE: discarding only happens when a channel goes away
+        if (queue->mPriority) {
+          mPriority.remove(queue);
+        } else {
+          mActive.remove(queue);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      SecureByteBlockPtr ChannelSendScheduler::next(ChannelNumber &outChannelNumber)
+      {
+        outChannelNumber = 0;
+
+        if (mPriority.size() > 0) {
+          return pop(mPriority.front(), outChannelNumber);
+        }
+
+        while (mActive.size() > 0) {
+          QueuePtr queue = mActive.front();
+
+          size_t size = queue->mBuffers.front()->SizeInBytes();
+          if (size <= queue->mDeficit) {
+            queue->mDeficit -= size;
+            return pop(queue, outChannelNumber);
+          }
+
+          // this channel used up its share for the round, move on
+          queue->mDeficit += mQuantum;
+          mActive.pop_front();
+          mActive.push_back(queue);
+          ++mTotalRounds;
+        }
+
+        return SecureByteBlockPtr();
+      }
+
+      //-----------------------------------------------------------------------
+      void ChannelSendScheduler::clear()
+      {
+        while (mPriority.size() > 0) {
+          discard(mPriority.front());
+        }
+        while (mActive.size() > 0) {
+          discard(mActive.front());
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr ChannelSendScheduler::toDebug() const
+      {
+        ElementPtr resultEl = Element::create("stack::ChannelSendScheduler");
+
+        IHelper::debugAppend(resultEl, "quantum", mQuantum);
+        IHelper::debugAppend(resultEl, "priority queues", mPriority.size());
+        IHelper::debugAppend(resultEl, "active queues", mActive.size());
+        IHelper::debugAppend(resultEl, "queued bytes", mQueuedBytes);
+        IHelper::debugAppend(resultEl, "rounds", mTotalRounds);
+
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelSendScheduler => (internal)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      SecureByteBlockPtr ChannelSendScheduler::pop(
+                                                   QueuePtr queue,
+                                                   ChannelNumber &outChannelNumber
+                                                   )
+      {
+        SecureByteBlockPtr buffer = queue->mBuffers.front();
+        queue->mBuffers.pop_front();
+
+        size_t size = buffer->SizeInBytes();
+
+        queue->mQueuedBytes -= size;
+        ++(queue->mTotalBuffersSent);
+        queue->mTotalBytesSent += size;
+
+        mQueuedBytes -= size;
+
+        outChannelNumber = queue->mChannelNumber;
+
+        if (queue->mBuffers.size() < 1) {
+          // an idle channel does not keep its unused share
+          queue->mActive = false;
+          queue->mDeficit = 0;
+
+          QueueList &list = (queue->mPriority ? mPriority : mActive);
+          list.pop_front();
+        }
+
+        return buffer;
+      }
+
+    }
+  }
+}
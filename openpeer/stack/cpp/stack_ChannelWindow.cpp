@@ -0,0 +1,184 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/internal/stack_ChannelWindow.h>
+
+#include <openpeer/services/IHelper.h>
+
+#include <zsLib/XML.h>
+
+namespace openpeer { namespace stack { ZS_DECLARE_SUBSYSTEM(openpeer_stack) } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      using services::IHelper;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelWindow
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      ChannelWindow::ChannelWindow(
+                                   size_t window,
+                                   size_t maxReceiveBuffered
+                                   ) :
+        mWindow(window),
+        mMaxReceiveBuffered(maxReceiveBuffered),
+        mSentBytes(0),
+        mSendLimit(0),
+        mSendLimitKnown(false),
+        mReceivedBytes(0),
+        mAdvertisedWindow(0)
+      {
+        // a remote party honouring the window never leaves more than a window
+        // unread thus the bound cannot be tighter
+        if ((0 != mMaxReceiveBuffered) &&
+            (mMaxReceiveBuffered < mWindow)) {
+          mMaxReceiveBuffered = mWindow;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelWindow => (send side)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      bool ChannelWindow::hasSendCredit(size_t queuedBytes) const
+      {
+        if (0 == mWindow) return true;
+
+        // bounds what waits in the send scheduler for this channel even when
+        // the remote party never advertises a window
+        if (queuedBytes >= mWindow) return false;
+
+        if (!mSendLimitKnown) return true;
+
+        return mSentBytes < mSendLimit;
+      }
+
+      //-----------------------------------------------------------------------
+      void ChannelWindow::notifySent(size_t bytes)
+      {
+        mSentBytes += bytes;
+      }
+
+      //-----------------------------------------------------------------------
+      bool ChannelWindow::notifyWindow(QWORD window)
+      {
+        // updates can cross on the wire; an older (smaller) offset is stale
+        if ((mSendLimitKnown) &&
+            (window <= mSendLimit)) return false;
+
+        mSendLimit = window;
+        mSendLimitKnown = true;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelWindow => (receive side)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      bool ChannelWindow::notifyReceived(
+                                         size_t bytes,
+                                         size_t unreadBytes
+                                         )
+      {
+        if ((0 != mMaxReceiveBuffered) &&
+            (unreadBytes + bytes > mMaxReceiveBuffered)) return false;
+
+        mReceivedBytes += bytes;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool ChannelWindow::isBeyondAdvertisedWindow() const
+      {
+        if (0 == mAdvertisedWindow) return false;
+        return mReceivedBytes > mAdvertisedWindow;
+      }
+
+      //-----------------------------------------------------------------------
+      bool ChannelWindow::needsWindowUpdate(
+                                            size_t unreadBytes,
+                                            QWORD &outWindow
+                                            )
+      {
+        QWORD consumed = (mReceivedBytes > unreadBytes ? mReceivedBytes - unreadBytes : 0);
+        QWORD window = consumed + mWindow;
+
+        // only advertise again once at least half a window has been consumed
+        // so a steadily draining reader costs one update per half window
+        if ((0 != mAdvertisedWindow) &&
+            (window < mAdvertisedWindow + (mWindow / 2))) return false;
+
+        mAdvertisedWindow = window;
+        outWindow = window;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr ChannelWindow::toDebug() const
+      {
+        ElementPtr resultEl = Element::create("stack::ChannelWindow");
+
+        IHelper::debugAppend(resultEl, "window", mWindow);
+        IHelper::debugAppend(resultEl, "max receive buffered", mMaxReceiveBuffered);
+        IHelper::debugAppend(resultEl, "sent bytes", mSentBytes);
+        IHelper::debugAppend(resultEl, "send limit known", mSendLimitKnown);
+        IHelper::debugAppend(resultEl, "send limit", mSendLimit);
+        IHelper::debugAppend(resultEl, "received bytes", mReceivedBytes);
+        IHelper::debugAppend(resultEl, "advertised window", mAdvertisedWindow);
+
+        return resultEl;
+      }
+
+    }
+  }
+}
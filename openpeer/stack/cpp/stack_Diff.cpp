@@ -30,6 +30,7 @@
  */
 
 #include <openpeer/stack/internal/stack_Diff.h>
+#include <openpeer/stack/message/MessageNames.h>
 
 #include <zsLib/Log.h>
 #include <zsLib/Numeric.h>
@@ -198,7 +199,7 @@ namespace openpeer
           if (attributeIDName.size() > 0) {
             while (true) {
               if (!current) return ElementPtr();
-              AttributePtr attributeID = current->findAttribute("id");
+              AttributePtr attributeID = current->findAttribute(MessageNames::id());
               if (attributeID) {
                 if (attributeID->getValue() == attributeIDName) {
                   // found what we were looking for...
@@ -268,7 +269,7 @@ namespace openpeer
           bool foundOtherWithID = false;
           bool foundOtherElements = false;
 
-          String id = path->getAttributeValue("id");
+          String id = path->getAttributeValue(MessageNames::id());
           Index index = 0;
 
           String name = path->getValue();
@@ -279,7 +280,7 @@ namespace openpeer
             foundOtherElements = true;
             ++index;
 
-            String sibID = prevSibling->getAttributeValue("id");
+            String sibID = prevSibling->getAttributeValue(MessageNames::id());
             if (sibID == id) foundOtherWithID = true;
 
             prevSibling = prevSibling->findPreviousSiblingElement(name);
@@ -289,7 +290,7 @@ namespace openpeer
           while (nextSibling) {
             foundOtherElements = true;
             if (foundOtherWithID) break;
-            String sibID = nextSibling->getAttributeValue("id");
+            String sibID = nextSibling->getAttributeValue(MessageNames::id());
             if (sibID == id) {
               foundOtherWithID = true;
               break;
@@ -331,7 +332,7 @@ namespace openpeer
           result += "/" + (*iter);
         }
 
-        itemEl->setAttribute("path", result);
+        itemEl->setAttribute(MessageNames::path(), result);
         return itemEl;
       }
 
@@ -368,7 +369,7 @@ namespace openpeer
           ElementPtr itemEl = diffElem->findFirstChildElement(OPENPEER_STACK_DIFF_DOCUMENT_ITEM_ELEMENT_NAME);        // diff element
           while (itemEl)
           {
-            String pathStr = itemEl->getAttributeValue("path");
+            String pathStr = itemEl->getAttributeValue(MessageNames::path());
             String doStr = itemEl->getAttributeValue("do");
 
             PathComponentList pathList;
@@ -398,8 +399,8 @@ namespace openpeer
             switch (action) {
               case IDiff::DiffAction_None: {
                 // we are using "NONE" to reprepsent the special case of "attribute"
-                ElementPtr setElem = itemEl->findFirstChildElement("set");
-                ElementPtr removeElem = itemEl->findFirstChildElement("remove");
+                ElementPtr setElem = itemEl->findFirstChildElement(MessageNames::set());
+                ElementPtr removeElem = itemEl->findFirstChildElement(MessageNames::remove());
 
                 if (setElem) {
                   AttributePtr attrib = setElem->getFirstAttribute();
@@ -638,8 +639,8 @@ namespace openpeer
 
         ElementPtr itemEl = createDiffXDElement(modifyAtElementPath, DiffAction_Replace);
         itemEl->setAttribute("do", "a");
-        ElementPtr setEl = Element::create("set");
-        ElementPtr removeEl = Element::create("remove");
+        ElementPtr setEl = Element::create(MessageNames::set());
+        ElementPtr removeEl = Element::create(MessageNames::remove());
 
         if (setAttributesFromThisElement) {
           AttributePtr attrib = setAttributesFromThisElement->getFirstAttribute();
@@ -35,6 +35,8 @@
 #include <openpeer/stack/internal/stack_FinderRelayChannel.h>
 
 #include <openpeer/stack/message/peer-finder/ChannelMapRequest.h>
+#include <openpeer/stack/message/peer-finder/ChannelWindowNotify.h>
+#include <openpeer/stack/message/MessageEnvelope.h>
 
 #include <openpeer/stack/IMessageMonitor.h>
 
@@ -69,6 +71,10 @@ namespace openpeer
 
       using peer_finder::ChannelMapRequest;
       using peer_finder::ChannelMapRequestPtr;
+      using peer_finder::ChannelWindowNotify;
+      using peer_finder::ChannelWindowNotifyPtr;
+      using peer_finder::MessageFactoryPeerFinder;
+      using peer_finder::MessageFactoryPeerFinderPtr;
 
 //      typedef zsLib::XML::Exceptions::CheckFailed CheckFailed;
 
@@ -88,13 +94,18 @@ namespace openpeer
       #pragma mark FinderConnectionManager
       #pragma mark
 
+      // NOTE: the root manager keeps one pool per finder IP (never pruned, the
+      //       set of finder IPs is small) no matter which stack queue shard
+      //       asks for it; each pool is its own manager whose lock is shared
+      //       only by the relay connections in that pool.
       class FinderConnectionManager : public SharedRecursiveLock
       {
       public:
         friend class FinderConnection;
 
         typedef String RemoteIPString;
-        typedef std::map<RemoteIPString, FinderConnectionPtr> FinderConnectionMap;
+        typedef std::list<FinderConnectionPtr> FinderConnectionList;
+        typedef std::map<RemoteIPString, FinderConnectionManagerPtr> PoolMap;
 
       protected:
         //---------------------------------------------------------------------
@@ -112,6 +123,7 @@ namespace openpeer
         static FinderConnectionManagerPtr create()
         {
           FinderConnectionManagerPtr pThis(new FinderConnectionManager);
+          pThis->mThisWeak = pThis;
           return pThis;
         }
 
@@ -127,6 +139,14 @@ namespace openpeer
           return result;
         }
 
+        //---------------------------------------------------------------------
+        static FinderConnectionManagerPtr singleton(const IPAddress &remoteIP)
+        {
+          FinderConnectionManagerPtr root = singleton();
+          if (!root) return FinderConnectionManagerPtr();
+          return root->forFinder(remoteIP);
+        }
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -136,30 +156,37 @@ namespace openpeer
         // (duplicate) virtual RecursiveLock &*this const;
 
         //---------------------------------------------------------------------
-        FinderConnectionPtr find(const IPAddress &remoteIP)
+        // NOTE: picks and adds under the pool's lock so accounts racing to
+        //       the same finder never each open a connection of their own
+        FinderConnectionPtr obtain(IMessageQueuePtr queue)
         {
-          FinderConnectionMap::iterator found = mRelays.find(remoteIP.string());
-          if (found == mRelays.end()) return FinderConnectionPtr();
+          AutoRecursiveLock lock(*this);
 
-          return (*found).second;
-        }
+          FinderConnectionPtr existing = pick();
+          if (existing) {
+            ZS_LOG_DEBUG(existing->log("reusing existing connection"))
+            return existing;
+          }
 
-        //---------------------------------------------------------------------
-        void add(
-                 const IPAddress &remoteIP,
-                 FinderConnectionPtr relay
-                 )
-        {
-          mRelays[remoteIP.string()] = relay;
+          FinderConnectionPtr relay(new FinderConnection(mThisWeak.lock(), queue, mRemoteIP));
+          relay->mThisWeak = relay;
+          relay->init();
+
+          mPool.push_back(relay);
+          return relay;
         }
 
         //---------------------------------------------------------------------
-        void remove(const IPAddress &remoteIP)
+        void remove(PUID relayID)
         {
-          FinderConnectionMap::iterator found = mRelays.find(remoteIP.string());
-          if (found == mRelays.end()) return;
+          AutoRecursiveLock lock(*this);
 
-          mRelays.erase(found);
+          for (FinderConnectionList::iterator iter = mPool.begin(); iter != mPool.end(); ++iter)
+          {
+            if ((*iter)->getID() != relayID) continue;
+            mPool.erase(iter);
+            break;
+          }
         }
 
         static Log::Params slog(const char *message)
@@ -176,6 +203,61 @@ namespace openpeer
         //---------------------------------------------------------------------
         virtual const SharedRecursiveLock &getLock() const {return *this;}
 
+        //---------------------------------------------------------------------
+        FinderConnectionManagerPtr forFinder(const IPAddress &remoteIP)
+        {
+          AutoRecursiveLock lock(*this);
+
+          PoolMap::iterator found = mPools.find(remoteIP.string());
+          if (found != mPools.end()) return (*found).second;
+
+          FinderConnectionManagerPtr pool = create();
+          pool->mRemoteIP = remoteIP;
+          mPools[remoteIP.string()] = pool;
+          return pool;
+        }
+
+        //---------------------------------------------------------------------
+        // NOTE: returns the least loaded connection in the finder's pool (by
+        //       observed throughput, then by channel count) or NULL when a new
+        //       connection should be added to the pool instead; the pool only
+        //       grows while even its least loaded connection is busy
+        FinderConnectionPtr pick()
+        {
+          FinderConnectionPtr least;
+          for (FinderConnectionList::iterator iter = mPool.begin(); iter != mPool.end(); ++iter)
+          {
+            FinderConnectionPtr relay = (*iter);
+            if (!least) {
+              least = relay;
+              continue;
+            }
+
+            if (relay->mThroughput < least->mThroughput) {
+              least = relay;
+              continue;
+            }
+            if ((relay->mThroughput == least->mThroughput) &&
+                (relay->mChannels.size() < least->mChannels.size())) {
+              least = relay;
+            }
+          }
+
+          if (!least) return FinderConnectionPtr();
+
+          size_t maxConnections = services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_POOL_MAX_CONNECTIONS);
+          QWORD growAt = services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_POOL_GROW_AT_BYTES_PER_SECOND);
+
+          if ((mPool.size() < maxConnections) &&
+              (0 != growAt) &&
+              (least->mThroughput >= growAt)) {
+            ZS_LOG_DEBUG(slog("all pooled finder connections are busy (will add connection)") + ZS_PARAM("remote ip", mRemoteIP.string()) + ZS_PARAM("pool size", mPool.size()) + ZS_PARAM("least throughput", least->mThroughput))
+            return FinderConnectionPtr();
+          }
+
+          return least;
+        }
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -184,7 +266,10 @@ namespace openpeer
 
         FinderConnectionManagerWeakPtr mThisWeak;
 
-        FinderConnectionMap mRelays;
+        IPAddress mRemoteIP;                      // only set on pools
+        FinderConnectionList mPool;               // only used on pools
+
+        PoolMap mPools;                           // only used on the root
       };
 
       //-----------------------------------------------------------------------
@@ -207,13 +292,34 @@ namespace openpeer
         mCurrentState(SessionState_Pending),
         mRemoteIP(remoteFinderIP),
         mLastSentData(zsLib::now()),
-        mSendKeepAliveAfter(Seconds(services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_MUST_SEND_PING_IF_NO_SEND_ACTIVITY_IN_SECONDS)))
+        mSendKeepAliveAfter(Seconds(services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_MUST_SEND_PING_IF_NO_SEND_ACTIVITY_IN_SECONDS))),
+        mSendScheduler(services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_SEND_QUANTUM_IN_BYTES)),
+        mSendLowWaterMark(services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_SEND_LOW_WATER_MARK_IN_BYTES)),
+        mChannelWindow(services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_WINDOW_IN_BYTES)),
+        mFlowControl(services::ISettings::getBool(OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_FLOW_CONTROL)),
+        mChannelMaxReceiveBuffered(services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_MAX_RECEIVE_BUFFERED_IN_BYTES)),
+        mTotalBytesSent(0),
+        mTotalBytesReceived(0),
+        mThroughput(0),
+        mThroughputSampledAt(zsLib::now()),
+        mThroughputSampledBytes(0),
+        mMaxMapRequestsInFlight(services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_MAX_CHANNEL_MAP_REQUESTS_IN_FLIGHT))
       {
         ZS_LOG_DETAIL(log("created"))
 
+        mControlQueue = mSendScheduler.open(0, true);
+
         if (mSendKeepAliveAfter.total_seconds() < 1) {
           mSendKeepAliveAfter = Duration();
         }
+
+        if (0 == mChannelWindow) {
+          mFlowControl = false;
+        }
+
+        if (mMaxMapRequestsInFlight < 1) {
+          mMaxMapRequestsInFlight = 1;
+        }
       }
 
       //-----------------------------------------------------------------------
@@ -226,7 +332,11 @@ namespace openpeer
 
         mTCPMessaging = ITCPMessaging::connect(mThisWeak.lock(), mWireReceiveStream->getStream(), mWireSendStream->getStream(), true, mRemoteIP);
 
-        if (Duration() != mSendKeepAliveAfter) {
+        // NOTE: pooled relay connections need the tick to sample throughput
+        //       even when keep-alive pings are disabled
+        if ((Duration() != mSendKeepAliveAfter) ||
+            ((isFinderRelayConnection()) &&
+             (services::ISettings::getUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_POOL_MAX_CONNECTIONS) > 1))) {
           mPingTimer = Timer::create(mThisWeak.lock(), Seconds(5));
         }
 
@@ -281,21 +391,16 @@ namespace openpeer
 
         RecursiveLock bogusLock;
 
-        FinderConnectionManagerPtr manager = FinderConnectionManager::singleton();
+        IMessageQueuePtr queue = UseStack::queueStackFor(delegate);
 
-        FinderConnectionPtr existing = manager ? manager->find(remoteFinderIP) : FinderConnectionPtr();
-
-        if (existing) {
-          ZS_LOG_DEBUG(existing->log("reusing existing connection"))
-          return existing->connect(delegate, localContextID, remoteContextID, relayDomain, relayAccessToken, relayAccessSecretProof, receiveStream, sendStream);
-        }
+        FinderConnectionManagerPtr manager = FinderConnectionManager::singleton(remoteFinderIP);
 
-        FinderConnectionPtr pThis(new FinderConnection(manager, UseStack::queueStack(), remoteFinderIP));
-        pThis->mThisWeak = pThis;
-        pThis->init();
+        FinderConnectionPtr pThis = manager ? manager->obtain(queue) : FinderConnectionPtr();
 
-        if (manager) {
-          manager->add(remoteFinderIP, pThis);
+        if (!pThis) {
+          pThis = FinderConnectionPtr(new FinderConnection(FinderConnectionManagerPtr(), queue, remoteFinderIP));
+          pThis->mThisWeak = pThis;
+          pThis->init();
         }
 
         return pThis->connect(delegate, localContextID, remoteContextID, relayDomain, relayAccessToken, relayAccessSecretProof, receiveStream, sendStream);
@@ -341,7 +446,7 @@ namespace openpeer
         pThis->init();
 
         ChannelPtr channel = Channel::incoming(pThis, pThis, receiveStream, sendStream, 0);
-        pThis->mChannels[0] = channel;
+        pThis->addChannel(0, channel);
 
         return pThis;
       }
@@ -371,7 +476,7 @@ namespace openpeer
             return subscription;
           }
 
-          for (ChannelMap::iterator iter = mIncomingChannels.begin(); iter != mIncomingChannels.end(); ++iter)
+          for (size_t index = 0; index < mChannels.size(Channels::List_Incoming); ++index)
           {
             delegate->onFinderConnectionIncomingRelayChannel(pThis);
           }
@@ -404,7 +509,7 @@ namespace openpeer
 
         FinderConnectionManagerPtr outer = mOuter.lock();
         if (outer) {
-          outer->remove(mRemoteIP);
+          outer->remove(mID);
         }
 
         if (mTCPMessaging) {
@@ -422,22 +527,19 @@ namespace openpeer
 
         // scope: clear out channels
         {
-          for (ChannelMap::iterator iter = mChannels.begin(); iter != mChannels.end(); ++iter)
+          for (ChannelHandle handle = mChannels.first(); !handle.isEmpty(); handle = mChannels.next(handle))
           {
-            ChannelPtr channel = (*iter).second;
+            ChannelPtr channel = *(mChannels.get(handle));
+            if (channel->mMapRequestMonitor) {
+              channel->mMapRequestMonitor->cancel();
+              channel->mMapRequestMonitor.reset();
+            }
             channel->cancel();
           }
           mChannels.clear();
         }
 
-        mPendingMapRequest.clear();
-        mIncomingChannels.clear();
-        mRemoveChannels.clear();
-
-        if (mMapRequestChannelMonitor) {
-          mMapRequestChannelMonitor->cancel();
-          mMapRequestChannelMonitor.reset();
-        }
+        mSendScheduler.clear();
       }
 
       //-----------------------------------------------------------------------
@@ -480,15 +582,15 @@ namespace openpeer
 
         stepCleanRemoval();
 
-        if (mIncomingChannels.size() < 1) {
+        if (mChannels.size(Channels::List_Incoming) < 1) {
           ZS_LOG_WARNING(Detail, log("no pending channels found"))
           return IFinderRelayChannelPtr();
         }
 
-        ChannelMap::iterator found = mIncomingChannels.begin();
+        ChannelHandle handle = mChannels.front(Channels::List_Incoming);
 
-        ChannelNumber channelNumber = (*found).first;
-        ChannelPtr channel = (*found).second;
+        ChannelNumber channelNumber = mChannels.channelNumber(handle);
+        ChannelPtr channel = *(mChannels.get(handle));
 
         ZS_LOG_DEBUG(log("accepting channel") + ZS_PARAM("channel number", channelNumber))
 
@@ -500,7 +602,7 @@ namespace openpeer
         UseFinderRelayChannelPtr relay = UseFinderRelayChannel::createIncoming(delegate, account, receiveStream, sendStream, wireReceiveStream, wireSendStream);
         channel->notifyIncomingFinderRelayChannel(FinderRelayChannel::convert(relay));
 
-        mIncomingChannels.erase(found);
+        mChannels.unlink(handle, Channels::List_Incoming);
 
         if (mSendStreamNotifiedReady) {
           ZS_LOG_DEBUG(log("notify channel that it's now write ready"))
@@ -534,6 +636,28 @@ namespace openpeer
 
         Time tick = zsLib::now();
 
+        sampleThroughput(tick);
+
+        // also picks up anything held back if the wire drained quietly
+        sendScheduled();
+
+        if (0 != mChannelWindow) {
+          // likewise for channels holding data or owing a window update
+          for (ChannelHandle handle = mChannels.first(); !handle.isEmpty(); handle = mChannels.next(handle))
+          {
+            if (mChannels.isLinked(handle, Channels::List_Pending)) continue;
+            if (mChannels.isLinked(handle, Channels::List_Mapping)) continue;
+
+            ChannelPtr channel = *(mChannels.get(handle));
+            channel->notifyFlowControlCheck();
+          }
+        }
+
+        if (Duration() == mSendKeepAliveAfter) {
+          ZS_LOG_INSANE(log("keep-alive pings are disabled"))
+          return;
+        }
+
         if (mLastSentData + mSendKeepAliveAfter > tick) {
           ZS_LOG_INSANE(log("activity within window thus no need to send ping"))
           return;
@@ -544,17 +668,15 @@ namespace openpeer
           return;
         }
 
-        ChannelHeaderPtr header(new ChannelHeader);
-        header->mChannelID = static_cast<decltype(header->mChannelID)>(0);
-
-        mWireSendStream->write((const BYTE *)"\n", sizeof(char), header);
-
-        mLastSentData = tick;
+        mSendScheduler.enqueue(mControlQueue, SecureByteBlockPtr(new SecureByteBlock((const BYTE *)"\n", sizeof(char))));
+        sendScheduled();
       }
 
       //-----------------------------------------------------------------------
       void FinderConnection::onWake()
       {
+        mWake.woken();
+
         AutoRecursiveLock lock(*this);
         ZS_LOG_DEBUG(log("on wake"))
         step();
@@ -605,16 +727,17 @@ namespace openpeer
         if (writer == mWireSendStream) {
           get(mSendStreamNotifiedReady) = true;
 
-          for (ChannelMap::iterator iter = mChannels.begin(); iter != mChannels.end(); ++iter)
-          {
-            ChannelNumber channelNumber = (*iter).first;
-            ChannelPtr &channel = (*iter).second;
+          sendScheduled();
 
-            ChannelMap::iterator found = mPendingMapRequest.find(channelNumber);
-            if (found != mPendingMapRequest.end()) {
-              ZS_LOG_DEBUG(log("cannot notify about write ready because channel map request has not completed yet") + ZS_PARAM("channel number", channelNumber))
+          for (ChannelHandle handle = mChannels.first(); !handle.isEmpty(); handle = mChannels.next(handle))
+          {
+            if ((mChannels.isLinked(handle, Channels::List_Pending)) ||
+                (mChannels.isLinked(handle, Channels::List_Mapping))) {
+              ZS_LOG_DEBUG(log("cannot notify about write ready because channel map request has not completed yet") + ZS_PARAM("channel number", mChannels.channelNumber(handle)))
               continue;
             }
+
+            ChannelPtr channel = *(mChannels.get(handle));
             channel->notifyReceivedWireWriteReady();
           }
         }
@@ -672,34 +795,27 @@ namespace openpeer
                                                                 )
       {
         AutoRecursiveLock lock(*this);
-        if (monitor != mMapRequestChannelMonitor) {
+
+        ChannelHandle handle = findMapRequest(monitor);
+        if (handle.isEmpty()) {
           ZS_LOG_WARNING(Detail, log("notified about obsolete monitor"))
           return false;
         }
 
-        ZS_LOG_DEBUG(log("channel map request completed successfully") + ZS_PARAM("channel number", mMapRequestChannelNumber))
+        ZS_LOG_DEBUG(log("channel map request completed successfully") + ZS_PARAM("channel number", mChannels.channelNumber(handle)) + ZS_PARAM("in flight", mChannels.size(Channels::List_Mapping)))
 
-        mMapRequestChannelMonitor.reset();
+        ChannelPtr channel = *(mChannels.get(handle));
+        ZS_THROW_BAD_STATE_IF(!channel)
 
-        // scope: remove from pending list
-        {
-          ChannelMap::iterator found = mPendingMapRequest.find(mMapRequestChannelNumber);
-          if (found != mPendingMapRequest.end()) {
-            ZS_LOG_TRACE(log("removed from pending map"))
-
-            if (mSendStreamNotifiedReady) {
-              ChannelPtr channel = (*found).second;
-              ZS_THROW_BAD_STATE_IF(!channel)
-              ZS_LOG_DEBUG(log("notifying channel of write ready"))
-              channel->notifyReceivedWireWriteReady();
-            }
-            mPendingMapRequest.erase(found);
-          }
-        }
+        channel->mMapRequestMonitor.reset();
+        mChannels.unlink(handle, Channels::List_Mapping);
 
-        get(mMapRequestChannelNumber) = 0;
+        if (mSendStreamNotifiedReady) {
+          ZS_LOG_DEBUG(log("notifying channel of write ready"))
+          channel->notifyReceivedWireWriteReady();
+        }
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
 
         return true;
       }
@@ -712,39 +828,29 @@ namespace openpeer
                                                                      )
       {
         AutoRecursiveLock lock(*this);
-        if (monitor != mMapRequestChannelMonitor) {
+
+        ChannelHandle handle = findMapRequest(monitor);
+        if (handle.isEmpty()) {
           ZS_LOG_WARNING(Detail, log("notified about obsolete monitor"))
           return false;
         }
 
-        ZS_LOG_WARNING(Detail, log("channel map request failed") + ZS_PARAM("channel number", mMapRequestChannelNumber))
+        ZS_LOG_WARNING(Detail, log("channel map request failed") + ZS_PARAM("channel number", mChannels.channelNumber(handle)))
 
-        mMapRequestChannelMonitor.reset();
+        ChannelPtr channel = *(mChannels.get(handle));
+        ZS_THROW_BAD_STATE_IF(!channel)
 
-        // scope: remove from channels list
-        {
-          ChannelMap::iterator found = mChannels.find(mMapRequestChannelNumber);
-          if (found != mChannels.end()) {
-            ZS_LOG_TRACE(log("removed from channels map"))
-            ChannelPtr channel = (*found).second;
-            ZS_THROW_BAD_STATE_IF(!channel)
-            channel->cancel();
-            mChannels.erase(found);
-          }
-        }
+        channel->mMapRequestMonitor.reset();
+        mChannels.unlink(handle, Channels::List_Mapping);
 
-        // scope: remove from pending list
+        // scope: cancel channel (the slot is released by the clean removal step)
         {
-          ChannelMap::iterator found = mPendingMapRequest.find(mMapRequestChannelNumber);
-          if (found != mPendingMapRequest.end()) {
-            ZS_LOG_TRACE(log("removed from pending map"))
-            mPendingMapRequest.erase(found);
-          }
+          ZS_LOG_TRACE(log("cancelling channel"))
+          channel->cancel();
+          mChannels.link(handle, Channels::List_Remove);
         }
 
-        get(mMapRequestChannelNumber) = 0;
-
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
 
         return true;
       }
@@ -771,10 +877,11 @@ namespace openpeer
 
       //-----------------------------------------------------------------------
       void FinderConnection::sendBuffer(
-                                        ChannelNumber channelNumber,
+                                        SendQueuePtr queue,
                                         SecureByteBlockPtr buffer
                                         )
       {
+        ZS_THROW_INVALID_ARGUMENT_IF(!queue)
         ZS_THROW_INVALID_ARGUMENT_IF(!buffer)
 
         AutoRecursiveLock lock(*this);
@@ -784,31 +891,59 @@ namespace openpeer
           return;
         }
 
-        ZS_LOG_DEBUG(log("send buffer called") + ZS_PARAM("channel number", channelNumber) + ZS_PARAM("buffer size", buffer->SizeInBytes()))
-
-        ChannelHeaderPtr header(new ChannelHeader);
-        header->mChannelID = static_cast<decltype(header->mChannelID)>(channelNumber);
+        ZS_LOG_DEBUG(log("send buffer called") + ZS_PARAM("channel number", queue->mChannelNumber) + ZS_PARAM("buffer size", buffer->SizeInBytes()))
 
-        mWireSendStream->write(buffer, header);
-
-        mLastSentData = zsLib::now();
+        mSendScheduler.enqueue(queue, buffer);
+        sendScheduled();
       }
 
       //-----------------------------------------------------------------------
-      void FinderConnection::notifyDestroyed(ChannelNumber channelNumber)
+      void FinderConnection::notifyDestroyed(ChannelHandle channel)
       {
         AutoRecursiveLock lock(*this);
 
-        ZS_LOG_DEBUG(log("channel is destroyed") + ZS_PARAM("channel number", channelNumber))
+        ZS_LOG_DEBUG(log("channel is destroyed") + ZS_PARAM("channel number", mChannels.channelNumber(channel)))
 
         if (isShutdown()) {
           ZS_LOG_WARNING(Trace, log("finder connection already destroyed (probably okay)"))
           return;
         }
 
-        mRemoveChannels[channelNumber] = ChannelPtr();
+        if (!mChannels.link(channel, Channels::List_Remove)) {
+          ZS_LOG_WARNING(Trace, log("channel was already removed (probably okay)"))
+          return;
+        }
         
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
+      }
+
+      //-----------------------------------------------------------------------
+      void FinderConnection::sendWindow(
+                                        ChannelNumber channelNumber,
+                                        QWORD window
+                                        )
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (isShutdown()) {
+          ZS_LOG_WARNING(Detail, log("cannot send channel window while shutdown"))
+          return;
+        }
+
+        ChannelWindowNotifyPtr notify = ChannelWindowNotify::create();
+        notify->channelNumber(static_cast<ChannelWindowNotify::ChannelNumber>(channelNumber));
+        notify->window(window);
+
+        SecureByteBlockPtr frame = notify->encoded(Message::EncodedForm_JSON, mMessageWriter);
+        if (!frame) {
+          ZS_LOG_ERROR(Detail, log("failed to encode channel window notify") + Message::toDebug(notify))
+          return;
+        }
+
+        ZS_LOG_TRACE(log("advertising channel window") + ZS_PARAM("channel number", channelNumber) + ZS_PARAM("window", window))
+
+        mSendScheduler.enqueue(mControlQueue, frame);
+        sendScheduled();
       }
 
 
@@ -855,6 +990,7 @@ namespace openpeer
         ElementPtr resultEl = Element::create("FinderConnection");
 
         IHelper::debugAppend(resultEl, "id", mID);
+        IHelper::debugAppend(resultEl, mWake.toDebug());
 
         IHelper::debugAppend(resultEl, "outer", (bool)mOuter.lock());
 
@@ -880,12 +1016,24 @@ namespace openpeer
 
         IHelper::debugAppend(resultEl, "channels", mChannels.size());
 
-        IHelper::debugAppend(resultEl, "pending map request channels", mPendingMapRequest.size());
-        IHelper::debugAppend(resultEl, "incoming channels", mIncomingChannels.size());
-        IHelper::debugAppend(resultEl, "remove channels", mRemoveChannels.size());
+        IHelper::debugAppend(resultEl, "channel slots", mChannels.capacity());
+        IHelper::debugAppend(resultEl, "send scheduler", mSendScheduler.toDebug());
+        IHelper::debugAppend(resultEl, "control queue", ChannelSendScheduler::toDebug(mControlQueue));
+        IHelper::debugAppend(resultEl, "send low water mark", mSendLowWaterMark);
+        IHelper::debugAppend(resultEl, "channel window", mChannelWindow);
+        IHelper::debugAppend(resultEl, "flow control", mFlowControl);
+        IHelper::debugAppend(resultEl, "channel max receive buffered", mChannelMaxReceiveBuffered);
+
+        IHelper::debugAppend(resultEl, "total bytes sent", mTotalBytesSent);
+        IHelper::debugAppend(resultEl, "total bytes received", mTotalBytesReceived);
+        IHelper::debugAppend(resultEl, "throughput (bytes/s)", mThroughput);
 
-        IHelper::debugAppend(resultEl, "map request monitor", (bool)mMapRequestChannelMonitor);
-        IHelper::debugAppend(resultEl, "map request channel number", mMapRequestChannelNumber);
+        IHelper::debugAppend(resultEl, "pending map request channels", mChannels.size(Channels::List_Pending));
+        IHelper::debugAppend(resultEl, "incoming channels", mChannels.size(Channels::List_Incoming));
+        IHelper::debugAppend(resultEl, "remove channels", mChannels.size(Channels::List_Remove));
+
+        IHelper::debugAppend(resultEl, "map requests in flight", mChannels.size(Channels::List_Mapping));
+        IHelper::debugAppend(resultEl, "max map requests in flight", mMaxMapRequestsInFlight);
 
         return resultEl;
       }
@@ -949,13 +1097,16 @@ namespace openpeer
       //-----------------------------------------------------------------------
       bool FinderConnection::stepCleanRemoval()
       {
-        if (mRemoveChannels.size() < 1) {
+        if (mChannels.size(Channels::List_Remove) < 1) {
           ZS_LOG_TRACE(log("no channels to remove"))
           return true;
         }
 
-        for (ChannelMap::iterator iter = mRemoveChannels.begin(); iter != mRemoveChannels.end(); ++iter) {
-          ChannelNumber channelNumber = (*iter).first;
+        while (mChannels.size(Channels::List_Remove) > 0) {
+          ChannelHandle handle = mChannels.front(Channels::List_Remove);
+          ChannelNumber channelNumber = mChannels.channelNumber(handle);
+
+          mChannels.unlink(handle, Channels::List_Remove);
 
           ZS_LOG_DEBUG(log("removing channel") + ZS_PARAM("channel number", channelNumber))
 
@@ -963,77 +1114,77 @@ namespace openpeer
 
           // scope: remove from pending map request
           {
-            ChannelMap::iterator found = mPendingMapRequest.find(channelNumber);
-            if (found != mPendingMapRequest.end()) {
+            if (mChannels.unlink(handle, Channels::List_Pending)) {
               ZS_LOG_DEBUG(log("removing channel from pending map request"))
               foundInPendingMapRequest = true;
-              mPendingMapRequest.erase(found);
             }
           }
 
-          if ((mMapRequestChannelMonitor) &&
-              (mMapRequestChannelNumber == channelNumber)) {
-            ZS_LOG_WARNING(Detail, log("outstanding channel map request is being cancelled for channel"))
-            mMapRequestChannelMonitor->cancel();
-            mMapRequestChannelMonitor.reset();
+          // scope: cancel outstanding map request
+          {
+            if (mChannels.unlink(handle, Channels::List_Mapping)) {
+              ZS_LOG_WARNING(Detail, log("outstanding channel map request is being cancelled for channel"))
+              ChannelPtr channel = *(mChannels.get(handle));
+              if (channel->mMapRequestMonitor) {
+                channel->mMapRequestMonitor->cancel();
+                channel->mMapRequestMonitor.reset();
+              }
+            }
           }
 
           // scope: remove from incoming channels
           {
-            ChannelMap::iterator found = mIncomingChannels.find(channelNumber);
-            if (found != mIncomingChannels.end()) {
+            if (mChannels.unlink(handle, Channels::List_Incoming)) {
               ZS_LOG_DEBUG(log("removing channel from incoming channels"))
-              mIncomingChannels.erase(found);
             }
           }
 
+          SendQueuePtr sendQueue;
+
           // scope: remove from channels
           {
-            ChannelMap::iterator found = mChannels.find(channelNumber);
-            if (found != mChannels.end()) {
-              ZS_LOG_DEBUG(log("removing channel from channels"))
-
-              ChannelPtr channel = (*found).second;
+            ZS_LOG_DEBUG(log("removing channel from channels"))
 
-              ZS_THROW_BAD_STATE_IF(!channel)
+            ChannelPtr channel = *(mChannels.get(handle));
 
-              channel->cancel();
+            ZS_THROW_BAD_STATE_IF(!channel)
 
-              if (0 == channelNumber) {
-                // in this special case, everything must shutdown...
-                WORD errorCode = 0;
-                String errorReason;
-                channel->getState(&errorCode, &errorReason);
+            channel->cancel();
 
-                ZS_LOG_DEBUG(log("master relay channel is shutdown (so must now self destruct)") + ZS_PARAM("error code", errorCode) + ZS_PARAM("reason", errorReason))
+            if (0 == channelNumber) {
+              // in this special case, everything must shutdown...
+              WORD errorCode = 0;
+              String errorReason;
+              channel->getState(&errorCode, &errorReason);
 
-                setError(errorCode, errorReason);
-                cancel();
-                return false;
-              }
+              ZS_LOG_DEBUG(log("master relay channel is shutdown (so must now self destruct)") + ZS_PARAM("error code", errorCode) + ZS_PARAM("reason", errorReason))
 
-              mChannels.erase(found);
+              setError(errorCode, errorReason);
+              cancel();
+              return false;
             }
+
+            sendQueue = channel->mSendQueue;
+
+            mChannels.erase(handle);
           }
 
-          if (!foundInPendingMapRequest) {
+          if (foundInPendingMapRequest) {
+            // nothing was ever sent on an unmapped channel
+            mSendScheduler.discard(sendQueue);
+          } else {
             ZS_LOG_DEBUG(log("will notify channel is closed") + ZS_PARAM("channel", channelNumber))
 
-            // notify remote party of channel closure
-            ChannelHeaderPtr header(new ChannelHeader);
-            header->mChannelID = static_cast<decltype(header->mChannelID)>(channelNumber);
-
+            // notify remote party of channel closure (after anything still queued for the channel)
             SecureByteBlockPtr buffer(new SecureByteBlock);
 
             // by writing a buffer of "0" size to the channel number, it will cause the channel to close
-            mWireSendStream->write(buffer, header);
-
-            mLastSentData = zsLib::now();
+            mSendScheduler.enqueue(sendQueue, buffer);
           }
 
         }
 
-        mRemoveChannels.clear();
+        sendScheduled();
 
         ZS_LOG_TRACE(log("remove channels completed"))
 
@@ -1085,15 +1236,15 @@ namespace openpeer
           return true;
         }
 
-        ChannelMap::iterator found = mChannels.find(0);
-        if (found == mChannels.end()) {
+        ChannelPtr *found = mChannels.get(mChannels.find(0));
+        if (!found) {
           ZS_LOG_WARNING(Detail, log("could not find master channel thus must shutdown"))
           setError(IHTTP::HTTPStatusCode_NotFound, "could not find master channel");
           cancel();
           return false;
         }
 
-        const ChannelPtr &channel = (*found).second;
+        ChannelPtr channel = *found;
 
         WORD error = 0;
         String reason;
@@ -1118,62 +1269,77 @@ namespace openpeer
       //-----------------------------------------------------------------------
       bool FinderConnection::stepChannelMapRequest()
       {
-        if (mMapRequestChannelMonitor) {
-          ZS_LOG_TRACE(log("pending channel map request is already outstanding"))
-          return true;
-        }
-        if (mPendingMapRequest.size() < 1) {
+        if (mChannels.size(Channels::List_Pending) < 1) {
           ZS_LOG_TRACE(log("no pending channels needing to be notified"))
           return true;
         }
 
-        ChannelMap::iterator found = mPendingMapRequest.begin();
-        ZS_THROW_BAD_STATE_IF(found == mPendingMapRequest.end())
+        // NOTE: results are matched to requests by message ID so requests
+        //       are pipelined up to the in-flight limit rather than costing
+        //       one round trip per channel
+        while ((mChannels.size(Channels::List_Pending) > 0) &&
+               (mChannels.size(Channels::List_Mapping) < mMaxMapRequestsInFlight)) {
+
+          ChannelHandle handle = mChannels.front(Channels::List_Pending);
+          ZS_THROW_BAD_STATE_IF(handle.isEmpty())
+
+          ChannelNumber channelNumber = mChannels.channelNumber(handle);
+          ChannelPtr channel = *(mChannels.get(handle));
+
+          ZS_LOG_DEBUG(log("sending channel map request") + ZS_PARAM("channel", channelNumber) + ZS_PARAM("in flight", mChannels.size(Channels::List_Mapping)))
 
-        ChannelNumber channelNumber = (*found).first;
-        ChannelPtr channel = (*found).second;
+          const Channel::ConnectionInfo &info = channel->getConnectionInfo();
 
-        ZS_LOG_DEBUG(log("sending channel map request") + ZS_PARAM("channel", channelNumber))
+          ChannelMapRequestPtr request = ChannelMapRequest::create();
+          request->domain(info.mRelayDomain);
+          request->channelNumber(static_cast<ChannelMapRequest::ChannelNumber>(channelNumber));
+          request->localContextID(info.mLocalContextID);
+          request->remoteContextID(info.mRemoteContextID);
+          request->relayAccessToken(info.mRelayAccessToken);
+          request->relayAccessSecretProof(info.mRelayAccessSecretProof);
 
-        const Channel::ConnectionInfo &info = channel->getConnectionInfo();
+          SecureByteBlockPtr frame = request->encoded(Message::EncodedForm_JSON, mMessageWriter);
+          if (!frame) {
+            ZS_LOG_ERROR(Detail, log("failed to encode channel map request (thus cancelling channel)") + Message::toDebug(request))
 
-        ChannelMapRequestPtr request = ChannelMapRequest::create();
-        request->domain(info.mRelayDomain);
-        request->channelNumber(static_cast<ChannelMapRequest::ChannelNumber>(channelNumber));
-        request->localContextID(info.mLocalContextID);
-        request->remoteContextID(info.mRemoteContextID);
-        request->relayAccessToken(info.mRelayAccessToken);
-        request->relayAccessSecretProof(info.mRelayAccessSecretProof);
+            mChannels.unlink(handle, Channels::List_Pending);
 
-        mMapRequestChannelMonitor = IMessageMonitor::monitor(IMessageMonitorResultDelegate<ChannelMapResult>::convert(mThisWeak.lock()), request, Seconds(OPENPEER_STACK_CHANNEL_MAP_REQUEST_TIMEOUT_SECONDS));
-        get(mMapRequestChannelNumber) = channelNumber;
+            // scope: cancel channel (the slot is released by the clean removal step)
+            {
+              channel->setError(IHTTP::HTTPStatusCode_InternalServerError, "failed to encode channel map request");
+              channel->cancel();
+              mChannels.link(handle, Channels::List_Remove);
+            }
 
-        DocumentPtr doc = request->encode();
+            mWake.wake(mThisWeak.lock());
+            continue;
+          }
 
-        size_t outputLength = 0;
-        GeneratorPtr generator = Generator::createJSONGenerator();
-        boost::shared_array<char> output = generator->write(doc, &outputLength);
+          channel->mMapRequestMonitor = IMessageMonitor::monitor(IMessageMonitorResultDelegate<ChannelMapResult>::convert(mThisWeak.lock()), request, Seconds(OPENPEER_STACK_CHANNEL_MAP_REQUEST_TIMEOUT_SECONDS));
 
-        ChannelHeaderPtr header(new ChannelHeader);
-        header->mChannelID = 0;
+          mSendScheduler.enqueue(mControlQueue, frame);
 
-        mWireSendStream->write((const BYTE *) (output.get()), outputLength, header);
+          if (ZS_IS_LOGGING(Debug)) {
+            ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
+            ZS_LOG_DETAIL(log(") ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )"))
+            ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
+            ZS_LOG_DETAIL(log("MESSAGE INFO") + Message::toDebug(request))
+            ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
+            ZS_LOG_DETAIL(log("CHANNEL SEND MESSAGE") + ZS_PARAM("json out", String((const char *)(frame->BytePtr()), frame->SizeInBytes())))
+            ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
+            ZS_LOG_DETAIL(log(") ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )"))
+            ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
+          }
 
-        mLastSentData = zsLib::now();
+          mChannels.unlink(handle, Channels::List_Pending);
+          mChannels.link(handle, Channels::List_Mapping);
+        }
 
-        if (ZS_IS_LOGGING(Debug)) {
-          ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
-          ZS_LOG_DETAIL(log(") ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )"))
-          ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
-          ZS_LOG_DETAIL(log("MESSAGE INFO") + Message::toDebug(request))
-          ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
-          ZS_LOG_DETAIL(log("CHANNEL SEND MESSAGE") + ZS_PARAM("json out", ((CSTR)(output.get()))))
-          ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
-          ZS_LOG_DETAIL(log(") ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )"))
-          ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
+        if (mChannels.size(Channels::List_Pending) > 0) {
+          ZS_LOG_TRACE(log("channel map requests in flight at limit") + ZS_PARAM("in flight", mChannels.size(Channels::List_Mapping)) + ZS_PARAM("pending", mChannels.size(Channels::List_Pending)))
         }
 
-        mPendingMapRequest.erase(found);
+        sendScheduled();
 
         return true;
       }
@@ -1202,15 +1368,17 @@ namespace openpeer
 
           ZS_LOG_TRACE(log("received data") + ZS_PARAM("channel number", channelHeader->mChannelID) + ZS_PARAM("size", buffer->SizeInBytes()))
 
-          ChannelMap::iterator found = mChannels.find(channelHeader->mChannelID);
+          mTotalBytesReceived += buffer->SizeInBytes();
+
           ChannelPtr channel;
-          if (found != mChannels.end()) {
-            channel = (*found).second;
+          ChannelPtr *found = mChannels.get(static_cast<ChannelNumber>(channelHeader->mChannelID));
+          if (found) {
+            channel = *found;
           }
 
           if (buffer->SizeInBytes() < 1) {
             // special close request
-            if (found == mChannels.end()) {
+            if (!channel) {
               ZS_LOG_WARNING(Detail, log("channel closed but channel is not known"))
               continue;
             }
@@ -1219,32 +1387,48 @@ namespace openpeer
             continue;
           }
 
+          if ((0 == channelHeader->mChannelID) &&
+              (mFlowControl)) {
+            // window updates are consumed here rather than handed to the
+            // master channel (or dropped as unmonitored on relay connections)
+            MessageEnvelope envelope;
+            if ((MessageEnvelope::scan(buffer, envelope)) &&
+                (handleChannelWindowNotify(envelope))) {
+              continue;
+            }
+          }
+
           if (!channel) {
             if (isFinderRelayConnection()) {
               if (0 == channelHeader->mChannelID) {
                 
-                DocumentPtr document = Document::createFromAutoDetect((CSTR)(buffer->BytePtr()));
-                MessagePtr message = Message::create(document, mThisWeak.lock());
+                MessageEnvelope envelope;
+                if (!MessageEnvelope::scan(buffer, envelope)) {
+                  ZS_LOG_TRACE(log("channel message could not be scanned (thus decoding in full)"))
+                }
 
                 if (ZS_IS_LOGGING(Debug)) {
                   ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
                   ZS_LOG_DETAIL(log("( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ("))
                   ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
-                  ZS_LOG_DETAIL(log("MESSAGE INFO") + Message::toDebug(message))
+                  ZS_LOG_DETAIL(log("MESSAGE INFO") + envelope.toDebug())
                   ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
-                  ZS_LOG_DETAIL(log("CHANNEL MESSAGE") + ZS_PARAM("json in", ((CSTR)(buffer->BytePtr()))))
+                  ZS_LOG_DETAIL(log("CHANNEL MESSAGE") + ZS_PARAM("json in", envelope.logText()))
                   ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
                   ZS_LOG_DETAIL(log("( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ( ("))
                   ZS_LOG_DETAIL(log("-------------------------------------------------------------------------------------------"))
                 }
 
-                if (!message) {
-                  ZS_LOG_WARNING(Detail, log("failed to create a message object from incoming message"))
+                // NOTE: only monitored messages are of interest on channel 0 so
+                //       anything else is dropped without ever being decoded
+                MessagePtr message;
+                if (IMessageMonitor::handleMessageReceived(envelope, mThisWeak.lock(), message)) {
+                  ZS_LOG_DEBUG(log("handled message via message handler"))
                   continue;
                 }
 
-                if (IMessageMonitor::handleMessageReceived(message)) {
-                  ZS_LOG_DEBUG(log("handled message via message handler"))
+                if (!message) {
+                  ZS_LOG_WARNING(Detail, log("no monitor for incoming message (thus ignoring)") + envelope.toDebug())
                   continue;
                 }
 
@@ -1263,8 +1447,7 @@ namespace openpeer
             ITransportStreamPtr sendStream = ITransportStream::create();
             channel = Channel::incoming(mThisWeak.lock(), IFinderConnectionRelayChannelDelegatePtr(), receiveStream, sendStream, channelHeader->mChannelID);
 
-            mChannels[channelHeader->mChannelID] = channel;
-            mIncomingChannels[channelHeader->mChannelID] = channel;
+            mChannels.link(addChannel(static_cast<ChannelNumber>(channelHeader->mChannelID), channel), Channels::List_Incoming);
             mSubscriptions.delegate()->onFinderConnectionIncomingRelayChannel(mThisWeak.lock());
           }
 
@@ -1283,22 +1466,11 @@ namespace openpeer
           return true;
         }
 
-        if ((mPendingMapRequest.size() > 0) ||
-            (mMapRequestChannelMonitor)) {
+        if (mChannels.size(Channels::List_Mapping) > 0) {
           ZS_LOG_TRACE(log("has pending map request"))
           return true;
         }
 
-        if (mIncomingChannels.size() > 0) {
-          ZS_LOG_TRACE(log("has pending incoming channels"))
-          return true;
-        }
-
-        if (mRemoveChannels.size() > 0) {
-          ZS_LOG_TRACE(log("has pending remove channels"))
-          return true;
-        }
-
         ZS_LOG_DEBUG(log("no more activity detected on finder connection thus going to self destruct now"))
 
         cancel();
@@ -1328,14 +1500,124 @@ namespace openpeer
 
         ChannelPtr channel = Channel::connect(mThisWeak.lock(), delegate, localContextID, remoteContextID, relayDomain, relayAccessToken, relayAccessSecretProof, receiveStream, sendStream, channelNumber);
 
-        mChannels[channelNumber] = channel;
-        mPendingMapRequest[channelNumber] = channel;
+        mChannels.link(addChannel(channelNumber, channel), Channels::List_Pending);
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
 
         return channel;
       }
 
+      //-----------------------------------------------------------------------
+      FinderConnection::ChannelHandle FinderConnection::addChannel(
+                                                                   ChannelNumber channelNumber,
+                                                                   ChannelPtr channel
+                                                                   )
+      {
+        channel->mSlot = mChannels.insert(channelNumber, channel);
+
+        // control traffic on channel 0 shares the priority queue with pings
+        // and channel map requests
+        channel->mSendQueue = (0 == channelNumber ? mControlQueue : mSendScheduler.open(channelNumber));
+
+        return channel->mSlot;
+      }
+
+      //-----------------------------------------------------------------------
+      void FinderConnection::sendScheduled()
+      {
+        if (!mWireSendStream) return;
+        if (!mSendScheduler.hasData()) return;
+
+        // NOTE: data is only handed to the wire while the wire has less than
+        //       the low water mark still waiting to go out; anything beyond
+        //       that waits in the scheduler so later control traffic and
+        //       other channels are not stuck behind a bulk channel's data
+        size_t pending = 0;
+        if (0 != mSendLowWaterMark) {
+          pending = mWireSendStream->getStream()->getReader()->getTotalReadSizeAvailableInBytes();
+        }
+
+        while (mSendScheduler.hasData()) {
+          if ((0 != mSendLowWaterMark) &&
+              (pending >= mSendLowWaterMark)) {
+            ZS_LOG_TRACE(log("wire is busy, holding queued data until it drains") + ZS_PARAM("wire pending", pending) + ZS_PARAM("queued", mSendScheduler.totalQueuedBytes()))
+            return;
+          }
+
+          ChannelNumber channelNumber = 0;
+          SecureByteBlockPtr buffer = mSendScheduler.next(channelNumber);
+          if (!buffer) break;
+
+          ChannelHeaderPtr header(new ChannelHeader);
+          header->mChannelID = static_cast<decltype(header->mChannelID)>(channelNumber);
+
+          mWireSendStream->write(buffer, header);
+
+          pending += buffer->SizeInBytes();
+          mTotalBytesSent += buffer->SizeInBytes();
+          mLastSentData = zsLib::now();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      FinderConnection::ChannelHandle FinderConnection::findMapRequest(IMessageMonitorPtr monitor)
+      {
+        for (ChannelHandle handle = mChannels.front(Channels::List_Mapping); !handle.isEmpty(); handle = mChannels.next(handle, Channels::List_Mapping))
+        {
+          ChannelPtr channel = *(mChannels.get(handle));
+          if (channel->mMapRequestMonitor == monitor) return handle;
+        }
+        return ChannelHandle();
+      }
+
+      //-----------------------------------------------------------------------
+      void FinderConnection::sampleThroughput(Time tick)
+      {
+        Duration elapsed = tick - mThroughputSampledAt;
+        if (elapsed < Seconds(1)) return;
+
+        QWORD total = mTotalBytesSent + mTotalBytesReceived;
+        QWORD rate = ((total - mThroughputSampledBytes) * 1000) / static_cast<QWORD>(elapsed.total_milliseconds());
+
+        // smoothed so a single burst does not grow the finder's pool
+        mThroughput = (mThroughput + rate) / 2;
+
+        mThroughputSampledAt = tick;
+        mThroughputSampledBytes = total;
+
+        ZS_LOG_INSANE(log("throughput sampled") + ZS_PARAM("rate", rate) + ZS_PARAM("throughput", mThroughput))
+      }
+
+      //-----------------------------------------------------------------------
+      bool FinderConnection::handleChannelWindowNotify(const MessageEnvelope &envelope)
+      {
+        if (Message::MessageType_Notify != envelope.mType) return false;
+
+        MessageFactoryPeerFinderPtr factory = MessageFactoryPeerFinder::singleton();
+        if (!factory) return false;
+
+        if (envelope.mHandler != factory->getHandler()) return false;
+        if (envelope.mMethod != factory->toString((Message::Methods)MessageFactoryPeerFinder::Method_ChannelWindow)) return false;
+
+        ChannelWindowNotifyPtr notify = ChannelWindowNotify::convert(envelope.decode(mThisWeak.lock()));
+        if (!notify) {
+          ZS_LOG_WARNING(Detail, log("channel window notify could not be decoded (thus ignoring)") + envelope.toDebug())
+          return true;
+        }
+
+        ChannelPtr *found = mChannels.get(static_cast<ChannelNumber>(notify->channelNumber()));
+        if (!found) {
+          ZS_LOG_DEBUG(log("channel window notify for unknown channel (probably already closed)") + ZS_PARAM("channel number", notify->channelNumber()))
+          return true;
+        }
+
+        ZS_LOG_TRACE(log("received channel window") + ZS_PARAM("channel number", notify->channelNumber()) + ZS_PARAM("window", notify->window()))
+
+        ChannelPtr channel = *found;
+        channel->notifyWindow(notify->window());
+        return true;
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -1359,7 +1641,9 @@ namespace openpeer
         mCurrentState(SessionState_Pending),
         mOuterReceiveStream(receiveStream->getWriter()),
         mOuterSendStream(sendStream->getReader()),
-        mChannelNumber(channelNumber)
+        mChannelNumber(channelNumber),
+        mWindow(0 == channelNumber ? 0 : outer->mChannelWindow, 0 == channelNumber ? 0 : outer->mChannelMaxReceiveBuffered),
+        mFlowControl(0 == channelNumber ? false : outer->mFlowControl)
       {
         ZS_LOG_DEBUG(log("created"))
         if (delegate) {
@@ -1430,7 +1714,7 @@ namespace openpeer
         ZS_THROW_INVALID_ARGUMENT_IF(!receiveStream)
         ZS_THROW_INVALID_ARGUMENT_IF(!sendStream)
 
-        ChannelPtr pThis(new Channel(UseStack::queueStack(), outer, delegate, receiveStream, sendStream, channelNumber));
+        ChannelPtr pThis(new Channel(UseStack::queueStackFor(outer), outer, delegate, receiveStream, sendStream, channelNumber));
         pThis->mThisWeak = pThis;
         pThis->mConnectionInfo.mLocalContextID = String(localContextID);
         pThis->mConnectionInfo.mRemoteContextID = String(remoteContextID);
@@ -1453,7 +1737,7 @@ namespace openpeer
 
         FinderConnectionPtr connection = mOuter.lock();
         if (connection) {
-          connection->notifyDestroyed(mChannelNumber);
+          connection->notifyDestroyed(mSlot);
         }
 
         mDelegate.reset();
@@ -1569,7 +1853,7 @@ namespace openpeer
                                                                        ULONG channelNumber
                                                                        )
       {
-        ChannelPtr pThis(new Channel(UseStack::queueStack(), outer, delegate, receiveStream, sendStream, channelNumber));
+        ChannelPtr pThis(new Channel(UseStack::queueStackFor(outer), outer, delegate, receiveStream, sendStream, channelNumber));
         pThis->mThisWeak = pThis;
         pThis->init();
         return pThis;
@@ -1596,7 +1880,8 @@ namespace openpeer
       {
         ZS_LOG_TRACE(log("notified received wire write ready"))
         get(mWireStreamNotifiedReady) = true;
-        if (mOuterSendStream) {
+        if ((mOuterSendStream) &&
+            (!mSendHeld)) {
           mOuterSendStream->notifyReaderReadyToRead();
         }
         step();
@@ -1609,9 +1894,56 @@ namespace openpeer
           ZS_LOG_WARNING(Detail, log("cannot receive data as already shutdown"))
           return;
         }
+
+        size_t unread = mOuterReceiveStream->getStream()->getReader()->getTotalReadSizeAvailableInBytes();
+        if (!mWindow.notifyReceived(buffer->SizeInBytes(), unread)) {
+          // NOTE: the relay connection is shared thus it cannot stop reading
+          //       for one channel; a remote party that ignores (or never
+          //       receives) the window loses its channel instead
+          ZS_LOG_WARNING(Detail, log("receive buffering bound exceeded (thus closing channel)") + ZS_PARAM("unread", unread) + ZS_PARAM("size", buffer->SizeInBytes()) + ZS_PARAM("max", mWindow.maxReceiveBuffered()))
+          setError(IHTTP::HTTPStatusCode_RequestEntityTooLarge, "receive buffering bound exceeded");
+          cancel();
+          return;
+        }
+
+        if ((mFlowControl) &&
+            (mWindow.isBeyondAdvertisedWindow())) {
+          ZS_LOG_WARNING(Debug, log("remote party sent beyond the advertised window") + ZS_PARAM("received", mWindow.receivedBytes()) + ZS_PARAM("window", mWindow.advertisedWindow()))
+        }
+
         mOuterReceiveStream->write(buffer);
       }
 
+      //-----------------------------------------------------------------------
+      void FinderConnection::Channel::notifyWindow(QWORD window)
+      {
+        if (!mFlowControl) {
+          ZS_LOG_TRACE(log("flow control is disabled (thus ignoring window)"))
+          return;
+        }
+
+        if (!mWindow.notifyWindow(window)) {
+          ZS_LOG_TRACE(log("window is not beyond the current send limit (thus ignoring)") + ZS_PARAM("window", window) + ZS_PARAM("send limit", mWindow.sendLimit()))
+          return;
+        }
+
+        if (mSendHeld) {
+          ZS_LOG_TRACE(log("window opened, resuming send") + ZS_PARAM("sent", mWindow.sentBytes()) + ZS_PARAM("send limit", mWindow.sendLimit()))
+          step();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void FinderConnection::Channel::notifyFlowControlCheck()
+      {
+        if (isShutdown()) return;
+
+        if ((!mSendHeld) &&
+            (!mFlowControl)) return;
+
+        step();
+      }
+
       //-----------------------------------------------------------------------
       void FinderConnection::Channel::getStreams(
                                                  ITransportStreamPtr &outReceiveStream,
@@ -1657,12 +1989,17 @@ namespace openpeer
         IHelper::debugAppend(resultEl, "last error", mLastError);
         IHelper::debugAppend(resultEl, "last reason", mLastErrorReason);
         IHelper::debugAppend(resultEl, "channel number", mChannelNumber, false);
+        IHelper::debugAppend(resultEl, "send queue", ChannelSendScheduler::toDebug(mSendQueue));
+        IHelper::debugAppend(resultEl, "map request monitor", (bool)mMapRequestMonitor);
         IHelper::debugAppend(resultEl, "outer recv stream", ITransportStream::toDebug(mOuterReceiveStream->getStream()));
         IHelper::debugAppend(resultEl, "outer send stream", ITransportStream::toDebug(mOuterSendStream->getStream()));
         IHelper::debugAppend(resultEl, "outer receive stream subscription", (bool)mOuterReceiveStreamSubscription);
         IHelper::debugAppend(resultEl, "outer send stream subscription", (bool)mOuterSendStreamSubscription);
         IHelper::debugAppend(resultEl, "wire stream notified ready", mWireStreamNotifiedReady);
         IHelper::debugAppend(resultEl, "outer stream notified ready", mOuterStreamNotifiedReady);
+        IHelper::debugAppend(resultEl, "window", mWindow.toDebug());
+        IHelper::debugAppend(resultEl, "flow control", mFlowControl);
+        IHelper::debugAppend(resultEl, "send held", mSendHeld);
         IHelper::debugAppend(resultEl, "local context", mConnectionInfo.mLocalContextID);
         IHelper::debugAppend(resultEl, "remote context", mConnectionInfo.mRemoteContextID);
         IHelper::debugAppend(resultEl, "relay domain", mConnectionInfo.mRelayAccessToken);
@@ -1723,6 +2060,7 @@ namespace openpeer
         ZS_LOG_DEBUG(debug("step"))
 
         if (!stepSendData()) return;
+        if (!stepReceiveWindow()) return;
 
         setState(SessionState_Connected);
       }
@@ -1748,7 +2086,18 @@ namespace openpeer
           return false;
         }
 
+        bool wasHeld = mSendHeld;
+        get(mSendHeld) = false;
+
         while (mOuterSendStream->getTotalReadBuffersAvailable() > 0) {
+          if (!hasSendCredit()) {
+            // NOTE: whatever is not read stays in the outer send stream so
+            //       its writer stops being told it is ready to write
+            ZS_LOG_TRACE(log("send window exhausted, holding data") + ZS_PARAM("sent", mWindow.sentBytes()) + ZS_PARAM("send limit", mWindow.sendLimit()) + ZS_PARAM("queued", mSendQueue ? mSendQueue->mQueuedBytes : 0))
+            get(mSendHeld) = true;
+            return true;
+          }
+
           SecureByteBlockPtr buffer = mOuterSendStream->read();
           if (buffer->SizeInBytes() < 1) {
             ZS_LOG_WARNING(Detail, log("no data read"))
@@ -1756,13 +2105,52 @@ namespace openpeer
           }
 
           ZS_LOG_TRACE(log("buffer to send read") + ZS_PARAM("size", buffer->SizeInBytes()))
-          connection->sendBuffer(mChannelNumber, buffer);
+          mWindow.notifySent(buffer->SizeInBytes());
+          connection->sendBuffer(mSendQueue, buffer);
+        }
+
+        if (wasHeld) {
+          ZS_LOG_TRACE(log("send window reopened, notifying writer"))
+          mOuterSendStream->notifyReaderReadyToRead();
         }
 
         ZS_LOG_TRACE(log("buffer to send read complete"))
         return true;
       }
 
+      //-----------------------------------------------------------------------
+      bool FinderConnection::Channel::stepReceiveWindow()
+      {
+        if (!mFlowControl) {
+          ZS_LOG_INSANE(log("flow control is disabled"))
+          return true;
+        }
+
+        FinderConnectionPtr connection = mOuter.lock();
+        if (!connection) {
+          ZS_LOG_WARNING(Detail, log("connection is gone, cannot advertise window"))
+          return true;
+        }
+
+        size_t unread = mOuterReceiveStream->getStream()->getReader()->getTotalReadSizeAvailableInBytes();
+
+        QWORD window = 0;
+        if (!mWindow.needsWindowUpdate(unread, window)) {
+          ZS_LOG_INSANE(log("no window update needed") + ZS_PARAM("unread", unread) + ZS_PARAM("advertised window", mWindow.advertisedWindow()))
+          return true;
+        }
+
+        connection->sendWindow(mChannelNumber, window);
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool FinderConnection::Channel::hasSendCredit() const
+      {
+        if (!mFlowControl) return true;
+        return mWindow.hasSendCredit(mSendQueue ? mSendQueue->mQueuedBytes : 0);
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -233,7 +233,7 @@ namespace openpeer
         ZS_THROW_INVALID_ARGUMENT_IF(!localPublicKey)
         ZS_THROW_INVALID_ARGUMENT_IF(!remotePublicKey)
 
-        FinderRelayChannelPtr pThis(new FinderRelayChannel(UseStack::queueStack(), delegate, account, receiveStream, sendStream));
+        FinderRelayChannelPtr pThis(new FinderRelayChannel(UseStack::queueStackFor(account), delegate, account, receiveStream, sendStream));
         pThis->mThisWeak = pThis;
 
         pThis->mConnectInfo.mFinderIP = remoteFinderIP;
@@ -443,7 +443,7 @@ namespace openpeer
         ZS_THROW_INVALID_ARGUMENT_IF(!wireReceiveStream)
         ZS_THROW_INVALID_ARGUMENT_IF(!wireSendStream)
 
-        FinderRelayChannelPtr pThis(new FinderRelayChannel(UseStack::queueStack(), delegate, account, outerReceiveStream, outerSendStream));
+        FinderRelayChannelPtr pThis(new FinderRelayChannel(UseStack::queueStackFor(account), delegate, account, outerReceiveStream, outerSendStream));
         pThis->mThisWeak = pThis;
         pThis->mWireReceiveStream = wireReceiveStream;
         pThis->mWireSendStream = wireSendStream;
@@ -189,6 +189,45 @@ namespace openpeer
         return internal::getJavaScriptLogLevel();
       }
 
+      //-----------------------------------------------------------------------
+      size_t Helper::hashSeed()
+      {
+        if (sizeof(size_t) >= sizeof(QWORD)) {
+          return static_cast<size_t>((((QWORD)0xcbf29ce4U) << 32) | ((QWORD)0x84222325U));
+        }
+        return static_cast<size_t>(2166136261U);
+      }
+
+      //-----------------------------------------------------------------------
+      size_t Helper::hash(
+                          const BYTE *buffer,
+                          size_t length,
+                          size_t previous
+                          )
+      {
+        size_t prime = static_cast<size_t>(16777619U);
+        if (sizeof(size_t) >= sizeof(QWORD)) {
+          prime = static_cast<size_t>((((QWORD)0x100U) << 32) | ((QWORD)0x1b3U));
+        }
+
+        size_t result = previous;
+        for (size_t index = 0; index < length; ++index) {
+          result ^= static_cast<size_t>(buffer[index]);
+          result *= prime;
+        }
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t Helper::hash(
+                          const char *str,
+                          size_t previous
+                          )
+      {
+        if (!str) return previous;
+        return hash((const BYTE *)str, strlen(str), previous);
+      }
+
       //-----------------------------------------------------------------------
       Log::Params Helper::log(const char *message)
       {
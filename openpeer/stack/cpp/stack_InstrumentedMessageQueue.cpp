@@ -0,0 +1,365 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/internal/stack_InstrumentedMessageQueue.h>
+
+#include <openpeer/services/IHelper.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/Stringize.h>
+
+namespace openpeer { namespace stack { ZS_DECLARE_SUBSYSTEM(openpeer_stack) } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      using services::IHelper;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      // upper bound (inclusive) of each bucket, the last bucket is unbounded
+      static const ULONG gTimeBucketsInMilliseconds[InstrumentedMessageQueue::HistogramBuckets_Total] = {0, 1, 5, 10, 50, 100, 500, 1000, 5000, 0};
+      static const ULONG gDepthBuckets[InstrumentedMessageQueue::HistogramBuckets_Total] = {1, 2, 5, 10, 25, 50, 100, 500, 1000, 0};
+
+      //-----------------------------------------------------------------------
+      static ULONG toMilliseconds(const Duration &duration)
+      {
+        if (duration.is_negative()) return 0;
+        return static_cast<ULONG>(duration.total_milliseconds());
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark InstrumentedMessageQueueMessage
+      #pragma mark
+
+      class InstrumentedMessageQueueMessage : public IMessageQueueMessage
+      {
+      public:
+        //---------------------------------------------------------------------
+        InstrumentedMessageQueueMessage(
+                                        InstrumentedMessageQueuePtr queue,
+                                        IMessageQueueMessagePtr message
+                                        ) :
+          mQueue(queue),
+          mMessage(message),
+          mPosted(zsLib::now())
+        {
+        }
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark InstrumentedMessageQueueMessage => IMessageQueueMessage
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual const char *getDelegateName() const
+        {
+          return mMessage->getDelegateName();
+        }
+
+        //---------------------------------------------------------------------
+        virtual const char *getMethodName() const
+        {
+          return mMessage->getMethodName();
+        }
+
+        //---------------------------------------------------------------------
+        virtual void processMessage()
+        {
+          Time start = zsLib::now();
+          mQueue->notifyStarted(start - mPosted);
+
+          mMessage->processMessage();
+
+          mQueue->notifyCompleted(zsLib::now() - start);
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark InstrumentedMessageQueueMessage => (data)
+        #pragma mark
+
+        InstrumentedMessageQueuePtr mQueue;
+        IMessageQueueMessagePtr mMessage;
+        Time mPosted;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark InstrumentedMessageQueue::Histogram
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      InstrumentedMessageQueue::Histogram::Histogram() :
+        mCount(0),
+        mMax(0),
+        mSum(0)
+      {
+        for (int index = 0; index < HistogramBuckets_Total; ++index) {
+          mBuckets[index] = 0;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void InstrumentedMessageQueue::Histogram::record(ULONG value)
+      {
+        ++mCount;
+        mSum += static_cast<double>(value);
+        if (value > mMax) mMax = value;
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr InstrumentedMessageQueue::Histogram::toDebug(
+                                                              const char *name,
+                                                              const ULONG *upperBounds,
+                                                              const char *units
+                                                              ) const
+      {
+        ElementPtr resultEl = Element::create(name);
+
+        IHelper::debugAppend(resultEl, "count", mCount);
+        IHelper::debugAppend(resultEl, (String("max (") + units + ")").c_str(), mMax);
+        IHelper::debugAppend(resultEl, (String("average (") + units + ")").c_str(), 0 != mCount ? static_cast<ULONG>(mSum / static_cast<double>(mCount)) : 0);
+
+        ElementPtr bucketsEl = Element::create("buckets");
+
+        for (int index = 0; index < HistogramBuckets_Total; ++index) {
+          String bucketName;
+          if (index == HistogramBuckets_Total - 1) {
+            bucketName = String("> ") + string(upperBounds[index - 1]);
+          } else {
+            bucketName = String("<= ") + string(upperBounds[index]);
+          }
+          IHelper::debugAppend(bucketsEl, bucketName.c_str(), mBuckets[index]);
+        }
+
+        IHelper::debugAppend(resultEl, bucketsEl);
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark InstrumentedMessageQueue
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void recordInto(
+                             InstrumentedMessageQueue::Histogram &histogram,
+                             const ULONG *upperBounds,
+                             ULONG value
+                             )
+      {
+        histogram.record(value);
+
+        int index = 0;
+        for (; index < InstrumentedMessageQueue::HistogramBuckets_Total - 1; ++index) {
+          if (value <= upperBounds[index]) break;
+        }
+        ++(histogram.mBuckets[index]);
+      }
+
+      //-----------------------------------------------------------------------
+      InstrumentedMessageQueue::InstrumentedMessageQueue(
+                                                         IMessageQueuePtr queue,
+                                                         const char *name
+                                                         ) :
+        mQueue(queue),
+        mName(name),
+        mSince(zsLib::now()),
+        mDepth(0),
+        mTotalPosted(0),
+        mTotalProcessed(0)
+      {
+        ZS_LOG_DETAIL(log("created"))
+      }
+
+      //-----------------------------------------------------------------------
+      InstrumentedMessageQueue::~InstrumentedMessageQueue()
+      {
+        mThisWeak.reset();
+        ZS_LOG_DETAIL(log("destroyed"))
+      }
+
+      //-----------------------------------------------------------------------
+      InstrumentedMessageQueuePtr InstrumentedMessageQueue::create(
+                                                                   IMessageQueuePtr queue,
+                                                                   const char *name
+                                                                   )
+      {
+        ZS_THROW_INVALID_ARGUMENT_IF(!queue)
+
+        InstrumentedMessageQueuePtr pThis(new InstrumentedMessageQueue(queue, name));
+        pThis->mThisWeak = pThis;
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark InstrumentedMessageQueue => IMessageQueue
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void InstrumentedMessageQueue::post(IMessageQueueMessagePtr message)
+      {
+        {
+          AutoRecursiveLock lock(mLock);
+
+          ++mDepth;
+          ++mTotalPosted;
+          recordInto(mDepthOnPost, gDepthBuckets, mDepth);
+
+          const char *delegateName = message->getDelegateName();
+          const char *methodName = message->getMethodName();
+          ++(mMethodCounts[String(delegateName ? delegateName : "") + "::" + (methodName ? methodName : "")]);
+        }
+
+        mQueue->post(IMessageQueueMessagePtr(new InstrumentedMessageQueueMessage(mThisWeak.lock(), message)));
+      }
+
+      //-----------------------------------------------------------------------
+      IMessageQueue::size_type InstrumentedMessageQueue::getTotalUnprocessedMessages() const
+      {
+        return mQueue->getTotalUnprocessedMessages();
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark InstrumentedMessageQueue => friend Stack
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      ElementPtr InstrumentedMessageQueue::getStatistics(bool resetAfterSnapshot)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        ElementPtr resultEl = Element::create("queue");
+
+        IHelper::debugAppend(resultEl, "name", mName);
+        IHelper::debugAppend(resultEl, "since", mSince);
+        IHelper::debugAppend(resultEl, "depth", mDepth);
+        IHelper::debugAppend(resultEl, "unprocessed", static_cast<ULONG>(mQueue->getTotalUnprocessedMessages()));
+        IHelper::debugAppend(resultEl, "posted", mTotalPosted);
+        IHelper::debugAppend(resultEl, "processed", mTotalProcessed);
+
+        IHelper::debugAppend(resultEl, mDwell.toDebug("dwell", gTimeBucketsInMilliseconds, "ms"));
+        IHelper::debugAppend(resultEl, mExecution.toDebug("execution", gTimeBucketsInMilliseconds, "ms"));
+        IHelper::debugAppend(resultEl, mDepthOnPost.toDebug("depth on post", gDepthBuckets, "messages"));
+
+        ElementPtr methodsEl = Element::create("methods");
+        for (MethodCountMap::const_iterator iter = mMethodCounts.begin(); iter != mMethodCounts.end(); ++iter) {
+          IHelper::debugAppend(methodsEl, (*iter).first.c_str(), (*iter).second);
+        }
+        IHelper::debugAppend(resultEl, methodsEl);
+
+        if (resetAfterSnapshot) {
+          mSince = zsLib::now();
+          mTotalPosted = 0;
+          mTotalProcessed = 0;
+          mDwell = Histogram();
+          mExecution = Histogram();
+          mDepthOnPost = Histogram();
+          mMethodCounts.clear();
+        }
+
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark InstrumentedMessageQueue => friend InstrumentedMessageQueueMessage
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void InstrumentedMessageQueue::notifyStarted(Duration dwell)
+      {
+        AutoRecursiveLock lock(mLock);
+        if (mDepth > 0) --mDepth;
+        recordInto(mDwell, gTimeBucketsInMilliseconds, toMilliseconds(dwell));
+      }
+
+      //-----------------------------------------------------------------------
+      void InstrumentedMessageQueue::notifyCompleted(Duration execution)
+      {
+        AutoRecursiveLock lock(mLock);
+        ++mTotalProcessed;
+        recordInto(mExecution, gTimeBucketsInMilliseconds, toMilliseconds(execution));
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark InstrumentedMessageQueue => (internal)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      Log::Params InstrumentedMessageQueue::log(const char *message) const
+      {
+        ElementPtr objectEl = Element::create("stack::InstrumentedMessageQueue");
+        IHelper::debugAppend(objectEl, "id", mID);
+        IHelper::debugAppend(objectEl, "name", mName);
+        return Log::Params(message, objectEl);
+      }
+
+    }
+  }
+}
@@ -39,6 +39,7 @@
 #include <openpeer/services/IDHKeyDomain.h>
 
 #include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
 
 #include <zsLib/XML.h>
 
@@ -55,6 +56,185 @@ namespace openpeer
 
       using services::IHelper;
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RSAKeyPairReservoir
+      #pragma mark
+
+      // NOTE: keeps a small number of default sized RSA key pairs generated
+      //       ahead of time (on the key generation queue) so an account
+      //       logging in does not have to wait for a key pair to generate.
+      class RSAKeyPairReservoir : public MessageQueueAssociator,
+                                  public IWakeDelegate
+      {
+      public:
+        typedef std::pair<IRSAPrivateKeyPtr, IRSAPublicKeyPtr> RSAKeyPair;
+        typedef std::list<RSAKeyPair> RSAKeyPairList;
+
+      protected:
+        //---------------------------------------------------------------------
+        RSAKeyPairReservoir(IMessageQueuePtr queue) :
+          MessageQueueAssociator(queue)
+        {
+          ZS_LOG_DEBUG(log("created"))
+        }
+
+        //---------------------------------------------------------------------
+        static RSAKeyPairReservoirPtr create()
+        {
+          RSAKeyPairReservoirPtr pThis(new RSAKeyPairReservoir(UseStack::queueKeyGeneration()));
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+      public:
+        //---------------------------------------------------------------------
+        ~RSAKeyPairReservoir()
+        {
+          mThisWeak.reset();
+          ZS_LOG_DEBUG(log("destroyed"))
+        }
+
+        //---------------------------------------------------------------------
+        static RSAKeyPairReservoirPtr singleton()
+        {
+          static SingletonLazySharedPtr<RSAKeyPairReservoir> singleton(create());
+          RSAKeyPairReservoirPtr result = singleton.singleton();
+          if (!result) {
+            ZS_LOG_WARNING(Detail, slog("singleton gone"))
+          }
+          return result;
+        }
+
+        //---------------------------------------------------------------------
+        bool take(
+                  size_t keySizeInBits,
+                  IRSAPrivateKeyPtr &outPrivateKey,
+                  IRSAPublicKeyPtr &outPublicKey
+                  )
+        {
+          AutoRecursiveLock lock(mLock);
+
+          bool found = false;
+
+          if ((OPENPEER_SERVICES_RSA_PRIVATE_KEY_GENERATION_SIZE == keySizeInBits) &&
+              (mKeyPairs.size() > 0)) {
+            outPrivateKey = mKeyPairs.front().first;
+            outPublicKey = mKeyPairs.front().second;
+            mKeyPairs.pop_front();
+            found = true;
+            ZS_LOG_DEBUG(log("key pair taken from reservoir") + ZS_PARAM("remaining", mKeyPairs.size()))
+          }
+
+          // refill off the hot path
+          fill();
+          return found;
+        }
+
+        //---------------------------------------------------------------------
+        void fill()
+        {
+          AutoRecursiveLock lock(mLock);
+
+          if (mFilling) return;
+          if (mKeyPairs.size() >= getTargetDepth()) return;
+
+          ZS_LOG_DEBUG(log("filling reservoir") + ZS_PARAM("depth", mKeyPairs.size()) + ZS_PARAM("target", getTargetDepth()))
+
+          get(mFilling) = true;
+          IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RSAKeyPairReservoir => IWakeDelegate
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual void onWake()
+        {
+          // generate one key pair per wake so other jobs on this key
+          // generation worker are not held up behind the whole refill
+          Time startTime = zsLib::now();
+
+          IRSAPublicKeyPtr publicKey;
+          IRSAPrivateKeyPtr privateKey = IRSAPrivateKey::generate(publicKey);
+
+          AutoRecursiveLock lock(mLock);
+          get(mFilling) = false;
+
+          if (!privateKey) {
+            ZS_LOG_ERROR(Detail, log("failed to generate rsa key pair for reservoir"))
+            return;
+          }
+
+          mKeyPairs.push_back(RSAKeyPair(privateKey, publicKey));
+
+          ZS_LOG_DEBUG(log("key pair added to reservoir") + ZS_PARAM("depth", mKeyPairs.size()) + ZS_PARAM("compute (ms)", (zsLib::now() - startTime).total_milliseconds()))
+
+          fill();
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RSAKeyPairReservoir => (internal)
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        Log::Params log(const char *message) const
+        {
+          ElementPtr objectEl = Element::create("stack::RSAKeyPairReservoir");
+          IHelper::debugAppend(objectEl, "id", mID);
+          return Log::Params(message, objectEl);
+        }
+
+        //---------------------------------------------------------------------
+        static Log::Params slog(const char *message)
+        {
+          return Log::Params(message, "stack::RSAKeyPairReservoir");
+        }
+
+        //---------------------------------------------------------------------
+        static size_t getTargetDepth()
+        {
+          return services::ISettings::getUInt(OPENPEER_STACK_SETTING_KEY_GENERATOR_RSA_RESERVOIR_DEPTH);
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RSAKeyPairReservoir => (data)
+        #pragma mark
+
+        AutoPUID mID;
+        mutable RecursiveLock mLock;
+        RSAKeyPairReservoirWeakPtr mThisWeak;
+
+        AutoBool mFilling;
+        RSAKeyPairList mKeyPairs;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark IKeyGeneratorForStack
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void IKeyGeneratorForStack::fillReservoir()
+      {
+        RSAKeyPairReservoirPtr reservoir = RSAKeyPairReservoir::singleton();
+        if (!reservoir) return;
+        reservoir->fill();
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -80,9 +260,17 @@ namespace openpeer
       //-----------------------------------------------------------------------
       void KeyGenerator::init()
       {
+        if (mCompleted) {
+          ZS_LOG_DEBUG(debug("key generator completed immediately"))
+          mSubscriptions.delegate()->onKeyGenerated(mThisWeak.lock());
+          mSubscriptions.clear();
+          return;
+        }
+
         if (mDependencyKeyGenerator) {
           mDependencySubscription = mDependencyKeyGenerator->subscribe(mThisWeak.lock());
         }
+        mQueuedAt = zsLib::now();
         IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
       }
 
@@ -128,11 +316,20 @@ namespace openpeer
         ZS_THROW_INVALID_ARGUMENT_IF(!password)
         ZS_THROW_INVALID_ARGUMENT_IF(!signedSaltEl)
 
-        KeyGeneratorPtr pThis(new KeyGenerator(UseStack::queueKeyGeneration(), delegate));
+        KeyGeneratorPtr pThis(new KeyGenerator(UseStack::queueKeyGenerationWorker(), delegate));
         pThis->mThisWeak = pThis;
         pThis->mPassword = String(password);
         pThis->mSignedSaltEl = signedSaltEl;
         pThis->mDependencyKeyGenerator = rsaKeyGenerator;
+
+        if (!rsaKeyGenerator) {
+          RSAKeyPairReservoirPtr reservoir = RSAKeyPairReservoir::singleton();
+          if (reservoir) {
+            // peer files still need to be signed but the RSA key pair does not need generating
+            reservoir->take(OPENPEER_SERVICES_RSA_PRIVATE_KEY_GENERATION_SIZE, pThis->mRSAPrivateKey, pThis->mRSAPublicKey);
+          }
+        }
+
         pThis->init();
 
         return pThis;
@@ -147,9 +344,17 @@ namespace openpeer
         ZS_THROW_INVALID_ARGUMENT_IF(!delegate)
         ZS_THROW_INVALID_ARGUMENT_IF(keySizeInBits < 1)
 
-        KeyGeneratorPtr pThis(new KeyGenerator(UseStack::queueKeyGeneration(), delegate));
+        KeyGeneratorPtr pThis(new KeyGenerator(UseStack::queueKeyGenerationWorker(), delegate));
         pThis->mThisWeak = pThis;
-        pThis->mRSAKeyLength = keySizeInBits;
+
+        RSAKeyPairReservoirPtr reservoir = RSAKeyPairReservoir::singleton();
+        if ((reservoir) &&
+            (reservoir->take(keySizeInBits, pThis->mRSAPrivateKey, pThis->mRSAPublicKey))) {
+          get(pThis->mCompleted) = true;
+        } else {
+          pThis->mRSAKeyLength = keySizeInBits;
+        }
+
         pThis->init();
 
         return pThis;
@@ -164,7 +369,7 @@ namespace openpeer
         ZS_THROW_INVALID_ARGUMENT_IF(!delegate)
         ZS_THROW_INVALID_ARGUMENT_IF(keySizeInBits < 1)
 
-        KeyGeneratorPtr pThis(new KeyGenerator(UseStack::queueKeyGeneration(), delegate));
+        KeyGeneratorPtr pThis(new KeyGenerator(UseStack::queueKeyGenerationWorker(), delegate));
         pThis->mThisWeak = pThis;
         pThis->mDHKeyDomainKeyLength = keySizeInBits;
         pThis->init();
@@ -300,6 +505,17 @@ namespace openpeer
             mDependencyKeyGenerator->getRSAKey(rsaPrivateKey, rsaPublicKey);
           }
 
+          if ((!rsaPrivateKey) &&
+              (mRSAPrivateKey)) {
+            // key pair was taken from the reservoir
+            rsaPrivateKey = mRSAPrivateKey;
+            rsaPublicKey = mRSAPublicKey;
+          }
+
+          if (Time() != mQueuedAt) {
+            mQueueWaitDuration = startTime - mQueuedAt;
+          }
+
           ZS_LOG_DEBUG(debug("key generator started") + ZS_PARAM("started at", startTime))
 
           signedSaltEl = mSignedSaltEl;
@@ -365,13 +581,13 @@ namespace openpeer
             mDHKeyDomainKeyLength = 0;
           }
 
+          mComputeDuration = zsLib::now() - startTime;
+
           mSubscriptions.delegate()->onKeyGenerated(mThisWeak.lock());
           mSubscriptions.clear();
         }
 
-        Duration calculationDuration = zsLib::now() - startTime;
-
-        ZS_LOG_DEBUG(debug("key generator complete") + ZS_PARAM("duration (s)", calculationDuration))
+        ZS_LOG_DEBUG(debug("key generator complete") + ZS_PARAM("queue wait (ms)", mQueueWaitDuration.total_milliseconds()) + ZS_PARAM("compute (ms)", mComputeDuration.total_milliseconds()))
       }
 
       //-----------------------------------------------------------------------
@@ -388,6 +604,7 @@ namespace openpeer
         ZS_LOG_DEBUG(log("on key generator") + ZS_PARAM("generator id", generator->getID()))
 
         AutoRecursiveLock lock(mLock);
+        mQueuedAt = zsLib::now();
         IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
       }
 
@@ -440,6 +657,10 @@ namespace openpeer
         IHelper::debugAppend(resultEl, "dh key domain key length", mDHKeyDomainKeyLength);
         IHelper::debugAppend(resultEl, "dh key domain", (bool)mDHKeyDomain);
 
+        IHelper::debugAppend(resultEl, "queued at", mQueuedAt);
+        IHelper::debugAppend(resultEl, "queue wait (ms)", mQueueWaitDuration.total_milliseconds());
+        IHelper::debugAppend(resultEl, "compute (ms)", mComputeDuration.total_milliseconds());
+
         return resultEl;
       }
 
@@ -34,9 +34,11 @@
 #include <openpeer/stack/internal/stack_Stack.h>
 #include <openpeer/stack/internal/stack_Helper.h>
 #include <openpeer/stack/internal/stack_Location.h>
+#include <openpeer/stack/internal/stack_TimerWheel.h>
 
 #include <openpeer/stack/IBootstrappedNetwork.h>
 #include <openpeer/stack/message/Message.h>
+#include <openpeer/stack/message/MessageEnvelope.h>
 
 #include <openpeer/services/IHelper.h>
 
@@ -55,6 +57,7 @@ namespace openpeer
     namespace internal
     {
       typedef IStackForInternal UseStack;
+      typedef ITimerWheelForInternal UseTimerWheel;
       
       using services::IHelper;
 
@@ -90,7 +93,7 @@ namespace openpeer
                                      IMessageQueuePtr queue
                                      ) :
         MessageQueueAssociator(queue),
-        SharedRecursiveLock(manager ? *manager : SharedRecursiveLock::create()),
+        SharedRecursiveLock(SharedRecursiveLock::create()),
         mManager(manager),
         mWasHandled(false),
         mTimeoutFired(false),
@@ -107,7 +110,7 @@ namespace openpeer
 
         if (Duration() != timeout) {
           mExpires = zsLib::now() + timeout;
-          mTimer = Timer::create(mThisWeak.lock(), timeout, false);
+          mTimer = UseTimerWheel::arm(mThisWeak.lock(), timeout);
         }
 
         UseMessageMonitorManagerPtr manager = mManager.lock();
@@ -165,7 +168,7 @@ namespace openpeer
 
         MessageMonitorPtr pThis(new MessageMonitor(
                                                    MessageMonitorManager::convert(UseMessageMonitorManager::singleton()),
-                                                   UseStack::queueStack()
+                                                   UseStack::queueStackFor(delegate)
                                                    ));
         pThis->mThisWeak = pThis;
         pThis->mMessageID = requestMessage->messageID();
@@ -239,6 +242,34 @@ namespace openpeer
         return manager->handleMessage(message);
       }
 
+      //-----------------------------------------------------------------------
+      bool MessageMonitor::handleMessageReceived(
+                                                 const message::MessageEnvelope &envelope,
+                                                 IMessageSourcePtr messageSource,
+                                                 message::MessagePtr &outMessage
+                                                 )
+      {
+        outMessage = message::MessagePtr();
+
+        UseMessageMonitorManagerPtr manager = UseMessageMonitorManager::singleton();
+
+        if ((envelope.hasData()) &&
+            (envelope.mID.hasData())) {
+          if (!manager) return false;
+
+          if (!manager->isMonitoring(envelope.mID)) {
+            ZS_LOG_TRACE(slog("no monitor watching message (not decoding)") + envelope.toDebug())
+            return false;
+          }
+        }
+
+        outMessage = envelope.decode(messageSource);
+        if (!outMessage) return false;
+
+        if (!manager) return false;
+        return manager->handleMessage(outMessage);
+      }
+
       //-----------------------------------------------------------------------
       bool MessageMonitor::isComplete() const
       {
@@ -383,15 +414,20 @@ namespace openpeer
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       #pragma mark
-      #pragma mark MessageMonitor => ITimerDelegate
+      #pragma mark MessageMonitor => ITimerWheelDelegate
       #pragma mark
 
       //-----------------------------------------------------------------------
-      void MessageMonitor::onTimer(TimerPtr timer)
+      void MessageMonitor::onTimerWheelExpired(TimerWheelEntryPtr entry)
       {
         AutoRecursiveLock lock(*this);
         if (!mDelegate) return;
 
+        if (entry != mTimer) {
+          ZS_LOG_WARNING(Trace, log("ignoring obsolete timeout (probably okay)") + ZS_PARAM("entry", entry->getID()))
+          return;
+        }
+
         mTimeoutFired = true;
         if (0 != mPendingHandled) return;
 
@@ -464,7 +500,7 @@ namespace openpeer
         MessageResultPtr result = MessageResult::create(mOriginalMessage, code);
         if (result) {
           // create a fake error result since the send failed
-          IMessageMonitorAsyncDelegateProxy::create(UseStack::queueStack(), mThisWeak.lock())->onAutoHandleFailureResult(result);
+          IMessageMonitorAsyncDelegateProxy::create(mThisWeak.lock())->onAutoHandleFailureResult(result);
           return;
         }
 
@@ -536,5 +572,15 @@ namespace openpeer
     {
       return internal::MessageMonitor::handleMessageReceived(message);
     }
+
+    //-------------------------------------------------------------------------
+    bool IMessageMonitor::handleMessageReceived(
+                                                const message::MessageEnvelope &envelope,
+                                                IMessageSourcePtr messageSource,
+                                                message::MessagePtr &outMessage
+                                                )
+    {
+      return internal::MessageMonitor::handleMessageReceived(envelope, messageSource, outMessage);
+    }
   }
 }
@@ -153,7 +153,13 @@ namespace openpeer
         mThisWeak.reset();
 
         ZS_LOG_DETAIL(log("destoyed"))
-        mMonitors.clear();
+        for (size_t index = 0; index < Sizes_Shards; ++index) {
+          Shard &shard = mShards[index];
+          AutoRecursiveLock shardLock(shard.mLock);
+          shard.mMonitors.clear();
+          shard.mMonitorsBySentVia.clear();
+          shard.mSentViaByMonitor.clear();
+        }
 
         if (mTimer) {
           mTimer->cancel();
@@ -191,34 +197,25 @@ namespace openpeer
       {
         UseMessageMonitorPtr monitor = inMonitor;
 
-        AutoRecursiveLock lock(mLock);
-
         PUID monitorID = monitor->getID();
         String requestID = monitor->getMonitoredMessageID();
+        MessageIDHash requestIDHash = MessageMonitorTable::hash(requestID);
 
-        SentViaObjectID objectID = 0;
+        Shard &shard = shardFor(requestIDHash);
+        AutoRecursiveLock lock(shard.mLock);
 
-        SentViaObjectMap::iterator foundSentVia = mSentViaObjectIDs.find(requestID);
-        if (foundSentVia != mSentViaObjectIDs.end()) {
-          objectID = (*foundSentVia).second;
-        }
+        MessageMonitorTable::Entry *entry = shard.mMonitors.insert(requestID, requestIDHash);
 
-        ZS_LOG_TRACE(log("monitoring request ID") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("request id", requestID) + ZS_PARAM("sent via object id", objectID))
+        SentViaObjectID objectID = entry->mSentViaObjectID;
 
-        MonitorsMap::iterator found = mMonitors.find(requestID);
-        if (found != mMonitors.end()) {
-          ZS_LOG_TRACE(log("already found a monitor for the request ID") + ZS_PARAM("request id", requestID))
+        ZS_LOG_TRACE(log("monitoring request ID") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("request id", requestID) + ZS_PARAM("sent via object id", objectID) + ZS_PARAM("existing monitors", entry->totalMonitors()))
 
-          MonitorMapPtr monitors = (*found).second;
+        entry->addMonitor(monitorID, monitor);
 
-          (*monitors)[monitorID] = monitor;
-          return objectID;
+        if (0 != objectID) {
+          indexSentVia(shard, objectID, monitorID, monitor);
         }
 
-        MonitorMapPtr monitors(new MonitorMap);
-        (*monitors)[monitorID] = monitor;
-
-        mMonitors[requestID] = monitors;
         return objectID;
       }
 
@@ -227,65 +224,63 @@ namespace openpeer
       {
         UseMessageMonitor &monitor = inMonitor;
 
-        AutoRecursiveLock lock(mLock);
-
         PUID monitorID = monitor.getID();
         String requestID = monitor.getMonitoredMessageID();
+        MessageIDHash requestIDHash = MessageMonitorTable::hash(requestID);
+
+        Shard &shard = shardFor(requestIDHash);
+        AutoRecursiveLock lock(shard.mLock);
 
         ZS_LOG_TRACE(log("remove monitoring of request ID") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("message id", requestID))
 
-        MonitorsMap::iterator found = mMonitors.find(requestID);
-        if (found == mMonitors.end()) {
-          ZS_LOG_TRACE(log("already removed all monitors for this message id"))
-          return;
-        }
+        removeMonitor(shard, requestID, requestIDHash, monitorID);
+      }
 
-        MonitorMapPtr monitors = (*found).second;
-        MonitorMap::iterator foundMonitor = monitors->find(monitorID);
+      //-----------------------------------------------------------------------
+      bool MessageMonitorManager::isMonitoring(const String &messageID)
+      {
+        if (messageID.isEmpty()) return false;
 
-        if (foundMonitor == monitors->end()) {
-          ZS_LOG_TRACE(log("already removed monitor for this message"))
-          return;
-        }
+        MessageIDHash messageIDHash = MessageMonitorTable::hash(messageID);
 
-        monitors->erase(foundMonitor);
+        Shard &shard = shardFor(messageIDHash);
+        AutoRecursiveLock lock(shard.mLock);
 
-        if (monitors->size() > 0) {
-          ZS_LOG_TRACE(log("still more monitors active - continue to monitor request ID") + ZS_PARAM("size", monitors->size()))
-          return;
-        }
+        MessageMonitorTable::Entry *entry = shard.mMonitors.find(messageID, messageIDHash);
+        if (!entry) return false;
 
-        ZS_LOG_TRACE(log("no more monitors active (stop monitoring this message id)"))
-        mMonitors.erase(found);
+        return entry->hasMonitors();
       }
 
       //-----------------------------------------------------------------------
       bool MessageMonitorManager::handleMessage(message::MessagePtr message)
       {
-        AutoRecursiveLock lock(mLock);
-
         String id = message->messageID();
-        MonitorsMap::iterator found = mMonitors.find(id);
-        if (found == mMonitors.end()) {
+        MessageIDHash idHash = MessageMonitorTable::hash(id);
+
+        Shard &shard = shardFor(idHash);
+
+        MonitorList monitors;
+
+        {
+          AutoRecursiveLock lock(shard.mLock);
+          collectMonitors(shard, id, idHash, monitors);
+        }
+
+        if (monitors.size() < 1) {
           ZS_LOG_TRACE(log("no monitors watching this message") + ZS_PARAM("message id", id))
           return false;
         }
 
-        MonitorMapPtr monitors = (*found).second;
-
         bool handled = false;
 
-        for (MonitorMap::iterator iter = monitors->begin(); iter != monitors->end(); )
+        // NOTE: monitors are called outside of the manager lock since each
+        //       monitor is protected by the lock of the stack queue shard
+        //       it belongs to
+        for (MonitorList::iterator iter = monitors.begin(); iter != monitors.end(); ++iter)
         {
-          MonitorMap::iterator current = iter; ++iter;
-
-          MonitorID monitorID = (*current).first;
-          UseMessageMonitorPtr monitor = (*current).second.lock();
-          if (!monitor) {
-            ZS_LOG_WARNING(Debug, log("monitor is gone") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("message id", id))
-            monitors->erase(current);
-            continue;
-          }
+          UseMessageMonitorPtr monitor = (*iter);
+          MonitorID monitorID = monitor->getID();
 
           bool monitorDidHandle = monitor->handleMessage(message);
           handled = handled || monitorDidHandle;
@@ -296,14 +291,11 @@ namespace openpeer
           }
 
           ZS_LOG_TRACE(log("monitor handled request") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("message id", id))
-          monitors->erase(current);
-        }
 
-        if (monitors->size() < 1) {
-          ZS_LOG_TRACE(log("all monitors have completed monitoring this message") + ZS_PARAM("message id", id))
-          mMonitors.erase(found);
+          AutoRecursiveLock lock(shard.mLock);
+          removeMonitor(shard, id, idHash, monitorID);
         }
-        
+
         return handled;
       }
 
@@ -317,18 +309,33 @@ namespace openpeer
 
         if (0 == sentViaObjectID) return;
 
-        AutoRecursiveLock lock(*this);
-
         String messageID = message->messageID();
-
-        mSentViaObjectIDs[messageID] = sentViaObjectID;
+        MessageIDHash messageIDHash = MessageMonitorTable::hash(messageID);
 
         Time expires = zsLib::now() + Seconds(OPENPEER_STACK_DEFAULT_MESSAGE_MONITOR_TRACK_MESSAGE_ID_TO_OBJECT_ID_TIME_IN_SECONDS);
 
-        mExpiredSentViaObjectIDs.push_back(MessageExpiryPair(messageID, expires));
+        // scope: track within the message's shard
+        {
+          Shard &shard = shardFor(messageIDHash);
+          AutoRecursiveLock lock(shard.mLock);
+
+          MessageMonitorTable::Entry *entry = shard.mMonitors.insert(messageID, messageIDHash);
+          entry->mSentViaObjectID = sentViaObjectID;
+
+          MonitorPairList monitors;
+          entry->getMonitors(monitors);
+
+          for (MonitorPairList::iterator iter = monitors.begin(); iter != monitors.end(); ++iter) {
+            indexSentVia(shard, sentViaObjectID, (*iter).first, (*iter).second);
+          }
+
+          shard.mExpiredSentViaObjectIDs.push_back(MessageExpiryPair(messageID, expires));
+        }
 
         ZS_LOG_TRACE(log("tracking mapping of message ID to object ID (for future monitoring of same message ID)") + ZS_PARAM("message id", messageID) + ZS_PARAM("sent via sender id", sentViaObjectID) + ZS_PARAM("until", expires))
 
+        AutoRecursiveLock lock(mLock);
+
         if (mTimer) return;
 
         mTimer = Timer::create(mThisWeak.lock(), Seconds(30));
@@ -347,11 +354,11 @@ namespace openpeer
       {
         ZS_LOG_WARNING(Detail, log("notify message send failure") + ZS_PARAM("message", message->messageID()))
 
-        AutoRecursiveLock lock(*this);
+        AutoRecursiveLock lock(mLock);
 
         mPendingFailures.push_back(message);
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
       }
 
       //-----------------------------------------------------------------------
@@ -359,11 +366,11 @@ namespace openpeer
       {
         ZS_LOG_DEBUG(log("notify sender object gone") + ZS_PARAM("sender object id", objectID))
 
-        AutoRecursiveLock lock(*this);
+        AutoRecursiveLock lock(mLock);
 
         mPendingGone.push_back(objectID);
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        mWake.wake(mThisWeak.lock());
       }
 
       //-----------------------------------------------------------------------
@@ -378,73 +385,75 @@ namespace openpeer
       void MessageMonitorManager::onWake()
       {
         ZS_LOG_TRACE(log("on wake"))
+        mWake.woken();
+
+        PendingMessageSendFailureMessageList pendingFailures;
+        PendingSenderObjectGoneList pendingGone;
 
-        AutoRecursiveLock lock(*this);
+        {
+          AutoRecursiveLock lock(mLock);
+          pendingFailures.swap(mPendingFailures);
+          pendingGone.swap(mPendingGone);
+        }
 
         // scope: handle message send failures
         {
-          for (PendingMessageSendFailureMessageList::iterator iterPending = mPendingFailures.begin(); iterPending != mPendingFailures.end(); ++iterPending)
+          for (PendingMessageSendFailureMessageList::iterator iterPending = pendingFailures.begin(); iterPending != pendingFailures.end(); ++iterPending)
           {
             MessagePtr message = (*iterPending);
 
             String id = message->messageID();
-            MonitorsMap::iterator found = mMonitors.find(id);
-            if (found == mMonitors.end()) {
-              ZS_LOG_TRACE(log("no monitors watching this message") + ZS_PARAM("message id", id))
-              continue;
-            }
 
-            MonitorMapPtr monitors = (*found).second;
+            MessageIDHash idHash = MessageMonitorTable::hash(id);
+            Shard &shard = shardFor(idHash);
+
+            MonitorList monitors;
 
-            for (MonitorMap::iterator iter = monitors->begin(); iter != monitors->end(); )
             {
-              MonitorMap::iterator current = iter; ++iter;
+              AutoRecursiveLock lock(shard.mLock);
+              collectMonitors(shard, id, idHash, monitors);
+            }
 
-              MonitorID monitorID = (*current).first;
-              UseMessageMonitorPtr monitor = (*current).second.lock();
-              if (!monitor) {
-                ZS_LOG_WARNING(Debug, log("monitor is already gone") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("message id", id))
-                monitors->erase(current);
-                continue;
-              }
+            if (monitors.size() < 1) {
+              ZS_LOG_TRACE(log("no monitors watching this message") + ZS_PARAM("message id", id))
+              continue;
+            }
 
+            for (MonitorList::iterator iter = monitors.begin(); iter != monitors.end(); ++iter)
+            {
+              UseMessageMonitorPtr monitor = (*iter);
               monitor->notifySendMessageFailure(message);
             }
           }
-          ZS_LOG_TRACE(log("clearing out pending failures") + ZS_PARAM("size", mPendingFailures.size()))
-          mPendingFailures.clear();
+          ZS_LOG_TRACE(log("cleared out pending failures") + ZS_PARAM("size", pendingFailures.size()))
         }
 
         // scope: handle sender object gone
         {
-          for (PendingSenderObjectGoneList::iterator iterPending = mPendingGone.begin(); iterPending != mPendingGone.end(); ++iterPending)
+          if (pendingGone.size() < 1) return;
+
+          for (PendingSenderObjectGoneList::iterator iterPending = pendingGone.begin(); iterPending != pendingGone.end(); ++iterPending)
           {
             SentViaObjectID id = (*iterPending);
 
-            for (MonitorsMap::iterator iterMonitors = mMonitors.begin(); iterMonitors != mMonitors.end(); )
-            {
-              MonitorsMap::iterator currentMonitors = iterMonitors; ++iterMonitors;
-
-              MonitorMapPtr monitors = (*currentMonitors).second;
+            MonitorList monitors;
 
-              for (MonitorMap::iterator iter = monitors->begin(); iter != monitors->end(); )
-              {
-                MonitorMap::iterator current = iter; ++iter;
+            // NOTE: monitors sent via this object may be in any shard
+            for (size_t index = 0; index < Sizes_Shards; ++index) {
+              Shard &shard = mShards[index];
+              AutoRecursiveLock lock(shard.mLock);
+              collectSentViaMonitors(shard, id, monitors);
+            }
 
-                MonitorID monitorID = (*current).first;
-                UseMessageMonitorPtr monitor = (*current).second.lock();
-                if (!monitor) {
-                  ZS_LOG_WARNING(Debug, log("monitor is already gone") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("gone object id", id))
-                  monitors->erase(current);
-                  continue;
-                }
+            ZS_LOG_TRACE(log("notifying monitors of sender object gone") + ZS_PARAM("sender object id", id) + ZS_PARAM("monitors", monitors.size()))
 
-                monitor->notifySenderObjectGone(id);
-              }
+            for (MonitorList::iterator iter = monitors.begin(); iter != monitors.end(); ++iter)
+            {
+              UseMessageMonitorPtr monitor = (*iter);
+              monitor->notifySenderObjectGone(id);
             }
           }
-          ZS_LOG_TRACE(log("clearing out pending sender object gone notifications") + ZS_PARAM("size", mPendingGone.size()))
-          mPendingGone.clear();
+          ZS_LOG_TRACE(log("cleared out pending sender object gone notifications") + ZS_PARAM("size", pendingGone.size()))
         }
       }
 
@@ -461,37 +470,60 @@ namespace openpeer
       {
         ZS_LOG_TRACE(log("on timer"))
 
-        AutoRecursiveLock lock(*this);
-
         Time tick = zsLib::now();
 
-        while (mExpiredSentViaObjectIDs.size() > 0)
+        bool pending = false;
+
+        for (size_t index = 0; index < Sizes_Shards; ++index)
         {
-          MessageExpiryPair &info = mExpiredSentViaObjectIDs.front();
+          Shard &shard = mShards[index];
+          AutoRecursiveLock lock(shard.mLock);
 
-          if (tick < info.second) {
-            ZS_LOG_TRACE(log("message has not expired yet (thus stop processing more)") + ZS_PARAM("expires", info.second) + ZS_PARAM("now", tick))
-            return;
-          }
+          while (shard.mExpiredSentViaObjectIDs.size() > 0)
+          {
+            MessageExpiryPair &info = shard.mExpiredSentViaObjectIDs.front();
 
-          const String &mesageID = info.first;
+            if (tick < info.second) {
+              ZS_LOG_TRACE(log("message has not expired yet (thus stop processing more)") + ZS_PARAM("shard", index) + ZS_PARAM("expires", info.second) + ZS_PARAM("now", tick))
+              pending = true;
+              break;
+            }
 
-          SentViaObjectMap::iterator found = mSentViaObjectIDs.find(mesageID);
-          if (found != mSentViaObjectIDs.end()) {
-            SentViaObjectID objectID = (*found).second;
-            ZS_LOG_DEBUG(log("message ID to sent via object ID mapping is no longer tracking") + ZS_PARAM("message ID", mesageID) + ZS_PARAM("object ID", objectID))
-            mSentViaObjectIDs.erase(found);
-          } else {
-            ZS_LOG_WARNING(Detail, log("message ID to sent via object ID mapping was already removed (sent to multiple senders?)") + ZS_PARAM("message ID", mesageID))
-          }
+            const String &mesageID = info.first;
+
+            MessageMonitorTable::Entry *entry = shard.mMonitors.find(mesageID);
+            if ((entry) &&
+                (0 != entry->mSentViaObjectID)) {
+              ZS_LOG_DEBUG(log("message ID to sent via object ID mapping is no longer tracking") + ZS_PARAM("message ID", mesageID) + ZS_PARAM("object ID", entry->mSentViaObjectID))
+              entry->mSentViaObjectID = 0;
+              shard.mMonitors.eraseIfUnused(entry);
+            } else {
+              ZS_LOG_WARNING(Detail, log("message ID to sent via object ID mapping was already removed (sent to multiple senders?)") + ZS_PARAM("message ID", mesageID))
+            }
 
-          mExpiredSentViaObjectIDs.pop_front();
+            shard.mExpiredSentViaObjectIDs.pop_front();
+          }
         }
 
+        if (pending) return;
+
+        AutoRecursiveLock lock(mLock);
+
         if (mTimer) {
           mTimer->cancel();
           mTimer.reset();
         }
+
+        // a message may have been tracked after its shard was checked above
+        for (size_t index = 0; index < Sizes_Shards; ++index)
+        {
+          Shard &shard = mShards[index];
+          AutoRecursiveLock shardLock(shard.mLock);
+          if (shard.mExpiredSentViaObjectIDs.size() < 1) continue;
+
+          mTimer = Timer::create(mThisWeak.lock(), Seconds(30));
+          break;
+        }
       }
 
       //-----------------------------------------------------------------------
@@ -515,6 +547,154 @@ namespace openpeer
       {
         return Log::Params(message, "stack::MessageMonitorManager");
       }
+
+      //-----------------------------------------------------------------------
+      MessageMonitorManager::Shard &MessageMonitorManager::shardFor(MessageIDHash messageIDHash)
+      {
+        // the table's slots come from the low bits so the shard is picked
+        // from the high bits to keep each shard's table evenly spread
+        return mShards[(messageIDHash >> ((sizeof(MessageIDHash) * 8) - Sizes_ShardBits)) & (Sizes_Shards - 1)];
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorManager::collectMonitors(
+                                                  Shard &shard,
+                                                  const MessageID &messageID,
+                                                  MessageIDHash messageIDHash,
+                                                  MonitorList &outMonitors
+                                                  )
+      {
+        MessageMonitorTable::Entry *entry = shard.mMonitors.find(messageID, messageIDHash);
+        if (!entry) return;
+
+        MonitorPairList monitors;
+        entry->getMonitors(monitors);
+
+        for (MonitorPairList::iterator iter = monitors.begin(); iter != monitors.end(); ++iter)
+        {
+          MonitorID monitorID = (*iter).first;
+          UseMessageMonitorPtr monitor = (*iter).second.lock();
+          if (!monitor) {
+            ZS_LOG_WARNING(Debug, log("monitor is gone") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("message id", messageID))
+            entry->removeMonitor(monitorID);
+            unindexSentVia(shard, monitorID);
+            continue;
+          }
+
+          outMonitors.push_back(monitor);
+        }
+
+        if (!entry->hasMonitors()) {
+          ZS_LOG_TRACE(log("all monitors have completed monitoring this message") + ZS_PARAM("message id", messageID))
+          shard.mMonitors.eraseIfUnused(entry);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorManager::removeMonitor(
+                                                Shard &shard,
+                                                const MessageID &messageID,
+                                                MessageIDHash messageIDHash,
+                                                MonitorID monitorID
+                                                )
+      {
+        MessageMonitorTable::Entry *entry = shard.mMonitors.find(messageID, messageIDHash);
+        if (!entry) {
+          ZS_LOG_TRACE(log("already removed all monitors for this message id"))
+          return;
+        }
+
+        if (!entry->removeMonitor(monitorID)) {
+          ZS_LOG_TRACE(log("already removed monitor for this message"))
+          return;
+        }
+
+        unindexSentVia(shard, monitorID);
+
+        if (entry->hasMonitors()) {
+          ZS_LOG_TRACE(log("still more monitors active - continue to monitor request ID") + ZS_PARAM("size", entry->totalMonitors()))
+          return;
+        }
+
+        ZS_LOG_TRACE(log("no more monitors active (stop monitoring this message id)"))
+        shard.mMonitors.eraseIfUnused(entry);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorManager::indexSentVia(
+                                               Shard &shard,
+                                               SentViaObjectID sentViaObjectID,
+                                               MonitorID monitorID,
+                                               UseMessageMonitorWeakPtr monitor
+                                               )
+      {
+        MonitorSentViaMap::iterator found = shard.mSentViaByMonitor.find(monitorID);
+        if (found != shard.mSentViaByMonitor.end()) {
+          if (sentViaObjectID == (*found).second) return;
+
+          // NOTE: the message was re-sent via another object, the monitor only
+          //       cares about the most recent sender object
+          unindexSentVia(shard, monitorID);
+        }
+
+        ZS_LOG_TRACE(log("indexing monitor by sent via object") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("sent via object id", sentViaObjectID))
+
+        shard.mSentViaByMonitor[monitorID] = sentViaObjectID;
+        shard.mMonitorsBySentVia[sentViaObjectID][monitorID] = monitor;
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorManager::unindexSentVia(
+                                                 Shard &shard,
+                                                 MonitorID monitorID
+                                                 )
+      {
+        MonitorSentViaMap::iterator found = shard.mSentViaByMonitor.find(monitorID);
+        if (found == shard.mSentViaByMonitor.end()) return;
+
+        SentViaObjectID sentViaObjectID = (*found).second;
+        shard.mSentViaByMonitor.erase(found);
+
+        SentViaMonitorsMap::iterator foundSentVia = shard.mMonitorsBySentVia.find(sentViaObjectID);
+        if (foundSentVia == shard.mMonitorsBySentVia.end()) return;
+
+        MonitorMap &monitors = (*foundSentVia).second;
+        monitors.erase(monitorID);
+
+        if (monitors.size() > 0) return;
+
+        shard.mMonitorsBySentVia.erase(foundSentVia);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorManager::collectSentViaMonitors(
+                                                         Shard &shard,
+                                                         SentViaObjectID sentViaObjectID,
+                                                         MonitorList &outMonitors
+                                                         )
+      {
+        SentViaMonitorsMap::iterator found = shard.mMonitorsBySentVia.find(sentViaObjectID);
+        if (found == shard.mMonitorsBySentVia.end()) return;
+
+        MonitorMap &monitors = (*found).second;
+
+        for (MonitorMap::iterator iter = monitors.begin(); iter != monitors.end(); ++iter)
+        {
+          MonitorID monitorID = (*iter).first;
+          shard.mSentViaByMonitor.erase(monitorID);
+
+          UseMessageMonitorPtr monitor = (*iter).second.lock();
+          if (!monitor) {
+            ZS_LOG_WARNING(Debug, log("monitor is gone") + ZS_PARAM("monitor id", monitorID) + ZS_PARAM("sender object id", sentViaObjectID))
+            continue;
+          }
+
+          outMonitors.push_back(monitor);
+        }
+
+        // NOTE: the sender object is gone so nothing can be sent via it again
+        shard.mMonitorsBySentVia.erase(found);
+      }
     }
   }
 }
@@ -0,0 +1,351 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/internal/stack_MessageMonitorTable.h>
+#include <openpeer/stack/internal/stack_Helper.h>
+
+#include <openpeer/services/IHelper.h>
+
+#include <zsLib/XML.h>
+
+namespace openpeer { namespace stack { ZS_DECLARE_SUBSYSTEM(openpeer_stack) } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      using services::IHelper;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageMonitorTable::Entry
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      MessageMonitorTable::Entry::Entry() :
+        mHash(0),
+        mMonitorID(0),
+        mSentViaObjectID(0)
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorTable::Entry::addMonitor(
+                                                  MonitorID monitorID,
+                                                  UseMessageMonitorWeakPtr monitor
+                                                  )
+      {
+        if (mOverflow) {
+          (*mOverflow)[monitorID] = monitor;
+          return;
+        }
+
+        if ((0 == mMonitorID) ||
+            (monitorID == mMonitorID)) {
+          mMonitorID = monitorID;
+          mMonitor = monitor;
+          return;
+        }
+
+        // second monitor for the same message ID, move to the overflow map
+        mOverflow = MonitorMapPtr(new MonitorMap);
+        (*mOverflow)[mMonitorID] = mMonitor;
+        (*mOverflow)[monitorID] = monitor;
+
+        mMonitorID = 0;
+        mMonitor.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageMonitorTable::Entry::removeMonitor(MonitorID monitorID)
+      {
+        if (!mOverflow) {
+          if ((0 == monitorID) ||
+              (monitorID != mMonitorID)) return false;
+
+          mMonitorID = 0;
+          mMonitor.reset();
+          return true;
+        }
+
+        MonitorMap::iterator found = mOverflow->find(monitorID);
+        if (found == mOverflow->end()) return false;
+
+        mOverflow->erase(found);
+
+        if (mOverflow->size() > 1) return true;
+
+        // back to the single monitor case
+        if (mOverflow->size() > 0) {
+          MonitorMap::iterator remaining = mOverflow->begin();
+          mMonitorID = (*remaining).first;
+          mMonitor = (*remaining).second;
+        }
+        mOverflow.reset();
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageMonitorTable::Entry::hasMonitors() const
+      {
+        if (mOverflow) return mOverflow->size() > 0;
+        return 0 != mMonitorID;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t MessageMonitorTable::Entry::totalMonitors() const
+      {
+        if (mOverflow) return mOverflow->size();
+        return (0 != mMonitorID ? 1 : 0);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorTable::Entry::getMonitors(MonitorPairList &outMonitors) const
+      {
+        if (!mOverflow) {
+          if (0 == mMonitorID) return;
+          outMonitors.push_back(MonitorPair(mMonitorID, mMonitor));
+          return;
+        }
+
+        for (MonitorMap::const_iterator iter = mOverflow->begin(); iter != mOverflow->end(); ++iter)
+        {
+          outMonitors.push_back(MonitorPair((*iter).first, (*iter).second));
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageMonitorTable::Entry::isUnused() const
+      {
+        return (!hasMonitors()) && (0 == mSentViaObjectID);
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageMonitorTable
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      MessageMonitorTable::MessageMonitorTable(size_t initialCapacity) :
+        mMask(0),
+        mUsed(0),
+        mErased(0),
+        mMinCapacity(8),
+        mTotalRehashes(0)
+      {
+        while (mMinCapacity < initialCapacity) {
+          mMinCapacity <<= 1;
+        }
+
+        mSlots.resize(mMinCapacity);
+        mMask = mMinCapacity - 1;
+      }
+
+      //-----------------------------------------------------------------------
+      MessageMonitorTable::~MessageMonitorTable()
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      MessageMonitorTable::Hash MessageMonitorTable::hash(const MessageID &messageID)
+      {
+        return Helper::hash(messageID.c_str());
+      }
+
+      //-----------------------------------------------------------------------
+      MessageMonitorTable::Entry *MessageMonitorTable::find(
+                                                            const MessageID &messageID,
+                                                            Hash messageIDHash
+                                                            )
+      {
+        size_t index = findSlot(messageID, messageIDHash);
+        if (SlotState_Used != mSlots[index].mState) return NULL;
+        return &(mSlots[index].mEntry);
+      }
+
+      //-----------------------------------------------------------------------
+      MessageMonitorTable::Entry *MessageMonitorTable::insert(
+                                                              const MessageID &messageID,
+                                                              Hash messageIDHash
+                                                              )
+      {
+        size_t index = findSlot(messageID, messageIDHash);
+        if (SlotState_Used == mSlots[index].mState) return &(mSlots[index].mEntry);
+
+        // keep the load (including erased markers) at or below 3/4
+        if (((mUsed + mErased + 1) * 4) > (mSlots.size() * 3)) {
+          size_t capacity = mSlots.size();
+          if (((mUsed + 1) * 2) > capacity) {
+            capacity <<= 1;
+          }
+          rehash(capacity);
+          index = findSlot(messageID, messageIDHash);
+        }
+
+        Slot &slot = mSlots[index];
+        if (SlotState_Erased == slot.mState) {
+          --mErased;
+        }
+
+        slot.mState = SlotState_Used;
+        slot.mEntry = Entry();
+        slot.mEntry.mHash = messageIDHash;
+        slot.mEntry.mMessageID = messageID;
+
+        ++mUsed;
+        return &(slot.mEntry);
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageMonitorTable::eraseIfUnused(Entry *entry)
+      {
+        if (!entry) return false;
+        if (!entry->isUnused()) return false;
+
+        size_t index = findSlot(entry->mMessageID, entry->mHash);
+        Slot *slot = &(mSlots[index]);
+        ZS_THROW_BAD_STATE_IF(SlotState_Used != slot->mState)
+        ZS_THROW_BAD_STATE_IF(entry != &(slot->mEntry))
+
+        slot->mState = SlotState_Erased;
+        slot->mEntry = Entry();
+
+        --mUsed;
+        ++mErased;
+
+        if ((mUsed * 8 < mSlots.size()) &&
+            (mSlots.size() > mMinCapacity)) {
+          // shrink back after a burst of outstanding requests
+          rehash(mSlots.size() >> 1);
+        }
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorTable::clear()
+      {
+        SlotVector empty(mMinCapacity);
+        mSlots.swap(empty);
+        mMask = mMinCapacity - 1;
+        mUsed = 0;
+        mErased = 0;
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr MessageMonitorTable::toDebug() const
+      {
+        ElementPtr resultEl = Element::create("stack::MessageMonitorTable");
+
+        IHelper::debugAppend(resultEl, "size", mUsed);
+        IHelper::debugAppend(resultEl, "erased", mErased);
+        IHelper::debugAppend(resultEl, "capacity", mSlots.size());
+        IHelper::debugAppend(resultEl, "rehashes", mTotalRehashes);
+
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageMonitorTable => (internal)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      size_t MessageMonitorTable::findSlot(
+                                           const MessageID &messageID,
+                                           Hash messageIDHash
+                                           ) const
+      {
+        // NOTE: returns the matching used slot or else the first free slot
+        //       found while probing (erased slots are reused for inserts)
+        size_t firstErased = mSlots.size();
+        size_t index = messageIDHash & mMask;
+
+        while (true) {
+          const Slot &slot = mSlots[index];
+
+          switch (slot.mState) {
+            case SlotState_Empty:   return (firstErased != mSlots.size() ? firstErased : index);
+            case SlotState_Erased:  {
+              if (firstErased == mSlots.size()) firstErased = index;
+              break;
+            }
+            case SlotState_Used:    {
+              if ((messageIDHash == slot.mEntry.mHash) &&
+                  (messageID == slot.mEntry.mMessageID)) return index;
+              break;
+            }
+          }
+
+          index = (index + 1) & mMask;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageMonitorTable::rehash(size_t capacity)
+      {
+        ++mTotalRehashes;
+
+        SlotVector oldSlots(capacity);
+        mSlots.swap(oldSlots);
+        mMask = capacity - 1;
+        mErased = 0;
+
+        for (SlotVector::iterator iter = oldSlots.begin(); iter != oldSlots.end(); ++iter)
+        {
+          Slot &oldSlot = (*iter);
+          if (SlotState_Used != oldSlot.mState) continue;
+
+          size_t index = oldSlot.mEntry.mHash & mMask;
+          while (SlotState_Empty != mSlots[index].mState) {
+            index = (index + 1) & mMask;
+          }
+
+          mSlots[index].mState = SlotState_Used;
+          mSlots[index].mEntry = oldSlot.mEntry;
+        }
+      }
+
+    }
+  }
+}
@@ -66,6 +66,7 @@ namespace openpeer
       ZS_DECLARE_USING_PTR(services, ISettings)
 
       ZS_DECLARE_TYPEDEF_PTR(IStackForInternal, UseStack)
+      ZS_DECLARE_TYPEDEF_PTR(ITimerWheelForInternal, UseTimerWheel)
       
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -1172,16 +1173,16 @@ namespace openpeer
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       #pragma mark
-      #pragma mark Publication::CacheableDocument => ITimerDelegate
+      #pragma mark Publication::CacheableDocument => ITimerWheelDelegate
       #pragma mark
 
       //-----------------------------------------------------------------------
-      void Publication::CacheableDocument::onTimer(TimerPtr timer)
+      void Publication::CacheableDocument::onTimerWheelExpired(TimerWheelEntryPtr entry)
       {
         AutoRecursiveLock lock(*this);
 
-        if (timer != mMoveToCacheTimer) {
-          ZS_LOG_WARNING(Trace, log("ignoring obsolete move to cache timer (probably okay)") + ZS_PARAM("timer", timer->getID()))
+        if (entry != mMoveToCacheTimer) {
+          ZS_LOG_WARNING(Trace, log("ignoring obsolete move to cache timer (probably okay)") + ZS_PARAM("timer", entry->getID()))
           return;
         }
         moveToCacheNow();
@@ -1209,7 +1210,7 @@ namespace openpeer
 
         if (!mMoveToCacheTimer) {
           ZS_LOG_TRACE(log("creating timer to move to cache"))
-          mMoveToCacheTimer = Timer::create(mThisWeak.lock(), mMoveToCacheDuration, false);
+          mMoveToCacheTimer = UseTimerWheel::arm(mThisWeak.lock(), mMoveToCacheDuration);
         }
       }
 
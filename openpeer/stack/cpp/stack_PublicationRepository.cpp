@@ -191,7 +191,7 @@ namespace openpeer
       //-----------------------------------------------------------------------
       PublicationRepositoryPtr PublicationRepository::create(AccountPtr account)
       {
-        PublicationRepositoryPtr pThis(new PublicationRepository(UseStack::queueStack(), account));
+        PublicationRepositoryPtr pThis(new PublicationRepository(UseStack::queueStackFor(account), account));
         pThis->mThisWeak = pThis;
         pThis->init();
         return pThis;
@@ -89,6 +89,7 @@ namespace openpeer
     namespace internal
     {
       typedef stack::internal::IStackForInternal UseStack;
+      typedef stack::internal::ITimerWheelForInternal UseTimerWheel;
 
       typedef IServiceIdentitySessionForServiceLockbox::ForLockboxPtr ForLockboxPtr;
 
@@ -879,7 +880,10 @@ namespace openpeer
           mGrantWait.reset();
         }
 
-        mTimer.reset();
+        if (mTimer) {
+          mTimer->cancel();
+          mTimer.reset();
+        }
 
         setState(SessionState_Shutdown);
       }
@@ -1082,11 +1086,16 @@ namespace openpeer
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
-      void ServiceIdentitySession::onTimer(TimerPtr timer)
+      void ServiceIdentitySession::onTimerWheelExpired(TimerWheelEntryPtr entry)
       {
         ZS_LOG_DEBUG(log("on timer fired"))
         AutoRecursiveLock lock(getLock());
 
+        if (entry != mTimer) {
+          ZS_LOG_WARNING(Trace, log("ignoring obsolete timer (probably okay)") + ZS_PARAM("timer", entry->getID()))
+          return;
+        }
+
         mTimer.reset();
 
         step();
@@ -2493,7 +2502,7 @@ namespace openpeer
           if (waitTime < Seconds(1)) {
             waitTime = Seconds(1);
           }
-          mTimer = Timer::create(mThisWeak.lock(), waitTime, false);
+          mTimer = UseTimerWheel::arm(mThisWeak.lock(), waitTime);
 
           ZS_LOG_TRACE(log("delaying downloading contacts") + ZS_PARAM("wait time (s)", waitTime))
           return true;
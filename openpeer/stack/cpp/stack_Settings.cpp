@@ -32,6 +32,11 @@
 #include <openpeer/stack/internal/stack_Settings.h>
 #include <openpeer/stack/internal/stack.h>
 
+#include <openpeer/stack/message/internal/stack_message_MessageFactoryManager.h>
+#include <openpeer/stack/message/MessageBinary.h>
+#include <openpeer/stack/message/MessageCompression.h>
+#include <openpeer/stack/message/MessageBatch.h>
+
 #include <openpeer/services/IHelper.h>
 #include <openpeer/services/ISettings.h>
 
@@ -144,19 +149,43 @@ namespace openpeer
 
         setString(OPENPEER_STACK_SETTING_STACK_STACK_THREAD_PRIORITY, "normal");
         setString(OPENPEER_STACK_SETTING_STACK_KEY_GENERATION_THREAD_PRIORITY, "low");
+        setUInt(OPENPEER_STACK_SETTING_STACK_TOTAL_STACK_THREADS, 1);
+        setUInt(OPENPEER_STACK_SETTING_STACK_TOTAL_KEY_GENERATION_THREADS, 1);
+        setBool(OPENPEER_STACK_SETTING_STACK_QUEUE_STATISTICS_ENABLED, false);
+
+        setString(OPENPEER_STACK_SETTING_MESSAGE_CREATION_ELEMENT_MODE, "keep");
+        setBool(OPENPEER_STACK_SETTING_MESSAGE_BINARY_ENCODING_ENABLED, false);
+        setBool(OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_ENABLED, false);
+        setUInt(OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES, 1024);
+        setBool(OPENPEER_STACK_SETTING_MESSAGE_BATCHING_ENABLED, false);
+        setUInt(OPENPEER_STACK_SETTING_MESSAGE_BATCHING_WINDOW_IN_MILLISECONDS, 0);
+        setUInt(OPENPEER_STACK_SETTING_MESSAGE_BATCHING_MAX_SIZE_IN_BYTES, 16*1024);
 
         setBool(OPENPEER_STACK_SETTING_BOOTSTRAPPER_SERVICE_FORCE_WELL_KNOWN_OVER_INSECURE_HTTP, false);
         setBool(OPENPEER_STACK_SETTING_BOOTSTRAPPER_SERVICE_FORCE_WELL_KNOWN_USING_POST, false);
 
         setBool(OPENPEER_STACK_SETTING_ACCOUNT_SHUTDOWN_ON_ICE_SOCKET_FAILURE, false);
         setBool(OPENPEER_STACK_SETTING_ACCOUNT_PEER_LOCATION_DEBUG_FORCE_MESSAGES_OVER_RELAY, false);
+        setUInt(OPENPEER_STACK_SETTING_ACCOUNT_EPHEMERAL_DH_KEY_POOL_DEPTH, 4);
 
         setUInt(OPENPEER_STACK_SETTING_BACKGROUNDING_ACCOUNT_PHASE, 1);
 
         setUInt(OPENPEER_STACK_SETTING_FINDER_MAX_CLIENT_SESSION_KEEP_ALIVE_IN_SECONDS, 0);
         setUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_MUST_SEND_PING_IF_NO_SEND_ACTIVITY_IN_SECONDS, 25);
+        setUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_SEND_QUANTUM_IN_BYTES, 4*1024);
+        setUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_SEND_LOW_WATER_MARK_IN_BYTES, 16*1024);
+        setUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_WINDOW_IN_BYTES, 256*1024);
+        setBool(OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_FLOW_CONTROL, false);
+        setUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_MAX_RECEIVE_BUFFERED_IN_BYTES, 4*1024*1024);
+        setUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_POOL_MAX_CONNECTIONS, 1);
+        setUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_POOL_GROW_AT_BYTES_PER_SECOND, 512*1024);
+        setUInt(OPENPEER_STACK_SETTING_FINDER_CONNECTION_MAX_CHANNEL_MAP_REQUESTS_IN_FLIGHT, 16);
 
         setUInt(OPENPEER_STACK_SETTING_PUBLICATION_MOVE_DOCUMENT_TO_CACHE_TIME, 120);
+
+        setUInt(OPENPEER_STACK_SETTING_KEY_GENERATOR_RSA_RESERVOIR_DEPTH, 0);
+
+        setUInt(OPENPEER_STACK_SETTING_TIMER_WHEEL_RESOLUTION_IN_MILLISECONDS, 100);
       }
 
       //-----------------------------------------------------------------------
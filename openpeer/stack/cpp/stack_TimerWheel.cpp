@@ -0,0 +1,537 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/internal/stack_TimerWheel.h>
+#include <openpeer/stack/internal/stack_Stack.h>
+
+#include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
+
+#include <zsLib/XML.h>
+
+namespace openpeer { namespace stack { ZS_DECLARE_SUBSYSTEM(openpeer_stack) } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      using services::IHelper;
+      using zsLib::QWORD;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ITimerWheelForInternal
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      TimerWheelEntryPtr ITimerWheelForInternal::arm(
+                                                     ITimerWheelDelegatePtr delegate,
+                                                     Duration timeout
+                                                     )
+      {
+        TimerWheelPtr wheel = TimerWheel::singleton(UseStack::queueStackFor(delegate));
+        if (!wheel) return TimerWheelEntryPtr();
+        return wheel->arm(delegate, timeout);
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TimerWheelEntry
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      TimerWheelEntry::TimerWheelEntry(
+                                       TimerWheelPtr wheel,
+                                       ITimerWheelDelegatePtr delegate,
+                                       Time expires
+                                       ) :
+        mWheel(wheel),
+        mDelegate(delegate),
+        mExpires(expires),
+        mExpiresTick(0),
+        mSlot(NULL)
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      TimerWheelEntry::~TimerWheelEntry()
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      void TimerWheelEntry::cancel()
+      {
+        TimerWheelPtr wheel = mWheel.lock();
+        if (!wheel) return;
+        wheel->cancel(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TimerWheel
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      TimerWheel::TimerWheel(IMessageQueuePtr queue) :
+        MessageQueueAssociator(queue),
+        mResolution(zsLib::Milliseconds(services::ISettings::getUInt(OPENPEER_STACK_SETTING_TIMER_WHEEL_RESOLUTION_IN_MILLISECONDS))),
+        mStartTime(zsLib::now()),
+        mCurrentTick(0),
+        mTotalArmed(0),
+        mTotalFired(0),
+        mTimerTick(0)
+      {
+        if (mResolution.total_milliseconds() < 1) {
+          mResolution = zsLib::Milliseconds(1);
+        }
+        ZS_LOG_DETAIL(log("created") + ZS_PARAM("resolution (ms)", mResolution.total_milliseconds()))
+      }
+
+      //-----------------------------------------------------------------------
+      void TimerWheel::init()
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      TimerWheel::~TimerWheel()
+      {
+        mThisWeak.reset();
+        ZS_LOG_DETAIL(log("destroyed"))
+
+        if (mTimer) {
+          mTimer->cancel();
+          mTimer.reset();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      TimerWheelPtr TimerWheel::create()
+      {
+        TimerWheelPtr pThis = create(UseStack::queueStackShard(0));
+
+        ULONG total = UseStack::totalStackShards();
+        for (ULONG index = 1; index < total; ++index) {
+          pThis->mShards.push_back(create(UseStack::queueStackShard(index)));
+        }
+
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      TimerWheelPtr TimerWheel::create(IMessageQueuePtr queue)
+      {
+        TimerWheelPtr pThis(new TimerWheel(queue));
+        pThis->mThisWeak = pThis;
+        pThis->init();
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      TimerWheelPtr TimerWheel::singleton()
+      {
+        static SingletonLazySharedPtr<TimerWheel> singleton(create());
+        TimerWheelPtr result = singleton.singleton();
+        if (!result) {
+          ZS_LOG_WARNING(Detail, slog("singleton gone"))
+        }
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      TimerWheelPtr TimerWheel::singleton(IMessageQueuePtr queue)
+      {
+        TimerWheelPtr root = singleton();
+        if (!root) return TimerWheelPtr();
+        return root->forQueue(queue);
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TimerWheel => friend ITimerWheelForInternal
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      TimerWheelEntryPtr TimerWheel::arm(
+                                         ITimerWheelDelegatePtr delegate,
+                                         Duration timeout
+                                         )
+      {
+        ZS_THROW_INVALID_ARGUMENT_IF(!delegate)
+
+        Time now = currentTime();
+
+        AutoRecursiveLock lock(mLock);
+
+        if (0 == mTotalArmed) {
+          // nothing is armed thus nothing is lost by skipping the idle ticks
+          mCurrentTick = toTick(now, false);
+        }
+
+        // fire on the wheel's own stack queue shard (the delegate's shard when
+        // the delegate is bound to one)
+        TimerWheelEntryPtr entry(new TimerWheelEntry(mThisWeak.lock(), ITimerWheelDelegateProxy::createWeak(getAssociatedMessageQueue(), delegate), now + timeout));
+        entry->mExpiresTick = toTick(entry->mExpires, true);
+
+        insert(entry);
+        ++mTotalArmed;
+
+        if ((!mTimer) ||
+            (static_cast<LONG>(entry->mExpiresTick - mTimerTick) < 0)) {
+          scheduleTimer();
+        }
+
+        ZS_LOG_TRACE(log("armed") + ZS_PARAM("entry", entry->getID()) + ZS_PARAM("timeout (ms)", timeout.total_milliseconds()) + ZS_PARAM("armed", mTotalArmed))
+        return entry;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TimerWheel => friend TimerWheelEntry
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void TimerWheel::cancel(TimerWheelEntry &entry)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if (!entry.mSlot) return;
+
+        entry.mSlot->erase(entry.mPosition);
+        entry.mSlot = NULL;
+        entry.mDelegate.reset();
+
+        --mTotalArmed;
+
+        ZS_LOG_TRACE(log("cancelled") + ZS_PARAM("entry", entry.getID()) + ZS_PARAM("armed", mTotalArmed))
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TimerWheel => ITimerDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void TimerWheel::onTimer(TimerPtr timer)
+      {
+        EntryList expired;
+
+        {
+          AutoRecursiveLock lock(mLock);
+
+          if (timer != mTimer) {
+            ZS_LOG_WARNING(Trace, log("ignoring obsolete wheel timer (probably okay)") + ZS_PARAM("timer", timer->getID()))
+            return;
+          }
+
+          mTimer.reset();
+
+          advance(toTick(currentTime(), false), expired);
+
+          scheduleTimer();
+
+          mTotalFired += expired.size();
+        }
+
+        // notify outside the lock
+        for (EntryList::iterator iter = expired.begin(); iter != expired.end(); ++iter)
+        {
+          TimerWheelEntryPtr entry = (*iter);
+
+          ITimerWheelDelegatePtr delegate;
+          {
+            AutoRecursiveLock lock(mLock);
+            delegate = entry->mDelegate;
+            entry->mDelegate.reset();
+          }
+
+          if (!delegate) continue;
+
+          try {
+            delegate->onTimerWheelExpired(entry);
+          } catch (ITimerWheelDelegateProxy::Exceptions::DelegateGone &) {
+            ZS_LOG_TRACE(log("delegate gone") + ZS_PARAM("entry", entry->getID()))
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TimerWheel => (internal)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      Log::Params TimerWheel::log(const char *message) const
+      {
+        ElementPtr objectEl = Element::create("stack::TimerWheel");
+        IHelper::debugAppend(objectEl, "id", mID);
+        return Log::Params(message, objectEl);
+      }
+
+      //-----------------------------------------------------------------------
+      Log::Params TimerWheel::slog(const char *message)
+      {
+        return Log::Params(message, "stack::TimerWheel");
+      }
+
+      //-----------------------------------------------------------------------
+      Log::Params TimerWheel::debug(const char *message) const
+      {
+        return Log::Params(message, toDebug());
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr TimerWheel::toDebug() const
+      {
+        AutoRecursiveLock lock(mLock);
+
+        ElementPtr resultEl = Element::create("stack::TimerWheel");
+
+        IHelper::debugAppend(resultEl, "id", mID);
+        IHelper::debugAppend(resultEl, "other shards", mShards.size());
+        IHelper::debugAppend(resultEl, "resolution (ms)", mResolution.total_milliseconds());
+        IHelper::debugAppend(resultEl, "current tick", mCurrentTick);
+        IHelper::debugAppend(resultEl, "armed", mTotalArmed);
+        IHelper::debugAppend(resultEl, "fired", mTotalFired);
+        IHelper::debugAppend(resultEl, "timer", mTimer ? mTimer->getID() : 0);
+        IHelper::debugAppend(resultEl, "timer tick", mTimerTick);
+
+        return resultEl;
+      }
+
+      //-----------------------------------------------------------------------
+      TimerWheelPtr TimerWheel::forQueue(IMessageQueuePtr queue)
+      {
+        // NOTE: mShards never changes once created thus no lock is needed
+        if (mShards.size() < 1) return mThisWeak.lock();
+        if (queue == getAssociatedMessageQueue()) return mThisWeak.lock();
+
+        for (TimerWheelArray::iterator iter = mShards.begin(); iter != mShards.end(); ++iter) {
+          TimerWheelPtr &wheel = (*iter);
+          if (queue == wheel->getAssociatedMessageQueue()) return wheel;
+        }
+
+        // not a stack queue shard, spread such delegates across the wheels
+        size_t index = (reinterpret_cast<size_t>(queue.get()) / sizeof(void *)) % (mShards.size() + 1);
+        if (0 == index) return mThisWeak.lock();
+        return mShards[index - 1];
+      }
+
+      //-----------------------------------------------------------------------
+      Time TimerWheel::currentTime() const
+      {
+        return zsLib::now();
+      }
+
+      //-----------------------------------------------------------------------
+      ULONG TimerWheel::toTick(Time when, bool roundUp) const
+      {
+        if (when <= mStartTime) return 0;
+
+        QWORD elapsed = static_cast<QWORD>((when - mStartTime).total_milliseconds());
+        QWORD resolution = static_cast<QWORD>(mResolution.total_milliseconds());
+
+        if (roundUp) elapsed += (resolution - 1);
+
+        return static_cast<ULONG>(elapsed / resolution);
+      }
+
+      //-----------------------------------------------------------------------
+      void TimerWheel::insert(TimerWheelEntryPtr entry)
+      {
+        ULONG expiresTick = entry->mExpiresTick;
+        ULONG delta = expiresTick - mCurrentTick;
+
+        EntryList *slot = NULL;
+
+        if (static_cast<LONG>(delta) < 0) {
+          // already expired, fire on the next tick processed
+          slot = &(mFirstLevel[mCurrentTick & (Sizes_FirstLevelSlots - 1)]);
+        } else if (delta < (1 << Sizes_FirstLevelBits)) {
+          slot = &(mFirstLevel[expiresTick & (Sizes_FirstLevelSlots - 1)]);
+        } else {
+          ULONG level = 0;
+          for (; level < Sizes_OtherLevels - 1; ++level) {
+            if (delta < (1 << (Sizes_FirstLevelBits + ((level + 1) * Sizes_OtherLevelBits)))) break;
+          }
+
+          ULONG limit = (1 << (Sizes_FirstLevelBits + (Sizes_OtherLevels * Sizes_OtherLevelBits)));
+          if (delta >= limit) {
+            // beyond the end of the wheel; park in the last slot reachable
+            // and re-insert when it cascades down
+            expiresTick = mCurrentTick + (limit - 1);
+          }
+
+          slot = &(mOtherLevels[level][(expiresTick >> (Sizes_FirstLevelBits + (level * Sizes_OtherLevelBits))) & (Sizes_OtherLevelSlots - 1)]);
+        }
+
+        entry->mSlot = slot;
+        entry->mPosition = slot->insert(slot->end(), entry);
+      }
+
+      //-----------------------------------------------------------------------
+      ULONG TimerWheel::nextTick() const
+      {
+        // entries in the first level expire exactly on their slot's tick so
+        // the first non-empty slot is the next expiry; higher levels only
+        // matter once the first level wraps and a cascade is due
+        for (ULONG loop = 0; loop < Sizes_FirstLevelSlots; ++loop) {
+          ULONG tick = mCurrentTick + loop;
+          ULONG index = (tick & (Sizes_FirstLevelSlots - 1));
+          if (0 == index) return tick;
+          if (mFirstLevel[index].size() > 0) return tick;
+        }
+        return mCurrentTick + Sizes_FirstLevelSlots;
+      }
+
+      //-----------------------------------------------------------------------
+      void TimerWheel::scheduleTimer()
+      {
+        if (0 == mTotalArmed) {
+          if (mTimer) {
+            ZS_LOG_DEBUG(log("stopping wheel timer as nothing is armed"))
+            mTimer->cancel();
+            mTimer.reset();
+          }
+          return;
+        }
+
+        ULONG tick = nextTick();
+        if ((mTimer) &&
+            (tick == mTimerTick)) return;
+
+        if (mTimer) {
+          mTimer->cancel();
+          mTimer.reset();
+        }
+
+        Time fireAt = mStartTime + zsLib::Milliseconds(static_cast<QWORD>(tick) * static_cast<QWORD>(mResolution.total_milliseconds()));
+        Time now = currentTime();
+
+        Duration waitTime = zsLib::Milliseconds(0);
+        if (fireAt > now) {
+          waitTime = fireAt - now;
+        }
+
+        mTimerTick = tick;
+        mTimer = Timer::create(mThisWeak.lock(), waitTime, false);
+
+        ZS_LOG_TRACE(log("wheel timer armed") + ZS_PARAM("tick", tick) + ZS_PARAM("wait (ms)", waitTime.total_milliseconds()))
+      }
+
+      //-----------------------------------------------------------------------
+      void TimerWheel::advance(
+                               ULONG nowTick,
+                               EntryList &outExpired
+                               )
+      {
+        // NOTE: processes every tick up to and including nowTick; the
+        //       caller holds the lock
+        while ((0 != mTotalArmed) &&
+               (static_cast<LONG>(nowTick - mCurrentTick) >= 0)) {
+          ULONG index = (mCurrentTick & (Sizes_FirstLevelSlots - 1));
+
+          if (0 == index) {
+            if (0 == cascade(0, (mCurrentTick >> Sizes_FirstLevelBits) & (Sizes_OtherLevelSlots - 1))) {
+              if (0 == cascade(1, (mCurrentTick >> (Sizes_FirstLevelBits + Sizes_OtherLevelBits)) & (Sizes_OtherLevelSlots - 1))) {
+                cascade(2, (mCurrentTick >> (Sizes_FirstLevelBits + (2*Sizes_OtherLevelBits))) & (Sizes_OtherLevelSlots - 1));
+              }
+            }
+          }
+
+          ++mCurrentTick;
+
+          EntryList &slot = mFirstLevel[index];
+          while (slot.size() > 0) {
+            TimerWheelEntryPtr entry = slot.front();
+            slot.pop_front();
+            --mTotalArmed;
+
+            if (static_cast<LONG>(entry->mExpiresTick - mCurrentTick) >= 0) {
+              // was clamped to the end of the wheel, place it again
+              insert(entry);
+              ++mTotalArmed;
+              continue;
+            }
+
+            entry->mSlot = NULL;
+            outExpired.push_back(entry);
+          }
+        }
+
+        if (0 == mTotalArmed) {
+          mCurrentTick = nowTick + 1;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      ULONG TimerWheel::cascade(
+                                ULONG level,
+                                ULONG index
+                                )
+      {
+        EntryList entries;
+        entries.swap(mOtherLevels[level][index]);
+
+        for (EntryList::iterator iter = entries.begin(); iter != entries.end(); ++iter)
+        {
+          insert(*iter);
+        }
+
+        return index;
+      }
+
+    }
+  }
+}
@@ -0,0 +1,121 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/internal/stack_WakeOnce.h>
+
+#include <openpeer/services/IHelper.h>
+#include <openpeer/services/IWakeDelegate.h>
+
+#include <zsLib/XML.h>
+
+namespace openpeer { namespace stack { ZS_DECLARE_SUBSYSTEM(openpeer_stack) } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      using services::IHelper;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark WakeOnce
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      WakeOnce::WakeOnce() :
+        mPending(false),
+        mTotalWakes(0),
+        mTotalCoalesced(0)
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      WakeOnce::~WakeOnce()
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      bool WakeOnce::wake(IWakeDelegatePtr delegate)
+      {
+        if (!delegate) return false;
+
+        {
+          AutoRecursiveLock lock(mLock);
+          if (mPending) {
+            ++mTotalCoalesced;
+            return false;
+          }
+
+          mPending = true;
+          ++mTotalWakes;
+        }
+
+        IWakeDelegateProxy::create(delegate)->onWake();
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      void WakeOnce::woken()
+      {
+        AutoRecursiveLock lock(mLock);
+        mPending = false;
+      }
+
+      //-----------------------------------------------------------------------
+      bool WakeOnce::isPending() const
+      {
+        AutoRecursiveLock lock(mLock);
+        return mPending;
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr WakeOnce::toDebug() const
+      {
+        AutoRecursiveLock lock(mLock);
+
+        ElementPtr resultEl = Element::create("stack::WakeOnce");
+
+        IHelper::debugAppend(resultEl, "pending", mPending);
+        IHelper::debugAppend(resultEl, "wakes", mTotalWakes);
+        IHelper::debugAppend(resultEl, "coalesced", mTotalCoalesced);
+
+        return resultEl;
+      }
+
+    }
+  }
+}
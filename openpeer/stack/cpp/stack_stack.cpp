@@ -45,6 +45,8 @@
 #include <openpeer/stack/message/peer-to-peer/MessageFactoryPeerToPeer.h>
 
 #include <openpeer/stack/internal/stack_Settings.h>
+#include <openpeer/stack/internal/stack_KeyGenerator.h>
+#include <openpeer/stack/internal/stack_InstrumentedMessageQueue.h>
 
 #include <openpeer/stack/ISettings.h>
 
@@ -84,6 +86,32 @@ namespace openpeer
       using message::peer_salt::MessageFactoryPeerSalt;
       using message::peer_to_peer::MessageFactoryPeerToPeer;
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static String toThreadName(
+                                 const char *baseThreadName,
+                                 ULONG index
+                                 )
+      {
+        if (0 == index) return baseThreadName;
+        return String(baseThreadName) + "." + string(index);
+      }
+
+      //-----------------------------------------------------------------------
+      static ULONG getTotalThreads(const char *settingName)
+      {
+        ULONG total = services::ISettings::getUInt(settingName);
+        if (total < 1) total = 1;
+        return total;
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -116,6 +144,39 @@ namespace openpeer
         return IStack::getStackQueue();
       }
 
+      //-----------------------------------------------------------------------
+      IMessageQueuePtr IStackForInternal::queueStackShard()
+      {
+        StackPtr singleton = Stack::singleton();
+        if (!singleton) return IStack::getStackQueue();
+        return singleton->queueStackShard();
+      }
+
+      //-----------------------------------------------------------------------
+      ULONG IStackForInternal::totalStackShards()
+      {
+        StackPtr singleton = Stack::singleton();
+        if (!singleton) return 1;
+        return singleton->totalStackShards();
+      }
+
+      //-----------------------------------------------------------------------
+      IMessageQueuePtr IStackForInternal::queueStackShard(ULONG index)
+      {
+        StackPtr singleton = Stack::singleton();
+        if (!singleton) return IStack::getStackQueue();
+        return singleton->queueStackShard(index);
+      }
+
+      //-----------------------------------------------------------------------
+      bool IStackForInternal::isStackShard(IMessageQueuePtr queue)
+      {
+        if (!queue) return false;
+        StackPtr singleton = Stack::singleton();
+        if (!singleton) return queue == IStack::getStackQueue();
+        return singleton->isStackShard(queue);
+      }
+
       //-----------------------------------------------------------------------
       IMessageQueuePtr IStackForInternal::queueServices()
       {
@@ -128,6 +189,14 @@ namespace openpeer
         return IStack::getKeyGenerationQueue();
       }
 
+      //-----------------------------------------------------------------------
+      IMessageQueuePtr IStackForInternal::queueKeyGenerationWorker()
+      {
+        StackPtr singleton = Stack::singleton();
+        if (!singleton) return IStack::getKeyGenerationQueue();
+        return singleton->queueKeyGenerationWorker();
+      }
+
       //-----------------------------------------------------------------------
       void IStackForInternal::logInstanceInformation()
       {
@@ -146,7 +215,9 @@ namespace openpeer
 
       //-----------------------------------------------------------------------
       Stack::Stack() :
-        mID(zsLib::createPUID())
+        mID(zsLib::createPUID()),
+        mNextStackQueue(0),
+        mNextKeyGenerationQueue(0)
       {
         ZS_LOG_BASIC(log("created"))
 
@@ -212,29 +283,56 @@ namespace openpeer
                         IMessageQueuePtr servicesMessageQueue,
                         IMessageQueuePtr keyGenerationQueue
                         )
+      {
+        MessageQueueList stackMessageQueues;
+        if (stackMessageQueue) {
+          stackMessageQueues.push_back(stackMessageQueue);
+        }
+
+        setup(defaultDelegateMessageQueue, stackMessageQueues, servicesMessageQueue, keyGenerationQueue);
+      }
+
+      //-----------------------------------------------------------------------
+      void Stack::setup(
+                        IMessageQueuePtr defaultDelegateMessageQueue,
+                        const MessageQueueList &stackMessageQueues,
+                        IMessageQueuePtr servicesMessageQueue,
+                        IMessageQueuePtr keyGenerationQueue
+                        )
       {
         AutoRecursiveLock lock(mLock);
 
-        IMessageQueueManager::registerMessageQueueThreadPriority(OPENPEER_STACK_STACK_THREAD_NAME, zsLib::threadPriorityFromString(services::ISettings::getString(OPENPEER_STACK_SETTING_STACK_STACK_THREAD_PRIORITY)));
-        IMessageQueueManager::registerMessageQueueThreadPriority(OPENPEER_STACK_KEY_GENERATION_THREAD_NAME, zsLib::threadPriorityFromString(services::ISettings::getString(OPENPEER_STACK_SETTING_STACK_KEY_GENERATION_THREAD_PRIORITY)));
+        // settings decide thread counts, priorities and instrumentation
+        ISettingsForStack::applyDefaultsIfNoDelegatePresent();
+
+        for (ULONG index = 0, total = getTotalThreads(OPENPEER_STACK_SETTING_STACK_TOTAL_STACK_THREADS); index < total; ++index) {
+          IMessageQueueManager::registerMessageQueueThreadPriority(toThreadName(OPENPEER_STACK_STACK_THREAD_NAME, index), zsLib::threadPriorityFromString(services::ISettings::getString(OPENPEER_STACK_SETTING_STACK_STACK_THREAD_PRIORITY)));
+        }
+        for (ULONG index = 0, total = getTotalThreads(OPENPEER_STACK_SETTING_STACK_TOTAL_KEY_GENERATION_THREADS); index < total; ++index) {
+          IMessageQueueManager::registerMessageQueueThreadPriority(toThreadName(OPENPEER_STACK_KEY_GENERATION_THREAD_NAME, index), zsLib::threadPriorityFromString(services::ISettings::getString(OPENPEER_STACK_SETTING_STACK_KEY_GENERATION_THREAD_PRIORITY)));
+        }
 
         if (defaultDelegateMessageQueue) {
-          mDelegateQueue = defaultDelegateMessageQueue;
+          mDelegateQueue = instrument(defaultDelegateMessageQueue, "delegate");
         }
 
-        if (stackMessageQueue) {
-          mStackQueue = stackMessageQueue;
+        if (stackMessageQueues.size() > 0) {
+          mStackQueues.clear();
+          for (MessageQueueList::const_iterator iter = stackMessageQueues.begin(); iter != stackMessageQueues.end(); ++iter) {
+            const IMessageQueuePtr &queue = (*iter);
+            if (!queue) continue;
+            mStackQueues.push_back(instrument(queue, toThreadName("stack", static_cast<ULONG>(mStackQueues.size()))));
+          }
         }
 
         if (servicesMessageQueue) {
-          mServicesQueue = servicesMessageQueue;
+          mServicesQueue = instrument(servicesMessageQueue, "services");
         }
         if (keyGenerationQueue) {
-          mKeyGenerationQueue = keyGenerationQueue;
+          mKeyGenerationQueues.clear();
+          mKeyGenerationQueues.push_back(instrument(keyGenerationQueue, "key generation"));
         }
 
-        ISettingsForStack::applyDefaultsIfNoDelegatePresent();
-
         verifySettingIsSet(OPENPEER_COMMON_SETTING_APPLICATION_NAME);
         verifySettingIsSet(OPENPEER_COMMON_SETTING_APPLICATION_IMAGE_URL);
         verifySettingIsSet(OPENPEER_COMMON_SETTING_APPLICATION_URL);
@@ -246,6 +344,28 @@ namespace openpeer
         verifySettingIsSet(OPENPEER_COMMON_SETTING_INSTANCE_ID);
 
         ZS_THROW_INVALID_ARGUMENT_IF(!mDelegateQueue)
+
+        // start generating key pairs ahead of the first account login (only
+        // when the application opted into a reservoir depth)
+        IKeyGeneratorForStack::fillReservoir();
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr Stack::getQueueStatistics(bool resetAfterSnapshot)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        ElementPtr resultEl = Element::create("queues");
+
+        IHelper::debugAppend(resultEl, "enabled", services::ISettings::getBool(OPENPEER_STACK_SETTING_STACK_QUEUE_STATISTICS_ENABLED));
+        IHelper::debugAppend(resultEl, "snapshot", zsLib::now());
+
+        for (InstrumentedMessageQueueList::iterator iter = mInstrumentedQueues.begin(); iter != mInstrumentedQueues.end(); ++iter) {
+          InstrumentedMessageQueuePtr queue = (*iter);
+          IHelper::debugAppend(resultEl, queue->getStatistics(resetAfterSnapshot));
+        }
+
+        return resultEl;
       }
 
       //-----------------------------------------------------------------------
@@ -279,15 +399,26 @@ namespace openpeer
       IMessageQueuePtr Stack::queueStack()
       {
         AutoRecursiveLock lock(mLock);
-        if (!mStackQueue) mStackQueue = IMessageQueueManager::getMessageQueue(OPENPEER_STACK_STACK_THREAD_NAME);
-        return mStackQueue;
+        prepareStackQueues();
+        return mStackQueues.front();
+      }
+
+      //-----------------------------------------------------------------------
+      IMessageQueuePtr Stack::queueStackShard()
+      {
+        AutoRecursiveLock lock(mLock);
+        prepareStackQueues();
+
+        IMessageQueuePtr queue = mStackQueues[mNextStackQueue % mStackQueues.size()];
+        ++mNextStackQueue;
+        return queue;
       }
 
       //-----------------------------------------------------------------------
       IMessageQueuePtr Stack::queueServices()
       {
         AutoRecursiveLock lock(mLock);
-        if (!mServicesQueue) mServicesQueue = IHelper::getServiceQueue();
+        if (!mServicesQueue) mServicesQueue = instrument(IHelper::getServiceQueue(), "services");
         return mServicesQueue;
       }
 
@@ -295,10 +426,49 @@ namespace openpeer
       IMessageQueuePtr Stack::queueKeyGeneration()
       {
         AutoRecursiveLock lock(mLock);
-        if (!mKeyGenerationQueue) {
-          mKeyGenerationQueue = IMessageQueueManager::getMessageQueue(OPENPEER_STACK_KEY_GENERATION_THREAD_NAME);
+        prepareKeyGenerationQueues();
+        return mKeyGenerationQueues.front();
+      }
+
+      //-----------------------------------------------------------------------
+      IMessageQueuePtr Stack::queueKeyGenerationWorker()
+      {
+        AutoRecursiveLock lock(mLock);
+        prepareKeyGenerationQueues();
+
+        // each key generation job is handed to the next worker in the pool
+        IMessageQueuePtr queue = mKeyGenerationQueues[mNextKeyGenerationQueue % mKeyGenerationQueues.size()];
+        ++mNextKeyGenerationQueue;
+        return queue;
+      }
+
+      //-----------------------------------------------------------------------
+      ULONG Stack::totalStackShards()
+      {
+        AutoRecursiveLock lock(mLock);
+        prepareStackQueues();
+        return static_cast<ULONG>(mStackQueues.size());
+      }
+
+      //-----------------------------------------------------------------------
+      IMessageQueuePtr Stack::queueStackShard(ULONG index)
+      {
+        AutoRecursiveLock lock(mLock);
+        prepareStackQueues();
+        return mStackQueues[index % mStackQueues.size()];
+      }
+
+      //-----------------------------------------------------------------------
+      bool Stack::isStackShard(IMessageQueuePtr queue)
+      {
+        AutoRecursiveLock lock(mLock);
+        prepareStackQueues();
+
+        for (MessageQueueArray::iterator iter = mStackQueues.begin(); iter != mStackQueues.end(); ++iter)
+        {
+          if ((*iter) == queue) return true;
         }
-        return mKeyGenerationQueue;
+        return false;
       }
 
       //-----------------------------------------------------------------------
@@ -348,6 +518,50 @@ namespace openpeer
 
         ZS_THROW_INVALID_USAGE(String("setting is missing a value: ") + settingName)
       }
+
+      //-----------------------------------------------------------------------
+      void Stack::prepareStackQueues()
+      {
+        if (mStackQueues.size() > 0) return;
+
+        ULONG total = getTotalThreads(OPENPEER_STACK_SETTING_STACK_TOTAL_STACK_THREADS);
+        for (ULONG index = 0; index < total; ++index) {
+          mStackQueues.push_back(instrument(IMessageQueueManager::getMessageQueue(toThreadName(OPENPEER_STACK_STACK_THREAD_NAME, index)), toThreadName("stack", index)));
+        }
+
+        ZS_LOG_DEBUG(log("stack queues prepared") + ZS_PARAM("total", total))
+      }
+
+      //-----------------------------------------------------------------------
+      void Stack::prepareKeyGenerationQueues()
+      {
+        if (mKeyGenerationQueues.size() > 0) return;
+
+        ULONG total = getTotalThreads(OPENPEER_STACK_SETTING_STACK_TOTAL_KEY_GENERATION_THREADS);
+        for (ULONG index = 0; index < total; ++index) {
+          mKeyGenerationQueues.push_back(instrument(IMessageQueueManager::getMessageQueue(toThreadName(OPENPEER_STACK_KEY_GENERATION_THREAD_NAME, index)), toThreadName("key generation", index)));
+        }
+
+        ZS_LOG_DEBUG(log("key generation queues prepared") + ZS_PARAM("total", total))
+      }
+
+      //-----------------------------------------------------------------------
+      IMessageQueuePtr Stack::instrument(
+                                         IMessageQueuePtr queue,
+                                         const String &name
+                                         )
+      {
+        if (!queue) return queue;
+        if (!services::ISettings::getBool(OPENPEER_STACK_SETTING_STACK_QUEUE_STATISTICS_ENABLED)) return queue;
+
+        if (dynamic_pointer_cast<InstrumentedMessageQueue>(queue)) return queue;
+
+        InstrumentedMessageQueuePtr instrumented = InstrumentedMessageQueue::create(queue, name);
+        mInstrumentedQueues.push_back(instrumented);
+
+        ZS_LOG_DEBUG(log("instrumenting queue") + ZS_PARAM("name", name))
+        return instrumented;
+      }
     }
 
     //-------------------------------------------------------------------------
@@ -380,6 +594,30 @@ namespace openpeer
       singleton->setup(defaultDelegateMessageQueue, stackMessageQueue, servicesQueue, keyGenerationQueue);
     }
 
+    //-------------------------------------------------------------------------
+    void IStack::setup(
+                       IMessageQueuePtr defaultDelegateMessageQueue,
+                       const MessageQueueList &stackMessageQueues,
+                       IMessageQueuePtr servicesQueue,
+                       IMessageQueuePtr keyGenerationQueue
+                       )
+    {
+      services::IHelper::setSocketThreadPriority();
+      services::IHelper::setTimerThreadPriority();
+
+      internal::StackPtr singleton = internal::Stack::singleton();
+      ZS_THROW_INVALID_USAGE_IF(!singleton) // called during shutdown process?
+      singleton->setup(defaultDelegateMessageQueue, stackMessageQueues, servicesQueue, keyGenerationQueue);
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr IStack::getQueueStatistics(bool resetAfterSnapshot)
+    {
+      internal::StackPtr singleton = internal::Stack::singleton();
+      if (!singleton) return ElementPtr();
+      return singleton->getQueueStatistics(resetAfterSnapshot);
+    }
+
     //-------------------------------------------------------------------------
     IMessageQueuePtr IStack::getStackQueue()
     {
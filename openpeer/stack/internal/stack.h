@@ -37,17 +37,22 @@
 #include <openpeer/stack/internal/stack_Diff.h>
 #include <openpeer/stack/internal/stack_BootstrappedNetwork.h>
 #include <openpeer/stack/internal/stack_BootstrappedNetworkManager.h>
+#include <openpeer/stack/internal/stack_ChannelSendScheduler.h>
+#include <openpeer/stack/internal/stack_ChannelTable.h>
+#include <openpeer/stack/internal/stack_ChannelWindow.h>
 #include <openpeer/stack/internal/stack_IFinderRelayChannel.h>
 #include <openpeer/stack/internal/stack_FinderRelayChannel.h>
 #include <openpeer/stack/internal/stack_IFinderConnection.h>
 #include <openpeer/stack/internal/stack_IFinderConnectionRelayChannel.h>
 #include <openpeer/stack/internal/stack_FinderConnection.h>
 #include <openpeer/stack/internal/stack_Helper.h>
+#include <openpeer/stack/internal/stack_InstrumentedMessageQueue.h>
 #include <openpeer/stack/internal/stack_KeyGenerator.h>
 #include <openpeer/stack/internal/stack_Location.h>
 #include <openpeer/stack/internal/stack_MessageIncoming.h>
 #include <openpeer/stack/internal/stack_MessageMonitor.h>
 #include <openpeer/stack/internal/stack_MessageMonitorManager.h>
+#include <openpeer/stack/internal/stack_MessageMonitorTable.h>
 #include <openpeer/stack/internal/stack_Peer.h>
 #include <openpeer/stack/internal/stack_PeerFiles.h>
 #include <openpeer/stack/internal/stack_PeerFilePublic.h>
@@ -63,3 +68,5 @@
 #include <openpeer/stack/internal/stack_ServiceSaltFetchSignedSaltQuery.h>
 #include <openpeer/stack/internal/stack_Settings.h>
 #include <openpeer/stack/internal/stack_Stack.h>
+#include <openpeer/stack/internal/stack_TimerWheel.h>
+#include <openpeer/stack/internal/stack_WakeOnce.h>
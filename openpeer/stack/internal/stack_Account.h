@@ -36,6 +36,7 @@
 #include <openpeer/stack/internal/stack_AccountPeerLocation.h>
 #include <openpeer/stack/internal/stack_ServiceLockboxSession.h>
 #include <openpeer/stack/internal/stack_IFinderRelayChannel.h>
+#include <openpeer/stack/internal/stack_WakeOnce.h>
 
 #include <openpeer/stack/message/peer-finder/PeerLocationFindResult.h>
 #include <openpeer/stack/message/bootstrapped-finder/FindersGetResult.h>
@@ -54,9 +55,11 @@
 #include <zsLib/Timer.h>
 
 #include <map>
+#include <set>
 
 #define OPENPEER_STACK_SETTING_BACKGROUNDING_ACCOUNT_PHASE "openpeer/stack/backgrounding-phase-account"
 #define OPENPEER_STACK_SETTING_ACCOUNT_SHUTDOWN_ON_ICE_SOCKET_FAILURE "openpeer/stack/account-shutdown-on-ice-socket-failure"
+#define OPENPEER_STACK_SETTING_ACCOUNT_EPHEMERAL_DH_KEY_POOL_DEPTH "openpeer/stack/account-ephemeral-dh-key-pool-depth"
 
 namespace openpeer
 {
@@ -327,8 +330,10 @@ namespace openpeer
         ZS_DECLARE_TYPEDEF_PTR(IServiceLockboxSessionForAccount, UseServiceLockboxSession)
 
         ZS_DECLARE_STRUCT_PTR(PeerInfo)
+        ZS_DECLARE_CLASS_PTR(EphemeralDHKeyPool)
 
         friend struct PeerInfo;
+        friend class EphemeralDHKeyPool;
 
         typedef IAccount::AccountStates AccountStates;
 
@@ -341,6 +346,7 @@ namespace openpeer
 
         typedef std::map<PeerURI, UsePeerWeakPtr> PeerMap;
         typedef std::map<PeerURI, PeerInfoPtr> PeerInfoMap;
+        typedef std::set<PeerURI> PeerURISet;
 
         typedef std::map<PeerSubscriptionID, UsePeerSubscriptionWeakPtr> PeerSubscriptionMap;
 
@@ -684,6 +690,7 @@ namespace openpeer
         bool stepFinderDNS();
         bool stepFinder();
         bool stepPeers();
+        bool stepPeer(PeerInfoMap::iterator current);
         bool stepFinderBackgrounding();
 
         void setState(AccountStates accountState);
@@ -729,6 +736,9 @@ namespace openpeer
 
         void handleFindRequestComplete(IMessageMonitorPtr requester);
 
+        void markPeerDirty(const PeerURI &peerURI);
+        void markAllPeersDirty();
+
         void handleFinderRelatedFailure();
 
         void notifySubscriptions(
@@ -790,6 +800,114 @@ namespace openpeer
           AutoBool mFindAgainAfterBackgrounded;
         };
 
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark Account::EphemeralDHKeyPool
+        #pragma mark
+
+        // NOTE: pool of ephemeral DH key pairs (per key domain) generated
+        //       from the account's DH key pair templates on the key
+        //       generation queue so responding to an incoming peer location
+        //       find never has to generate a key pair on the stack queue.
+        class EphemeralDHKeyPool : public MessageQueueAssociator,
+                                   public IWakeDelegate,
+                                   public ITimerDelegate
+        {
+        public:
+          typedef IDHKeyDomain::KeyDomainPrecompiledTypes KeyDomainPrecompiledTypes;
+          typedef std::list<DHKeyPair> DHKeyPairList;
+
+          struct Domain
+          {
+            DHKeyPair mTemplate;
+            DHKeyPairList mReady;
+
+            bool mFailing;                      // last generation attempt failed
+            Time mRetryAfter;
+            Duration mLastRetryAfterDuration;
+
+            Domain();
+          };
+
+          typedef std::map<KeyDomainPrecompiledTypes, Domain> DomainMap;
+
+        protected:
+          EphemeralDHKeyPool(
+                             IMessageQueuePtr queue,
+                             AccountPtr outer
+                             );
+
+        public:
+          ~EphemeralDHKeyPool();
+
+          static EphemeralDHKeyPoolPtr create(AccountPtr outer);
+
+          void cancel();
+
+          void addTemplate(
+                           KeyDomainPrecompiledTypes type,
+                           const DHKeyPair &templateKeyPair
+                           );
+
+          bool take(
+                    KeyDomainPrecompiledTypes type,
+                    IDHPrivateKeyPtr &outPrivateKey,
+                    IDHPublicKeyPtr &outPublicKey,
+                    bool &outGenerateInline
+                    );
+
+          Log::Params log(const char *message) const;
+          ElementPtr toDebug() const;
+
+        protected:
+          //-------------------------------------------------------------------
+          #pragma mark
+          #pragma mark Account::EphemeralDHKeyPool => IWakeDelegate
+          #pragma mark
+
+          virtual void onWake();
+
+          //-------------------------------------------------------------------
+          #pragma mark
+          #pragma mark Account::EphemeralDHKeyPool => ITimerDelegate
+          #pragma mark
+
+          virtual void onTimer(TimerPtr timer);
+
+        protected:
+          //-------------------------------------------------------------------
+          #pragma mark
+          #pragma mark Account::EphemeralDHKeyPool => (internal)
+          #pragma mark
+
+          void fill();
+          bool needsFill(KeyDomainPrecompiledTypes &outType) const;
+          bool getNextRetry(Time &outRetryAfter) const;
+
+        protected:
+          //-------------------------------------------------------------------
+          #pragma mark
+          #pragma mark Account::EphemeralDHKeyPool => (data)
+          #pragma mark
+
+          AutoPUID mID;
+          mutable RecursiveLock mLock;
+          EphemeralDHKeyPoolWeakPtr mThisWeak;
+          AccountWeakPtr mOuter;
+
+          size_t mTargetDepth;
+
+          AutoBool mFilling;
+          AutoBool mOuterWaiting;
+
+          TimerPtr mRetryTimer;
+
+          DomainMap mDomains;
+        };
+
       protected:
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
@@ -801,6 +919,7 @@ namespace openpeer
 
         AutoPUID mID;
         AccountWeakPtr mThisWeak;
+        WakeOnce mWake;
         AccountPtr mGracefulShutdownReference;
 
         AccountStates mCurrentState;
@@ -826,6 +945,7 @@ namespace openpeer
         UsePublicationRepositoryPtr mRepository;
 
         DHKeyPairTemplates mDHKeyPairTemplates;
+        EphemeralDHKeyPoolPtr mEphemeralDHKeyPool;
 
         AutoBool mBlockRSAKeyGeneration;
         IKeyGeneratorPtr mRSAKeyGenerator;
@@ -843,6 +963,10 @@ namespace openpeer
         IncomingFindRequestList mIncomingFindRequests;
 
         PeerInfoMap mPeerInfos;
+        PeerURISet mDirtyPeers;
+        AutoBool mAllPeersDirty;
+        AutoULONG mTotalPeerSweeps;
+        AutoULONG mTotalPeersStepped;
 
         PeerSubscriptionMap mPeerSubscriptions;
 
@@ -36,9 +36,13 @@
 #include <openpeer/stack/message/peer-finder/SessionCreateResult.h>
 #include <openpeer/stack/message/peer-finder/SessionKeepAliveResult.h>
 #include <openpeer/stack/message/peer-finder/SessionDeleteResult.h>
+#include <openpeer/stack/message/MessageWriter.h>
+#include <openpeer/stack/message/MessageBatch.h>
 
 #include <openpeer/stack/IAccount.h>
 #include <openpeer/stack/internal/types.h>
+#include <openpeer/stack/internal/stack_WakeOnce.h>
+#include <openpeer/stack/internal/stack_TimerWheel.h>
 #include <openpeer/stack/IMessageMonitor.h>
 
 
@@ -134,7 +138,8 @@ namespace openpeer
                             public IMessageMonitorResultDelegate<SessionCreateResult>,
                             public IMessageMonitorResultDelegate<SessionKeepAliveResult>,
                             public IMessageMonitorResultDelegate<SessionDeleteResult>,
-                            public ITimerDelegate
+                            public ITimerDelegate,
+                            public ITimerWheelDelegate
       {
       public:
         friend interaction IAccountFinderFactory;
@@ -145,6 +150,7 @@ namespace openpeer
         ZS_DECLARE_TYPEDEF_PTR(IMessageMonitorManagerForAccountFinder, UseMessageMonitorManager)
 
         typedef IFinderConnection::ChannelNumber ChannelNumber;
+        typedef std::list<MessagePtr> MessageList;
 
       protected:
         AccountFinder(
@@ -296,6 +302,13 @@ namespace openpeer
 
         virtual void onTimer(TimerPtr timer);
 
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark AccountFinder => ITimerWheelDelegate
+        #pragma mark
+
+        virtual void onTimerWheelExpired(TimerWheelEntryPtr entry);
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -322,6 +335,9 @@ namespace openpeer
 
         void setState(AccountStates state);
 
+        bool writeFrame(SecureByteBlockPtr frame) const;
+        void flushSendBatch() const;
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -333,6 +349,7 @@ namespace openpeer
         AccountStates mCurrentState;
 
         AccountFinderWeakPtr mThisWeak;
+        mutable WakeOnce mWake;
         IAccountFinderDelegatePtr mDelegate;
         UseAccountWeakPtr mOuter;
 
@@ -342,6 +359,13 @@ namespace openpeer
 
         ITransportStreamReaderPtr mReceiveStream;
         ITransportStreamWriterPtr mSendStream;
+        mutable MessageWriter mMessageWriter;
+        AutoBool mBinaryEncoding;
+        AutoBool mCompression;
+        AutoBool mBatching;
+        mutable MessageBatch mSendBatch;
+        mutable MessageList mSendBatchRequests;   // requests with frames in mSendBatch
+        mutable TimerWheelEntryPtr mSendBatchTimer;
 
         IMessageMonitorPtr mSessionCreateMonitor;
         IMessageMonitorPtr mSessionKeepAliveMonitor;
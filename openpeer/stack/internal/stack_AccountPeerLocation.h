@@ -34,11 +34,15 @@
 #include <openpeer/stack/internal/types.h>
 #include <openpeer/stack/internal/stack_IFinderRelayChannel.h>
 #include <openpeer/stack/internal/stack_IFinderConnection.h>
+#include <openpeer/stack/internal/stack_TimerWheel.h>
+#include <openpeer/stack/internal/stack_WakeOnce.h>
 
 #include <openpeer/stack/message/peer-finder/PeerLocationFindNotify.h>
 
 #include <openpeer/stack/message/peer-to-peer/PeerIdentifyResult.h>
 #include <openpeer/stack/message/peer-to-peer/PeerKeepAliveResult.h>
+#include <openpeer/stack/message/MessageWriter.h>
+#include <openpeer/stack/message/MessageBatch.h>
 
 #include <openpeer/stack/IAccount.h>
 #include <openpeer/stack/ILocation.h>
@@ -51,7 +55,6 @@
 #include <openpeer/services/IMessageLayerSecurityChannel.h>
 
 #include <zsLib/MessageQueueAssociator.h>
-#include <zsLib/Timer.h>
 
 #include <map>
 #include <list>
@@ -175,7 +178,7 @@ namespace openpeer
                                   public SharedRecursiveLock,
                                   public IAccountPeerLocationForAccount,
                                   public IWakeDelegate,
-                                  public ITimerDelegate,
+                                  public ITimerWheelDelegate,
                                   public IFinderRelayChannelDelegate,
                                   public IICESocketDelegate,
                                   public IRUDPTransportDelegate,
@@ -197,6 +200,7 @@ namespace openpeer
         ZS_DECLARE_TYPEDEF_PTR(IMessageMonitorManagerForAccountPeerLocation, UseMessageMonitorManager)
 
         typedef IFinderConnection::ChannelNumber ChannelNumber;
+        typedef std::list<MessagePtr> MessageList;
 
         enum CreatedFromReasons
         {
@@ -313,10 +317,10 @@ namespace openpeer
 
         //---------------------------------------------------------------------
         #pragma mark
-        #pragma mark AccountPeerLocation => ITimerDelegate
+        #pragma mark AccountPeerLocation => ITimerWheelDelegate
         #pragma mark
 
-        virtual void onTimer(TimerPtr timer);
+        virtual void onTimerWheelExpired(TimerWheelEntryPtr entry);
 
         //---------------------------------------------------------------------
         #pragma mark
@@ -475,6 +479,10 @@ namespace openpeer
         void handleMessage(MessagePtr message);
         bool isLegalDuringPreIdentify(MessagePtr message) const;
 
+        bool isSendReady() const;
+        bool writeFrame(SecureByteBlockPtr frame) const;
+        void flushSendBatch() const;
+
         void connectLocation(
                              const char *remoteICEUsernameFrag,
                              const char *remoteICEPassword,
@@ -490,6 +498,7 @@ namespace openpeer
 
         AutoPUID mID;
         mutable AccountPeerLocationWeakPtr mThisWeak;
+        mutable WakeOnce mWake;
 
         IAccountPeerLocationDelegatePtr mDelegate;
         UseAccountWeakPtr mOuter;
@@ -506,6 +515,13 @@ namespace openpeer
         AutoBool mShouldRefindNow;
 
         mutable Time mLastActivity;
+        mutable MessageWriter mMessageWriter;
+        AutoBool mBinaryEncoding;
+        AutoBool mCompression;
+        AutoBool mBatching;
+        mutable MessageBatch mSendBatch;
+        mutable MessageList mSendBatchRequests;   // requests with frames in mSendBatch
+        mutable TimerWheelEntryPtr mSendBatchTimer;
 
         // information about the location found
         LocationInfoPtr mLocationInfo;
@@ -532,7 +548,7 @@ namespace openpeer
         PeerLocationFindRequestPtr mFindRequest;
 
         IMessageMonitorPtr mFindRequestMonitor;
-        TimerPtr mFindRequestTimer;
+        TimerWheelEntryPtr mFindRequestTimer;
 
         IFinderRelayChannelPtr mOutgoingRelayChannel;
         ITransportStreamReaderPtr mOutgoingRelayReceiveStream;
@@ -35,6 +35,7 @@
 
 #include <openpeer/stack/message/bootstrapper/ServicesGetResult.h>
 #include <openpeer/stack/message/certificates/CertificatesGetResult.h>
+#include <openpeer/stack/message/MessageWriter.h>
 
 #include <openpeer/stack/message/types.h>
 
@@ -509,6 +510,8 @@ namespace openpeer
 
         ULONG mRedirectionAttempts;
 
+        MessageWriter mMessageWriter;
+
         ServiceTypeMap mServiceTypeMap;
         CertificateMap mCertificates;
 
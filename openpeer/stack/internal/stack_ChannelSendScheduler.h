@@ -0,0 +1,145 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/internal/types.h>
+
+#include <list>
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelSendScheduler
+      #pragma mark
+
+      // NOTE: deficit round robin between the channels sharing one wire;
+      //       every visit adds a quantum of bytes to a channel's deficit and
+      //       the channel may send buffers while they fit within it, so a
+      //       bulk channel gets its share without starving small messages on
+      //       other channels. Priority queues (control traffic on channel 0)
+      //       are always drained before any other channel is visited.
+      class ChannelSendScheduler
+      {
+      public:
+        typedef ULONG ChannelNumber;
+        typedef std::list<SecureByteBlockPtr> BufferList;
+
+        ZS_DECLARE_STRUCT_PTR(Queue)
+
+        typedef std::list<QueuePtr> QueueList;
+
+        struct Queue
+        {
+          ChannelNumber mChannelNumber;
+          bool mPriority;
+
+          BufferList mBuffers;
+          size_t mQueuedBytes;
+
+          size_t mDeficit;
+          bool mActive;
+
+          ULONG mTotalBuffersQueued;
+          size_t mTotalBytesQueued;
+          ULONG mTotalBuffersSent;
+          size_t mTotalBytesSent;
+          ULONG mTotalBuffersDiscarded;
+
+          size_t mMaxQueuedBuffers;
+          size_t mMaxQueuedBytes;
+
+          Queue(
+                ChannelNumber channelNumber,
+                bool priority
+                );
+        };
+
+      public:
+        ChannelSendScheduler(size_t quantum = 4096);
+        ~ChannelSendScheduler();
+
+        static ElementPtr toDebug(QueuePtr queue);
+
+        QueuePtr open(
+                      ChannelNumber channelNumber,
+                      bool priority = false
+                      );
+
+        void enqueue(
+                     QueuePtr queue,
+                     SecureByteBlockPtr buffer
+                     );
+
+        void discard(QueuePtr queue);
+
+        SecureByteBlockPtr next(ChannelNumber &outChannelNumber);
+
+        bool hasData() const {return (mPriority.size() > 0) || (mActive.size() > 0);}
+        size_t totalQueuedBytes() const {return mQueuedBytes;}
+
+        void clear();
+
+        ElementPtr toDebug() const;
+
+      protected:
+        SecureByteBlockPtr pop(
+                               QueuePtr queue,
+                               ChannelNumber &outChannelNumber
+                               );
+
+      private:
+        ChannelSendScheduler(const ChannelSendScheduler &);
+        ChannelSendScheduler &operator=(const ChannelSendScheduler &);
+
+      protected:
+        size_t mQuantum;
+
+        QueueList mPriority;
+        QueueList mActive;
+
+        size_t mQueuedBytes;
+
+        ULONG mTotalRounds;
+      };
+
+    }
+  }
+}
@@ -0,0 +1,468 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/internal/types.h>
+
+#include <vector>
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelTable
+      #pragma mark
+
+      // NOTE: dense table of channels; slots are reused through a free list
+      //       and every reuse bumps the slot's generation so a handle kept by
+      //       a destroyed channel never resolves to its successor. Channel
+      //       numbers are chosen by the remote finder and are sparse, so a
+      //       number is resolved to its slot through a small open addressing
+      //       index (with the last hit cached for back to back packets on the
+      //       same channel). Each slot can also sit on any of the intrusive
+      //       state lists without allocating. Value pointers remain valid
+      //       only until the next insert().
+      template <typename Value>
+      class ChannelTable
+      {
+      public:
+        typedef ULONG ChannelNumber;
+
+        enum Lists
+        {
+          List_Pending,
+          List_Mapping,
+          List_Incoming,
+          List_Remove,
+
+          List_Last = List_Remove,
+        };
+
+        struct Handle
+        {
+          size_t mIndex;
+          ULONG mGeneration;                    // 0 is never a valid generation
+
+          Handle() : mIndex(0), mGeneration(0) {}
+          Handle(size_t index, ULONG generation) : mIndex(index), mGeneration(generation) {}
+
+          bool isEmpty() const {return 0 == mGeneration;}
+
+          bool operator==(const Handle &rValue) const {return (mIndex == rValue.mIndex) && (mGeneration == rValue.mGeneration);}
+          bool operator!=(const Handle &rValue) const {return !(*this == rValue);}
+        };
+
+      protected:
+        static const size_t NoIndex = static_cast<size_t>(-1);
+        static const size_t ErasedIndex = static_cast<size_t>(-2);
+
+        struct Link
+        {
+          size_t mPrev;
+          size_t mNext;
+          bool mLinked;
+
+          Link() : mPrev(NoIndex), mNext(NoIndex), mLinked(false) {}
+        };
+
+        struct ListHead
+        {
+          size_t mFirst;
+          size_t mLast;
+          size_t mSize;
+
+          ListHead() : mFirst(NoIndex), mLast(NoIndex), mSize(0) {}
+        };
+
+        struct Slot
+        {
+          bool mUsed;
+          ULONG mGeneration;
+          ChannelNumber mChannelNumber;
+          Value mValue;
+
+          Link mLinks[List_Last + 1];
+          size_t mNextFree;
+
+          Slot() : mUsed(false), mGeneration(1), mChannelNumber(0), mNextFree(NoIndex) {}
+        };
+
+        typedef std::vector<Slot> SlotVector;
+        typedef std::vector<size_t> IndexVector;
+
+      public:
+        ChannelTable() :
+          mFreeSlot(NoIndex),
+          mUsed(0),
+          mIndexMask(0),
+          mIndexErased(0),
+          mLastFound(NoIndex)
+        {
+          mIndex.resize(16, NoIndex);
+          mIndexMask = mIndex.size() - 1;
+        }
+
+        //---------------------------------------------------------------------
+        Handle insert(
+                      ChannelNumber channelNumber,
+                      const Value &value
+                      )
+        {
+          Handle existing = find(channelNumber);
+          if (!existing.isEmpty()) {
+            mSlots[existing.mIndex].mValue = value;
+            return existing;
+          }
+
+          size_t index = mFreeSlot;
+          if (NoIndex != index) {
+            mFreeSlot = mSlots[index].mNextFree;
+          } else {
+            index = mSlots.size();
+            mSlots.push_back(Slot());
+          }
+
+          Slot &slot = mSlots[index];
+          slot.mUsed = true;
+          slot.mChannelNumber = channelNumber;
+          slot.mValue = value;
+          slot.mNextFree = NoIndex;
+
+          ++mUsed;
+
+          // keep the index (including erased markers) at or below half full
+          if (((mUsed + mIndexErased) * 2) > mIndex.size()) {
+            size_t capacity = mIndex.size();
+            while ((mUsed * 4) > capacity) {
+              capacity <<= 1;
+            }
+            rehash(capacity);
+          }
+
+          size_t position = findPosition(channelNumber);
+          if (ErasedIndex == mIndex[position]) --mIndexErased;
+          mIndex[position] = index;
+
+          mLastFound = index;
+          return Handle(index, slot.mGeneration);
+        }
+
+        //---------------------------------------------------------------------
+        Handle find(ChannelNumber channelNumber) const
+        {
+          if ((NoIndex != mLastFound) &&
+              (mSlots[mLastFound].mUsed) &&
+              (channelNumber == mSlots[mLastFound].mChannelNumber)) {
+            return Handle(mLastFound, mSlots[mLastFound].mGeneration);
+          }
+
+          size_t index = mIndex[findPosition(channelNumber)];
+          if ((NoIndex == index) ||
+              (ErasedIndex == index)) return Handle();
+
+          mLastFound = index;
+          return Handle(index, mSlots[index].mGeneration);
+        }
+
+        //---------------------------------------------------------------------
+        Value *get(const Handle &handle)
+        {
+          if (!isValid(handle)) return NULL;
+          return &(mSlots[handle.mIndex].mValue);
+        }
+
+        //---------------------------------------------------------------------
+        Value *get(ChannelNumber channelNumber)
+        {
+          return get(find(channelNumber));
+        }
+
+        //---------------------------------------------------------------------
+        bool isValid(const Handle &handle) const
+        {
+          if (handle.isEmpty()) return false;
+          if (handle.mIndex >= mSlots.size()) return false;
+
+          const Slot &slot = mSlots[handle.mIndex];
+          return (slot.mUsed) && (handle.mGeneration == slot.mGeneration);
+        }
+
+        //---------------------------------------------------------------------
+        ChannelNumber channelNumber(const Handle &handle) const
+        {
+          if (!isValid(handle)) return 0;
+          return mSlots[handle.mIndex].mChannelNumber;
+        }
+
+        //---------------------------------------------------------------------
+        bool erase(const Handle &handle)
+        {
+          if (!isValid(handle)) return false;
+
+          Slot &slot = mSlots[handle.mIndex];
+
+          for (int list = 0; list <= List_Last; ++list) {
+            unlink(handle, static_cast<Lists>(list));
+          }
+
+          mIndex[findPosition(slot.mChannelNumber)] = ErasedIndex;
+          ++mIndexErased;
+
+          slot.mUsed = false;
+          slot.mValue = Value();
+          ++slot.mGeneration;
+          if (0 == slot.mGeneration) slot.mGeneration = 1;
+
+          slot.mNextFree = mFreeSlot;
+          mFreeSlot = handle.mIndex;
+
+          if (mLastFound == handle.mIndex) mLastFound = NoIndex;
+
+          --mUsed;
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        void clear()
+        {
+          // NOTE: generations survive a clear so older handles stay stale
+          for (size_t index = 0; index < mSlots.size(); ++index) {
+            Slot &slot = mSlots[index];
+            if (slot.mUsed) erase(Handle(index, slot.mGeneration));
+          }
+        }
+
+        size_t size() const {return mUsed;}
+        size_t capacity() const {return mSlots.size();}
+
+        //---------------------------------------------------------------------
+        Handle first() const
+        {
+          return nextUsed(0);
+        }
+
+        //---------------------------------------------------------------------
+        Handle next(const Handle &handle) const
+        {
+          return nextUsed(handle.mIndex + 1);
+        }
+
+        //---------------------------------------------------------------------
+        bool link(
+                  const Handle &handle,
+                  Lists list
+                  )
+        {
+          if (!isValid(handle)) return false;
+
+          Link &link = mSlots[handle.mIndex].mLinks[list];
+          if (link.mLinked) return true;
+
+          ListHead &head = mLists[list];
+
+          link.mLinked = true;
+          link.mPrev = head.mLast;
+          link.mNext = NoIndex;
+
+          if (NoIndex != head.mLast) {
+            mSlots[head.mLast].mLinks[list].mNext = handle.mIndex;
+          } else {
+            head.mFirst = handle.mIndex;
+          }
+          head.mLast = handle.mIndex;
+          ++head.mSize;
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        bool unlink(
+                    const Handle &handle,
+                    Lists list
+                    )
+        {
+          if (!isValid(handle)) return false;
+
+          Link &link = mSlots[handle.mIndex].mLinks[list];
+          if (!link.mLinked) return false;
+
+          ListHead &head = mLists[list];
+
+          if (NoIndex != link.mPrev) {
+            mSlots[link.mPrev].mLinks[list].mNext = link.mNext;
+          } else {
+            head.mFirst = link.mNext;
+          }
+
+          if (NoIndex != link.mNext) {
+            mSlots[link.mNext].mLinks[list].mPrev = link.mPrev;
+          } else {
+            head.mLast = link.mPrev;
+          }
+
+          link = Link();
+          --head.mSize;
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        bool isLinked(
+                      const Handle &handle,
+                      Lists list
+                      ) const
+        {
+          if (!isValid(handle)) return false;
+          return mSlots[handle.mIndex].mLinks[list].mLinked;
+        }
+
+        //---------------------------------------------------------------------
+        Handle front(Lists list) const
+        {
+          size_t index = mLists[list].mFirst;
+          if (NoIndex == index) return Handle();
+          return Handle(index, mSlots[index].mGeneration);
+        }
+
+        //---------------------------------------------------------------------
+        Handle next(
+                    const Handle &handle,
+                    Lists list
+                    ) const
+        {
+          if (!isLinked(handle, list)) return Handle();
+
+          size_t index = mSlots[handle.mIndex].mLinks[list].mNext;
+          if (NoIndex == index) return Handle();
+          return Handle(index, mSlots[index].mGeneration);
+        }
+
+        size_t size(Lists list) const {return mLists[list].mSize;}
+
+      protected:
+        //---------------------------------------------------------------------
+        static size_t hash(ChannelNumber channelNumber)
+        {
+          // NOTE: finders tend to hand out consecutive channel numbers so mix
+          //       the bits before masking
+          ULONG result = channelNumber;
+          result ^= (result >> 16);
+          result *= 0x45d9f3bU;
+          result ^= (result >> 16);
+          return static_cast<size_t>(result);
+        }
+
+        //---------------------------------------------------------------------
+        size_t findPosition(ChannelNumber channelNumber) const
+        {
+          // NOTE: returns the position holding the channel number or else the
+          //       first free position found while probing
+          size_t firstErased = NoIndex;
+          size_t position = hash(channelNumber) & mIndexMask;
+
+          while (true) {
+            size_t index = mIndex[position];
+            if (NoIndex == index) return (NoIndex != firstErased ? firstErased : position);
+
+            if (ErasedIndex == index) {
+              if (NoIndex == firstErased) firstErased = position;
+            } else if (channelNumber == mSlots[index].mChannelNumber) {
+              return position;
+            }
+
+            position = (position + 1) & mIndexMask;
+          }
+        }
+
+        //---------------------------------------------------------------------
+        void rehash(size_t capacity)
+        {
+          IndexVector empty(capacity, NoIndex);
+          mIndex.swap(empty);
+          mIndexMask = capacity - 1;
+          mIndexErased = 0;
+
+          for (size_t index = 0; index < mSlots.size(); ++index) {
+            const Slot &slot = mSlots[index];
+            if (!slot.mUsed) continue;
+
+            size_t position = hash(slot.mChannelNumber) & mIndexMask;
+            while (NoIndex != mIndex[position]) {
+              position = (position + 1) & mIndexMask;
+            }
+            mIndex[position] = index;
+          }
+        }
+
+        //---------------------------------------------------------------------
+        Handle nextUsed(size_t index) const
+        {
+          for (; index < mSlots.size(); ++index) {
+            const Slot &slot = mSlots[index];
+            if (slot.mUsed) return Handle(index, slot.mGeneration);
+          }
+          return Handle();
+        }
+
+      private:
+        ChannelTable(const ChannelTable &);
+        ChannelTable &operator=(const ChannelTable &);
+
+      protected:
+        SlotVector mSlots;
+        size_t mFreeSlot;
+        size_t mUsed;
+
+        IndexVector mIndex;
+        size_t mIndexMask;
+        size_t mIndexErased;
+
+        mutable size_t mLastFound;
+
+        ListHead mLists[List_Last + 1];
+      };
+
+      template <typename Value>
+      const size_t ChannelTable<Value>::NoIndex;
+
+      template <typename Value>
+      const size_t ChannelTable<Value>::ErasedIndex;
+
+    }
+  }
+}
@@ -0,0 +1,126 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/internal/types.h>
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelWindow
+      #pragma mark
+
+      // NOTE: credit accounting for one relay channel. The receiving side
+      //       advertises an absolute byte offset (bytes consumed plus the
+      //       window) and the sending side stops once it has sent up to the
+      //       last offset it was given; until the first offset arrives the
+      //       sender is held only by what waits in its own send queue. The
+      //       receiving side refuses to buffer more than a fixed bound
+      //       whether or not the remote party honours the window (or ever
+      //       receives it, as the finder must forward each update).
+      class ChannelWindow
+      {
+      public:
+        ChannelWindow(
+                      size_t window,
+                      size_t maxReceiveBuffered = 0
+                      );
+
+        size_t window() const {return mWindow;}
+        size_t maxReceiveBuffered() const {return mMaxReceiveBuffered;}
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark ChannelWindow => (send side)
+        #pragma mark
+
+        bool hasSendCredit(size_t queuedBytes) const;
+
+        void notifySent(size_t bytes);
+
+        // returns true if the window moved beyond the current send limit
+        bool notifyWindow(QWORD window);
+
+        QWORD sentBytes() const {return mSentBytes;}
+        bool isSendLimitKnown() const {return mSendLimitKnown;}
+        QWORD sendLimit() const {return mSendLimit;}
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark ChannelWindow => (receive side)
+        #pragma mark
+
+        // returns false if accepting the bytes would leave more than the
+        // bound waiting unread (the bytes are not counted)
+        bool notifyReceived(
+                            size_t bytes,
+                            size_t unreadBytes
+                            );
+
+        bool isBeyondAdvertisedWindow() const;
+
+        // returns true (and records it as advertised) when enough has been
+        // consumed to be worth advertising a new window
+        bool needsWindowUpdate(
+                               size_t unreadBytes,
+                               QWORD &outWindow
+                               );
+
+        QWORD receivedBytes() const {return mReceivedBytes;}
+        QWORD advertisedWindow() const {return mAdvertisedWindow;}
+
+        ElementPtr toDebug() const;
+
+      protected:
+        size_t mWindow;
+        size_t mMaxReceiveBuffered;
+
+        QWORD mSentBytes;
+        QWORD mSendLimit;
+        bool mSendLimitKnown;
+
+        QWORD mReceivedBytes;
+        QWORD mAdvertisedWindow;
+      };
+
+    }
+  }
+}
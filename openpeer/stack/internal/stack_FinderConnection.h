@@ -32,11 +32,16 @@
 #pragma once
 
 #include <openpeer/stack/internal/types.h>
+#include <openpeer/stack/internal/stack_ChannelSendScheduler.h>
+#include <openpeer/stack/internal/stack_ChannelTable.h>
+#include <openpeer/stack/internal/stack_ChannelWindow.h>
 #include <openpeer/stack/internal/stack_IFinderConnectionRelayChannel.h>
 #include <openpeer/stack/internal/stack_IFinderConnection.h>
 #include <openpeer/stack/internal/stack_IFinderRelayChannel.h>
+#include <openpeer/stack/internal/stack_WakeOnce.h>
 
 #include <openpeer/stack/message/types.h>
+#include <openpeer/stack/message/MessageWriter.h>
 #include <openpeer/stack/message/peer-finder/ChannelMapResult.h>
 
 #include <openpeer/stack/IMessageMonitor.h>
@@ -52,6 +57,14 @@
 #include <map>
 
 #define OPENPEER_STACK_SETTING_FINDER_CONNECTION_MUST_SEND_PING_IF_NO_SEND_ACTIVITY_IN_SECONDS "openpeer/stack/finder-connection-send-ping-keep-alive-after-in-seconds"
+#define OPENPEER_STACK_SETTING_FINDER_CONNECTION_SEND_QUANTUM_IN_BYTES "openpeer/stack/finder-connection-send-quantum-in-bytes"
+#define OPENPEER_STACK_SETTING_FINDER_CONNECTION_SEND_LOW_WATER_MARK_IN_BYTES "openpeer/stack/finder-connection-send-low-water-mark-in-bytes"
+#define OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_WINDOW_IN_BYTES "openpeer/stack/finder-connection-channel-window-in-bytes"
+#define OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_FLOW_CONTROL "openpeer/stack/finder-connection-channel-flow-control"
+#define OPENPEER_STACK_SETTING_FINDER_CONNECTION_CHANNEL_MAX_RECEIVE_BUFFERED_IN_BYTES "openpeer/stack/finder-connection-channel-max-receive-buffered-in-bytes"
+#define OPENPEER_STACK_SETTING_FINDER_CONNECTION_POOL_MAX_CONNECTIONS "openpeer/stack/finder-connection-pool-max-connections"
+#define OPENPEER_STACK_SETTING_FINDER_CONNECTION_POOL_GROW_AT_BYTES_PER_SECOND "openpeer/stack/finder-connection-pool-grow-at-bytes-per-second"
+#define OPENPEER_STACK_SETTING_FINDER_CONNECTION_MAX_CHANNEL_MAP_REQUESTS_IN_FLIGHT "openpeer/stack/finder-connection-max-channel-map-requests-in-flight"
 
 namespace openpeer
 {
@@ -98,9 +111,11 @@ namespace openpeer
         ZS_DECLARE_CLASS_PTR(Channel)
 
         typedef IFinderConnection::ChannelNumber ChannelNumber;
-        typedef std::map<ChannelNumber, ChannelPtr> ChannelMap;
 
-        typedef boost::value_initialized<ChannelNumber> AutoChannelNumber;
+        typedef ChannelTable<ChannelPtr> Channels;
+        typedef Channels::Handle ChannelHandle;
+
+        typedef ChannelSendScheduler::QueuePtr SendQueuePtr;
 
       protected:
         FinderConnection(
@@ -246,10 +261,15 @@ namespace openpeer
         void notifyOuterWriterReady();
 
         void sendBuffer(
-                        ChannelNumber channelNumber,
+                        SendQueuePtr queue,
                         SecureByteBlockPtr buffer
                         );
-        void notifyDestroyed(ChannelNumber channelNumber);
+        void notifyDestroyed(ChannelHandle channel);
+
+        void sendWindow(
+                        ChannelNumber channelNumber,
+                        QWORD window
+                        );
 
       protected:
         //---------------------------------------------------------------------
@@ -277,6 +297,18 @@ namespace openpeer
         bool stepReceiveData();
         bool stepSelfDestruct();
 
+        ChannelHandle addChannel(
+                                 ChannelNumber channelNumber,
+                                 ChannelPtr channel
+                                 );
+
+        void sendScheduled();
+        void sampleThroughput(Time tick);
+
+        ChannelHandle findMapRequest(IMessageMonitorPtr monitor);
+
+        bool handleChannelWindowNotify(const message::MessageEnvelope &envelope);
+
         IFinderConnectionRelayChannelPtr connect(
                                                  IFinderConnectionRelayChannelDelegatePtr delegate,
                                                  const char *localContextID,
@@ -415,6 +447,9 @@ namespace openpeer
 
           void notifyDataReceived(SecureByteBlockPtr buffer);
 
+          void notifyWindow(QWORD window);
+          void notifyFlowControlCheck();
+
           void getStreams(
                           ITransportStreamPtr &outReceiveStream,
                           ITransportStreamPtr &outSendStream
@@ -440,6 +475,9 @@ namespace openpeer
 
           void step();
           bool stepSendData();
+          bool stepReceiveWindow();
+
+          bool hasSendCredit() const;
 
         protected:
           AutoPUID mID;
@@ -455,6 +493,9 @@ namespace openpeer
           String mLastErrorReason;
 
           ChannelNumber mChannelNumber;
+          ChannelHandle mSlot;
+          SendQueuePtr mSendQueue;
+          IMessageMonitorPtr mMapRequestMonitor;
 
           ITransportStreamWriterPtr mOuterReceiveStream;
           ITransportStreamWriterSubscriptionPtr mOuterReceiveStreamSubscription;
@@ -464,6 +505,10 @@ namespace openpeer
           AutoBool mWireStreamNotifiedReady;
           AutoBool mOuterStreamNotifiedReady;
 
+          ChannelWindow mWindow;
+          bool mFlowControl;
+          AutoBool mSendHeld;
+
           ConnectionInfo mConnectionInfo;
 
           IFinderRelayChannelSubscriptionPtr mRelayChannelSubscription;
@@ -477,6 +522,7 @@ namespace openpeer
 
         AutoPUID mID;
         FinderConnectionWeakPtr mThisWeak;
+        WakeOnce mWake;
 
         FinderConnectionManagerWeakPtr mOuter;
 
@@ -500,14 +546,25 @@ namespace openpeer
         Time mLastSentData;
         TimerPtr mPingTimer;
 
-        ChannelMap mChannels;
+        Channels mChannels;
+
+        ChannelSendScheduler mSendScheduler;
+        SendQueuePtr mControlQueue;
+        size_t mSendLowWaterMark;
+
+        size_t mChannelWindow;
+        bool mFlowControl;
+        size_t mChannelMaxReceiveBuffered;
+
+        QWORD mTotalBytesSent;
+        QWORD mTotalBytesReceived;
+        QWORD mThroughput;
+        Time mThroughputSampledAt;
+        QWORD mThroughputSampledBytes;
 
-        ChannelMap mPendingMapRequest;
-        ChannelMap mIncomingChannels;
-        ChannelMap mRemoveChannels;
+        size_t mMaxMapRequestsInFlight;
 
-        IMessageMonitorPtr mMapRequestChannelMonitor;
-        AutoChannelNumber mMapRequestChannelNumber;
+        MessageWriter mMessageWriter;
       };
 
       //-----------------------------------------------------------------------
@@ -88,6 +88,21 @@ namespace openpeer
 
         static const char *getJavaScriptLogLevel();
 
+        //---------------------------------------------------------------------
+        // PURPOSE: FNV-1a hash sized to size_t (64-bit constants when size_t
+        //          is 64 bits wide); pass a previous result to continue
+        //          hashing more data as if it were appended
+        static size_t hashSeed();
+        static size_t hash(
+                           const BYTE *buffer,
+                           size_t length,
+                           size_t previous = hashSeed()
+                           );
+        static size_t hash(
+                           const char *str,
+                           size_t previous = hashSeed()
+                           );
+
       protected:
         static Log::Params log(const char *message);
       };
@@ -0,0 +1,169 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/internal/types.h>
+
+#include <zsLib/MessageQueue.h>
+
+#include <map>
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      ZS_DECLARE_USING_PTR(zsLib, IMessageQueueMessage)
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark InstrumentedMessageQueue
+      #pragma mark
+
+      // NOTE: wraps a message queue to record how long each posted message
+      //       waited before executing (dwell), how long it took to execute,
+      //       the queue depth seen by each post and how many times each
+      //       proxy method was posted.
+      class InstrumentedMessageQueue : public IMessageQueue
+      {
+      public:
+        friend class InstrumentedMessageQueueMessage;
+
+        enum HistogramBuckets
+        {
+          HistogramBuckets_Total = 10,
+        };
+
+        struct Histogram
+        {
+          Histogram();
+
+          void record(ULONG value);
+          ElementPtr toDebug(
+                             const char *name,
+                             const ULONG *upperBounds,
+                             const char *units
+                             ) const;
+
+          ULONG mCount;
+          ULONG mMax;
+          double mSum;
+          ULONG mBuckets[HistogramBuckets_Total];
+        };
+
+        typedef String MethodName;
+        typedef std::map<MethodName, ULONG> MethodCountMap;
+
+      protected:
+        InstrumentedMessageQueue(
+                                 IMessageQueuePtr queue,
+                                 const char *name
+                                 );
+
+      public:
+        ~InstrumentedMessageQueue();
+
+        static InstrumentedMessageQueuePtr create(
+                                                  IMessageQueuePtr queue,
+                                                  const char *name
+                                                  );
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark InstrumentedMessageQueue => IMessageQueue
+        #pragma mark
+
+        virtual void post(IMessageQueueMessagePtr message);
+
+        virtual size_type getTotalUnprocessedMessages() const;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark InstrumentedMessageQueue => friend Stack
+        #pragma mark
+
+        const String &getName() const {return mName;}
+        IMessageQueuePtr getQueue() const {return mQueue;}
+
+        ElementPtr getStatistics(bool resetAfterSnapshot);
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark InstrumentedMessageQueue => friend InstrumentedMessageQueueMessage
+        #pragma mark
+
+        void notifyStarted(Duration dwell);
+        void notifyCompleted(Duration execution);
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark InstrumentedMessageQueue => (internal)
+        #pragma mark
+
+        Log::Params log(const char *message) const;
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark InstrumentedMessageQueue => (data)
+        #pragma mark
+
+        AutoPUID mID;
+        mutable RecursiveLock mLock;
+        InstrumentedMessageQueueWeakPtr mThisWeak;
+
+        IMessageQueuePtr mQueue;
+        String mName;
+
+        Time mSince;
+
+        ULONG mDepth;
+        ULONG mTotalPosted;
+        ULONG mTotalProcessed;
+
+        Histogram mDwell;
+        Histogram mExecution;
+        Histogram mDepthOnPost;
+
+        MethodCountMap mMethodCounts;
+      };
+
+    }
+  }
+}
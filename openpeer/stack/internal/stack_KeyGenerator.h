@@ -39,12 +39,27 @@
 
 #include <zsLib/MessageQueueAssociator.h>
 
+#define OPENPEER_STACK_SETTING_KEY_GENERATOR_RSA_RESERVOIR_DEPTH "openpeer/stack/key-generator-rsa-reservoir-depth"
+
 namespace openpeer
 {
   namespace stack
   {
     namespace internal
     {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark IKeyGeneratorForStack
+      #pragma mark
+
+      interaction IKeyGeneratorForStack
+      {
+        static void fillReservoir();
+      };
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -62,6 +77,7 @@ namespace openpeer
       public:
         friend interaction IKeyGeneratorFactory;
         friend interaction IKeyGenerator;
+        friend interaction IKeyGeneratorForStack;
 
       protected:
         KeyGenerator(
@@ -165,6 +181,10 @@ namespace openpeer
 
         size_t mDHKeyDomainKeyLength;
         IDHKeyDomainPtr mDHKeyDomain;
+
+        Time mQueuedAt;
+        Duration mQueueWaitDuration;
+        Duration mComputeDuration;
       };
 
       //-----------------------------------------------------------------------
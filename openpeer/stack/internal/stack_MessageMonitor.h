@@ -33,9 +33,9 @@
 
 #include <openpeer/stack/IMessageMonitor.h>
 #include <openpeer/stack/internal/types.h>
+#include <openpeer/stack/internal/stack_TimerWheel.h>
 
 #include <zsLib/MessageQueueAssociator.h>
-#include <zsLib/Timer.h>
 
 namespace openpeer
 {
@@ -100,7 +100,7 @@ namespace openpeer
                              public IMessageMonitor,
                              public IMessageMonitorAsyncDelegate,
                              public IMessageMonitorForMessageMonitorManager,
-                             public ITimerDelegate
+                             public ITimerWheelDelegate
       {
       public:
         friend interaction IMessageMonitorFactory;
@@ -159,6 +159,11 @@ namespace openpeer
                                                          );
 
         static bool handleMessageReceived(message::MessagePtr message);
+        static bool handleMessageReceived(
+                                          const message::MessageEnvelope &envelope,
+                                          IMessageSourcePtr messageSource,
+                                          message::MessagePtr &outMessage
+                                          );
 
         virtual PUID getID() const {return mID;}
 
@@ -197,10 +202,10 @@ namespace openpeer
 
         //---------------------------------------------------------------------
         #pragma mark
-        #pragma mark MessageMonitor => ITimerDelegate
+        #pragma mark MessageMonitor => ITimerWheelDelegate
         #pragma mark
 
-        virtual void onTimer(TimerPtr timer);
+        virtual void onTimerWheelExpired(TimerWheelEntryPtr entry);
 
       protected:
         //---------------------------------------------------------------------
@@ -230,7 +235,7 @@ namespace openpeer
         bool mTimeoutFired;
         ULONG mPendingHandled;
 
-        TimerPtr mTimer;
+        TimerWheelEntryPtr mTimer;
         Time mExpires;
         message::MessagePtr mOriginalMessage;
 
@@ -32,6 +32,8 @@
 #pragma once
 
 #include <openpeer/stack/internal/types.h>
+#include <openpeer/stack/internal/stack_MessageMonitorTable.h>
+#include <openpeer/stack/internal/stack_WakeOnce.h>
 #include <openpeer/services/IWakeDelegate.h>
 
 #include <map>
@@ -96,6 +98,8 @@ namespace openpeer
 
         virtual void monitorEnd(MessageMonitor &monitor) = 0;
 
+        virtual bool isMonitoring(const String &messageID) = 0;
+
         virtual bool handleMessage(message::MessagePtr message) = 0;
 
         virtual void trackSentViaObjectID(
@@ -112,6 +116,11 @@ namespace openpeer
       #pragma mark MessageMonitorManager
       #pragma mark
 
+      // NOTE: monitors are striped across shards by message ID, each with
+      //       its own lock, so accounts pinned to different stack queues do
+      //       not serialize on one lock when starting, ending or matching
+      //       monitors; only sender object gone notifications visit every
+      //       shard.
       class MessageMonitorManager : public Noop,
                                     public MessageQueueAssociator,
                                     public SharedRecursiveLock,
@@ -130,19 +139,39 @@ namespace openpeer
         typedef std::list<MessagePtr> PendingMessageSendFailureMessageList;
         typedef std::list<SentViaObjectID> PendingSenderObjectGoneList;
 
-        typedef String MessageID;
-        typedef std::map<MessageID, SentViaObjectID> SentViaObjectMap;
+        typedef MessageMonitorTable::MessageID MessageID;
+        typedef MessageMonitorTable::Hash MessageIDHash;
 
         typedef Time Expiry;
         typedef std::pair<MessageID, Expiry> MessageExpiryPair;
         typedef std::list<MessageExpiryPair> MessageExpiryList;
 
-        typedef PUID MonitorID;
-        typedef std::map<MonitorID, UseMessageMonitorWeakPtr> MonitorMap;
+        typedef MessageMonitorTable::MonitorID MonitorID;
+        typedef MessageMonitorTable::MonitorMap MonitorMap;
+        typedef MessageMonitorTable::MonitorPairList MonitorPairList;
+
+        typedef std::map<SentViaObjectID, MonitorMap> SentViaMonitorsMap;
+        typedef std::map<MonitorID, SentViaObjectID> MonitorSentViaMap;
+
+        typedef std::list<UseMessageMonitorPtr> MonitorList;
+
+        enum Sizes
+        {
+          Sizes_ShardBits = 4,
+          Sizes_Shards = (1 << Sizes_ShardBits),
+        };
+
+        struct Shard
+        {
+          mutable RecursiveLock mLock;
 
-        ZS_DECLARE_PTR(MonitorMap)
+          MessageMonitorTable mMonitors;            // outstanding monitors and sent via object per message ID
 
-        typedef std::map<MessageID, MonitorMapPtr> MonitorsMap;
+          SentViaMonitorsMap mMonitorsBySentVia;    // reverse index used when a sender object goes away
+          MonitorSentViaMap mSentViaByMonitor;
+
+          MessageExpiryList mExpiredSentViaObjectIDs;
+        };
 
       protected:
         MessageMonitorManager();
@@ -172,6 +201,8 @@ namespace openpeer
 
         virtual void monitorEnd(MessageMonitor &monitor);
 
+        virtual bool isMonitoring(const String &messageID);
+
         virtual bool handleMessage(message::MessagePtr message);
 
         virtual void trackSentViaObjectID(
@@ -222,6 +253,37 @@ namespace openpeer
         Log::Params log(const char *message) const;
         static Log::Params slog(const char *message);
 
+        Shard &shardFor(MessageIDHash messageIDHash);
+
+        void collectMonitors(
+                             Shard &shard,
+                             const MessageID &messageID,
+                             MessageIDHash messageIDHash,
+                             MonitorList &outMonitors
+                             );
+        void removeMonitor(
+                           Shard &shard,
+                           const MessageID &messageID,
+                           MessageIDHash messageIDHash,
+                           MonitorID monitorID
+                           );
+
+        void indexSentVia(
+                          Shard &shard,
+                          SentViaObjectID sentViaObjectID,
+                          MonitorID monitorID,
+                          UseMessageMonitorWeakPtr monitor
+                          );
+        void unindexSentVia(
+                            Shard &shard,
+                            MonitorID monitorID
+                            );
+        void collectSentViaMonitors(
+                                    Shard &shard,
+                                    SentViaObjectID sentViaObjectID,
+                                    MonitorList &outMonitors
+                                    );
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -229,19 +291,17 @@ namespace openpeer
         #pragma mark
 
         AutoPUID mID;
-        mutable RecursiveLock mLock;
+        mutable RecursiveLock mLock;              // guards pending notifications and the timer only
         MessageMonitorManagerWeakPtr mThisWeak;
+        WakeOnce mWake;
 
-        MonitorsMap mMonitors;
+        Shard mShards[Sizes_Shards];
 
         PendingMessageSendFailureMessageList mPendingFailures;
         PendingSenderObjectGoneList mPendingGone;
 
         MessageExpiryList mMessageExpiryList;
 
-        SentViaObjectMap mSentViaObjectIDs;
-        MessageExpiryList mExpiredSentViaObjectIDs;
-
         TimerPtr mTimer;
       };
 
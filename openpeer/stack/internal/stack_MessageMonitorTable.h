@@ -0,0 +1,174 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/internal/types.h>
+
+#include <map>
+#include <list>
+#include <vector>
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      interaction IMessageMonitorForMessageMonitorManager;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageMonitorTable
+      #pragma mark
+
+      // NOTE: open addressing (linear probing) table of outstanding message
+      //       IDs; each entry keeps its hash so probing and rehashing never
+      //       recompute it, holds a single monitor inline and only allocates
+      //       an overflow map when a message ID gets more than one monitor.
+      //       Entry pointers remain valid only until the next insert() or
+      //       eraseIfUnused().
+      class MessageMonitorTable
+      {
+      public:
+        ZS_DECLARE_TYPEDEF_PTR(IMessageMonitorForMessageMonitorManager, UseMessageMonitor)
+
+        typedef String MessageID;
+        typedef size_t Hash;
+        typedef PUID MonitorID;
+        typedef PUID SentViaObjectID;
+
+        typedef std::map<MonitorID, UseMessageMonitorWeakPtr> MonitorMap;
+        ZS_DECLARE_PTR(MonitorMap)
+
+        typedef std::pair<MonitorID, UseMessageMonitorWeakPtr> MonitorPair;
+        typedef std::list<MonitorPair> MonitorPairList;
+
+        struct Entry
+        {
+          Hash mHash;
+          MessageID mMessageID;
+
+          MonitorID mMonitorID;                 // 0 if no inline monitor
+          UseMessageMonitorWeakPtr mMonitor;
+          MonitorMapPtr mOverflow;
+
+          SentViaObjectID mSentViaObjectID;     // 0 if not tracked
+
+          Entry();
+
+          void addMonitor(
+                          MonitorID monitorID,
+                          UseMessageMonitorWeakPtr monitor
+                          );
+          bool removeMonitor(MonitorID monitorID);
+
+          bool hasMonitors() const;
+          size_t totalMonitors() const;
+          void getMonitors(MonitorPairList &outMonitors) const;
+
+          bool isUnused() const;
+        };
+
+      protected:
+        enum SlotStates
+        {
+          SlotState_Empty,
+          SlotState_Used,
+          SlotState_Erased,
+        };
+
+        struct Slot
+        {
+          SlotStates mState;
+          Entry mEntry;
+
+          Slot() : mState(SlotState_Empty) {}
+        };
+
+        typedef std::vector<Slot> SlotVector;
+
+      public:
+        MessageMonitorTable(size_t initialCapacity = 64);
+        ~MessageMonitorTable();
+
+        static Hash hash(const MessageID &messageID);
+
+        Entry *find(const MessageID &messageID) {return find(messageID, hash(messageID));}
+        Entry *find(
+                    const MessageID &messageID,
+                    Hash messageIDHash
+                    );
+
+        Entry *insert(const MessageID &messageID) {return insert(messageID, hash(messageID));}
+        Entry *insert(
+                      const MessageID &messageID,
+                      Hash messageIDHash
+                      );
+
+        bool eraseIfUnused(Entry *entry);
+
+        void clear();
+
+        size_t size() const {return mUsed;}
+        size_t capacity() const {return mSlots.size();}
+
+        ElementPtr toDebug() const;
+
+      protected:
+        size_t findSlot(
+                        const MessageID &messageID,
+                        Hash messageIDHash
+                        ) const;
+        void rehash(size_t capacity);
+
+      private:
+        MessageMonitorTable(const MessageMonitorTable &);
+        MessageMonitorTable &operator=(const MessageMonitorTable &);
+
+      protected:
+        SlotVector mSlots;
+        size_t mMask;
+
+        size_t mUsed;
+        size_t mErased;
+        size_t mMinCapacity;
+
+        ULONG mTotalRehashes;
+      };
+
+    }
+  }
+}
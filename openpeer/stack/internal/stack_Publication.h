@@ -33,10 +33,10 @@
 
 #include <openpeer/stack/internal/types.h>
 #include <openpeer/stack/internal/stack_PublicationMetaData.h>
+#include <openpeer/stack/internal/stack_TimerWheel.h>
 #include <openpeer/stack/IPublication.h>
 
 #include <zsLib/Exception.h>
-#include <zsLib/Timer.h>
 
 #include <boost/shared_array.hpp>
 
@@ -482,7 +482,7 @@ namespace openpeer
 
         class CacheableDocument : public MessageQueueAssociator,
                                   public SharedRecursiveLock,
-                                  public ITimerDelegate
+                                  public ITimerWheelDelegate
         {
         protected:
           CacheableDocument(
@@ -508,10 +508,10 @@ namespace openpeer
         protected:
           //-------------------------------------------------------------------
           #pragma mark
-          #pragma mark Publication::CacheableDocument => ITimerDelegate
+          #pragma mark Publication::CacheableDocument => ITimerWheelDelegate
           #pragma mark
 
-          void onTimer(TimerPtr timer);
+          void onTimerWheelExpired(TimerWheelEntryPtr entry);
 
         protected:
           //-------------------------------------------------------------------
@@ -541,7 +541,7 @@ namespace openpeer
           mutable size_t mOutputSize;
 
           mutable AutoBool mPreviouslyStored;
-          mutable TimerPtr mMoveToCacheTimer;
+          mutable TimerWheelEntryPtr mMoveToCacheTimer;
         };
 
         //---------------------------------------------------------------------
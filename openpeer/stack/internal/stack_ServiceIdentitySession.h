@@ -46,10 +46,10 @@
 #include <openpeer/stack/message/rolodex/RolodexContactsGetResult.h>
 
 #include <openpeer/stack/internal/stack_ServiceNamespaceGrantSession.h>
+#include <openpeer/stack/internal/stack_TimerWheel.h>
 
 #include <openpeer/services/IWakeDelegate.h>
 
-#include <zsLib/Timer.h>
 #include <zsLib/MessageQueueAssociator.h>
 
 #include <list>
@@ -133,7 +133,7 @@ namespace openpeer
                                      public IServiceIdentitySessionForServiceLockbox,
                                      public IWakeDelegate,
                                      public IBootstrappedNetworkDelegate,
-                                     public zsLib::ITimerDelegate,
+                                     public ITimerWheelDelegate,
                                      public IServiceNamespaceGrantSessionWaitDelegate,
                                      public IServiceNamespaceGrantSessionQueryDelegate,
                                      public IMessageMonitorResultDelegate<IdentityAccessLockboxUpdateResult>,
@@ -313,10 +313,10 @@ namespace openpeer
 
         //---------------------------------------------------------------------
         #pragma mark
-        #pragma mark ServiceIdentitySession => ITimerDelegate
+        #pragma mark ServiceIdentitySession => ITimerWheelDelegate
         #pragma mark
 
-        virtual void onTimer(TimerPtr timer);
+        virtual void onTimerWheelExpired(TimerWheelEntryPtr entry);
 
         //---------------------------------------------------------------------
         #pragma mark
@@ -548,7 +548,7 @@ namespace openpeer
         AutoBool mRolodexNotSupportedForIdentity;
         RolodexInfo mRolodexInfo;
 
-        TimerPtr mTimer;
+        TimerWheelEntryPtr mTimer;
 
         String mFrozenVersion;
 
@@ -34,8 +34,13 @@
 #include <openpeer/stack/internal/types.h>
 #include <openpeer/stack/IStack.h>
 
+#include <zsLib/MessageQueueAssociator.h>
+
 #define OPENPEER_STACK_SETTING_STACK_STACK_THREAD_PRIORITY "openpeer/stack/stack-thread-priority"
 #define OPENPEER_STACK_SETTING_STACK_KEY_GENERATION_THREAD_PRIORITY "openpeer/stack/key-generation-thread-priority"
+#define OPENPEER_STACK_SETTING_STACK_TOTAL_STACK_THREADS "openpeer/stack/total-stack-threads"
+#define OPENPEER_STACK_SETTING_STACK_TOTAL_KEY_GENERATION_THREADS "openpeer/stack/total-key-generation-threads"
+#define OPENPEER_STACK_SETTING_STACK_QUEUE_STATISTICS_ENABLED "openpeer/stack/queue-statistics-enabled"
 
 namespace openpeer
 {
@@ -57,9 +62,40 @@ namespace openpeer
 
         static IMessageQueuePtr queueDelegate();
         static IMessageQueuePtr queueStack();
+        static IMessageQueuePtr queueStackShard();
         static IMessageQueuePtr queueServices();
         static IMessageQueuePtr queueKeyGeneration();
 
+        // NOTE: hands out the key generation workers in round-robin order
+        //       (queueKeyGeneration() always returns the same worker)
+        static IMessageQueuePtr queueKeyGenerationWorker();
+
+        // NOTE: the stack queue shards by index for objects that keep one
+        //       instance per shard
+        static ULONG totalStackShards();
+        static IMessageQueuePtr queueStackShard(ULONG index);
+        static bool isStackShard(IMessageQueuePtr queue);
+
+        //---------------------------------------------------------------------
+        // PURPOSE: returns the stack queue shard the object is associated with
+        //          (if the object is a MessageQueueAssociator bound to one of
+        //          the stack queue shards), otherwise the next stack queue
+        //          shard
+        // NOTE:    used so objects owned by an account stay on the account's
+        //          stack queue shard; an object associated with any other
+        //          queue (e.g. an application delegate on its own queue) never
+        //          moves stack work off the stack queues
+        template <typename TObjectPtr>
+        static IMessageQueuePtr queueStackFor(TObjectPtr object)
+        {
+          MessageQueueAssociator *associator = dynamic_cast<MessageQueueAssociator *>(object.get());
+          if (associator) {
+            IMessageQueuePtr queue = associator->getAssociatedMessageQueue();
+            if (isStackShard(queue)) return queue;
+          }
+          return queueStackShard();
+        }
+
         static void logInstanceInformation();
       };
 
@@ -78,6 +114,9 @@ namespace openpeer
         friend interaction IStack;
         friend interaction IStackForInternal;
 
+        typedef std::vector<IMessageQueuePtr> MessageQueueArray;
+        typedef std::list<InstrumentedMessageQueuePtr> InstrumentedMessageQueueList;
+
       protected:
         Stack();
 
@@ -102,8 +141,17 @@ namespace openpeer
                            IMessageQueuePtr keyGenerationQueue
                            );
 
+        virtual void setup(
+                           IMessageQueuePtr defaultDelegateMessageQueue,
+                           const MessageQueueList &stackMessageQueues,
+                           IMessageQueuePtr servicesMessageQueue,
+                           IMessageQueuePtr keyGenerationQueue
+                           );
+
         virtual PUID getID() const {return mID;}
 
+        virtual ElementPtr getQueueStatistics(bool resetAfterSnapshot);
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark Stack => IStackForInternal
@@ -113,8 +161,14 @@ namespace openpeer
 
         virtual IMessageQueuePtr queueDelegate() const;
         virtual IMessageQueuePtr queueStack();
+        virtual IMessageQueuePtr queueStackShard();
         virtual IMessageQueuePtr queueServices();
         virtual IMessageQueuePtr queueKeyGeneration();
+        virtual IMessageQueuePtr queueKeyGenerationWorker();
+
+        virtual ULONG totalStackShards();
+        virtual IMessageQueuePtr queueStackShard(ULONG index);
+        virtual bool isStackShard(IMessageQueuePtr queue);
 
         virtual void logInstanceInformation();
 
@@ -126,6 +180,12 @@ namespace openpeer
         Log::Params log(const char *message) const;
         static Log::Params slog(const char *message);
         void verifySettingIsSet(const char *settingName);
+        void prepareStackQueues();
+        void prepareKeyGenerationQueues();
+        IMessageQueuePtr instrument(
+                                    IMessageQueuePtr queue,
+                                    const String &name
+                                    );
 
       protected:
         //---------------------------------------------------------------------
@@ -138,9 +198,13 @@ namespace openpeer
         mutable RecursiveLock mLock;
 
         IMessageQueuePtr mDelegateQueue;
-        IMessageQueuePtr mStackQueue;
+        MessageQueueArray mStackQueues;   // [0] is the primary stack queue
+        ULONG mNextStackQueue;
         IMessageQueuePtr mServicesQueue;
-        IMessageQueuePtr mKeyGenerationQueue;
+        MessageQueueArray mKeyGenerationQueues;   // pool of key generation workers
+        ULONG mNextKeyGenerationQueue;
+
+        InstrumentedMessageQueueList mInstrumentedQueues;
       };
     }
   }
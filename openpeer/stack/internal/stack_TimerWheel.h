@@ -0,0 +1,277 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/internal/types.h>
+
+#include <zsLib/MessageQueueAssociator.h>
+#include <zsLib/Timer.h>
+
+#include <list>
+#include <vector>
+
+#define OPENPEER_STACK_SETTING_TIMER_WHEEL_RESOLUTION_IN_MILLISECONDS "openpeer/stack/timer-wheel-resolution-in-milliseconds"
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace internal
+    {
+      interaction IStackForInternal;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ITimerWheelForInternal
+      #pragma mark
+
+      interaction ITimerWheelForInternal
+      {
+        // NOTE: arms a one shot timeout on the stack wide timer wheel; the
+        //       returned entry is passed back to the delegate when the
+        //       timeout expires and can be cancelled at any time.
+        static TimerWheelEntryPtr arm(
+                                      ITimerWheelDelegatePtr delegate,
+                                      Duration timeout
+                                      );
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ITimerWheelDelegate
+      #pragma mark
+
+      interaction ITimerWheelDelegate
+      {
+        virtual void onTimerWheelExpired(TimerWheelEntryPtr entry) = 0;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TimerWheelEntry
+      #pragma mark
+
+      class TimerWheelEntry
+      {
+      public:
+        friend class TimerWheel;
+
+        typedef std::list<TimerWheelEntryPtr> EntryList;
+
+      protected:
+        TimerWheelEntry(
+                        TimerWheelPtr wheel,
+                        ITimerWheelDelegatePtr delegate,
+                        Time expires
+                        );
+
+      public:
+        ~TimerWheelEntry();
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TimerWheelEntry => (for consumers)
+        #pragma mark
+
+        PUID getID() const {return mID;}
+        Time getExpires() const {return mExpires;}
+
+        void cancel();
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TimerWheelEntry => (data)
+        #pragma mark
+
+        AutoPUID mID;
+        TimerWheelWeakPtr mWheel;
+
+        ITimerWheelDelegatePtr mDelegate;
+
+        Time mExpires;
+        ULONG mExpiresTick;
+
+        EntryList *mSlot;
+        EntryList::iterator mPosition;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TimerWheel
+      #pragma mark
+
+      // NOTE: hierarchical timing wheel (256 slots of one tick each followed
+      //       by three levels of 64 slots) driven from a single one shot
+      //       zsLib timer armed for the next tick holding entries (or the
+      //       next cascade); arming and cancelling are O(1) and an idle or
+      //       sparse wheel does not wake every tick. One wheel exists per
+      //       stack queue shard (each with its own lock) and entries are
+      //       armed on the wheel of their delegate's queue.
+      class TimerWheel : public MessageQueueAssociator,
+                         public ITimerDelegate
+      {
+      public:
+        friend interaction ITimerWheelForInternal;
+        friend class TimerWheelEntry;
+
+        ZS_DECLARE_TYPEDEF_PTR(IStackForInternal, UseStack)
+
+        typedef TimerWheelEntry::EntryList EntryList;
+        typedef std::vector<TimerWheelPtr> TimerWheelArray;
+
+        enum Sizes
+        {
+          Sizes_FirstLevelBits = 8,
+          Sizes_OtherLevelBits = 6,
+
+          Sizes_FirstLevelSlots = (1 << Sizes_FirstLevelBits),
+          Sizes_OtherLevelSlots = (1 << Sizes_OtherLevelBits),
+
+          Sizes_OtherLevels = 3,
+        };
+
+      protected:
+        TimerWheel(IMessageQueuePtr queue);
+
+        void init();
+
+        static TimerWheelPtr create();
+        static TimerWheelPtr create(IMessageQueuePtr queue);
+
+      public:
+        ~TimerWheel();
+
+        static TimerWheelPtr singleton();
+        static TimerWheelPtr singleton(IMessageQueuePtr queue);
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TimerWheel => friend ITimerWheelForInternal
+        #pragma mark
+
+        TimerWheelEntryPtr arm(
+                               ITimerWheelDelegatePtr delegate,
+                               Duration timeout
+                               );
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TimerWheel => friend TimerWheelEntry
+        #pragma mark
+
+        void cancel(TimerWheelEntry &entry);
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TimerWheel => ITimerDelegate
+        #pragma mark
+
+        virtual void onTimer(TimerPtr timer);
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TimerWheel => (internal)
+        #pragma mark
+
+        Log::Params log(const char *message) const;
+        static Log::Params slog(const char *message);
+        Log::Params debug(const char *message) const;
+
+        virtual ElementPtr toDebug() const;
+
+        TimerWheelPtr forQueue(IMessageQueuePtr queue);
+
+        virtual Time currentTime() const;
+        ULONG toTick(Time when, bool roundUp) const;
+
+        void insert(TimerWheelEntryPtr entry);
+        ULONG nextTick() const;
+        void scheduleTimer();
+        void advance(
+                     ULONG nowTick,
+                     EntryList &outExpired
+                     );
+        ULONG cascade(
+                      ULONG level,
+                      ULONG index
+                      );
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark TimerWheel => (data)
+        #pragma mark
+
+        AutoPUID mID;
+        mutable RecursiveLock mLock;
+        TimerWheelWeakPtr mThisWeak;
+
+        TimerWheelArray mShards;        // wheels of the other stack queue shards (never changes once created)
+
+        Duration mResolution;
+        Time mStartTime;
+        ULONG mCurrentTick;             // next tick to be processed
+
+        size_t mTotalArmed;
+        ULONG mTotalFired;
+
+        TimerPtr mTimer;
+        ULONG mTimerTick;               // tick the one shot timer is armed for
+
+        EntryList mFirstLevel[Sizes_FirstLevelSlots];
+        EntryList mOtherLevels[Sizes_OtherLevels][Sizes_OtherLevelSlots];
+      };
+
+    }
+  }
+}
+
+ZS_DECLARE_PROXY_BEGIN(openpeer::stack::internal::ITimerWheelDelegate)
+ZS_DECLARE_PROXY_TYPEDEF(openpeer::stack::internal::TimerWheelEntryPtr, TimerWheelEntryPtr)
+ZS_DECLARE_PROXY_METHOD_1(onTimerWheelExpired, TimerWheelEntryPtr)
+ZS_DECLARE_PROXY_END()
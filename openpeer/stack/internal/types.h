@@ -126,7 +126,10 @@ namespace openpeer
       ZS_DECLARE_CLASS_PTR(FinderConnection)
       ZS_DECLARE_CLASS_PTR(FinderConnectionManager)
       ZS_DECLARE_CLASS_PTR(Helper)
+      ZS_DECLARE_CLASS_PTR(InstrumentedMessageQueue)
+      ZS_DECLARE_CLASS_PTR(InstrumentedMessageQueueMessage)
       ZS_DECLARE_CLASS_PTR(KeyGenerator)
+      ZS_DECLARE_CLASS_PTR(RSAKeyPairReservoir)
       ZS_DECLARE_CLASS_PTR(MessageIncoming)
       ZS_DECLARE_CLASS_PTR(Location)
       ZS_DECLARE_CLASS_PTR(Peer)
@@ -145,6 +148,8 @@ namespace openpeer
       ZS_DECLARE_CLASS_PTR(ServiceSaltFetchSignedSaltQuery)
       ZS_DECLARE_CLASS_PTR(Settings)
       ZS_DECLARE_CLASS_PTR(Stack)
+      ZS_DECLARE_CLASS_PTR(TimerWheel)
+      ZS_DECLARE_CLASS_PTR(TimerWheelEntry)
 
       ZS_DECLARE_INTERACTION_PTR(IFinderRelayChannel)
       ZS_DECLARE_INTERACTION_PTR(IFinderConnection)
@@ -160,6 +165,7 @@ namespace openpeer
       ZS_DECLARE_INTERACTION_PROXY(IMessageMonitorAsyncDelegate)
       ZS_DECLARE_INTERACTION_PROXY(IServiceNamespaceGrantSessionQueryDelegate)
       ZS_DECLARE_INTERACTION_PROXY(IServiceNamespaceGrantSessionWaitDelegate)
+      ZS_DECLARE_INTERACTION_PROXY(ITimerWheelDelegate)
 
       ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IFinderRelayChannelSubscription, IFinderRelayChannelDelegate)
       ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IFinderConnectionSubscription, IFinderConnectionDelegate)
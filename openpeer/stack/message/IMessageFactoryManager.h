@@ -32,6 +32,7 @@
 #pragma once
 
 #include <openpeer/stack/message/types.h>
+#include <openpeer/stack/message/Message.h>
 
 namespace openpeer
 {
@@ -42,6 +43,19 @@ namespace openpeer
       interaction IMessageFactoryManager
       {
         static void registerFactory(IMessageFactoryPtr factory);
+
+        //---------------------------------------------------------------------
+        // PURPOSE: resolve a method name for a registered handler without
+        //          walking the factories (returns Method_Invalid if unknown)
+        static Message::Methods toMethod(
+                                         const char *handler,
+                                         const char *method
+                                         );
+
+        //---------------------------------------------------------------------
+        // PURPOSE: report the estimated memory saved per message type by the
+        //          "openpeer/stack/message-creation-element-mode" setting
+        static ElementPtr getCreationElementStatistics(bool resetAfterSnapshot = false);
       };
     }
   }
@@ -33,6 +33,7 @@
 
 #include <openpeer/stack/message/types.h>
 #include <openpeer/stack/message/Message.h>
+#include <openpeer/stack/message/MessageNames.h>
 
 namespace openpeer
 {
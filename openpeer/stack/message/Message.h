@@ -66,6 +66,16 @@ namespace openpeer
           Method_Invalid = -1,
         };
 
+        enum EncodedForms
+        {
+          EncodedForm_JSON,
+          EncodedForm_JSONWithoutAppID,
+          EncodedForm_Binary,
+          EncodedForm_BinaryWithoutAppID,
+
+          EncodedForm_Last = EncodedForm_BinaryWithoutAppID,
+        };
+
       public:
         static ElementPtr toDebug(MessagePtr message);
 
@@ -78,24 +88,47 @@ namespace openpeer
                                  IMessageSourcePtr messageSource
                                  );
 
+        // NOTE: parses a received JSON/XML or binary frame (NUL terminated);
+        //       in the "arena" creation element mode the message keeps the
+        //       frame itself rather than the parsed tree
+        static MessagePtr create(
+                                 SecureByteBlockPtr buffer,
+                                 IMessageSourcePtr messageSource
+                                 );
+
         virtual DocumentPtr encode();
 
+        // NOTE: streams the message into the writer; types without a
+        //       streaming encoder fall back to encode()
+        virtual bool encodeTo(MessageWriter &writer);
+
+        // NOTE: serialized bytes of the message in the given form, encoded
+        //       (through the writer for JSON) on first use and then handed
+        //       out as the same buffer to every later sender, e.g. a request
+        //       re-posted after a redirect; every setter drops them (senders
+        //       that batch frames still copy the bytes into the batch)
+        SecureByteBlockPtr encoded(
+                                   EncodedForms form,
+                                   MessageWriter &writer
+                                   );
+        void invalidateEncoded();
+
         virtual MessageTypes messageType() const = 0;
 
         virtual Methods method() const              {return Method_Invalid;}
         virtual const char *methodAsString() const;
 
         virtual const String &domain() const        {return mDomain;}
-        virtual void domain(const String &id)       {mDomain = id;}
+        virtual void domain(const String &id)       {mDomain = id; invalidateEncoded();}
 
         virtual const String &appID() const         {return mAppID;}
-        virtual void appID(const String &appID)     {mAppID = appID;}
+        virtual void appID(const String &appID)     {mAppID = appID; invalidateEncoded();}
 
         virtual const String &messageID() const     {return mID;}
-        virtual void messageID(const String &id)    {mID = id;}
+        virtual void messageID(const String &id)    {mID = id; invalidateEncoded();}
 
         Time time() const                           {return mTime;}
-        void time(Time val)                         {mTime = val;}
+        void time(Time val)                         {mTime = val; invalidateEncoded();}
 
         virtual bool isRequest() const              {return false;}
         virtual bool isResult() const               {return false;}
@@ -103,8 +136,25 @@ namespace openpeer
 
         virtual IMessageFactoryPtr factory() const  {return IMessageFactoryPtr();}
 
-        virtual ElementPtr creationElement() const  {return mCreationElement;}
-        virtual void creationElement(ElementPtr el) {mCreationElement = el;}
+        virtual ElementPtr creationElement() const;
+        virtual void creationElement(ElementPtr el);
+
+        // NOTE: compact keeps only the JSON text of the creation element
+        //       (creationElement() re-parses it on demand), release drops it
+        //       and a creation buffer replaces the tree with the frame it
+        //       was parsed from (shared, never copied)
+        virtual void compactCreationElement();
+        virtual void releaseCreationElement();
+        virtual bool hasCreationElement() const;
+        virtual size_t creationRawSize() const;
+
+        // NOTE: returns the JSON text of the creation element without
+        //       parsing when the compact text or a JSON creation buffer is
+        //       kept (only a tree or a binary frame is generated)
+        virtual String creationJSON() const;
+
+        virtual SecureByteBlockPtr creationBuffer() const     {return mCreationBuffer;}
+        virtual void creationBuffer(SecureByteBlockPtr buffer);
 
         virtual IMessageSourcePtr creationSource() const      {return mCreationSource;}
         virtual void creationSource(IMessageSourcePtr source) {mCreationSource = source;}
@@ -113,8 +163,12 @@ namespace openpeer
         Message();
 
         ElementPtr mCreationElement;
+        String mCreationRaw;
+        SecureByteBlockPtr mCreationBuffer;
         IMessageSourcePtr mCreationSource;
 
+        SecureByteBlockPtr mEncoded[EncodedForm_Last + 1];
+
         String mDomain;
         String mAppID;
         String mID;
@@ -0,0 +1,137 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#pragma once
+
+#include <openpeer/stack/message/types.h>
+
+#include <list>
+#include <vector>
+
+#define OPENPEER_STACK_SETTING_MESSAGE_BATCHING_ENABLED                   "openpeer/stack/message-batching-enabled"
+#define OPENPEER_STACK_SETTING_MESSAGE_BATCHING_WINDOW_IN_MILLISECONDS    "openpeer/stack/message-batching-window-in-milliseconds"
+#define OPENPEER_STACK_SETTING_MESSAGE_BATCHING_MAX_SIZE_IN_BYTES         "openpeer/stack/message-batching-max-size-in-bytes"
+
+#define OPENPEER_STACK_MESSAGE_BATCH_MAGIC                                (0xC3)
+
+#define OPENPEER_STACK_MESSAGE_BATCHING                                   "batch"
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageBatch
+      #pragma mark
+
+      // NOTE: aggregates encoded frames queued for the same stream into one
+      //       write, in the order they were appended:
+      //
+      //         0xC3 (varint(length) frame)*
+      //
+      //       The batch as a whole may then be compressed (see
+      //       MessageCompression). A batch holding a single frame is sent as
+      //       that plain frame. The window setting trades latency for
+      //       throughput: 0 only coalesces messages sent during the same pass
+      //       of the stack thread, larger values hold frames for up to that
+      //       long (rounded to the timer wheel resolution) unless the byte
+      //       budget fills first.
+      class MessageBatch
+      {
+      public:
+        typedef std::list<SecureByteBlockPtr> FrameList;
+
+        MessageBatch();
+
+        static bool isEnabled();
+        static Duration getWindow();
+        static size_t getMaxSize();
+
+        static bool isBatch(
+                            const BYTE *buffer,
+                            size_t lengthInBytes
+                            );
+
+        // appends batching to the encodings offered in session-create /
+        // peer-identify requests (unchanged when disabled)
+        static void offerBatching(StringList &ioEncodings);
+
+        // batching chosen for an offer; empty if frames are sent one by one
+        static String selectBatching(const StringList &offered);
+
+        // splits a received buffer into its frames, inflating a compressed
+        // batch first; anything else comes back as the only frame (false
+        // if the buffer claims to be a batch but is malformed)
+        static bool unpack(
+                           SecureByteBlockPtr buffer,
+                           FrameList &outFrames
+                           );
+
+        void append(
+                    const BYTE *frame,
+                    size_t lengthInBytes
+                    );
+
+        bool isEmpty() const                        {return 0 == mTotalFrames;}
+        bool isFull() const;
+        size_t getTotalFrames() const               {return mTotalFrames;}
+        size_t getSize() const                      {return mBuffer.size();}
+
+        // returns the frame to write and empties the batch
+        SecureByteBlockPtr take();
+
+        ElementPtr toDebug() const;
+
+      protected:
+        typedef std::vector<BYTE> Buffer;
+
+        Buffer mBuffer;
+        size_t mTotalFrames;
+
+        size_t mFirstFrameOffset;
+        size_t mFirstFrameSize;
+
+        size_t mMaxSize;
+
+        ULONG mTotalBatchesTaken;
+        ULONG mTotalFramesTaken;
+      };
+    }
+  }
+}
@@ -0,0 +1,110 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/message/types.h>
+
+#define OPENPEER_STACK_SETTING_MESSAGE_BINARY_ENCODING_ENABLED "openpeer/stack/message-binary-encoding-enabled"
+
+#define OPENPEER_STACK_MESSAGE_BINARY_MAGIC                   (0xC1)
+#define OPENPEER_STACK_MESSAGE_BINARY_VERSION                 (1)
+
+#define OPENPEER_STACK_MESSAGE_ENCODING_JSON                  "json"
+#define OPENPEER_STACK_MESSAGE_ENCODING_BINARY                "binary"
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageBinary
+      #pragma mark
+
+      // NOTE: compact binary form of the same element/attribute/text model
+      //       the JSON generator writes. A frame starts with a magic byte
+      //       JSON can never start with (0xC1 is not valid UTF-8), then a
+      //       version byte and the root element:
+      //
+      //         element := name attrCount (name value)* childCount child*
+      //         child   := 0x01 element | 0x02 textFormat value
+      //         name    := varint(len << 1) bytes | varint(index << 1 | 1)
+      //         value   := varint(len) bytes
+      //
+      //       Names are interned per frame so repeated element names cost a
+      //       byte or two. The root's name and attributes come first so the
+      //       envelope can be read without building a DOM.
+      class MessageBinary
+      {
+      public:
+        typedef std::map<String, String> AttributeMap;
+
+        static bool isEnabled();
+
+        static bool isBinary(
+                             const BYTE *buffer,
+                             size_t lengthInBytes
+                             );
+
+        static SecureByteBlockPtr encode(
+                                         DocumentPtr document,
+                                         bool excludeAppID = false
+                                         );
+
+        static DocumentPtr decode(
+                                  const BYTE *buffer,
+                                  size_t lengthInBytes
+                                  );
+
+        static bool scanRoot(
+                             const BYTE *buffer,
+                             size_t lengthInBytes,
+                             String &outName,
+                             AttributeMap &outAttributes
+                             );
+
+        // encodings offered in session-create / peer-identify requests
+        // (empty when binary is disabled so the request is unchanged)
+        static StringList offeredEncodings();
+
+        // encoding chosen for an offer; JSON unless both sides allow binary
+        static String selectEncoding(const StringList &offered);
+      };
+    }
+  }
+}
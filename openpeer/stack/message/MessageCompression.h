@@ -0,0 +1,102 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#pragma once
+
+#include <openpeer/stack/message/types.h>
+
+#define OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_ENABLED                "openpeer/stack/message-compression-enabled"
+#define OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES     "openpeer/stack/message-compression-threshold-in-bytes"
+
+#define OPENPEER_STACK_MESSAGE_COMPRESSION_MAGIC                          (0xC0)
+#define OPENPEER_STACK_MESSAGE_COMPRESSION_MAX_INFLATED_SIZE_IN_BYTES     (16*1024*1024)
+
+#define OPENPEER_STACK_MESSAGE_COMPRESSION_DEFLATE                        "deflate"
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageCompression
+      #pragma mark
+
+      // NOTE: per-frame deflate wrapper around an already encoded message
+      //       (JSON or MessageBinary). A compressed frame is:
+      //
+      //         0xC0 varint(inflatedLength) deflate-data
+      //
+      //       0xC0 can never start a JSON or binary frame so receivers detect
+      //       it from the first byte. Frames below the threshold, or which
+      //       would not shrink, are sent as they are.
+      class MessageCompression
+      {
+      public:
+        static bool isEnabled();
+
+        static bool isCompressed(
+                                 const BYTE *buffer,
+                                 size_t lengthInBytes
+                                 );
+
+        // returns NULL if the frame is better sent uncompressed
+        static SecureByteBlockPtr compress(
+                                           const BYTE *buffer,
+                                           size_t lengthInBytes
+                                           );
+
+        // the result carries a trailing NUL so JSON can be read as a string
+        static SecureByteBlockPtr decompress(
+                                             const BYTE *buffer,
+                                             size_t lengthInBytes
+                                             );
+
+        // appends the compression offered in session-create / peer-identify
+        // requests to the list of encodings (unchanged when disabled)
+        static void offerCompression(StringList &ioEncodings);
+
+        // compression chosen for an offer; empty if frames stay uncompressed
+        static String selectCompression(const StringList &offered);
+
+        // PURPOSE: bytes saved against time spent compressing and inflating
+        static ElementPtr getStatistics(bool resetAfterSnapshot = false);
+      };
+    }
+  }
+}
@@ -0,0 +1,86 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/message/Message.h>
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageEnvelope
+      #pragma mark
+
+      // NOTE: routing information scanned directly from a raw JSON frame
+      //       (root type plus the "$id", "$handler", "$method" and "$appid"
+      //       attributes) without building a DOM; decode() builds the full
+      //       message only once something actually consumes it. Binary
+      //       frames (see MessageBinary) are scanned the same way, and
+      //       compressed frames (see MessageCompression) are inflated first
+      //       so mRaw always holds the uncompressed frame.
+      struct MessageEnvelope
+      {
+        Message::MessageTypes mType;
+
+        String mID;
+        String mHandler;
+        String mMethod;
+        String mAppID;
+
+        SecureByteBlockPtr mRaw;
+        bool mBinary;
+        bool mCompressed;
+
+        MessageEnvelope();
+
+        static bool scan(
+                         SecureByteBlockPtr raw,
+                         MessageEnvelope &outEnvelope
+                         );
+
+        MessagePtr decode(IMessageSourcePtr messageSource) const;
+
+        bool hasData() const;
+        const char *logText() const;
+        ElementPtr toDebug() const;
+      };
+    }
+  }
+}
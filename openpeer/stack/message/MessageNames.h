@@ -0,0 +1,208 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#pragma once
+
+#include <openpeer/stack/message/types.h>
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageNames
+      #pragma mark
+
+      // NOTE: stack-wide table of the element and attribute names messages
+      //       are built from and looked up by. Each name is a single String
+      //       created once for the life of the process and passed around by
+      //       reference, so helpers and factories never construct a name per
+      //       call, and nodes created from it share its storage wherever
+      //       String copies share their buffer.
+      class MessageNames
+      {
+      public:
+        enum Names
+        {
+          Name_ID,
+          Name_Domain,
+          Name_AppID,
+          Name_Timestamp,
+          Name_Handler,
+          Name_Method,
+          Name_Error,
+          Name_Expires,
+          Name_Created,
+          Name_Updated,
+          Name_Name,
+          Name_Version,
+          Name_Type,
+          Name_URI,
+          Name_URL,
+          Name_Details,
+          Name_Document,
+          Name_Location,
+          Name_Locations,
+          Name_Contact,
+          Name_Contacts,
+          Name_Relationships,
+          Name_Encoding,
+          Name_Encodings,
+          Name_Compression,
+          Name_Batching,
+          Name_Channel,
+          Name_Window,
+          Name_Nonce,
+          Name_Relay,
+          Name_LocalContext,
+          Name_RemoteContext,
+          Name_Context,
+          Name_AccessToken,
+          Name_AccessSecret,
+          Name_AccessSecretExpires,
+          Name_AccessSecretProof,
+          Name_AccessSecretProofExpires,
+          Name_FindProofBundle,
+          Name_FindProof,
+          Name_FindSecret,
+          Name_FindSecretProof,
+          Name_FindSecretProofExpires,
+          Name_RequestFindProofBundleDigestValue,
+          Name_Peer,
+          Name_PeerIdentityProofBundle,
+          Name_PeerIdentityProof,
+          Name_PeerSecretEncrypted,
+          Name_Exclude,
+          Name_Candidates,
+          Name_Candidate,
+          Name_Transport,
+          Name_IP,
+          Name_Port,
+          Name_Host,
+          Name_Priority,
+          Name_Foundation,
+          Name_IceUsernameFrag,
+          Name_IcePassword,
+          Name_IcePasswordEncrypted,
+          Name_IceFinal,
+          Name_UserAgent,
+          Name_OS,
+          Name_System,
+          Name_Set,
+          Name_Remove,
+          Name_Path,
+
+          Name_Last = Name_Path,
+        };
+
+        static const char *toString(Names name);
+
+        static const String &get(Names name);
+
+        static const String &id()                                 {return get(Name_ID);}
+        static const String &domain()                             {return get(Name_Domain);}
+        static const String &appID()                              {return get(Name_AppID);}
+        static const String &timestamp()                          {return get(Name_Timestamp);}
+        static const String &handler()                            {return get(Name_Handler);}
+        static const String &method()                             {return get(Name_Method);}
+        static const String &error()                              {return get(Name_Error);}
+        static const String &expires()                            {return get(Name_Expires);}
+        static const String &created()                            {return get(Name_Created);}
+        static const String &updated()                            {return get(Name_Updated);}
+        static const String &name()                               {return get(Name_Name);}
+        static const String &version()                            {return get(Name_Version);}
+        static const String &type()                               {return get(Name_Type);}
+        static const String &uri()                                {return get(Name_URI);}
+        static const String &url()                                {return get(Name_URL);}
+        static const String &details()                            {return get(Name_Details);}
+        static const String &document()                           {return get(Name_Document);}
+        static const String &location()                           {return get(Name_Location);}
+        static const String &locations()                          {return get(Name_Locations);}
+        static const String &contact()                            {return get(Name_Contact);}
+        static const String &contacts()                           {return get(Name_Contacts);}
+        static const String &relationships()                      {return get(Name_Relationships);}
+        static const String &encoding()                           {return get(Name_Encoding);}
+        static const String &encodings()                          {return get(Name_Encodings);}
+        static const String &compression()                        {return get(Name_Compression);}
+        static const String &batching()                           {return get(Name_Batching);}
+        static const String &channel()                            {return get(Name_Channel);}
+        static const String &window()                             {return get(Name_Window);}
+        static const String &nonce()                              {return get(Name_Nonce);}
+        static const String &relay()                              {return get(Name_Relay);}
+        static const String &localContext()                       {return get(Name_LocalContext);}
+        static const String &remoteContext()                      {return get(Name_RemoteContext);}
+        static const String &context()                            {return get(Name_Context);}
+        static const String &accessToken()                        {return get(Name_AccessToken);}
+        static const String &accessSecret()                       {return get(Name_AccessSecret);}
+        static const String &accessSecretExpires()                {return get(Name_AccessSecretExpires);}
+        static const String &accessSecretProof()                  {return get(Name_AccessSecretProof);}
+        static const String &accessSecretProofExpires()           {return get(Name_AccessSecretProofExpires);}
+        static const String &findProofBundle()                    {return get(Name_FindProofBundle);}
+        static const String &findProof()                          {return get(Name_FindProof);}
+        static const String &findSecret()                         {return get(Name_FindSecret);}
+        static const String &findSecretProof()                    {return get(Name_FindSecretProof);}
+        static const String &findSecretProofExpires()             {return get(Name_FindSecretProofExpires);}
+        static const String &requestFindProofBundleDigestValue()  {return get(Name_RequestFindProofBundleDigestValue);}
+        static const String &peer()                               {return get(Name_Peer);}
+        static const String &peerIdentityProofBundle()            {return get(Name_PeerIdentityProofBundle);}
+        static const String &peerIdentityProof()                  {return get(Name_PeerIdentityProof);}
+        static const String &peerSecretEncrypted()                {return get(Name_PeerSecretEncrypted);}
+        static const String &exclude()                            {return get(Name_Exclude);}
+        static const String &candidates()                         {return get(Name_Candidates);}
+        static const String &candidate()                          {return get(Name_Candidate);}
+        static const String &transport()                          {return get(Name_Transport);}
+        static const String &ip()                                 {return get(Name_IP);}
+        static const String &port()                               {return get(Name_Port);}
+        static const String &host()                               {return get(Name_Host);}
+        static const String &priority()                           {return get(Name_Priority);}
+        static const String &foundation()                         {return get(Name_Foundation);}
+        static const String &iceUsernameFrag()                    {return get(Name_IceUsernameFrag);}
+        static const String &icePassword()                        {return get(Name_IcePassword);}
+        static const String &icePasswordEncrypted()               {return get(Name_IcePasswordEncrypted);}
+        static const String &iceFinal()                           {return get(Name_IceFinal);}
+        static const String &userAgent()                          {return get(Name_UserAgent);}
+        static const String &os()                                 {return get(Name_OS);}
+        static const String &system()                             {return get(Name_System);}
+        static const String &set()                                {return get(Name_Set);}
+        static const String &remove()                             {return get(Name_Remove);}
+        static const String &path()                               {return get(Name_Path);}
+      };
+    }
+  }
+}
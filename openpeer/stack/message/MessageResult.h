@@ -83,10 +83,10 @@ namespace openpeer
         bool hasAttribute(AttributeTypes type) const;
 
         ErrorCodeType errorCode() const                 {return mErrorCode;}
-        void errorCode(WORD val)                        {mErrorCode = val;}
+        void errorCode(WORD val)                        {mErrorCode = val; invalidateEncoded();}
 
         String errorReason() const                      {return mErrorReason;}
-        void errorReason(const char *reason)            {mErrorReason = String(reason);}
+        void errorReason(const char *reason)            {mErrorReason = String(reason); invalidateEncoded();}
 
         ElementPtr errorRoot() const                    {return mErrorRootEl;}
 
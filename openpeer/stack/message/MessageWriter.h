@@ -0,0 +1,123 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#pragma once
+
+#include <openpeer/stack/message/Message.h>
+
+#include <vector>
+
+#define OPENPEER_STACK_MESSAGE_WRITER_DEFAULT_RESERVE_IN_BYTES (4*1024)
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageWriter
+      #pragma mark
+
+      // NOTE: streams a message's JSON straight into a reusable buffer
+      //       instead of building a Document first; reset() keeps the
+      //       capacity so a long lived writer stops allocating once warm.
+      //       Subtrees which must exist as a DOM (e.g. signed elements) are
+      //       spliced in with writeElement().
+      class MessageWriter
+      {
+      public:
+        MessageWriter(size_t reserveInBytes = OPENPEER_STACK_MESSAGE_WRITER_DEFAULT_RESERVE_IN_BYTES);
+
+        void reset();
+
+        bool excludeAppID() const                   {return mExcludeAppID;}
+        void excludeAppID(bool exclude)             {mExcludeAppID = exclude;}
+
+        bool beginMessage(const Message &message);
+        void endMessage();
+
+        void beginObject(const char *name = NULL);  // NULL inside arrays
+        void endObject();
+
+        void beginArray(const char *name);
+        void endArray();
+
+        void writeAttribute(
+                            const char *name,
+                            const String &value
+                            );
+        void writeText(
+                       const char *name,
+                       const String &value
+                       );
+        void writeNumber(
+                         const char *name,
+                         const String &value
+                         );
+
+        void writeElement(ElementPtr el);
+        void writeElementValue(ElementPtr el);
+
+        bool writeDocument(DocumentPtr document);
+
+        const char *data() const                    {return mBuffer.c_str();}
+        size_t size() const                         {return mBuffer.length();}
+        size_t capacity() const                     {return mBuffer.capacity();}
+        bool isEmpty() const                        {return mBuffer.isEmpty();}
+
+        SecureByteBlockPtr toBuffer() const;
+
+      protected:
+        void beginMember();
+        void appendName(const char *name);
+        void appendQuoted(const String &value);
+        void appendGenerated(
+                             ElementPtr el,
+                             bool valueOnly
+                             );
+
+      protected:
+        typedef std::vector<bool> MemberStack;
+
+        String mBuffer;
+        MemberStack mHasMembers;
+
+        bool mExcludeAppID;
+      };
+    }
+  }
+}
@@ -64,7 +64,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           ULONG totalFinders() const       {return mTotalFinders;}
-          void totalFinders(ULONG val)     {mTotalFinders = val;}
+          void totalFinders(ULONG val)     {mTotalFinders = val; invalidateEncoded();}
 
         protected:
           FindersGetRequest();
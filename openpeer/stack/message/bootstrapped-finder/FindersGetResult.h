@@ -65,7 +65,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const FinderList &finders() const           {return mFinders;}
-          void finders(const FinderList &val)         {mFinders = val;}
+          void finders(const FinderList &val)         {mFinders = val; invalidateEncoded();}
 
         protected:
           FindersGetResult();
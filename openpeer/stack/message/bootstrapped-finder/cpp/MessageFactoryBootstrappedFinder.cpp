@@ -89,16 +89,7 @@ namespace openpeer
         //---------------------------------------------------------------------
         Message::Methods MessageFactoryBootstrappedFinder::toMethod(const char *inMethod) const
         {
-          typedef zsLib::ULONG ULONG;
-          String methodStr(inMethod ? inMethod : "");
-
-          for (ULONG loop = (ULONG)(MessageFactoryBootstrappedFinder::Method_Invalid+1); loop <= ((ULONG)MessageFactoryBootstrappedFinder::Method_Last); ++loop)
-          {
-            if (methodStr == toString((Message::Methods)loop)) {
-              return (Message::Methods)loop;
-            }
-          }
-          return Message::Method_Invalid;
+          return IMessageFactoryManager::toMethod(getHandler(), inMethod);
         }
 
         //---------------------------------------------------------------------
@@ -65,10 +65,10 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const ServiceMap &services() const                {return mServices;}
-          void services(const ServiceMap &val)              {mServices = val;}
+          void services(const ServiceMap &val)              {mServices = val; invalidateEncoded();}
 
           const ServiceTypeMap &servicesByType() const      {return mServicesByType;}
-          void servicesByType(const ServiceTypeMap &val)    {mServicesByType = val;}
+          void servicesByType(const ServiceTypeMap &val)    {mServicesByType = val; invalidateEncoded();}
 
         protected:
           ServicesGetResult();
@@ -89,16 +89,7 @@ namespace openpeer
         //---------------------------------------------------------------------
         Message::Methods MessageFactoryBootstrapper::toMethod(const char *inMethod) const
         {
-          typedef zsLib::ULONG ULONG;
-          String methodStr(inMethod ? inMethod : "");
-
-          for (ULONG loop = (ULONG)(MessageFactoryBootstrapper::Method_Invalid+1); loop <= ((ULONG)MessageFactoryBootstrapper::Method_Last); ++loop)
-          {
-            if (methodStr == toString((Message::Methods)loop)) {
-              return (Message::Methods)loop;
-            }
-          }
-          return Message::Method_Invalid;
+          return IMessageFactoryManager::toMethod(getHandler(), inMethod);
         }
 
         //---------------------------------------------------------------------
@@ -65,7 +65,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const CertificateMap &certificates() const   {return mCertificates;}
-          void certificates(const CertificateMap &val) {mCertificates = val;}
+          void certificates(const CertificateMap &val) {mCertificates = val; invalidateEncoded();}
 
         protected:
           CertificatesGetResult();
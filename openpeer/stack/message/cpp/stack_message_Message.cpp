@@ -32,7 +32,9 @@
 #include <openpeer/stack/message/internal/stack_message_MessageFactoryManager.h>
 #include <openpeer/stack/message/IMessageFactory.h>
 #include <openpeer/stack/message/Message.h>
+#include <openpeer/stack/message/MessageBinary.h>
 #include <openpeer/stack/message/MessageResult.h>
+#include <openpeer/stack/message/MessageWriter.h>
 #include <openpeer/stack/internal/stack_Helper.h>
 #include <openpeer/stack/internal/stack_Stack.h>
 
@@ -43,6 +45,8 @@
 #include <zsLib/Log.h>
 #include <zsLib/Stringize.h>
 
+#include <boost/shared_array.hpp>
+
 namespace openpeer { namespace stack { namespace message { ZS_DECLARE_SUBSYSTEM(openpeer_stack_message) } } }
 
 namespace openpeer
@@ -55,6 +59,9 @@ namespace openpeer
 
       using services::IHelper;
 
+      using zsLib::XML::Generator;
+      using zsLib::XML::GeneratorPtr;
+
       using stack::internal::IStackForInternal;
       using stack::internal::Helper;
 
@@ -66,6 +73,15 @@ namespace openpeer
         return Log::Params(message, "stack::message::Message");
       }
 
+      //-----------------------------------------------------------------------
+      static DocumentPtr parseCreationBuffer(SecureByteBlockPtr buffer)
+      {
+        if (MessageBinary::isBinary(buffer->BytePtr(), buffer->SizeInBytes())) {
+          return MessageBinary::decode(buffer->BytePtr(), buffer->SizeInBytes());
+        }
+        return Document::createFromAutoDetect((const char *)(buffer->BytePtr()));
+      }
+
       //-----------------------------------------------------------------------
       const char *Message::toString(MessageTypes type)
       {
@@ -176,6 +192,26 @@ namespace openpeer
         return internal::MessageFactoryManager::create(root, messageSource);
       }
 
+      //-----------------------------------------------------------------------
+      MessagePtr Message::create(
+                                 SecureByteBlockPtr buffer,
+                                 IMessageSourcePtr messageSource
+                                 )
+      {
+        if (!buffer) return MessagePtr();
+
+        DocumentPtr document = parseCreationBuffer(buffer);
+        if (!document) return MessagePtr();
+
+        ElementPtr root = document->getFirstChildElement();
+        if (!root) {
+          ZS_LOG_ERROR(Detail, slog("expected element is missing"))
+          return MessagePtr();
+        }
+
+        return internal::MessageFactoryManager::create(root, messageSource, buffer);
+      }
+
       //-----------------------------------------------------------------------
       const char *Message::methodAsString() const
       {
@@ -187,6 +223,134 @@ namespace openpeer
         return originalFactory->toString(method());
       }
 
+      //-----------------------------------------------------------------------
+      ElementPtr Message::creationElement() const
+      {
+        if (mCreationElement) return mCreationElement;
+
+        // not cached so the compact form stays compact
+        DocumentPtr document;
+        if (mCreationBuffer) {
+          document = parseCreationBuffer(mCreationBuffer);
+        } else if (mCreationRaw.hasData()) {
+          document = Document::createFromParsedJSON(mCreationRaw);
+        }
+        if (!document) return ElementPtr();
+
+        return document->getFirstChildElement();
+      }
+
+      //-----------------------------------------------------------------------
+      void Message::creationElement(ElementPtr el)
+      {
+        mCreationElement = el;
+        mCreationRaw.clear();
+        mCreationBuffer.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      void Message::compactCreationElement()
+      {
+        if (!mCreationElement) return;
+
+        GeneratorPtr generator = Generator::createJSONGenerator();
+        boost::shared_array<char> output = generator->write(mCreationElement);
+
+        mCreationRaw = String((const char *)output.get());
+        mCreationElement.reset();
+        mCreationBuffer.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      String Message::creationJSON() const
+      {
+        if (mCreationRaw.hasData()) return mCreationRaw;
+
+        if ((mCreationBuffer) &&
+            (mCreationBuffer->SizeInBytes() > 0) &&
+            ('{' == *((const char *)(mCreationBuffer->BytePtr())))) {
+          return String((const char *)(mCreationBuffer->BytePtr()));
+        }
+
+        ElementPtr el = creationElement();
+        if (!el) return String();
+
+        GeneratorPtr generator = Generator::createJSONGenerator();
+        boost::shared_array<char> output = generator->write(el);
+        return String((const char *)output.get());
+      }
+
+      //-----------------------------------------------------------------------
+      void Message::releaseCreationElement()
+      {
+        mCreationElement.reset();
+        mCreationRaw.clear();
+        mCreationBuffer.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      bool Message::hasCreationElement() const
+      {
+        return ((bool)mCreationElement) || (mCreationRaw.hasData()) || ((bool)mCreationBuffer);
+      }
+
+      //-----------------------------------------------------------------------
+      size_t Message::creationRawSize() const
+      {
+        if (mCreationBuffer) return mCreationBuffer->SizeInBytes();
+        return mCreationRaw.length();
+      }
+
+      //-----------------------------------------------------------------------
+      void Message::creationBuffer(SecureByteBlockPtr buffer)
+      {
+        mCreationElement.reset();
+        mCreationRaw.clear();
+        mCreationBuffer = buffer;
+      }
+
+      //-----------------------------------------------------------------------
+      bool Message::encodeTo(MessageWriter &writer)
+      {
+        return writer.writeDocument(encode());
+      }
+
+      //-----------------------------------------------------------------------
+      SecureByteBlockPtr Message::encoded(
+                                          EncodedForms form,
+                                          MessageWriter &writer
+                                          )
+      {
+        SecureByteBlockPtr &result = mEncoded[form];
+        if (result) return result;
+
+        switch (form) {
+          case EncodedForm_JSON:
+          case EncodedForm_JSONWithoutAppID:  {
+            writer.reset();
+            writer.excludeAppID(EncodedForm_JSONWithoutAppID == form);
+            if (!encodeTo(writer)) return SecureByteBlockPtr();
+            result = writer.toBuffer();
+            break;
+          }
+          case EncodedForm_Binary:
+          case EncodedForm_BinaryWithoutAppID:  {
+            result = MessageBinary::encode(encode(), EncodedForm_BinaryWithoutAppID == form);
+            break;
+          }
+        }
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      void Message::invalidateEncoded()
+      {
+        for (int loop = 0; loop <= (int)EncodedForm_Last; ++loop) {
+          mEncoded[loop].reset();
+        }
+      }
+
       //-----------------------------------------------------------------------
       DocumentPtr Message::encode()
       {
@@ -0,0 +1,296 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/message/MessageBatch.h>
+#include <openpeer/stack/message/MessageCompression.h>
+
+#include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/Log.h>
+
+#include <cstring>
+
+namespace openpeer { namespace stack { namespace message { ZS_DECLARE_SUBSYSTEM(openpeer_stack_message) } } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      using services::IHelper;
+      using zsLib::Milliseconds;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static Log::Params slog(const char *message)
+      {
+        return Log::Params(message, "stack::message::MessageBatch");
+      }
+
+      //-----------------------------------------------------------------------
+      static void appendVarint(
+                               std::vector<BYTE> &ioBuffer,
+                               size_t value
+                               )
+      {
+        while (value >= 0x80) {
+          ioBuffer.push_back((BYTE)((value & 0x7F) | 0x80));
+          value >>= 7;
+        }
+        ioBuffer.push_back((BYTE)value);
+      }
+
+      //-----------------------------------------------------------------------
+      static bool readVarint(
+                             const BYTE * &ioPos,
+                             const BYTE *end,
+                             size_t &outValue
+                             )
+      {
+        outValue = 0;
+        for (ULONG shift = 0; shift < 35; shift += 7) {
+          if (ioPos >= end) return false;
+          BYTE value = *ioPos;
+          ++ioPos;
+          outValue |= (((size_t)(value & 0x7F)) << shift);
+          if (0 == (value & 0x80)) return true;
+        }
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      static SecureByteBlockPtr copyFrame(
+                                          const BYTE *frame,
+                                          size_t lengthInBytes
+                                          )
+      {
+        // NUL terminated so JSON frames can be read as strings
+        SecureByteBlockPtr result(new SecureByteBlock(lengthInBytes + sizeof(char)));
+        if (lengthInBytes > 0) {
+          memcpy(result->BytePtr(), frame, lengthInBytes);
+        }
+        result->BytePtr()[lengthInBytes] = 0;
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageBatch
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      MessageBatch::MessageBatch() :
+        mTotalFrames(0),
+        mFirstFrameOffset(0),
+        mFirstFrameSize(0),
+        mMaxSize(0),
+        mTotalBatchesTaken(0),
+        mTotalFramesTaken(0)
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageBatch::isEnabled()
+      {
+        return services::ISettings::getBool(OPENPEER_STACK_SETTING_MESSAGE_BATCHING_ENABLED);
+      }
+
+      //-----------------------------------------------------------------------
+      Duration MessageBatch::getWindow()
+      {
+        return Milliseconds(services::ISettings::getUInt(OPENPEER_STACK_SETTING_MESSAGE_BATCHING_WINDOW_IN_MILLISECONDS));
+      }
+
+      //-----------------------------------------------------------------------
+      size_t MessageBatch::getMaxSize()
+      {
+        return services::ISettings::getUInt(OPENPEER_STACK_SETTING_MESSAGE_BATCHING_MAX_SIZE_IN_BYTES);
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageBatch::isBatch(
+                                 const BYTE *buffer,
+                                 size_t lengthInBytes
+                                 )
+      {
+        if ((!buffer) || (lengthInBytes < 1)) return false;
+        return (OPENPEER_STACK_MESSAGE_BATCH_MAGIC == buffer[0]);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageBatch::offerBatching(StringList &ioEncodings)
+      {
+        if (!isEnabled()) return;
+        ioEncodings.push_back(OPENPEER_STACK_MESSAGE_BATCHING);
+      }
+
+      //-----------------------------------------------------------------------
+      String MessageBatch::selectBatching(const StringList &offered)
+      {
+        if (!isEnabled()) return String();
+
+        for (StringList::const_iterator iter = offered.begin(); iter != offered.end(); ++iter) {
+          if (OPENPEER_STACK_MESSAGE_BATCHING == (*iter)) return OPENPEER_STACK_MESSAGE_BATCHING;
+        }
+        return String();
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageBatch::unpack(
+                                SecureByteBlockPtr buffer,
+                                FrameList &outFrames
+                                )
+      {
+        if (!buffer) return false;
+
+        bool inflated = false;
+
+        if (MessageCompression::isCompressed(buffer->BytePtr(), buffer->SizeInBytes())) {
+          SecureByteBlockPtr inflatedBuffer = MessageCompression::decompress(buffer->BytePtr(), buffer->SizeInBytes());
+          if (!inflatedBuffer) {
+            // let the envelope report the frame that failed to inflate
+            outFrames.push_back(buffer);
+            return true;
+          }
+          buffer = inflatedBuffer;
+          inflated = true;
+        }
+
+        if (!isBatch(buffer->BytePtr(), buffer->SizeInBytes())) {
+          outFrames.push_back(buffer);
+          return true;
+        }
+
+        const BYTE *pos = buffer->BytePtr() + 1;
+        const BYTE *end = buffer->BytePtr() + buffer->SizeInBytes();
+
+        // an inflated buffer carries a trailing NUL after the last frame
+        if ((inflated) && (end > pos)) --end;
+
+        FrameList frames;
+        while (pos < end) {
+          size_t length = 0;
+          if ((!readVarint(pos, end, length)) ||
+              (length > (size_t)(end - pos))) {
+            ZS_LOG_WARNING(Detail, slog("received batch is malformed") + ZS_PARAM("size", buffer->SizeInBytes()) + ZS_PARAM("frames", frames.size()))
+            return false;
+          }
+          frames.push_back(copyFrame(pos, length));
+          pos += length;
+        }
+
+        outFrames.splice(outFrames.end(), frames);
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageBatch::append(
+                                const BYTE *frame,
+                                size_t lengthInBytes
+                                )
+      {
+        if (mBuffer.size() < 1) {
+          mMaxSize = getMaxSize();
+          mBuffer.reserve(mMaxSize > 0 ? mMaxSize : lengthInBytes + 1 + 5);
+          mBuffer.push_back((BYTE)OPENPEER_STACK_MESSAGE_BATCH_MAGIC);
+        }
+
+        appendVarint(mBuffer, lengthInBytes);
+
+        if (0 == mTotalFrames) {
+          mFirstFrameOffset = mBuffer.size();
+          mFirstFrameSize = lengthInBytes;
+        }
+
+        mBuffer.insert(mBuffer.end(), frame, frame + lengthInBytes);
+        ++mTotalFrames;
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageBatch::isFull() const
+      {
+        return mBuffer.size() >= mMaxSize;
+      }
+
+      //-----------------------------------------------------------------------
+      SecureByteBlockPtr MessageBatch::take()
+      {
+        if (isEmpty()) return SecureByteBlockPtr();
+
+        SecureByteBlockPtr result;
+        if (1 == mTotalFrames) {
+          result = SecureByteBlockPtr(new SecureByteBlock(&(mBuffer[mFirstFrameOffset]), mFirstFrameSize));
+        } else {
+          result = SecureByteBlockPtr(new SecureByteBlock(&(mBuffer[0]), mBuffer.size()));
+        }
+
+        ++mTotalBatchesTaken;
+        mTotalFramesTaken += static_cast<ULONG>(mTotalFrames);
+
+        // keep the capacity for the next batch
+        mBuffer.clear();
+        mTotalFrames = 0;
+        mFirstFrameOffset = 0;
+        mFirstFrameSize = 0;
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr MessageBatch::toDebug() const
+      {
+        ElementPtr resultEl = Element::create("message::MessageBatch");
+
+        IHelper::debugAppend(resultEl, "pending frames", mTotalFrames);
+        IHelper::debugAppend(resultEl, "pending size", mBuffer.size());
+        IHelper::debugAppend(resultEl, "batches taken", mTotalBatchesTaken);
+        IHelper::debugAppend(resultEl, "frames taken", mTotalFramesTaken);
+
+        return resultEl;
+      }
+    }
+  }
+}
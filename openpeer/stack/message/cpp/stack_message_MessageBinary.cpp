@@ -0,0 +1,470 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/message/MessageBinary.h>
+
+#include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/Log.h>
+
+#include <vector>
+
+#define OPENPEER_STACK_MESSAGE_BINARY_TAG_ELEMENT (0x01)
+#define OPENPEER_STACK_MESSAGE_BINARY_TAG_TEXT    (0x02)
+
+#define OPENPEER_STACK_MESSAGE_BINARY_MAX_DEPTH   (64)
+
+namespace openpeer { namespace stack { namespace message { ZS_DECLARE_SUBSYSTEM(openpeer_stack_message) } } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      using zsLib::ULONG;
+      using zsLib::XML::Node;
+      using zsLib::XML::NodePtr;
+
+      namespace internal
+      {
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark MessageBinaryEncoder
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        class MessageBinaryEncoder
+        {
+        public:
+          typedef std::vector<BYTE> Buffer;
+          typedef std::map<String, size_t> NameMap;
+
+          //-------------------------------------------------------------------
+          MessageBinaryEncoder()
+          {
+            mBuffer.reserve(1024);
+            mBuffer.push_back((BYTE)OPENPEER_STACK_MESSAGE_BINARY_MAGIC);
+            mBuffer.push_back((BYTE)OPENPEER_STACK_MESSAGE_BINARY_VERSION);
+          }
+
+          //-------------------------------------------------------------------
+          void writeElement(ElementPtr el)
+          {
+            writeName(el->getValue());
+
+            size_t totalAttributes = 0;
+            for (NodePtr node = el->getFirstAttribute(); node; node = node->getNextSibling()) {
+              ++totalAttributes;
+            }
+
+            writeVarint(totalAttributes);
+            for (NodePtr node = el->getFirstAttribute(); node; node = node->getNextSibling()) {
+              AttributePtr attribute = node->toAttribute();
+              writeName(attribute->getName());
+              writeValue(attribute->getValue());
+            }
+
+            size_t totalChildren = 0;
+            for (NodePtr node = el->getFirstChild(); node; node = node->getNextSibling()) {
+              if ((node->isElement()) || (node->isText())) ++totalChildren;
+            }
+
+            writeVarint(totalChildren);
+            for (NodePtr node = el->getFirstChild(); node; node = node->getNextSibling()) {
+              if (node->isElement()) {
+                mBuffer.push_back((BYTE)OPENPEER_STACK_MESSAGE_BINARY_TAG_ELEMENT);
+                writeElement(node->toElement());
+                continue;
+              }
+              if (node->isText()) {
+                TextPtr text = node->toText();
+                mBuffer.push_back((BYTE)OPENPEER_STACK_MESSAGE_BINARY_TAG_TEXT);
+                mBuffer.push_back((BYTE)text->getFormat());
+                writeValue(text->getValue());
+              }
+            }
+          }
+
+          //-------------------------------------------------------------------
+          SecureByteBlockPtr result() const
+          {
+            return SecureByteBlockPtr(new SecureByteBlock(&(mBuffer[0]), mBuffer.size()));
+          }
+
+        protected:
+          //-------------------------------------------------------------------
+          void writeVarint(size_t value)
+          {
+            while (value >= 0x80) {
+              mBuffer.push_back((BYTE)((value & 0x7F) | 0x80));
+              value >>= 7;
+            }
+            mBuffer.push_back((BYTE)value);
+          }
+
+          //-------------------------------------------------------------------
+          void writeValue(const String &value)
+          {
+            writeVarint(value.length());
+            mBuffer.insert(mBuffer.end(), (const BYTE *)value.c_str(), ((const BYTE *)value.c_str()) + value.length());
+          }
+
+          //-------------------------------------------------------------------
+          void writeName(const String &name)
+          {
+            NameMap::iterator found = mNames.find(name);
+            if (found != mNames.end()) {
+              writeVarint((((*found).second) << 1) | 1);
+              return;
+            }
+
+            size_t index = mNames.size();
+            mNames[name] = index;
+
+            writeVarint(name.length() << 1);
+            mBuffer.insert(mBuffer.end(), (const BYTE *)name.c_str(), ((const BYTE *)name.c_str()) + name.length());
+          }
+
+        protected:
+          Buffer mBuffer;
+          NameMap mNames;
+        };
+
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark MessageBinaryDecoder
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        class MessageBinaryDecoder
+        {
+        public:
+          typedef std::vector<String> NameList;
+
+          //-------------------------------------------------------------------
+          MessageBinaryDecoder(
+                               const BYTE *buffer,
+                               size_t lengthInBytes
+                               ) :
+            mPos(buffer),
+            mEnd(buffer + lengthInBytes)
+          {
+          }
+
+          //-------------------------------------------------------------------
+          bool readHeader()
+          {
+            if (!MessageBinary::isBinary(mPos, mEnd - mPos)) return false;
+            if ((mEnd - mPos) < 2) return false;
+            if (OPENPEER_STACK_MESSAGE_BINARY_VERSION != mPos[1]) return false;
+            mPos += 2;
+            return true;
+          }
+
+          //-------------------------------------------------------------------
+          bool readRoot(
+                        String &outName,
+                        MessageBinary::AttributeMap &outAttributes
+                        )
+          {
+            if (!readName(outName)) return false;
+
+            size_t totalAttributes = 0;
+            if (!readVarint(totalAttributes)) return false;
+
+            for (size_t loop = 0; loop < totalAttributes; ++loop) {
+              String name;
+              String value;
+              if (!readName(name)) return false;
+              if (!readValue(value)) return false;
+              outAttributes[name] = value;
+            }
+            return true;
+          }
+
+          //-------------------------------------------------------------------
+          ElementPtr readElement(ULONG depth)
+          {
+            if (depth > OPENPEER_STACK_MESSAGE_BINARY_MAX_DEPTH) return ElementPtr();
+
+            String name;
+            if (!readName(name)) return ElementPtr();
+
+            ElementPtr el = Element::create(name);
+
+            size_t totalAttributes = 0;
+            if (!readVarint(totalAttributes)) return ElementPtr();
+
+            for (size_t loop = 0; loop < totalAttributes; ++loop) {
+              String attributeName;
+              String value;
+              if (!readName(attributeName)) return ElementPtr();
+              if (!readValue(value)) return ElementPtr();
+              el->setAttribute(attributeName, value);
+            }
+
+            size_t totalChildren = 0;
+            if (!readVarint(totalChildren)) return ElementPtr();
+
+            for (size_t loop = 0; loop < totalChildren; ++loop) {
+              if (mPos >= mEnd) return ElementPtr();
+
+              BYTE tag = *mPos;
+              ++mPos;
+
+              switch (tag) {
+                case OPENPEER_STACK_MESSAGE_BINARY_TAG_ELEMENT: {
+                  ElementPtr childEl = readElement(depth + 1);
+                  if (!childEl) return ElementPtr();
+                  el->adoptAsLastChild(childEl);
+                  break;
+                }
+                case OPENPEER_STACK_MESSAGE_BINARY_TAG_TEXT: {
+                  if (mPos >= mEnd) return ElementPtr();
+                  BYTE format = *mPos;
+                  ++mPos;
+
+                  Text::Formats textFormat = Text::Format_EntityEncoded;
+                  if (!toTextFormat(format, textFormat)) return ElementPtr();
+
+                  String value;
+                  if (!readValue(value)) return ElementPtr();
+
+                  TextPtr text = Text::create();
+                  text->setValue(value, textFormat);
+                  el->adoptAsLastChild(text);
+                  break;
+                }
+                default: return ElementPtr();
+              }
+            }
+
+            return el;
+          }
+
+        protected:
+          //-------------------------------------------------------------------
+          bool readVarint(size_t &outValue)
+          {
+            outValue = 0;
+            for (ULONG shift = 0; shift < 35; shift += 7) {
+              if (mPos >= mEnd) return false;
+              BYTE value = *mPos;
+              ++mPos;
+              outValue |= (((size_t)(value & 0x7F)) << shift);
+              if (0 == (value & 0x80)) return true;
+            }
+            return false;
+          }
+
+          //-------------------------------------------------------------------
+          bool readBytes(
+                         size_t length,
+                         String &outValue
+                         )
+          {
+            if (length > (size_t)(mEnd - mPos)) return false;
+            outValue = String((const char *)mPos, length);
+            mPos += length;
+            return true;
+          }
+
+          //-------------------------------------------------------------------
+          bool readValue(String &outValue)
+          {
+            size_t length = 0;
+            if (!readVarint(length)) return false;
+            return readBytes(length, outValue);
+          }
+
+          //-------------------------------------------------------------------
+          static bool toTextFormat(
+                                   BYTE value,
+                                   Text::Formats &outFormat
+                                   )
+          {
+            // never hand a value read off the wire to zsLib unchecked
+            switch (value) {
+              case Text::Format_EntityEncoded:
+              case Text::Format_CDATA:
+              case Text::Format_JSONStringEncoded:
+              case Text::Format_JSONNumberEncoded:  {
+                outFormat = (Text::Formats)value;
+                return true;
+              }
+            }
+            return false;
+          }
+
+          //-------------------------------------------------------------------
+          bool readName(String &outName)
+          {
+            size_t value = 0;
+            if (!readVarint(value)) return false;
+
+            if (0 != (value & 1)) {
+              size_t index = (value >> 1);
+              if (index >= mNames.size()) return false;
+              outName = mNames[index];
+              return true;
+            }
+
+            if (!readBytes(value >> 1, outName)) return false;
+            mNames.push_back(outName);
+            return true;
+          }
+
+        protected:
+          const BYTE *mPos;
+          const BYTE *mEnd;
+
+          NameList mNames;
+        };
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageBinary
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      bool MessageBinary::isEnabled()
+      {
+        return services::ISettings::getBool(OPENPEER_STACK_SETTING_MESSAGE_BINARY_ENCODING_ENABLED);
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageBinary::isBinary(
+                                   const BYTE *buffer,
+                                   size_t lengthInBytes
+                                   )
+      {
+        if ((!buffer) || (lengthInBytes < 1)) return false;
+        return (OPENPEER_STACK_MESSAGE_BINARY_MAGIC == buffer[0]);
+      }
+
+      //-----------------------------------------------------------------------
+      SecureByteBlockPtr MessageBinary::encode(
+                                               DocumentPtr document,
+                                               bool excludeAppID
+                                               )
+      {
+        if (!document) return SecureByteBlockPtr();
+
+        ElementPtr rootEl = document->getFirstChildElement();
+        if (!rootEl) return SecureByteBlockPtr();
+
+        if (excludeAppID) {
+          AttributePtr appID = rootEl->findAttribute("appid");
+          if (appID) {
+            appID->orphan();
+          }
+        }
+
+        internal::MessageBinaryEncoder encoder;
+        encoder.writeElement(rootEl);
+        return encoder.result();
+      }
+
+      //-----------------------------------------------------------------------
+      DocumentPtr MessageBinary::decode(
+                                        const BYTE *buffer,
+                                        size_t lengthInBytes
+                                        )
+      {
+        internal::MessageBinaryDecoder decoder(buffer, lengthInBytes);
+        if (!decoder.readHeader()) return DocumentPtr();
+
+        ElementPtr rootEl = decoder.readElement(0);
+        if (!rootEl) return DocumentPtr();
+
+        DocumentPtr document = Document::create();
+        document->setElementNameIsCaseSensative(true);
+        document->setAttributeNameIsCaseSensative(true);
+        document->adoptAsLastChild(rootEl);
+        return document;
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageBinary::scanRoot(
+                                   const BYTE *buffer,
+                                   size_t lengthInBytes,
+                                   String &outName,
+                                   AttributeMap &outAttributes
+                                   )
+      {
+        outName.clear();
+        outAttributes.clear();
+
+        internal::MessageBinaryDecoder decoder(buffer, lengthInBytes);
+        if (!decoder.readHeader()) return false;
+        return decoder.readRoot(outName, outAttributes);
+      }
+
+      //-----------------------------------------------------------------------
+      StringList MessageBinary::offeredEncodings()
+      {
+        StringList result;
+        if (!isEnabled()) return result;
+
+        result.push_back(OPENPEER_STACK_MESSAGE_ENCODING_BINARY);
+        result.push_back(OPENPEER_STACK_MESSAGE_ENCODING_JSON);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      String MessageBinary::selectEncoding(const StringList &offered)
+      {
+        if (offered.size() < 1) return String();
+
+        if (isEnabled()) {
+          for (StringList::const_iterator iter = offered.begin(); iter != offered.end(); ++iter) {
+            if (OPENPEER_STACK_MESSAGE_ENCODING_BINARY == (*iter)) return OPENPEER_STACK_MESSAGE_ENCODING_BINARY;
+          }
+        }
+        return OPENPEER_STACK_MESSAGE_ENCODING_JSON;
+      }
+    }
+  }
+}
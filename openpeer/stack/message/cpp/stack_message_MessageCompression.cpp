@@ -0,0 +1,400 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/message/MessageCompression.h>
+
+#include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/Log.h>
+
+#include <cryptopp/zdeflate.h>
+#include <cryptopp/zinflate.h>
+
+#include <cstring>
+
+#define OPENPEER_STACK_MESSAGE_COMPRESSION_INFLATE_CHUNK_SIZE_IN_BYTES (4*1024)
+
+namespace openpeer { namespace stack { namespace message { ZS_DECLARE_SUBSYSTEM(openpeer_stack_message) } } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      using services::IHelper;
+      using zsLib::ULONG;
+      using zsLib::QWORD;
+      using zsLib::Time;
+      using zsLib::Duration;
+      using zsLib::RecursiveLock;
+      using zsLib::AutoRecursiveLock;
+
+      namespace internal
+      {
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark MessageCompressionStatistics
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        struct MessageCompressionStatistics
+        {
+          QWORD mFramesCompressed;
+          QWORD mFramesSkipped;
+          QWORD mBytesBeforeCompression;
+          QWORD mBytesAfterCompression;
+          Duration mCompressTime;
+
+          QWORD mFramesInflated;
+          QWORD mFramesFailedToInflate;
+          QWORD mBytesBeforeInflation;
+          QWORD mBytesAfterInflation;
+          Duration mInflateTime;
+
+          MessageCompressionStatistics() :
+            mFramesCompressed(0),
+            mFramesSkipped(0),
+            mBytesBeforeCompression(0),
+            mBytesAfterCompression(0),
+            mFramesInflated(0),
+            mFramesFailedToInflate(0),
+            mBytesBeforeInflation(0),
+            mBytesAfterInflation(0)
+          {
+          }
+        };
+
+        //---------------------------------------------------------------------
+        ZS_DECLARE_CLASS_PTR(MessageCompressionMetrics)
+
+        class MessageCompressionMetrics
+        {
+        protected:
+          //-------------------------------------------------------------------
+          MessageCompressionMetrics() {}
+
+          //-------------------------------------------------------------------
+          static MessageCompressionMetricsPtr create()
+          {
+            return MessageCompressionMetricsPtr(new MessageCompressionMetrics);
+          }
+
+        public:
+          //-------------------------------------------------------------------
+          static MessageCompressionMetricsPtr singleton()
+          {
+            static SingletonLazySharedPtr<MessageCompressionMetrics> singleton(create());
+            return singleton.singleton();
+          }
+
+          //-------------------------------------------------------------------
+          void notifySkipped()
+          {
+            AutoRecursiveLock lock(mLock);
+            ++mStatistics.mFramesSkipped;
+          }
+
+          //-------------------------------------------------------------------
+          void notifyCompressed(
+                                size_t before,
+                                size_t after,
+                                Duration spent
+                                )
+          {
+            AutoRecursiveLock lock(mLock);
+            ++mStatistics.mFramesCompressed;
+            mStatistics.mBytesBeforeCompression += before;
+            mStatistics.mBytesAfterCompression += after;
+            mStatistics.mCompressTime += spent;
+          }
+
+          //-------------------------------------------------------------------
+          void notifyInflated(
+                              size_t before,
+                              size_t after,
+                              Duration spent
+                              )
+          {
+            AutoRecursiveLock lock(mLock);
+            ++mStatistics.mFramesInflated;
+            mStatistics.mBytesBeforeInflation += before;
+            mStatistics.mBytesAfterInflation += after;
+            mStatistics.mInflateTime += spent;
+          }
+
+          //-------------------------------------------------------------------
+          void notifyInflateFailed()
+          {
+            AutoRecursiveLock lock(mLock);
+            ++mStatistics.mFramesFailedToInflate;
+          }
+
+          //-------------------------------------------------------------------
+          MessageCompressionStatistics snapshot(bool resetAfterSnapshot)
+          {
+            AutoRecursiveLock lock(mLock);
+            MessageCompressionStatistics result = mStatistics;
+            if (resetAfterSnapshot) {
+              mStatistics = MessageCompressionStatistics();
+            }
+            return result;
+          }
+
+        protected:
+          RecursiveLock mLock;
+          MessageCompressionStatistics mStatistics;
+        };
+
+        //---------------------------------------------------------------------
+        static Log::Params slog(const char *message)
+        {
+          return Log::Params(message, "stack::message::MessageCompression");
+        }
+
+        //---------------------------------------------------------------------
+        static void writeVarint(
+                                BYTE *buffer,
+                                size_t &ioPos,
+                                size_t value
+                                )
+        {
+          while (value >= 0x80) {
+            buffer[ioPos] = (BYTE)((value & 0x7F) | 0x80);
+            ++ioPos;
+            value >>= 7;
+          }
+          buffer[ioPos] = (BYTE)value;
+          ++ioPos;
+        }
+
+        //---------------------------------------------------------------------
+        static bool readVarint(
+                               const BYTE *buffer,
+                               size_t lengthInBytes,
+                               size_t &ioPos,
+                               size_t &outValue
+                               )
+        {
+          outValue = 0;
+          for (ULONG shift = 0; shift < 35; shift += 7) {
+            if (ioPos >= lengthInBytes) return false;
+            BYTE value = buffer[ioPos];
+            ++ioPos;
+            outValue |= (((size_t)(value & 0x7F)) << shift);
+            if (0 == (value & 0x80)) return true;
+          }
+          return false;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageCompression
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      bool MessageCompression::isEnabled()
+      {
+        return services::ISettings::getBool(OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_ENABLED);
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageCompression::isCompressed(
+                                            const BYTE *buffer,
+                                            size_t lengthInBytes
+                                            )
+      {
+        if ((!buffer) || (lengthInBytes < 1)) return false;
+        return (OPENPEER_STACK_MESSAGE_COMPRESSION_MAGIC == buffer[0]);
+      }
+
+      //-----------------------------------------------------------------------
+      SecureByteBlockPtr MessageCompression::compress(
+                                                      const BYTE *buffer,
+                                                      size_t lengthInBytes
+                                                      )
+      {
+        internal::MessageCompressionMetricsPtr metrics = internal::MessageCompressionMetrics::singleton();
+
+        size_t threshold = services::ISettings::getUInt(OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES);
+        if ((!buffer) ||
+            (lengthInBytes < threshold) ||
+            (lengthInBytes < 1)) {
+          if (metrics) metrics->notifySkipped();
+          return SecureByteBlockPtr();
+        }
+
+        Time start = zsLib::now();
+
+        CryptoPP::Deflator deflator(NULL, CryptoPP::Deflator::DEFAULT_DEFLATE_LEVEL);
+        deflator.Put(buffer, lengthInBytes);
+        deflator.MessageEnd();
+
+        size_t deflatedSize = static_cast<size_t>(deflator.MaxRetrievable());
+
+        BYTE header[1 + 5] = {};
+        size_t headerSize = 0;
+        header[headerSize] = (BYTE)OPENPEER_STACK_MESSAGE_COMPRESSION_MAGIC;
+        ++headerSize;
+        internal::writeVarint(header, headerSize, lengthInBytes);
+
+        if (headerSize + deflatedSize >= lengthInBytes) {
+          ZS_LOG_TRACE(internal::slog("frame does not shrink (thus sending uncompressed)") + ZS_PARAM("size", lengthInBytes) + ZS_PARAM("deflated", deflatedSize))
+          if (metrics) metrics->notifySkipped();
+          return SecureByteBlockPtr();
+        }
+
+        SecureByteBlockPtr result(new SecureByteBlock(headerSize + deflatedSize));
+        memcpy(result->BytePtr(), &(header[0]), headerSize);
+        deflator.Get(result->BytePtr() + headerSize, deflatedSize);
+
+        if (metrics) metrics->notifyCompressed(lengthInBytes, result->SizeInBytes(), zsLib::now() - start);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      SecureByteBlockPtr MessageCompression::decompress(
+                                                        const BYTE *buffer,
+                                                        size_t lengthInBytes
+                                                        )
+      {
+        internal::MessageCompressionMetricsPtr metrics = internal::MessageCompressionMetrics::singleton();
+
+        if (!isCompressed(buffer, lengthInBytes)) {
+          if (metrics) metrics->notifyInflateFailed();
+          return SecureByteBlockPtr();
+        }
+
+        size_t pos = 1;
+        size_t inflatedSize = 0;
+        if ((!internal::readVarint(buffer, lengthInBytes, pos, inflatedSize)) ||
+            (inflatedSize > OPENPEER_STACK_MESSAGE_COMPRESSION_MAX_INFLATED_SIZE_IN_BYTES)) {
+          ZS_LOG_WARNING(Detail, internal::slog("compressed frame header is not valid") + ZS_PARAM("size", lengthInBytes))
+          if (metrics) metrics->notifyInflateFailed();
+          return SecureByteBlockPtr();
+        }
+
+        Time start = zsLib::now();
+
+        CryptoPP::Inflator inflator;
+        try {
+          // NOTE: fed in chunks so a frame lying about its size is caught
+          //       before it inflates much past what it declared
+          while (pos < lengthInBytes) {
+            size_t chunk = lengthInBytes - pos;
+            if (chunk > OPENPEER_STACK_MESSAGE_COMPRESSION_INFLATE_CHUNK_SIZE_IN_BYTES) chunk = OPENPEER_STACK_MESSAGE_COMPRESSION_INFLATE_CHUNK_SIZE_IN_BYTES;
+
+            inflator.Put(buffer + pos, chunk);
+            pos += chunk;
+
+            if (inflator.MaxRetrievable() > inflatedSize) break;
+          }
+          inflator.MessageEnd();
+        } catch (CryptoPP::Exception &) {
+          ZS_LOG_WARNING(Detail, internal::slog("compressed frame failed to inflate") + ZS_PARAM("size", lengthInBytes))
+          if (metrics) metrics->notifyInflateFailed();
+          return SecureByteBlockPtr();
+        }
+
+        if (inflatedSize != inflator.MaxRetrievable()) {
+          ZS_LOG_WARNING(Detail, internal::slog("compressed frame did not inflate to its declared size") + ZS_PARAM("declared", inflatedSize) + ZS_PARAM("inflated", inflator.MaxRetrievable()))
+          if (metrics) metrics->notifyInflateFailed();
+          return SecureByteBlockPtr();
+        }
+
+        SecureByteBlockPtr result(new SecureByteBlock(inflatedSize + sizeof(char)));
+        inflator.Get(result->BytePtr(), inflatedSize);
+        result->BytePtr()[inflatedSize] = 0;
+
+        if (metrics) metrics->notifyInflated(lengthInBytes, inflatedSize, zsLib::now() - start);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageCompression::offerCompression(StringList &ioEncodings)
+      {
+        if (!isEnabled()) return;
+        ioEncodings.push_back(OPENPEER_STACK_MESSAGE_COMPRESSION_DEFLATE);
+      }
+
+      //-----------------------------------------------------------------------
+      String MessageCompression::selectCompression(const StringList &offered)
+      {
+        if (!isEnabled()) return String();
+
+        for (StringList::const_iterator iter = offered.begin(); iter != offered.end(); ++iter) {
+          if (OPENPEER_STACK_MESSAGE_COMPRESSION_DEFLATE == (*iter)) return OPENPEER_STACK_MESSAGE_COMPRESSION_DEFLATE;
+        }
+        return String();
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr MessageCompression::getStatistics(bool resetAfterSnapshot)
+      {
+        internal::MessageCompressionStatistics stats;
+
+        internal::MessageCompressionMetricsPtr metrics = internal::MessageCompressionMetrics::singleton();
+        if (metrics) stats = metrics->snapshot(resetAfterSnapshot);
+
+        ElementPtr resultEl = Element::create("message::MessageCompression::Statistics");
+
+        IHelper::debugAppend(resultEl, "enabled", isEnabled());
+        IHelper::debugAppend(resultEl, "threshold", services::ISettings::getUInt(OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES));
+
+        IHelper::debugAppend(resultEl, "frames compressed", stats.mFramesCompressed);
+        IHelper::debugAppend(resultEl, "frames skipped", stats.mFramesSkipped);
+        IHelper::debugAppend(resultEl, "bytes before compression", stats.mBytesBeforeCompression);
+        IHelper::debugAppend(resultEl, "bytes after compression", stats.mBytesAfterCompression);
+        IHelper::debugAppend(resultEl, "bytes saved", stats.mBytesBeforeCompression - stats.mBytesAfterCompression);
+        IHelper::debugAppend(resultEl, "compress time (us)", stats.mCompressTime.total_microseconds());
+
+        IHelper::debugAppend(resultEl, "frames inflated", stats.mFramesInflated);
+        IHelper::debugAppend(resultEl, "frames failed to inflate", stats.mFramesFailedToInflate);
+        IHelper::debugAppend(resultEl, "bytes before inflation", stats.mBytesBeforeInflation);
+        IHelper::debugAppend(resultEl, "bytes after inflation", stats.mBytesAfterInflation);
+        IHelper::debugAppend(resultEl, "inflate time (us)", stats.mInflateTime.total_microseconds());
+
+        return resultEl;
+      }
+    }
+  }
+}
@@ -0,0 +1,332 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/message/MessageEnvelope.h>
+#include <openpeer/stack/message/MessageBinary.h>
+#include <openpeer/stack/message/MessageCompression.h>
+
+#include <openpeer/services/IHelper.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/Log.h>
+
+#include <cstring>
+
+namespace openpeer { namespace stack { namespace message { ZS_DECLARE_SUBSYSTEM(openpeer_stack_message) } } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      using services::IHelper;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void skipWhitespace(
+                                 const char * &ioPos,
+                                 const char *end
+                                 )
+      {
+        while ((ioPos < end) &&
+               ((' ' == *ioPos) || ('\t' == *ioPos) || ('\r' == *ioPos) || ('\n' == *ioPos))) {
+          ++ioPos;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static bool scanString(
+                             const char * &ioPos,
+                             const char *end,
+                             String *outValue
+                             )
+      {
+        if ((ioPos >= end) || ('"' != *ioPos)) return false;
+        ++ioPos;
+
+        const char *start = ioPos;
+
+        while (ioPos < end) {
+          switch (*ioPos) {
+            case '\0':  return false;
+            case '"':   {
+              if (outValue) {
+                *outValue = String(start, ioPos - start);
+              }
+              ++ioPos;
+              return true;
+            }
+            case '\\':  {
+              // escaped routing values are not expected, let the full parser
+              // deal with them
+              if (outValue) return false;
+              ++ioPos;
+              break;
+            }
+          }
+          ++ioPos;
+        }
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      static bool skipValue(
+                            const char * &ioPos,
+                            const char *end
+                            )
+      {
+        if (ioPos >= end) return false;
+
+        if ('"' == *ioPos) return scanString(ioPos, end, NULL);
+
+        ULONG depth = 0;
+
+        while (ioPos < end) {
+          switch (*ioPos) {
+            case '\0':  return false;
+            case '"':   {
+              if (!scanString(ioPos, end, NULL)) return false;
+              continue;
+            }
+            case '{':
+            case '[':   ++depth; break;
+            case '}':
+            case ']':   {
+              if (0 == depth) return true;
+              --depth;
+              if (0 == depth) {
+                ++ioPos;
+                return true;
+              }
+              break;
+            }
+            case ',':   {
+              if (0 == depth) return true;
+              break;
+            }
+          }
+          ++ioPos;
+        }
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      static bool scanFrame(
+                            SecureByteBlockPtr raw,
+                            MessageEnvelope &outEnvelope
+                            )
+      {
+        outEnvelope = MessageEnvelope();
+        outEnvelope.mRaw = raw;
+
+        if (!raw) return false;
+
+        if (MessageCompression::isCompressed(raw->BytePtr(), raw->SizeInBytes())) {
+          outEnvelope.mCompressed = true;
+
+          raw = MessageCompression::decompress(raw->BytePtr(), raw->SizeInBytes());
+          if (!raw) return false;
+
+          outEnvelope.mRaw = raw;
+        }
+
+        if (MessageBinary::isBinary(raw->BytePtr(), raw->SizeInBytes())) {
+          outEnvelope.mBinary = true;
+
+          String rootName;
+          MessageBinary::AttributeMap attributes;
+          if (!MessageBinary::scanRoot(raw->BytePtr(), raw->SizeInBytes(), rootName, attributes)) return false;
+
+          Message::MessageTypes type = Message::toMessageType(rootName);
+          if (Message::MessageType_Invalid == type) return false;
+
+          outEnvelope.mType = type;
+          outEnvelope.mID = attributes["id"];
+          outEnvelope.mHandler = attributes["handler"];
+          outEnvelope.mMethod = attributes["method"];
+          outEnvelope.mAppID = attributes["appid"];
+          return true;
+        }
+
+        const char *pos = (const char *)(raw->BytePtr());
+        const char *end = pos + raw->SizeInBytes();
+
+        // scope: root element, i.e. {"request":{
+        {
+          skipWhitespace(pos, end);
+          if ((pos >= end) || ('{' != *pos)) return false;   // not JSON (e.g. XML)
+          ++pos;
+
+          skipWhitespace(pos, end);
+
+          String rootName;
+          if (!scanString(pos, end, &rootName)) return false;
+
+          skipWhitespace(pos, end);
+          if ((pos >= end) || (':' != *pos)) return false;
+          ++pos;
+
+          skipWhitespace(pos, end);
+          if ((pos >= end) || ('{' != *pos)) return false;
+          ++pos;
+
+          Message::MessageTypes type = Message::toMessageType(rootName);
+          if (Message::MessageType_Invalid == type) return false;
+
+          outEnvelope.mType = type;
+        }
+
+        ULONG remaining = 4;
+
+        while (remaining > 0) {
+          skipWhitespace(pos, end);
+          if (pos >= end) return false;
+          if ('}' == *pos) break;
+
+          String name;
+          if (!scanString(pos, end, &name)) return false;
+
+          skipWhitespace(pos, end);
+          if ((pos >= end) || (':' != *pos)) return false;
+          ++pos;
+          skipWhitespace(pos, end);
+
+          String *value = NULL;
+          if ("$id" == name) value = &(outEnvelope.mID);
+          else if ("$handler" == name) value = &(outEnvelope.mHandler);
+          else if ("$method" == name) value = &(outEnvelope.mMethod);
+          else if ("$appid" == name) value = &(outEnvelope.mAppID);
+
+          if ((value) &&
+              (pos < end) &&
+              ('"' == *pos)) {
+            if (!scanString(pos, end, value)) return false;
+            --remaining;
+          } else {
+            if (!skipValue(pos, end)) return false;
+          }
+
+          skipWhitespace(pos, end);
+          if ((pos < end) && (',' == *pos)) ++pos;
+        }
+
+        return true;
+      }
+
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageEnvelope
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      MessageEnvelope::MessageEnvelope() :
+        mType(Message::MessageType_Invalid),
+        mBinary(false),
+        mCompressed(false)
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageEnvelope::scan(
+                                 SecureByteBlockPtr raw,
+                                 MessageEnvelope &outEnvelope
+                                 )
+      {
+        if (scanFrame(raw, outEnvelope)) return true;
+
+        // NOTE: a partial scan must not look like routing information (an
+        //       empty ID would never match a monitor) so only the frame is
+        //       kept, letting the caller fall back to a full decode
+        MessageEnvelope failed;
+        failed.mRaw = outEnvelope.mRaw;
+        failed.mBinary = outEnvelope.mBinary;
+        failed.mCompressed = outEnvelope.mCompressed;
+        outEnvelope = failed;
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      MessagePtr MessageEnvelope::decode(IMessageSourcePtr messageSource) const
+      {
+        if (!mRaw) return MessagePtr();
+
+        return Message::create(mRaw, messageSource);
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageEnvelope::hasData() const
+      {
+        return (Message::MessageType_Invalid != mType);
+      }
+
+      //-----------------------------------------------------------------------
+      const char *MessageEnvelope::logText() const
+      {
+        if (mBinary) return "(binary)";
+        if (!mRaw) return "";
+        if ((mCompressed) &&
+            (MessageCompression::isCompressed(mRaw->BytePtr(), mRaw->SizeInBytes()))) return "(compressed)";
+        return (const char *)(mRaw->BytePtr());
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr MessageEnvelope::toDebug() const
+      {
+        ElementPtr resultEl = Element::create("message::MessageEnvelope");
+
+        IHelper::debugAppend(resultEl, "type", Message::toString(mType));
+        IHelper::debugAppend(resultEl, "id", mID);
+        IHelper::debugAppend(resultEl, "handler", mHandler);
+        IHelper::debugAppend(resultEl, "method", mMethod);
+        IHelper::debugAppend(resultEl, "appid", mAppID);
+        IHelper::debugAppend(resultEl, "raw", mRaw ? mRaw->SizeInBytes() : 0);
+        IHelper::debugAppend(resultEl, "binary", mBinary);
+        IHelper::debugAppend(resultEl, "compressed", mCompressed);
+
+        return resultEl;
+      }
+
+    }
+  }
+}
@@ -36,8 +36,24 @@
 #include <openpeer/stack/message/MessageResult.h>
 #include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
 #include <openpeer/stack/message/IMessageFactory.h>
+#include <openpeer/stack/message/bootstrapped-finder/MessageFactoryBootstrappedFinder.h>
+#include <openpeer/stack/message/bootstrapper/MessageFactoryBootstrapper.h>
+#include <openpeer/stack/message/certificates/MessageFactoryCertificates.h>
+#include <openpeer/stack/message/identity/MessageFactoryIdentity.h>
+#include <openpeer/stack/message/identity-lookup/MessageFactoryIdentityLookup.h>
+#include <openpeer/stack/message/identity-lockbox/MessageFactoryIdentityLockbox.h>
+#include <openpeer/stack/message/namespace-grant/MessageFactoryNamespaceGrant.h>
+#include <openpeer/stack/message/rolodex/MessageFactoryRolodex.h>
+#include <openpeer/stack/message/peer/MessageFactoryPeer.h>
+#include <openpeer/stack/message/peer-common/MessageFactoryPeerCommon.h>
+#include <openpeer/stack/message/peer-finder/MessageFactoryPeerFinder.h>
+#include <openpeer/stack/message/peer-salt/MessageFactoryPeerSalt.h>
+#include <openpeer/stack/message/peer-to-peer/MessageFactoryPeerToPeer.h>
+
+#include <openpeer/stack/internal/stack_Helper.h>
 
 #include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
 
 #include <zsLib/Log.h>
 #include <zsLib/XML.h>
@@ -54,8 +70,28 @@ namespace openpeer
       {
         using services::IHelper;
 
+        using bootstrapped_finder::MessageFactoryBootstrappedFinder;
+        using bootstrapper::MessageFactoryBootstrapper;
+        using certificates::MessageFactoryCertificates;
+        using identity::MessageFactoryIdentity;
+        using identity_lookup::MessageFactoryIdentityLookup;
+        using identity_lockbox::MessageFactoryIdentityLockbox;
+        using namespace_grant::MessageFactoryNamespaceGrant;
+        using rolodex::MessageFactoryRolodex;
+        using peer::MessageFactoryPeer;
+        using peer_common::MessageFactoryPeerCommon;
+        using peer_finder::MessageFactoryPeerFinder;
+        using peer_salt::MessageFactoryPeerSalt;
+        using peer_to_peer::MessageFactoryPeerToPeer;
+
         typedef zsLib::XML::Exceptions::CheckFailed CheckFailed;
 
+        // upper bound when enumerating a factory's method codes via toString()
+        #define OPENPEER_STACK_MESSAGE_FACTORY_MANAGER_MAX_METHODS (256)
+
+        // rough DOM cost per element (node, name, attributes and text)
+        #define OPENPEER_STACK_MESSAGE_FACTORY_MANAGER_ESTIMATED_BYTES_PER_ELEMENT (256)
+
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
@@ -97,7 +133,35 @@ namespace openpeer
         }
 
         //---------------------------------------------------------------------
-        MessageFactoryManager::MessageFactoryManager()
+        const char *MessageFactoryManager::toString(CreationElementModes mode)
+        {
+          switch (mode)
+          {
+            case CreationElementMode_Keep:      return "keep";
+            case CreationElementMode_Compact:   return "compact";
+            case CreationElementMode_Release:   return "release";
+            case CreationElementMode_Arena:     return "arena";
+          }
+          return "UNDEFINED";
+        }
+
+        //---------------------------------------------------------------------
+        MessageFactoryManager::CreationElementModes MessageFactoryManager::toCreationElementMode(const char *inMode)
+        {
+          String mode(inMode ? inMode : "");
+
+          for (int loop = (int)CreationElementMode_Keep; loop <= (int)CreationElementMode_Arena; ++loop)
+          {
+            if (mode == toString((CreationElementModes)loop)) {
+              return (CreationElementModes)loop;
+            }
+          }
+          return CreationElementMode_Keep;
+        }
+
+        //---------------------------------------------------------------------
+        MessageFactoryManager::MessageFactoryManager() :
+          mFrozen(false)
         {
         }
 
@@ -127,6 +191,41 @@ namespace openpeer
           return singleton;
         }
 
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark MessageFactoryManager::Registry
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        const MessageFactoryManager::Registry::Entry *MessageFactoryManager::Registry::find(
+                                                                                            const char *handler,
+                                                                                            const char *method
+                                                                                            ) const
+        {
+          if (mTotal < 1) return NULL;
+
+          if (!handler) handler = "";
+          if (!method) method = "";
+
+          Hash value = MessageFactoryManager::hash(handler, method);
+
+          for (size_t index = value & mMask; true; index = (index + 1) & mMask)
+          {
+            const Entry &entry = mEntries[index];
+            if (!entry.mFactory) return NULL;
+
+            if (value != entry.mHash) continue;
+            if (entry.mHandler != handler) continue;
+            if (entry.mMethod != method) continue;
+
+            return &entry;
+          }
+          return NULL;
+        }
+
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
@@ -142,6 +241,92 @@ namespace openpeer
           pThis->internalRegisterFactory(factory);
         }
 
+        //---------------------------------------------------------------------
+        Message::Methods MessageFactoryManager::toMethod(
+                                                         const char *handler,
+                                                         const char *method
+                                                         )
+        {
+          MessageFactoryManagerPtr pThis = singleton();
+          if (!pThis) return Message::Method_Invalid;
+
+          RegistryPtr late;
+          const Registry::Entry *entry = pThis->find(handler, method, late);
+          if (!entry) return Message::Method_Invalid;
+          return entry->mMethodCode;
+        }
+
+        //---------------------------------------------------------------------
+        ElementPtr MessageFactoryManager::getCreationElementStatistics(bool resetAfterSnapshot)
+        {
+          MessageFactoryManagerPtr pThis = singleton();
+          if (!pThis) return ElementPtr();
+
+          CreationElementStatisticsMap statistics;
+
+          {
+            AutoRecursiveLock lock(pThis->mLock);
+            statistics = pThis->mCreationElementStatistics;
+            if (resetAfterSnapshot) {
+              pThis->mCreationElementStatistics.clear();
+            }
+          }
+
+          ElementPtr resultEl = Element::create("message::MessageFactoryManager::CreationElementStatistics");
+
+          IHelper::debugAppend(resultEl, "mode", toString(toCreationElementMode(services::ISettings::getString(OPENPEER_STACK_SETTING_MESSAGE_CREATION_ELEMENT_MODE))));
+
+          QWORD totalBefore = 0;
+          QWORD totalAfter = 0;
+
+          for (CreationElementStatisticsMap::iterator iter = statistics.begin(); iter != statistics.end(); ++iter)
+          {
+            const MessageTypeName &name = (*iter).first;
+            const CreationElementStatistics &stats = (*iter).second;
+
+            ElementPtr typeEl = Element::create("type");
+            IHelper::debugAppend(typeEl, "name", name);
+            IHelper::debugAppend(typeEl, "messages", stats.mTotal);
+            IHelper::debugAppend(typeEl, "estimated bytes before", stats.mEstimatedBytesBefore);
+            IHelper::debugAppend(typeEl, "estimated bytes after", stats.mEstimatedBytesAfter);
+            IHelper::debugAppend(typeEl, "estimated bytes saved", stats.mEstimatedBytesBefore - stats.mEstimatedBytesAfter);
+            IHelper::debugAppend(resultEl, typeEl);
+
+            totalBefore += stats.mEstimatedBytesBefore;
+            totalAfter += stats.mEstimatedBytesAfter;
+          }
+
+          IHelper::debugAppend(resultEl, "estimated bytes before", totalBefore);
+          IHelper::debugAppend(resultEl, "estimated bytes after", totalAfter);
+          IHelper::debugAppend(resultEl, "estimated bytes saved", totalBefore - totalAfter);
+
+          return resultEl;
+        }
+
+        //---------------------------------------------------------------------
+        MessageFactoryManager::CreationElementStatistics MessageFactoryManager::getCreationElementTotals(bool resetAfterSnapshot)
+        {
+          CreationElementStatistics result;
+
+          MessageFactoryManagerPtr pThis = singleton();
+          if (!pThis) return result;
+
+          AutoRecursiveLock lock(pThis->mLock);
+
+          for (CreationElementStatisticsMap::iterator iter = pThis->mCreationElementStatistics.begin(); iter != pThis->mCreationElementStatistics.end(); ++iter)
+          {
+            const CreationElementStatistics &stats = (*iter).second;
+            result.mTotal += stats.mTotal;
+            result.mEstimatedBytesBefore += stats.mEstimatedBytesBefore;
+            result.mEstimatedBytesAfter += stats.mEstimatedBytesAfter;
+          }
+
+          if (resetAfterSnapshot) {
+            pThis->mCreationElementStatistics.clear();
+          }
+          return result;
+        }
+
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
@@ -153,11 +338,12 @@ namespace openpeer
         //---------------------------------------------------------------------
         MessagePtr MessageFactoryManager::create(
                                                  ElementPtr root,
-                                                 IMessageSourcePtr messageSource
+                                                 IMessageSourcePtr messageSource,
+                                                 SecureByteBlockPtr creationBuffer
                                                  )
         {
           MessageFactoryManagerPtr pThis = singleton();
-          return pThis->internalCreate(root, messageSource);
+          return pThis->internalCreate(root, messageSource, creationBuffer);
         }
 
         //---------------------------------------------------------------------
@@ -195,21 +381,227 @@ namespace openpeer
           return Log::Params(message, objectEl);
         }
 
+        //---------------------------------------------------------------------
+        MessageFactoryManager::Hash MessageFactoryManager::hash(
+                                                                const char *handler,
+                                                                const char *method
+                                                                )
+        {
+          // hashed as "handler\0method"
+          return stack::internal::Helper::hash(method, stack::internal::Helper::hash((const BYTE *)handler, strlen(handler) + 1));
+        }
+
+        //---------------------------------------------------------------------
+        MessageFactoryManager::RegistryPtr MessageFactoryManager::buildRegistry(const FactoryList &factories)
+        {
+          typedef std::list<Registry::Entry> EntryList;
+
+          EntryList entries;
+
+          for (FactoryList::const_iterator iter = factories.begin(); iter != factories.end(); ++iter)
+          {
+            const IMessageFactoryPtr &factory = (*iter);
+            const char *handler = factory->getHandler();
+
+            Registry::Entry handlerEntry;
+            handlerEntry.mHandler = String(handler ? handler : "");
+            handlerEntry.mFactory = factory;
+            entries.push_back(handlerEntry);
+
+            // method codes are contiguous from the first valid value
+            for (int loop = ((int)Message::Method_Invalid) + 1; loop < OPENPEER_STACK_MESSAGE_FACTORY_MANAGER_MAX_METHODS; ++loop)
+            {
+              const char *method = factory->toString((Message::Methods)loop);
+              if ((!method) || ('\0' == *method)) break;
+
+              Registry::Entry entry;
+              entry.mHandler = handlerEntry.mHandler;
+              entry.mMethod = String(method);
+              entry.mFactory = factory;
+              entry.mMethodCode = (Message::Methods)loop;
+              entries.push_back(entry);
+            }
+          }
+
+          boost::shared_ptr<Registry> result(new Registry);
+
+          size_t capacity = 16;
+          while (capacity < (entries.size() * 2)) {
+            capacity <<= 1;
+          }
+
+          result->mEntries.resize(capacity);
+          result->mMask = capacity - 1;
+
+          for (EntryList::iterator iter = entries.begin(); iter != entries.end(); ++iter)
+          {
+            Registry::Entry &entry = (*iter);
+            entry.mHash = hash(entry.mHandler.c_str(), entry.mMethod.c_str());
+
+            // first registration of a (handler, method) wins, same as the
+            // previous registration order walk
+            if (result->find(entry.mHandler.c_str(), entry.mMethod.c_str())) continue;
+
+            size_t index = entry.mHash & result->mMask;
+            while (result->mEntries[index].mFactory) {
+              index = (index + 1) & result->mMask;
+            }
+            result->mEntries[index] = entry;
+            ++(result->mTotal);
+          }
+
+          return result;
+        }
+
+        //---------------------------------------------------------------------
+        const MessageFactoryManager::Registry &MessageFactoryManager::frozenRegistry()
+        {
+          // NOTE: built exactly once on first use (callers racing the first
+          //       use wait for it) and never changed afterwards
+          static RegistryPtr frozen = freezeRegistry();
+          return *frozen;
+        }
+
+        //---------------------------------------------------------------------
+        MessageFactoryManager::RegistryPtr MessageFactoryManager::freezeRegistry()
+        {
+          // every built-in factory registers before the registry is frozen
+          MessageFactoryBootstrappedFinder::singleton();
+          MessageFactoryBootstrapper::singleton();
+          MessageFactoryCertificates::singleton();
+          MessageFactoryIdentity::singleton();
+          MessageFactoryIdentityLookup::singleton();
+          MessageFactoryIdentityLockbox::singleton();
+          MessageFactoryNamespaceGrant::singleton();
+          MessageFactoryRolodex::singleton();
+          MessageFactoryPeer::singleton();
+          MessageFactoryPeerCommon::singleton();
+          MessageFactoryPeerFinder::singleton();
+          MessageFactoryPeerSalt::singleton();
+          MessageFactoryPeerToPeer::singleton();
+
+          AutoRecursiveLock lock(mLock);
+          mFrozen = true;
+
+          RegistryPtr registry = buildRegistry(mFactories);
+
+          ZS_LOG_DEBUG(log("message factory registry frozen") + ZS_PARAM("factories", mFactories.size()) + ZS_PARAM("registry entries", registry->mTotal) + ZS_PARAM("registry capacity", registry->mEntries.size()))
+          return registry;
+        }
+
+        //---------------------------------------------------------------------
+        const MessageFactoryManager::Registry::Entry *MessageFactoryManager::find(
+                                                                                  const char *handler,
+                                                                                  const char *method,
+                                                                                  RegistryPtr &outLateRegistry
+                                                                                  )
+        {
+          const Registry::Entry *entry = frozenRegistry().find(handler, method);
+          if (entry) return entry;
+
+          {
+            AutoRecursiveLock lock(mRegistryLock);
+            outLateRegistry = mLateRegistry;
+          }
+
+          if (!outLateRegistry) return NULL;
+          return outLateRegistry->find(handler, method);
+        }
+
+        //---------------------------------------------------------------------
+        MessageFactoryManager::ULONG MessageFactoryManager::countElements(ElementPtr el)
+        {
+          ULONG result = 0;
+          for (; el; el = el->getNextSiblingElement()) {
+            result += 1 + countElements(el->getFirstChildElement());
+          }
+          return result;
+        }
+
+        //---------------------------------------------------------------------
+        void MessageFactoryManager::applyCreationElementMode(
+                                                             MessagePtr message,
+                                                             ElementPtr root,
+                                                             const Registry::Entry &entry,
+                                                             Message::MessageTypes msgType,
+                                                             SecureByteBlockPtr creationBuffer
+                                                             )
+        {
+          CreationElementModes mode = toCreationElementMode(services::ISettings::getString(OPENPEER_STACK_SETTING_MESSAGE_CREATION_ELEMENT_MODE));
+          if (CreationElementMode_Keep == mode) return;
+
+          // NOTE: counts the tree just parsed (never asks the message for it
+          //       so nothing is re-parsed here)
+          if (!root) return;
+
+          // only the root element's own subtree is counted (never its siblings)
+          QWORD before = (QWORD)(1 + countElements(root->getFirstChildElement())) * OPENPEER_STACK_MESSAGE_FACTORY_MANAGER_ESTIMATED_BYTES_PER_ELEMENT;
+          QWORD after = 0;
+
+          switch (mode) {
+            case CreationElementMode_Keep:      break;
+            case CreationElementMode_Compact:   {
+              message->compactCreationElement();
+              after = (QWORD)message->creationRawSize();
+              break;
+            }
+            case CreationElementMode_Release:   {
+              message->releaseCreationElement();
+              break;
+            }
+            case CreationElementMode_Arena:     {
+              // NOTE: the tree is released in one step here; without the
+              //       original frame the JSON text is kept instead
+              if (creationBuffer) {
+                message->creationBuffer(creationBuffer);
+              } else {
+                message->compactCreationElement();
+              }
+              after = (QWORD)message->creationRawSize();
+              break;
+            }
+          }
+
+          MessageTypeName name = entry.mHandler + "/" + entry.mMethod + "/" + Message::toString(msgType);
+
+          AutoRecursiveLock lock(mLock);
+
+          CreationElementStatistics &stats = mCreationElementStatistics[name];
+          ++stats.mTotal;
+          stats.mEstimatedBytesBefore += before;
+          stats.mEstimatedBytesAfter += after;
+        }
+
         //---------------------------------------------------------------------
         void MessageFactoryManager::internalRegisterFactory(IMessageFactoryPtr factory)
         {
           AutoRecursiveLock lock(mLock);
-          mFactories.push_back(factory);
+
+          if (!mFrozen) {
+            mFactories.push_back(factory);
+            ZS_LOG_DEBUG(log("registered message factory") + ZS_PARAM("handler", factory->getHandler()) + ZS_PARAM("factories", mFactories.size()))
+            return;
+          }
+
+          mLateFactories.push_back(factory);
+
+          RegistryPtr registry = buildRegistry(mLateFactories);
+
+          {
+            AutoRecursiveLock registryLock(mRegistryLock);
+            mLateRegistry = registry;
+          }
+
+          ZS_LOG_DEBUG(log("registered message factory after registry was frozen") + ZS_PARAM("handler", factory->getHandler()) + ZS_PARAM("late factories", mLateFactories.size()) + ZS_PARAM("registry entries", registry->mTotal) + ZS_PARAM("registry capacity", registry->mEntries.size()))
         }
 
         //---------------------------------------------------------------------
         MessagePtr MessageFactoryManager::internalCreate(
                                                          ElementPtr root,
-                                                         IMessageSourcePtr messageSource
+                                                         IMessageSourcePtr messageSource,
+                                                         SecureByteBlockPtr creationBuffer
                                                          )
         {
-          AutoRecursiveLock lock(mLock);
-
           if (!root) {
             ZS_LOG_WARNING(Detail, log("cannot create message from null element"))
             return MessagePtr();
@@ -222,22 +614,22 @@ namespace openpeer
           if (Message::MessageType_Invalid == msgType) return MessagePtr();
 
           bool foundHandler = false;
+          RegistryPtr late;                       // keeps a late createdEntry alive
+          const Registry::Entry *createdEntry = NULL;
 
           try {
             message = MessageResult::createOnlyIfError(root);
             if (message) return message;
 
-            for (FactoryList::iterator iter = mFactories.begin(); iter != mFactories.end(); ++iter)
-            {
-              IMessageFactoryPtr &factory = (*iter);
-              const char *handlerFactory = factory->getHandler();
-
-              if (handlerStr != handlerFactory) continue;
+            String methodStr = IMessageHelper::getAttribute(root, "method");
 
-              message = factory->create(root, messageSource);
-              if (message) break;
-
-              foundHandler = true;
+            const Registry::Entry *entry = find(handlerStr, methodStr, late);
+            if (entry) {
+              message = entry->mFactory->create(root, messageSource);
+              foundHandler = !message;
+              createdEntry = (message ? entry : NULL);
+            } else {
+              foundHandler = (NULL != find(handlerStr, "", late));
             }
           } catch (CheckFailed &) {
             ZS_LOG_ERROR(Detail, log("expected element is missing"))
@@ -267,6 +659,9 @@ namespace openpeer
           if (message) {
             message->creationElement(root);
             message->creationSource(messageSource);
+            if (createdEntry) {
+              applyCreationElementMode(message, root, *createdEntry, msgType, creationBuffer);
+            }
             return message;
           }
 
@@ -281,29 +676,22 @@ namespace openpeer
                                                       IMessageFactoryPtr &outFactory
                                                       )
         {
-          AutoRecursiveLock lock(mLock);
-
           outMethod = Message::Method_Invalid;
           outFactory = IMessageFactoryPtr();
 
           String handlerStr = IMessageHelper::getAttribute(root, "handler");
           String methodStr = IMessageHelper::getAttribute(root, "method");
 
-          for (FactoryList::iterator iter = mFactories.begin(); iter != mFactories.end(); ++iter)
-          {
-            IMessageFactoryPtr &factory = (*iter);
-            const char *handlerFactory = factory->getHandler();
-
-            if (handlerStr != handlerFactory) continue;
-
-            Message::Methods method = factory->toMethod(methodStr);
-            if (Message::Method_Invalid != method) {
-              outMethod = method;
-              outFactory = factory;
-              return true;
-            }
+          RegistryPtr late;
+          const Registry::Entry *entry = find(handlerStr, methodStr, late);
+          if ((!entry) ||
+              (Message::Method_Invalid == entry->mMethodCode)) {
+            return false;
           }
-          return false;
+
+          outMethod = entry->mMethodCode;
+          outFactory = entry->mFactory;
+          return true;
         }
       }
 
@@ -320,6 +708,21 @@ namespace openpeer
       {
         internal::MessageFactoryManager::registerFactory(factory);
       }
+
+      //-----------------------------------------------------------------------
+      Message::Methods IMessageFactoryManager::toMethod(
+                                                        const char *handler,
+                                                        const char *method
+                                                        )
+      {
+        return internal::MessageFactoryManager::toMethod(handler, method);
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr IMessageFactoryManager::getCreationElementStatistics(bool resetAfterSnapshot)
+      {
+        return internal::MessageFactoryManager::getCreationElementStatistics(resetAfterSnapshot);
+      }
     }
   }
 }
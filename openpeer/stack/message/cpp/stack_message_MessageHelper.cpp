@@ -113,12 +113,12 @@ namespace openpeer
         String domain = message.domain();
 
         if (domain.hasData()) {
-          IMessageHelper::setAttribute(rootEl, "domain", domain);
+          IMessageHelper::setAttribute(rootEl, MessageNames::domain(), domain);
         }
 
         String appID = message.appID();
         if (appID.hasData()) {
-          IMessageHelper::setAttribute(rootEl, "appid", appID);
+          IMessageHelper::setAttribute(rootEl, MessageNames::appID(), appID);
         }
 
         Time time = message.time();
@@ -126,9 +126,9 @@ namespace openpeer
           IMessageHelper::setAttributeTimestamp(rootEl, time);
         }
 
-        IMessageHelper::setAttribute(rootEl, "handler", factory->getHandler());
+        IMessageHelper::setAttribute(rootEl, MessageNames::handler(), factory->getHandler());
         IMessageHelper::setAttributeID(rootEl, message.messageID());
-        IMessageHelper::setAttribute(rootEl, "method", factory->toString(message.method()));
+        IMessageHelper::setAttribute(rootEl, MessageNames::method(), factory->toString(message.method()));
 
         if (message.isResult()) {
           const message::MessageResult *msgResult = (dynamic_cast<const message::MessageResult *>(&message));
@@ -137,9 +137,9 @@ namespace openpeer
 
             ElementPtr errorEl;
             if (msgResult->hasAttribute(MessageResult::AttributeType_ErrorReason)) {
-              errorEl = IMessageHelper::createElementWithTextAndJSONEncode("error", msgResult->errorReason());
+              errorEl = IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::error(), msgResult->errorReason());
             } else {
-              errorEl = IMessageHelper::createElement("error");
+              errorEl = IMessageHelper::createElement(MessageNames::error());
             }
             if (msgResult->hasAttribute(MessageResult::AttributeType_ErrorCode)) {
               IMessageHelper:setAttributeID(errorEl, string(msgResult->errorCode()));
@@ -162,20 +162,20 @@ namespace openpeer
       //---------------------------------------------------------------------
       String IMessageHelper::getAttributeID(ElementPtr node)
       {
-        return IMessageHelper::getAttribute(node, "id");
+        return IMessageHelper::getAttribute(node, MessageNames::id());
       }
 
       //---------------------------------------------------------------------
       void IMessageHelper::setAttributeID(ElementPtr elem, const String &value)
       {
         if (value.isEmpty()) return;
-        IMessageHelper::setAttribute(elem, "id", value);
+        IMessageHelper::setAttribute(elem, MessageNames::id(), value);
       }
 
       //---------------------------------------------------------------------
       Time IMessageHelper::getAttributeEpoch(ElementPtr node)
       {
-        return IHelper::stringToTime(IMessageHelper::getAttribute(node, "timestamp"));
+        return IHelper::stringToTime(IMessageHelper::getAttribute(node, MessageNames::timestamp()));
       }
 
       //---------------------------------------------------------------------
@@ -183,7 +183,7 @@ namespace openpeer
       {
         if (!elem) return;
         if (Time() == value) return;
-        elem->setAttribute("timestamp", IHelper::timeToString(value), false);
+        elem->setAttribute(MessageNames::timestamp(), IHelper::timeToString(value), false);
       }
 
       //-----------------------------------------------------------------------
@@ -337,9 +337,9 @@ namespace openpeer
                                 IMessageSourcePtr source
                                 )
       {
-        String id = IMessageHelper::getAttribute(root, "id");
-        String domain = IMessageHelper::getAttribute(root, "domain");
-        String appID = IMessageHelper::getAttribute(root, "appid");
+        String id = IMessageHelper::getAttribute(root, MessageNames::id());
+        String domain = IMessageHelper::getAttribute(root, MessageNames::domain());
+        String appID = IMessageHelper::getAttribute(root, MessageNames::appID());
 
         if (id.hasData()) {
           message.messageID(id);
@@ -394,13 +394,13 @@ namespace openpeer
                                                 const char *encryptionPassphrase
                                                 )
         {
-          ElementPtr candidateEl = IMessageHelper::createElement("candidate");
+          ElementPtr candidateEl = IMessageHelper::createElement(MessageNames::candidate());
 
           if (candidate.mNamespace.hasData()) {
             candidateEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("namespace", candidate.mNamespace));
           }
           if (candidate.mTransport.hasData()) {
-            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("transport", candidate.mTransport));
+            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::transport(), candidate.mTransport));
           }
 
           const char *typeAsString = NULL;
@@ -413,11 +413,11 @@ namespace openpeer
           }
 
           if (typeAsString) {
-            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithText("type", typeAsString));
+            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::type(), typeAsString));
           }
 
           if (candidate.mFoundation.hasData()) {
-            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("foundation", candidate.mFoundation));
+            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::foundation(), candidate.mFoundation));
           }
 
           if (0 != candidate.mComponentID) {
@@ -426,26 +426,26 @@ namespace openpeer
 
           if (!candidate.mIPAddress.isEmpty()) {
             if (candidate.mAccessToken.hasData()) {
-              candidateEl->adoptAsLastChild(IMessageHelper::createElementWithText("host", candidate.mIPAddress.string(false)));
+              candidateEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::host(), candidate.mIPAddress.string(false)));
             } else {
-              candidateEl->adoptAsLastChild(IMessageHelper::createElementWithText("ip", candidate.mIPAddress.string(false)));
+              candidateEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::ip(), candidate.mIPAddress.string(false)));
             }
-            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("port", string(candidate.mIPAddress.getPort())));
+            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::port(), string(candidate.mIPAddress.getPort())));
           }
 
           if (0 != candidate.mPriority) {
-            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("priority", string(candidate.mPriority)));
+            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::priority(), string(candidate.mPriority)));
           }
 
           if (!candidate.mRelatedIP.isEmpty()) {
             ElementPtr relatedEl = Element::create("related");
             candidateEl->adoptAsLastChild(relatedEl);
-            relatedEl->adoptAsLastChild(IMessageHelper::createElementWithText("ip", candidate.mRelatedIP.string(false)));
-            relatedEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("port", string(candidate.mRelatedIP.getPort())));
+            relatedEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::ip(), candidate.mRelatedIP.string(false)));
+            relatedEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::port(), string(candidate.mRelatedIP.getPort())));
           }
 
           if (candidate.mAccessToken.hasData()) {
-            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("accessToken", candidate.mAccessToken));
+            candidateEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::accessToken(), candidate.mAccessToken));
           }
 
           if ((candidate.mAccessSecretProof.hasData()) &&
@@ -470,8 +470,8 @@ namespace openpeer
 
           UseLocationPtr location = Location::convert(locationInfo.mLocation);
 
-          ElementPtr locationEl = IMessageHelper::createElementWithID("location", location->getLocationID());
-          ElementPtr detailEl = IMessageHelper::createElement("details");
+          ElementPtr locationEl = IMessageHelper::createElementWithID(MessageNames::location(), location->getLocationID());
+          ElementPtr detailEl = IMessageHelper::createElement(MessageNames::details());
 
           if (!locationInfo.mDeviceID.isEmpty()) {
             detailEl->adoptAsLastChild(IMessageHelper::createElementWithID("device", locationInfo.mDeviceID));
@@ -479,25 +479,25 @@ namespace openpeer
 
           if (!locationInfo.mIPAddress.isAddressEmpty())
           {
-            ElementPtr ipEl = IMessageHelper::createElementWithText("ip", locationInfo.mIPAddress.string(false));
+            ElementPtr ipEl = IMessageHelper::createElementWithText(MessageNames::ip(), locationInfo.mIPAddress.string(false));
             detailEl->adoptAsLastChild(ipEl);
           }
 
           if (!locationInfo.mUserAgent.isEmpty())
-            detailEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("userAgent", locationInfo.mUserAgent));
+            detailEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::userAgent(), locationInfo.mUserAgent));
 
           if (!locationInfo.mOS.isEmpty())
-            detailEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("os", locationInfo.mOS));
+            detailEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::os(), locationInfo.mOS));
 
           if (!locationInfo.mSystem.isEmpty())
-            detailEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("system", locationInfo.mSystem));
+            detailEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::system(), locationInfo.mSystem));
 
           if (!locationInfo.mHost.isEmpty())
-            detailEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("host", locationInfo.mHost));
+            detailEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::host(), locationInfo.mHost));
 
           UsePeerPtr peer = location->getPeer();
           if (peer) {
-            locationEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("contact", peer->getPeerURI()));
+            locationEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::contact(), peer->getPeerURI()));
           }
 
           if (detailEl->hasChildren()) {
@@ -506,7 +506,7 @@ namespace openpeer
 
           if (locationInfo.mCandidates.size() > 0)
           {
-            ElementPtr candidates = IMessageHelper::createElement("candidates");
+            ElementPtr candidates = IMessageHelper::createElement(MessageNames::candidates());
             locationEl->adoptAsLastChild(candidates);
 
             CandidateList::const_iterator it;
@@ -534,19 +534,19 @@ namespace openpeer
           }
 
           if (!identity.mAccessToken.isEmpty()) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessToken", identity.mAccessToken));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessToken(), identity.mAccessToken));
           }
           if (!identity.mAccessSecret.isEmpty()) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessSecret", identity.mAccessSecret));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessSecret(), identity.mAccessSecret));
           }
           if (Time() != identity.mAccessSecretExpires) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("accessSecretExpires", IHelper::timeToString(identity.mAccessSecretExpires)));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::accessSecretExpires(), IHelper::timeToString(identity.mAccessSecretExpires)));
           }
           if (!identity.mAccessSecretProof.isEmpty()) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessSecretProof", identity.mAccessSecretProof));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessSecretProof(), identity.mAccessSecretProof));
           }
           if (Time() != identity.mAccessSecretProofExpires) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("accessSecretProofExpires", IHelper::timeToString(identity.mAccessSecretProofExpires)));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::accessSecretProofExpires(), IHelper::timeToString(identity.mAccessSecretProofExpires)));
           }
 
           if (!identity.mReloginKey.isEmpty()) {
@@ -557,7 +557,7 @@ namespace openpeer
             identityEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("base", identity.mBase));
           }
           if (!identity.mURI.isEmpty()) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("uri", identity.mURI));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::uri(), identity.mURI));
           }
           if (!identity.mProvider.isEmpty()) {
             identityEl->adoptAsLastChild(IMessageHelper::createElementWithText("provider", identity.mProvider));
@@ -573,7 +573,7 @@ namespace openpeer
 
           if ((0 != identity.mPriority) ||
               (forcePriorityWeightOutput)) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("priority", string(identity.mPriority)));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::priority(), string(identity.mPriority)));
           }
           if ((0 != identity.mWeight) ||
               (forcePriorityWeightOutput)) {
@@ -581,17 +581,17 @@ namespace openpeer
           }
 
           if (Time() != identity.mCreated) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("created", IHelper::timeToString(identity.mCreated)));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::created(), IHelper::timeToString(identity.mCreated)));
           }
           if (Time() != identity.mUpdated) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("updated", IHelper::timeToString(identity.mUpdated)));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::updated(), IHelper::timeToString(identity.mUpdated)));
           }
           if (Time() != identity.mExpires) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("expires", IHelper::timeToString(identity.mExpires)));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::expires(), IHelper::timeToString(identity.mExpires)));
           }
 
           if (!identity.mName.isEmpty()) {
-            identityEl->adoptAsLastChild(IMessageHelper::createElementWithText("name", identity.mName));
+            identityEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::name(), identity.mName));
           }
           if (!identity.mProfile.isEmpty()) {
             identityEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("profile", identity.mProfile));
@@ -608,10 +608,10 @@ namespace openpeer
               ElementPtr avatarEl = Element::create("avatar");
 
               if (!avatar.mName.isEmpty()) {
-                avatarEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("name", avatar.mName));
+                avatarEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::name(), avatar.mName));
               }
               if (!avatar.mURL.isEmpty()) {
-                avatarEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("name", avatar.mURL));
+                avatarEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::name(), avatar.mURL));
               }
               if (0 != avatar.mWidth) {
                 avatarEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("width", string(avatar.mWidth)));
@@ -645,25 +645,25 @@ namespace openpeer
           ElementPtr lockboxEl = Element::create("lockbox");
 
           if (info.mDomain.hasData()) {
-            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithText("domain", info.mDomain));
+            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::domain(), info.mDomain));
           }
           if (info.mAccountID.hasData()) {
-            lockboxEl->setAttribute("id", info.mAccountID);
+            lockboxEl->setAttribute(MessageNames::id(), info.mAccountID);
           }
           if (info.mAccessToken.hasData()) {
-            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessToken", info.mAccessToken));
+            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessToken(), info.mAccessToken));
           }
           if (info.mAccessSecret.hasData()) {
-            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessSecret", info.mAccessSecret));
+            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessSecret(), info.mAccessSecret));
           }
           if (Time() != info.mAccessSecretExpires) {
-            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("accessSecretExpires", IHelper::timeToString(info.mAccessSecretExpires)));
+            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::accessSecretExpires(), IHelper::timeToString(info.mAccessSecretExpires)));
           }
           if (info.mAccessSecretProof.hasData()) {
-            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessSecretProof", info.mAccessSecretProof));
+            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessSecretProof(), info.mAccessSecretProof));
           }
           if (Time() != info.mAccessSecretProofExpires) {
-            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("accessSecretProofExpires", IHelper::timeToString(info.mAccessSecretProofExpires)));
+            lockboxEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::accessSecretProofExpires(), IHelper::timeToString(info.mAccessSecretProofExpires)));
           }
 
           if (info.mKey) {
@@ -686,16 +686,16 @@ namespace openpeer
           ElementPtr agentEl = Element::create("agent");
 
           if (info.mUserAgent.hasData()) {
-            agentEl->adoptAsLastChild(IMessageHelper::createElementWithText("userAgent", info.mUserAgent));
+            agentEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::userAgent(), info.mUserAgent));
           }
           if (info.mName.hasData()) {
-            agentEl->adoptAsLastChild(IMessageHelper::createElementWithText("name", info.mName));
+            agentEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::name(), info.mName));
           }
           if (info.mImageURL.hasData()) {
             agentEl->adoptAsLastChild(IMessageHelper::createElementWithText("image", info.mImageURL));
           }
           if (info.mAgentURL.hasData()) {
-            agentEl->adoptAsLastChild(IMessageHelper::createElementWithText("url", info.mAgentURL));
+            agentEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::url(), info.mAgentURL));
           }
 
           return agentEl;
@@ -708,13 +708,13 @@ namespace openpeer
 
           setAttributeID(namespaceGrantChallengeEl, info.mID);
           if (info.mName.hasData()) {
-            namespaceGrantChallengeEl->adoptAsLastChild(IMessageHelper::createElementWithText("name", info.mName));
+            namespaceGrantChallengeEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::name(), info.mName));
           }
           if (info.mImageURL.hasData()) {
             namespaceGrantChallengeEl->adoptAsLastChild(IMessageHelper::createElementWithText("image", info.mName));
           }
           if (info.mServiceURL.hasData()) {
-            namespaceGrantChallengeEl->adoptAsLastChild(IMessageHelper::createElementWithText("url", info.mName));
+            namespaceGrantChallengeEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::url(), info.mName));
           }
           if (info.mDomains.hasData()) {
             namespaceGrantChallengeEl->adoptAsLastChild(IMessageHelper::createElementWithText("domains", info.mName));
@@ -729,10 +729,10 @@ namespace openpeer
           ElementPtr namespaceEl = Element::create("namespace");
 
           if (info.mURL.hasData()) {
-            namespaceEl->setAttribute("id", info.mURL);
+            namespaceEl->setAttribute(MessageNames::id(), info.mURL);
           }
           if (Time() != info.mLastUpdated) {
-            namespaceEl->setAttribute("updated", IHelper::timeToString(info.mLastUpdated));
+            namespaceEl->setAttribute(MessageNames::updated(), IHelper::timeToString(info.mLastUpdated));
           }
 
           return namespaceEl;
@@ -748,23 +748,23 @@ namespace openpeer
           }
 
           if (!info.mAccessToken.isEmpty()) {
-            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessToken", info.mAccessToken));
+            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessToken(), info.mAccessToken));
           }
           if (!info.mAccessSecret.isEmpty()) {
-            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessSecret", info.mAccessSecret));
+            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessSecret(), info.mAccessSecret));
           }
           if (Time() != info.mAccessSecretExpires) {
-            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("accessSecretExpires", IHelper::timeToString(info.mAccessSecretExpires)));
+            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::accessSecretExpires(), IHelper::timeToString(info.mAccessSecretExpires)));
           }
           if (!info.mAccessSecretProof.isEmpty()) {
-            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithText("accessSecretProof", info.mAccessSecretProof));
+            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::accessSecretProof(), info.mAccessSecretProof));
           }
           if (Time() != info.mAccessSecretExpires) {
-            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("accessSecretProofExpires", IHelper::timeToString(info.mAccessSecretProofExpires)));
+            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::accessSecretProofExpires(), IHelper::timeToString(info.mAccessSecretProofExpires)));
           }
 
           if (!info.mVersion.isEmpty()) {
-            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithText("version", info.mVersion));
+            rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::version(), info.mVersion));
           }
           if (Time() != info.mUpdateNext) {
             rolodexEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("updateNext", IHelper::timeToString(info.mUpdateNext)));
@@ -776,6 +776,19 @@ namespace openpeer
 
           return rolodexEl;
         }
+
+        //---------------------------------------------------------------------
+        ElementPtr MessageHelper::createEncodingsElement(const StringList &encodings)
+        {
+          ElementPtr encodingsEl = Element::create(MessageNames::encodings());
+
+          for (StringList::const_iterator iter = encodings.begin(); iter != encodings.end(); ++iter)
+          {
+            encodingsEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::encoding(), (*iter)));
+          }
+
+          return encodingsEl;
+        }
         
         //---------------------------------------------------------------------
         ElementPtr MessageHelper::createElement(
@@ -799,13 +812,13 @@ namespace openpeer
               case stack::IPublicationMetaData::Permission_Remove:  permissionStr = "remove"; break;
             }
 
-            ElementPtr relationshipsEl = IMessageHelper::createElement("relationships");
-            relationshipsEl->setAttribute("name", name);
+            ElementPtr relationshipsEl = IMessageHelper::createElement(MessageNames::relationships());
+            relationshipsEl->setAttribute(MessageNames::name(), name);
             relationshipsEl->setAttribute("allow", permissionStr);
 
             for (stack::IPublicationMetaData::PeerURIList::const_iterator contactIter = permission.second.begin(); contactIter != permission.second.end(); ++contactIter)
             {
-              ElementPtr contactEl = IMessageHelper::createElementWithTextAndJSONEncode("contact", (*contactIter));
+              ElementPtr contactEl = IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::contact(), (*contactIter));
               relationshipsEl->adoptAsLastChild(contactEl);
             }
 
@@ -901,8 +914,8 @@ namespace openpeer
           // make a copy of the relationships
           PublishToRelationshipsMap relationships = publicationMetaData->getRelationships();
 
-          ElementPtr docEl = IMessageHelper::createElement("document");
-          ElementPtr detailsEl = IMessageHelper::createElement("details");
+          ElementPtr docEl = IMessageHelper::createElement(MessageNames::document());
+          ElementPtr detailsEl = IMessageHelper::createElement(MessageNames::details());
           ElementPtr publishToRelationshipsEl = MessageHelper::createElement(relationships, MessageFactoryPeerCommon::Method_PeerSubscribe == (MessageFactoryPeerCommon::Methods)msg.method() ? "subscribeToRelationships" : "publishToRelationships");
           ElementPtr dataEl = IMessageHelper::createElement("data");
 
@@ -915,8 +928,8 @@ namespace openpeer
             creatorPeerURI = creatorLocation->getPeerURI();
           }
 
-          ElementPtr contactEl = IMessageHelper::createElementWithTextAndJSONEncode("contact", creatorPeerURI);
-          ElementPtr locationEl = IMessageHelper::createElementWithTextAndJSONEncode("location", creatorLocationID);
+          ElementPtr contactEl = IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::contact(), creatorPeerURI);
+          ElementPtr locationEl = IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::location(), creatorLocationID);
 
           NodePtr publishedDocEl;
           if (publication) {
@@ -931,15 +944,15 @@ namespace openpeer
             }
           }
 
-          ElementPtr nameEl = IMessageHelper::createElementWithText("name", publicationMetaData->getName());
-          ElementPtr versionEl = IMessageHelper::createElementWithNumber("version", string(toVersion));
+          ElementPtr nameEl = IMessageHelper::createElementWithText(MessageNames::name(), publicationMetaData->getName());
+          ElementPtr versionEl = IMessageHelper::createElementWithNumber(MessageNames::version(), string(toVersion));
           ElementPtr baseVersionEl = IMessageHelper::createElementWithNumber("baseVersion", string(fromVersion));
           ElementPtr lineageEl = IMessageHelper::createElementWithNumber("lineage", string(publicationMetaData->getLineage()));
           ElementPtr chunkEl = IMessageHelper::createElementWithText("chunk", "1/1");
 
           ElementPtr expiresEl;
           if (publicationMetaData->getExpires() != Time()) {
-            expiresEl = IMessageHelper::createElementWithNumber("expires", IHelper::timeToString(publicationMetaData->getExpires()));
+            expiresEl = IMessageHelper::createElementWithNumber(MessageNames::expires(), IHelper::timeToString(publicationMetaData->getExpires()));
           }
 
           ElementPtr mimeTypeEl = IMessageHelper::createElementWithText("mime", publicationMetaData->getMimeType());
@@ -951,7 +964,7 @@ namespace openpeer
             case stack::IPublication::Encoding_JSON:    encodingStr = "json"; break;
           }
 
-          ElementPtr encodingEl = IMessageHelper::createElementWithText("encoding", encodingStr);
+          ElementPtr encodingEl = IMessageHelper::createElementWithText(MessageNames::encoding(), encodingStr);
 
           root->adoptAsLastChild(docEl);
           docEl->adoptAsLastChild(detailsEl);
@@ -1268,27 +1281,27 @@ namespace openpeer
                                      )
         {
           try {
-            ElementPtr docEl = rootEl->findFirstChildElementChecked("document");
-            ElementPtr detailsEl = docEl->findFirstChildElementChecked("details");
+            ElementPtr docEl = rootEl->findFirstChildElementChecked(MessageNames::document());
+            ElementPtr detailsEl = docEl->findFirstChildElementChecked(MessageNames::details());
 
-            ElementPtr nameEl = detailsEl->findFirstChildElementChecked("name");
-            ElementPtr versionEl = detailsEl->findFirstChildElement("version");
+            ElementPtr nameEl = detailsEl->findFirstChildElementChecked(MessageNames::name());
+            ElementPtr versionEl = detailsEl->findFirstChildElement(MessageNames::version());
             ElementPtr baseVersionEl = detailsEl->findFirstChildElement("baseVersion");
             ElementPtr lineageEl = detailsEl->findFirstChildElement("lineage");
             ElementPtr scopeEl = detailsEl->findFirstChildElement("scope");
             ElementPtr lifetimeEl = detailsEl->findFirstChildElement("lifetime");
-            ElementPtr expiresEl = detailsEl->findFirstChildElement("expires");
+            ElementPtr expiresEl = detailsEl->findFirstChildElement(MessageNames::expires());
             ElementPtr mimeTypeEl = detailsEl->findFirstChildElement("mime");
-            ElementPtr encodingEl = detailsEl->findFirstChildElement("encoding");
+            ElementPtr encodingEl = detailsEl->findFirstChildElement(MessageNames::encoding());
 
             String contact;
-            ElementPtr contactEl = detailsEl->findFirstChildElement("contact");
+            ElementPtr contactEl = detailsEl->findFirstChildElement(MessageNames::contact());
             if (contactEl) {
               contact = contactEl->getTextDecoded();
             }
 
             String locationID;
-            ElementPtr locationEl = detailsEl->findFirstChildElement("location");
+            ElementPtr locationEl = detailsEl->findFirstChildElement(MessageNames::location());
             if (locationEl) {
               locationID = locationEl->getTextDecoded();
             }
@@ -1346,21 +1359,21 @@ namespace openpeer
 
             ElementPtr publishToRelationshipsEl = docEl->findFirstChildElement(MessageFactoryPeerCommon::Method_PeerSubscribe == (MessageFactoryPeerCommon::Methods)msg->method() ? "subscribeToRelationships" : "publishToRelationships");
             if (publishToRelationshipsEl) {
-              ElementPtr relationshipsEl = publishToRelationshipsEl->findFirstChildElement("relationships");
+              ElementPtr relationshipsEl = publishToRelationshipsEl->findFirstChildElement(MessageNames::relationships());
               while (relationshipsEl)
               {
-                String name = relationshipsEl->getAttributeValue("name");
+                String name = relationshipsEl->getAttributeValue(MessageNames::name());
                 String allowStr = relationshipsEl->getAttributeValue("allow");
 
                 IPublicationMetaData::PeerURIList contacts;
-                ElementPtr contactEl = relationshipsEl->findFirstChildElement("contact");
+                ElementPtr contactEl = relationshipsEl->findFirstChildElement(MessageNames::contact());
                 while (contactEl)
                 {
                   String contact = contactEl->getTextDecoded();
                   if (contact.size() > 0) {
                     contacts.push_back(contact);
                   }
-                  contactEl = contactEl->findNextSiblingElement("contact");
+                  contactEl = contactEl->findNextSiblingElement(MessageNames::contact());
                 }
 
                 IPublicationMetaData::Permissions permission = IPublicationMetaData::Permission_All;
@@ -1374,7 +1387,7 @@ namespace openpeer
                   relationships[name] = IPublicationMetaData::PermissionAndPeerURIListPair(permission, contacts);
                 }
 
-                relationshipsEl = relationshipsEl->findNextSiblingElement("relationships");
+                relationshipsEl = relationshipsEl->findNextSiblingElement(MessageNames::relationships());
               }
             }
 
@@ -1488,7 +1501,7 @@ namespace openpeer
         {
           if (!root) return 0;
 
-          ElementPtr errorEl = root->findFirstChildElement("error");
+          ElementPtr errorEl = root->findFirstChildElement(MessageNames::error());
           if (!errorEl) return 0;
 
           String ec = IMessageHelper::getAttributeID(errorEl);
@@ -1507,7 +1520,7 @@ namespace openpeer
         {
           if (!root) return String();
 
-          ElementPtr errorEl = root->findFirstChildElement("error");
+          ElementPtr errorEl = root->findFirstChildElement(MessageNames::error());
           if (!errorEl) return String();
 
           return IMessageHelper::getElementText(errorEl);
@@ -1526,18 +1539,18 @@ namespace openpeer
 
           String id = IMessageHelper::getAttributeID(elem);
 
-          ElementPtr contact = elem->findFirstChildElement("contact");
+          ElementPtr contact = elem->findFirstChildElement(MessageNames::contact());
           if (contact)
           {
             String peerURI = IMessageHelper::getElementTextAndDecode(contact);
             ret->mLocation = Location::convert(UseLocation::create(messageSource, peerURI, id));
           }
 
-          ElementPtr candidates = elem->findFirstChildElement("candidates");
+          ElementPtr candidates = elem->findFirstChildElement(MessageNames::candidates());
           if (candidates)
           {
             CandidateList candidateLst;
-            ElementPtr candidate = candidates->findFirstChildElement("candidate");
+            ElementPtr candidate = candidates->findFirstChildElement(MessageNames::candidate());
             while (candidate)
             {
               Candidate c = MessageHelper::createCandidate(candidate, encryptionPassphrase);
@@ -1551,18 +1564,18 @@ namespace openpeer
           }
 
           if (elem->getValue() == "location")
-            elem = elem->findFirstChildElement("details");
+            elem = elem->findFirstChildElement(MessageNames::details());
 
           if (elem)
           {
             ElementPtr device = elem->findFirstChildElement("device");
-            ElementPtr ip = elem->findFirstChildElement("ip");
-            ElementPtr ua = elem->findFirstChildElement("userAgent");
-            ElementPtr os = elem->findFirstChildElement("os");
-            ElementPtr system = elem->findFirstChildElement("system");
-            ElementPtr host = elem->findFirstChildElement("host");
+            ElementPtr ip = elem->findFirstChildElement(MessageNames::ip());
+            ElementPtr ua = elem->findFirstChildElement(MessageNames::userAgent());
+            ElementPtr os = elem->findFirstChildElement(MessageNames::os());
+            ElementPtr system = elem->findFirstChildElement(MessageNames::system());
+            ElementPtr host = elem->findFirstChildElement(MessageNames::host());
             if (device) {
-              ret->mDeviceID = IMessageHelper::getAttribute(device, "id");
+              ret->mDeviceID = IMessageHelper::getAttribute(device, MessageNames::id());
             }
             if (ip) {
               IPAddress ipOriginal(IMessageHelper::getElementText(ip), 0);
@@ -1587,22 +1600,22 @@ namespace openpeer
           if (!elem) return ret;
 
           ElementPtr namespaceEl = elem->findFirstChildElement("namespace");
-          ElementPtr transportEl = elem->findFirstChildElement("transport");
-          ElementPtr typeEl = elem->findFirstChildElement("type");
-          ElementPtr foundationEl = elem->findFirstChildElement("foundation");
+          ElementPtr transportEl = elem->findFirstChildElement(MessageNames::transport());
+          ElementPtr typeEl = elem->findFirstChildElement(MessageNames::type());
+          ElementPtr foundationEl = elem->findFirstChildElement(MessageNames::foundation());
           ElementPtr componentEl = elem->findFirstChildElement("component");
-          ElementPtr hostEl = elem->findFirstChildElement("host");
-          ElementPtr ipEl = elem->findFirstChildElement("ip");
-          ElementPtr portEl = elem->findFirstChildElement("port");
-          ElementPtr priorityEl = elem->findFirstChildElement("priority");
-          ElementPtr accessTokenEl = elem->findFirstChildElement("accessToken");
+          ElementPtr hostEl = elem->findFirstChildElement(MessageNames::host());
+          ElementPtr ipEl = elem->findFirstChildElement(MessageNames::ip());
+          ElementPtr portEl = elem->findFirstChildElement(MessageNames::port());
+          ElementPtr priorityEl = elem->findFirstChildElement(MessageNames::priority());
+          ElementPtr accessTokenEl = elem->findFirstChildElement(MessageNames::accessToken());
           ElementPtr accessSecretProofEncryptedEl = elem->findFirstChildElement("accessSecretProofEncrypted");
           ElementPtr relatedEl = elem->findFirstChildElement("related");
           ElementPtr relatedIPEl;
           ElementPtr relatedPortEl;
           if (relatedEl) {
-            relatedIPEl = relatedEl->findFirstChildElement("ip");
-            relatedPortEl = relatedEl->findFirstChildElement("port");
+            relatedIPEl = relatedEl->findFirstChildElement(MessageNames::ip());
+            relatedPortEl = relatedEl->findFirstChildElement(MessageNames::port());
           }
 
           ret.mNamespace = IMessageHelper::getElementTextAndDecode(namespaceEl);
@@ -1695,8 +1708,8 @@ namespace openpeer
             ElementPtr protocolEl = protocolsEl->findFirstChildElement("protocol");
             while (protocolEl) {
               Finder::Protocol protocol;
-              protocol.mTransport = IMessageHelper::getElementText(protocolEl->findFirstChildElement("transport"));
-              protocol.mHost = IMessageHelper::getElementText(protocolEl->findFirstChildElement("host"));
+              protocol.mTransport = IMessageHelper::getElementText(protocolEl->findFirstChildElement(MessageNames::transport()));
+              protocol.mHost = IMessageHelper::getElementText(protocolEl->findFirstChildElement(MessageNames::host()));
 
               if ((protocol.mTransport.hasData()) ||
                   (protocol.mHost.hasData())) {
@@ -1708,14 +1721,14 @@ namespace openpeer
           }
 
           ret.mRegion = IMessageHelper::getElementText(elem->findFirstChildElement("region"));
-          ret.mCreated = IHelper::stringToTime(IMessageHelper::getElementText(elem->findFirstChildElement("created")));
-          ret.mExpires = IHelper::stringToTime(IMessageHelper::getElementText(elem->findFirstChildElement("expires")));
+          ret.mCreated = IHelper::stringToTime(IMessageHelper::getElementText(elem->findFirstChildElement(MessageNames::created())));
+          ret.mExpires = IHelper::stringToTime(IMessageHelper::getElementText(elem->findFirstChildElement(MessageNames::expires())));
 
           try
           {
             ret.mPublicKey = IRSAPublicKey::load(*IHelper::convertFromBase64(IMessageHelper::getElementText(elem->findFirstChildElementChecked("key")->findFirstChildElementChecked("x509Data"))));
             try {
-              ret.mPriority = Numeric<WORD>(IMessageHelper::getElementText(elem->findFirstChildElementChecked("priority")));
+              ret.mPriority = Numeric<WORD>(IMessageHelper::getElementText(elem->findFirstChildElementChecked(MessageNames::priority())));
             } catch(Numeric<WORD>::ValueOutOfRange &) {
             }
             try {
@@ -1738,18 +1751,18 @@ namespace openpeer
           if (!serviceEl) return service;
 
           service.mID = IMessageHelper::getAttributeID(serviceEl);
-          service.mType = IMessageHelper::getElementText(serviceEl->findFirstChildElement("type"));
-          service.mVersion = IMessageHelper::getElementText(serviceEl->findFirstChildElement("version"));
+          service.mType = IMessageHelper::getElementText(serviceEl->findFirstChildElement(MessageNames::type()));
+          service.mVersion = IMessageHelper::getElementText(serviceEl->findFirstChildElement(MessageNames::version()));
 
           ElementPtr methodsEl = serviceEl->findFirstChildElement("methods");
           if (methodsEl) {
-            ElementPtr methodEl = methodsEl->findFirstChildElement("method");
+            ElementPtr methodEl = methodsEl->findFirstChildElement(MessageNames::method());
             while (methodEl) {
               Service::Method method;
-              method.mName = IMessageHelper::getElementText(methodEl->findFirstChildElement("name"));
+              method.mName = IMessageHelper::getElementText(methodEl->findFirstChildElement(MessageNames::name()));
 
-              String uri = IMessageHelper::getElementText(methodEl->findFirstChildElement("uri"));
-              String host = IMessageHelper::getElementText(methodEl->findFirstChildElement("host"));
+              String uri = IMessageHelper::getElementText(methodEl->findFirstChildElement(MessageNames::uri()));
+              String host = IMessageHelper::getElementText(methodEl->findFirstChildElement(MessageNames::host()));
 
               method.mURI = (host.hasData() ? host : uri);
               method.mUsername = IMessageHelper::getElementText(methodEl->findFirstChildElement("username"));
@@ -1759,7 +1772,7 @@ namespace openpeer
                 service.mMethods[method.mName] = method;
               }
 
-              methodEl = methodEl->findNextSiblingElement("method");
+              methodEl = methodEl->findNextSiblingElement(MessageNames::method());
             }
           }
           return service;
@@ -1774,26 +1787,26 @@ namespace openpeer
 
           info.mDisposition = IdentityInfo::toDisposition(elem->getAttributeValue("disposition"));
 
-          info.mAccessToken = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessToken"));
-          info.mAccessSecret = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecret"));
-          info.mAccessSecretExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretExpires")));
-          info.mAccessSecretProof = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretProof"));
-          info.mAccessSecretProofExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretProofExpires")));
+          info.mAccessToken = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessToken()));
+          info.mAccessSecret = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecret()));
+          info.mAccessSecretExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretExpires())));
+          info.mAccessSecretProof = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretProof()));
+          info.mAccessSecretProofExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretProofExpires())));
 
           info.mReloginKey = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("reloginKey"));
 
           info.mBase = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("base"));
-          info.mURI = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("uri"));
+          info.mURI = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::uri()));
           info.mProvider = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("provider"));
 
           info.mStableID = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("stableID"));
-          ElementPtr peerEl = elem->findFirstChildElement("peer");
+          ElementPtr peerEl = elem->findFirstChildElement(MessageNames::peer());
           if (peerEl) {
             info.mPeerFilePublic = IPeerFilePublic::loadFromElement(peerEl);
           }
 
           try {
-            info.mPriority = Numeric<WORD>(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("priority")));
+            info.mPriority = Numeric<WORD>(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::priority())));
           } catch(Numeric<WORD>::ValueOutOfRange &) {
           }
           try {
@@ -1801,11 +1814,11 @@ namespace openpeer
           } catch(Numeric<WORD>::ValueOutOfRange &) {
           }
 
-          info.mUpdated = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("created")));
-          info.mUpdated = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("updated")));
-          info.mExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("expires")));
+          info.mUpdated = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::created())));
+          info.mUpdated = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::updated())));
+          info.mExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::expires())));
 
-          info.mName = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("name"));
+          info.mName = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::name()));
           info.mProfile = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("profile"));
           info.mVProfile = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("vprofile"));
 
@@ -1814,8 +1827,8 @@ namespace openpeer
             ElementPtr avatarEl = avatarsEl->findFirstChildElement("avatar");
             while (avatarEl) {
               IdentityInfo::Avatar avatar;
-              avatar.mName = IMessageHelper::getElementTextAndDecode(avatarEl->findFirstChildElement("name"));
-              avatar.mURL = IMessageHelper::getElementTextAndDecode(avatarEl->findFirstChildElement("url"));
+              avatar.mName = IMessageHelper::getElementTextAndDecode(avatarEl->findFirstChildElement(MessageNames::name()));
+              avatar.mURL = IMessageHelper::getElementTextAndDecode(avatarEl->findFirstChildElement(MessageNames::url()));
               try {
                 avatar.mWidth = Numeric<int>(IMessageHelper::getElementTextAndDecode(avatarEl->findFirstChildElement("width")));
               } catch(Numeric<int>::ValueOutOfRange &) {
@@ -1851,13 +1864,13 @@ namespace openpeer
 
           if (!elem) return info;
 
-          info.mDomain = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("domain"));
+          info.mDomain = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::domain()));
           info.mAccountID = MessageHelper::getAttributeID(elem);
-          info.mAccessToken = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessToken"));
-          info.mAccessSecret = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecret"));
-          info.mAccessSecretExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretExpires")));
-          info.mAccessSecretProof = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretProof"));
-          info.mAccessSecretProofExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretProofExpires")));
+          info.mAccessToken = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessToken()));
+          info.mAccessSecret = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecret()));
+          info.mAccessSecretExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretExpires())));
+          info.mAccessSecretProof = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretProof()));
+          info.mAccessSecretProofExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretProofExpires())));
 
           String key = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("key"));
 
@@ -1882,10 +1895,10 @@ namespace openpeer
 
           if (!elem) return info;
 
-          info.mUserAgent = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("userAgent"));
-          info.mName = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("name"));
+          info.mUserAgent = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::userAgent()));
+          info.mName = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::name()));
           info.mImageURL = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("image"));
-          info.mAgentURL = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("url"));
+          info.mAgentURL = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::url()));
 
           return info;
         }
@@ -1898,9 +1911,9 @@ namespace openpeer
           if (!elem) return info;
 
           info.mID = IMessageHelper::getAttributeID(elem);
-          info.mName = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("name"));
+          info.mName = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::name()));
           info.mImageURL = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("image"));
-          info.mServiceURL = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("url"));
+          info.mServiceURL = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::url()));
           info.mDomains = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("domains"));
 
           return info;
@@ -1915,13 +1928,13 @@ namespace openpeer
 
           info.mServerToken = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("serverToken"));
 
-          info.mAccessToken = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessToken"));
-          info.mAccessSecret = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecret"));
-          info.mAccessSecretExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretExpires")));
-          info.mAccessSecretProof = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretProof"));
-          info.mAccessSecretProofExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("accessSecretProofExpires")));
+          info.mAccessToken = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessToken()));
+          info.mAccessSecret = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecret()));
+          info.mAccessSecretExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretExpires())));
+          info.mAccessSecretProof = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretProof()));
+          info.mAccessSecretProofExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::accessSecretProofExpires())));
 
-          info.mVersion = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("version"));
+          info.mVersion = IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement(MessageNames::version()));
           info.mUpdateNext = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(elem->findFirstChildElement("updateNext")));
 
           try {
@@ -1931,6 +1944,24 @@ namespace openpeer
           
           return info;
         }
+
+        //---------------------------------------------------------------------
+        StringList MessageHelper::createEncodings(ElementPtr elem)
+        {
+          StringList result;
+          if (!elem) return result;
+
+          ElementPtr encodingEl = elem->findFirstChildElement(MessageNames::encoding());
+          while (encodingEl) {
+            String encoding = IMessageHelper::getElementTextAndDecode(encodingEl);
+            if (encoding.hasData()) {
+              result.push_back(encoding);
+            }
+            encodingEl = encodingEl->findNextSiblingElement(MessageNames::encoding());
+          }
+
+          return result;
+        }
         
       }
     }
@@ -0,0 +1,184 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/message/MessageNames.h>
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      namespace internal
+      {
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark MessageNameTable
+        #pragma mark
+
+        ZS_DECLARE_CLASS_PTR(MessageNameTable)
+
+        class MessageNameTable
+        {
+        protected:
+          //-------------------------------------------------------------------
+          MessageNameTable()
+          {
+            for (int loop = 0; loop <= (int)MessageNames::Name_Last; ++loop) {
+              mNames[loop] = MessageNames::toString((MessageNames::Names)loop);
+            }
+          }
+
+          //-------------------------------------------------------------------
+          static MessageNameTablePtr create()
+          {
+            return MessageNameTablePtr(new MessageNameTable);
+          }
+
+        public:
+          //-------------------------------------------------------------------
+          static MessageNameTablePtr singleton()
+          {
+            static SingletonLazySharedPtr<MessageNameTable> singleton(create());
+            return singleton.singleton();
+          }
+
+          //-------------------------------------------------------------------
+          const String &get(MessageNames::Names name) const
+          {
+            return mNames[name];
+          }
+
+        protected:
+          String mNames[MessageNames::Name_Last + 1];
+        };
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageNames
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      const char *MessageNames::toString(Names name)
+      {
+        switch (name)
+        {
+          case Name_ID:                                 return "id";
+          case Name_Domain:                             return "domain";
+          case Name_AppID:                              return "appid";
+          case Name_Timestamp:                          return "timestamp";
+          case Name_Handler:                            return "handler";
+          case Name_Method:                             return "method";
+          case Name_Error:                              return "error";
+          case Name_Expires:                            return "expires";
+          case Name_Created:                            return "created";
+          case Name_Updated:                            return "updated";
+          case Name_Name:                               return "name";
+          case Name_Version:                            return "version";
+          case Name_Type:                               return "type";
+          case Name_URI:                                return "uri";
+          case Name_URL:                                return "url";
+          case Name_Details:                            return "details";
+          case Name_Document:                           return "document";
+          case Name_Location:                           return "location";
+          case Name_Locations:                          return "locations";
+          case Name_Contact:                            return "contact";
+          case Name_Contacts:                           return "contacts";
+          case Name_Relationships:                      return "relationships";
+          case Name_Encoding:                           return "encoding";
+          case Name_Encodings:                          return "encodings";
+          case Name_Compression:                        return "compression";
+          case Name_Batching:                           return "batching";
+          case Name_Channel:                            return "channel";
+          case Name_Window:                             return "window";
+          case Name_Nonce:                              return "nonce";
+          case Name_Relay:                              return "relay";
+          case Name_LocalContext:                       return "localContext";
+          case Name_RemoteContext:                      return "remoteContext";
+          case Name_Context:                            return "context";
+          case Name_AccessToken:                        return "accessToken";
+          case Name_AccessSecret:                       return "accessSecret";
+          case Name_AccessSecretExpires:                return "accessSecretExpires";
+          case Name_AccessSecretProof:                  return "accessSecretProof";
+          case Name_AccessSecretProofExpires:           return "accessSecretProofExpires";
+          case Name_FindProofBundle:                    return "findProofBundle";
+          case Name_FindProof:                          return "findProof";
+          case Name_FindSecret:                         return "findSecret";
+          case Name_FindSecretProof:                    return "findSecretProof";
+          case Name_FindSecretProofExpires:             return "findSecretProofExpires";
+          case Name_RequestFindProofBundleDigestValue:  return "requestFindProofBundleDigestValue";
+          case Name_Peer:                               return "peer";
+          case Name_PeerIdentityProofBundle:            return "peerIdentityProofBundle";
+          case Name_PeerIdentityProof:                  return "peerIdentityProof";
+          case Name_PeerSecretEncrypted:                return "peerSecretEncrypted";
+          case Name_Exclude:                            return "exclude";
+          case Name_Candidates:                         return "candidates";
+          case Name_Candidate:                          return "candidate";
+          case Name_Transport:                          return "transport";
+          case Name_IP:                                 return "ip";
+          case Name_Port:                               return "port";
+          case Name_Host:                               return "host";
+          case Name_Priority:                           return "priority";
+          case Name_Foundation:                         return "foundation";
+          case Name_IceUsernameFrag:                    return "iceUsernameFrag";
+          case Name_IcePassword:                        return "icePassword";
+          case Name_IcePasswordEncrypted:               return "icePasswordEncrypted";
+          case Name_IceFinal:                           return "iceFinal";
+          case Name_UserAgent:                          return "userAgent";
+          case Name_OS:                                 return "os";
+          case Name_System:                             return "system";
+          case Name_Set:                                return "set";
+          case Name_Remove:                             return "remove";
+          case Name_Path:                               return "path";
+        }
+        return "UNDEFINED";
+      }
+
+      //-----------------------------------------------------------------------
+      const String &MessageNames::get(Names name)
+      {
+        internal::MessageNameTablePtr table = internal::MessageNameTable::singleton();
+        ZS_THROW_BAD_STATE_IF(!table)
+
+        // the singleton keeps the table alive, so the reference stays valid
+        return table->get(name);
+      }
+    }
+  }
+}
@@ -0,0 +1,383 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/message/MessageWriter.h>
+#include <openpeer/stack/message/MessageResult.h>
+#include <openpeer/stack/message/IMessageFactory.h>
+#include <openpeer/stack/message/IMessageHelper.h>
+
+#include <openpeer/services/IHelper.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/Log.h>
+#include <zsLib/Stringize.h>
+
+#include <boost/shared_array.hpp>
+
+#include <cstdio>
+
+namespace openpeer { namespace stack { namespace message { ZS_DECLARE_SUBSYSTEM(openpeer_stack_message) } } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      using services::IHelper;
+
+      using zsLib::XML::Generator;
+      using zsLib::XML::GeneratorPtr;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static bool isWhitespace(char value)
+      {
+        return ((' ' == value) || ('\t' == value) || ('\r' == value) || ('\n' == value));
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageWriter
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      MessageWriter::MessageWriter(size_t reserveInBytes) :
+        mExcludeAppID(false)
+      {
+        mBuffer.reserve(reserveInBytes);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::reset()
+      {
+        // clear() leaves the reserved capacity in place
+        mBuffer.clear();
+        mHasMembers.clear();
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageWriter::beginMessage(const Message &message)
+      {
+        IMessageFactoryPtr factory = message.factory();
+        if (!factory) return false;
+
+        mBuffer.append("{");
+        mHasMembers.push_back(false);
+
+        beginObject(Message::toString(message.messageType()));
+
+        writeAttribute("domain", message.domain());
+        if (!mExcludeAppID) {
+          writeAttribute("appid", message.appID());
+        }
+
+        Time time = message.time();
+        if (Time() != time) {
+          writeAttribute("timestamp", IHelper::timeToString(time));
+        }
+
+        writeAttribute("handler", factory->getHandler());
+        writeAttribute("id", message.messageID());
+        writeAttribute("method", factory->toString(message.method()));
+
+        if (message.isResult()) {
+          const MessageResult *msgResult = (dynamic_cast<const MessageResult *>(&message));
+          if ((msgResult) &&
+              ((msgResult->hasAttribute(MessageResult::AttributeType_ErrorCode)) ||
+               (msgResult->hasAttribute(MessageResult::AttributeType_ErrorReason)))) {
+
+            // errors are rare so the element form is simply spliced in
+            ElementPtr errorEl;
+            if (msgResult->hasAttribute(MessageResult::AttributeType_ErrorReason)) {
+              errorEl = IMessageHelper::createElementWithTextAndJSONEncode("error", msgResult->errorReason());
+            } else {
+              errorEl = IMessageHelper::createElement("error");
+            }
+            if (msgResult->hasAttribute(MessageResult::AttributeType_ErrorCode)) {
+              IMessageHelper::setAttributeID(errorEl, string(msgResult->errorCode()));
+            }
+            writeElement(errorEl);
+          }
+        }
+
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::endMessage()
+      {
+        endObject();
+
+        mBuffer.append("}");
+        if (mHasMembers.size() > 0) {
+          mHasMembers.pop_back();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::beginObject(const char *name)
+      {
+        beginMember();
+        if (name) {
+          appendName(name);
+        }
+        mBuffer.append("{");
+        mHasMembers.push_back(false);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::endObject()
+      {
+        mBuffer.append("}");
+        if (mHasMembers.size() > 0) {
+          mHasMembers.pop_back();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::beginArray(const char *name)
+      {
+        beginMember();
+        appendName(name);
+        mBuffer.append("[");
+        mHasMembers.push_back(false);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::endArray()
+      {
+        mBuffer.append("]");
+        if (mHasMembers.size() > 0) {
+          mHasMembers.pop_back();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::writeAttribute(
+                                         const char *name,
+                                         const String &value
+                                         )
+      {
+        if (value.isEmpty()) return;
+
+        beginMember();
+        mBuffer.append("\"$");
+        mBuffer.append(name);
+        mBuffer.append("\":");
+        appendQuoted(value);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::writeText(
+                                    const char *name,
+                                    const String &value
+                                    )
+      {
+        beginMember();
+        appendName(name);
+        appendQuoted(value);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::writeNumber(
+                                      const char *name,
+                                      const String &value
+                                      )
+      {
+        beginMember();
+        appendName(name);
+        if (value.isEmpty()) {
+          mBuffer.append("\"\"");
+          return;
+        }
+        mBuffer.append(value);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::writeElement(ElementPtr el)
+      {
+        if (!el) return;
+        beginMember();
+        appendGenerated(el, false);
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::writeElementValue(ElementPtr el)
+      {
+        if (!el) return;
+        beginMember();
+        appendGenerated(el, true);
+      }
+
+      //-----------------------------------------------------------------------
+      bool MessageWriter::writeDocument(DocumentPtr document)
+      {
+        if (!document) return false;
+
+        if (mExcludeAppID) {
+          ElementPtr rootEl = document->getFirstChildElement();
+          if (rootEl) {
+            AttributePtr appID = rootEl->findAttribute("appid");
+            if (appID) {
+              appID->orphan();
+            }
+          }
+        }
+
+        size_t length = 0;
+        GeneratorPtr generator = Generator::createJSONGenerator();
+        boost::shared_array<char> output = generator->write(document, &length);
+
+        mBuffer.append(output.get(), length);
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      SecureByteBlockPtr MessageWriter::toBuffer() const
+      {
+        return SecureByteBlockPtr(new SecureByteBlock((const BYTE *)(mBuffer.c_str()), mBuffer.length()));
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::beginMember()
+      {
+        if (mHasMembers.size() < 1) return;
+
+        if (mHasMembers.back()) {
+          mBuffer.append(",");
+          return;
+        }
+        mHasMembers.back() = true;
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::appendName(const char *name)
+      {
+        mBuffer.append("\"");
+        mBuffer.append(name);
+        mBuffer.append("\":");
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::appendQuoted(const String &value)
+      {
+        mBuffer.append("\"");
+
+        const char *pos = value.c_str();
+        const char *start = pos;
+
+        for (; '\0' != *pos; ++pos) {
+          const char *escape = NULL;
+          char temp[7] = {};
+
+          switch (*pos) {
+            case '\"':  escape = "\\\""; break;
+            case '\\':  escape = "\\\\"; break;
+            case '\b':  escape = "\\b"; break;
+            case '\f':  escape = "\\f"; break;
+            case '\n':  escape = "\\n"; break;
+            case '\r':  escape = "\\r"; break;
+            case '\t':  escape = "\\t"; break;
+            default:    {
+              if (((unsigned char)*pos) < 0x20) {
+                snprintf(temp, sizeof(temp), "\\u%04x", (unsigned int)((unsigned char)*pos));
+                escape = temp;
+              }
+              break;
+            }
+          }
+
+          if (!escape) continue;
+
+          mBuffer.append(start, pos - start);
+          mBuffer.append(escape);
+          start = pos + 1;
+        }
+
+        mBuffer.append(start, pos - start);
+        mBuffer.append("\"");
+      }
+
+      //-----------------------------------------------------------------------
+      void MessageWriter::appendGenerated(
+                                          ElementPtr el,
+                                          bool valueOnly
+                                          )
+      {
+        size_t length = 0;
+        GeneratorPtr generator = Generator::createJSONGenerator();
+        boost::shared_array<char> output = generator->write(el, &length);
+
+        const char *start = output.get();
+        const char *end = start + length;
+
+        // the generator wraps an element as {"name":value}
+        while ((start < end) && (isWhitespace(*start))) ++start;
+        while ((start < end) && ((isWhitespace(*(end-1))) || ('\0' == *(end-1)))) --end;
+
+        if ((start < end) &&
+            ('{' == *start) &&
+            ('}' == *(end-1))) {
+          ++start;
+          --end;
+        }
+
+        if (valueOnly) {
+          while ((start < end) && (isWhitespace(*start))) ++start;
+          if ((start < end) && ('\"' == *start)) {
+            for (++start; (start < end) && ('\"' != *start); ++start) {
+              if ('\\' == *start) ++start;
+            }
+            if (start < end) ++start;
+          }
+          while ((start < end) && (isWhitespace(*start))) ++start;
+          if ((start < end) && (':' == *start)) ++start;
+        }
+
+        if (start < end) {
+          mBuffer.append(start, end - start);
+        }
+      }
+    }
+  }
+}
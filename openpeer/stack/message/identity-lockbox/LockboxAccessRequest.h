@@ -79,19 +79,19 @@ namespace openpeer
           // mAccessSecret
 
           const IdentityInfo &identityInfo() const        {return mIdentityInfo;}
-          void identityInfo(const IdentityInfo &val)      {mIdentityInfo = val;}
+          void identityInfo(const IdentityInfo &val)      {mIdentityInfo = val; invalidateEncoded();}
 
           const LockboxInfo &lockboxInfo() const          {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)        {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)        {mLockboxInfo = val; invalidateEncoded();}
 
           const AgentInfo &agentInfo() const              {return mAgentInfo;}
-          void agentInfo(const AgentInfo &val)            {mAgentInfo = val;}
+          void agentInfo(const AgentInfo &val)            {mAgentInfo = val; invalidateEncoded();}
 
           const String &grantID() const                   {return mGrantID;}
-          void grantID(const String &val)                 {mGrantID = val;}
+          void grantID(const String &val)                 {mGrantID = val; invalidateEncoded();}
 
           const NamespaceInfoMap &namespaceURLs() const   {return mNamespaceInfos;}
-          void namespaceURLs(const NamespaceInfoMap &val) {mNamespaceInfos = val;}
+          void namespaceURLs(const NamespaceInfoMap &val) {mNamespaceInfos = val; invalidateEncoded();}
 
         protected:
           LockboxAccessRequest();
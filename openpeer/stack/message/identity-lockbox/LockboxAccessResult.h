@@ -68,13 +68,13 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const LockboxInfo &lockboxInfo() const          {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)        {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)        {mLockboxInfo = val; invalidateEncoded();}
 
           const NamespaceGrantChallengeInfo &namespaceGrantChallengeInfo() const    {return mNamespaceGrantChallengeInfo;}
-          void namespaceGrantChallengeInfo(const NamespaceGrantChallengeInfo &val)  {mNamespaceGrantChallengeInfo = val;}
+          void namespaceGrantChallengeInfo(const NamespaceGrantChallengeInfo &val)  {mNamespaceGrantChallengeInfo = val; invalidateEncoded();}
 
           const IdentityInfoList &identities() const      {return mIdentities;}
-          void identities(const IdentityInfoList &val)    {mIdentities = val;}
+          void identities(const IdentityInfoList &val)    {mIdentities = val; invalidateEncoded();}
 
         protected:
           LockboxAccessResult();
@@ -68,10 +68,10 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const LockboxInfo &lockboxInfo() const            {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)          {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)          {mLockboxInfo = val; invalidateEncoded();}
 
           const NamespaceInfoMap &namespaceInfos() const    {return mNamespaceInfos;}
-          void namespaceInfos(const NamespaceInfoMap &val)  {mNamespaceInfos = val;}
+          void namespaceInfos(const NamespaceInfoMap &val)  {mNamespaceInfos = val; invalidateEncoded();}
 
         protected:
           LockboxContentGetRequest();
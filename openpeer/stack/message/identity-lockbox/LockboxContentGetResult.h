@@ -75,7 +75,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const NamespaceURLNameValueMap &namespaceURLNameValues() const   {return mNamespaceURLNameValues;}
-          void namespaceURLNameValues(const NamespaceURLNameValueMap &val) {mNamespaceURLNameValues = val;}
+          void namespaceURLNameValues(const NamespaceURLNameValueMap &val) {mNamespaceURLNameValues = val; invalidateEncoded();}
 
         protected:
           LockboxContentGetResult();
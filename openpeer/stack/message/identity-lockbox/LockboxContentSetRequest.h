@@ -76,10 +76,10 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const LockboxInfo &lockboxInfo() const    {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)  {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)  {mLockboxInfo = val; invalidateEncoded();}
 
           const NamespaceURLNameValueMap &namespaceURLNameValues() const   {return mNamespaceURLNameValues;}
-          void namespaceURLNameValues(const NamespaceURLNameValueMap &val) {mNamespaceURLNameValues = val;}
+          void namespaceURLNameValues(const NamespaceURLNameValueMap &val) {mNamespaceURLNameValues = val; invalidateEncoded();}
 
         protected:
           LockboxContentSetRequest();
@@ -69,13 +69,13 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const LockboxInfo &lockboxInfo() const    {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)  {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)  {mLockboxInfo = val; invalidateEncoded();}
 
           const IdentityInfoList &identitiesToUpdate() const    {return mIdentitiesToUpdate;}
-          void identitiesToUpdate(const IdentityInfoList &val)  {mIdentitiesToUpdate = val;}
+          void identitiesToUpdate(const IdentityInfoList &val)  {mIdentitiesToUpdate = val; invalidateEncoded();}
 
           const IdentityInfoList &identitiesToRemove() const    {return mIdentitiesToRemove;}
-          void identitiesToRemove(const IdentityInfoList &val)  {mIdentitiesToRemove = val;}
+          void identitiesToRemove(const IdentityInfoList &val)  {mIdentitiesToRemove = val; invalidateEncoded();}
 
         protected:
           LockboxIdentitiesUpdateRequest();
@@ -67,7 +67,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const IdentityInfoList &identities() const      {return mIdentities;}
-          void identities(const IdentityInfoList &val)    {mIdentities = val;}
+          void identities(const IdentityInfoList &val)    {mIdentities = val; invalidateEncoded();}
 
         protected:
           LockboxIdentitiesUpdateResult();
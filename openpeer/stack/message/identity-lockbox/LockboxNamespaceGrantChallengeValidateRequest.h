@@ -68,7 +68,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const LockboxInfo &lockboxInfo() const          {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)        {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)        {mLockboxInfo = val; invalidateEncoded();}
 
           const ElementPtr &namespaceGrantChallengeBundle() const {return mNamespaceGrantChallengeBundle;}
           void namespaceGrantChallengeBundle(ElementPtr val);
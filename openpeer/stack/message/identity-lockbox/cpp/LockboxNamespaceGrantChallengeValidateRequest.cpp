@@ -115,6 +115,8 @@ namespace openpeer
 
         void LockboxNamespaceGrantChallengeValidateRequest::namespaceGrantChallengeBundle(ElementPtr val)
         {
+          invalidateEncoded();
+
           if (!val) {
             mNamespaceGrantChallengeBundle.reset();
             return;
@@ -93,16 +93,7 @@ namespace openpeer
         //---------------------------------------------------------------------
         Message::Methods MessageFactoryIdentityLockbox::toMethod(const char *inMethod) const
         {
-          typedef zsLib::ULONG ULONG;
-          String methodStr(inMethod ? inMethod : "");
-
-          for (ULONG loop = (ULONG)(MessageFactoryIdentityLockbox::Method_Invalid+1); loop <= ((ULONG)MessageFactoryIdentityLockbox::Method_Last); ++loop)
-          {
-            if (methodStr == toString((Message::Methods)loop)) {
-              return (Message::Methods)loop;
-            }
-          }
-          return Message::Method_Invalid;
+          return IMessageFactoryManager::toMethod(getHandler(), inMethod);
         }
 
         //---------------------------------------------------------------------
@@ -74,7 +74,7 @@ namespace openpeer
           // mUpdated
 
           const IdentityInfoList &identities() const      {return mIdentities;}
-          void identities(const IdentityInfoList &val)    {mIdentities = val;}
+          void identities(const IdentityInfoList &val)    {mIdentities = val; invalidateEncoded();}
 
         protected:
           IdentityLookupCheckResult();
@@ -71,7 +71,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const ProviderList &providers() const       {return mProviders;}
-          void providers(const ProviderList &val)     {mProviders = val;}
+          void providers(const ProviderList &val)     {mProviders = val; invalidateEncoded();}
 
         protected:
           IdentityLookupRequest();
@@ -87,7 +87,7 @@ namespace openpeer
           // mAvatars           (optional
 
           const IdentityInfoList &identities() const      {return mIdentities;}
-          void identities(const IdentityInfoList &val)    {mIdentities = val;}
+          void identities(const IdentityInfoList &val)    {mIdentities = val; invalidateEncoded();}
 
         protected:
           IdentityLookupResult();
@@ -77,10 +77,10 @@ namespace openpeer
           // mAccessSecretExpires
 
           const IdentityInfo &identityInfo() const        {return mIdentityInfo;}
-          void identityInfo(const IdentityInfo &val)      {mIdentityInfo = val;}
+          void identityInfo(const IdentityInfo &val)      {mIdentityInfo = val; invalidateEncoded();}
 
           const LockboxInfo &lockboxInfo() const          {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)        {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)        {mLockboxInfo = val; invalidateEncoded();}
 
         protected:
           IdentityAccessCompleteNotify();
@@ -76,7 +76,7 @@ namespace openpeer
           // mAccessSecretExpires
 
           const IdentityInfo &identityInfo() const    {return mIdentityInfo;}
-          void identityInfo(const IdentityInfo &val)  {mIdentityInfo = val;}
+          void identityInfo(const IdentityInfo &val)  {mIdentityInfo = val; invalidateEncoded();}
 
         protected:
           IdentityAccessRolodexCredentialsGetRequest();
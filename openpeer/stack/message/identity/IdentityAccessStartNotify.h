@@ -82,19 +82,19 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const AgentInfo &agentInfo() const                {return mAgentInfo;}
-          void agentInfo(const AgentInfo &val)              {mAgentInfo = val;}
+          void agentInfo(const AgentInfo &val)              {mAgentInfo = val; invalidateEncoded();}
 
           const IdentityInfo &identityInfo() const          {return mIdentityInfo;}
-          void identityInfo(const IdentityInfo &val)        {mIdentityInfo = val;}
+          void identityInfo(const IdentityInfo &val)        {mIdentityInfo = val; invalidateEncoded();}
 
           BrowserVisibilities browserVisibility() const     {return mVisibility;}
-          void browserVisibility(BrowserVisibilities val)   {mVisibility = val;}
+          void browserVisibility(BrowserVisibilities val)   {mVisibility = val; invalidateEncoded();}
 
           bool popup() const                                {return (mPopup > 0);}
-          void popup(bool val)                              {mPopup = (val ? 1 : 0);}
+          void popup(bool val)                              {mPopup = (val ? 1 : 0); invalidateEncoded();}
 
           const String &outerFrameURL() const               {return mOuterFrameURL;}
-          void outerFrameURL(const String &val)             {mOuterFrameURL = val;}
+          void outerFrameURL(const String &val)             {mOuterFrameURL = val; invalidateEncoded();}
 
         protected:
           IdentityAccessStartNotify();
@@ -73,7 +73,7 @@ namespace openpeer
           // mAccessSeecret
           
           const LockboxInfo &lockboxInfo() const      {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)    {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)    {mLockboxInfo = val; invalidateEncoded();}
 
           // IdentityInfo members need to be set:
           //
@@ -91,10 +91,10 @@ namespace openpeer
           // mWeight
 
           const IdentityInfo &identityInfo() const    {return mIdentityInfo;}
-          void identityInfo(const IdentityInfo &val)  {mIdentityInfo = val;}
+          void identityInfo(const IdentityInfo &val)  {mIdentityInfo = val; invalidateEncoded();}
 
           IPeerFilesPtr peerFiles() const             {return mPeerFiles;}
-          void peerFiles(IPeerFilesPtr peerFiles)     {mPeerFiles = peerFiles;}
+          void peerFiles(IPeerFilesPtr peerFiles)     {mPeerFiles = peerFiles; invalidateEncoded();}
 
         protected:
           IdentityLookupUpdateRequest();
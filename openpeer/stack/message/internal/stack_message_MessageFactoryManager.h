@@ -38,6 +38,10 @@
 #include <openpeer/services/IHTTP.h>
 
 #include <list>
+#include <map>
+#include <vector>
+
+#define OPENPEER_STACK_SETTING_MESSAGE_CREATION_ELEMENT_MODE "openpeer/stack/message-creation-element-mode"
 
 namespace openpeer
 {
@@ -59,6 +63,8 @@ namespace openpeer
         {
         public:
           typedef zsLib::PUID PUID;
+          typedef zsLib::ULONG ULONG;
+          typedef zsLib::QWORD QWORD;
           typedef zsLib::String String;
           typedef zsLib::RecursiveLock RecursiveLock;
           typedef zsLib::XML::ElementPtr ElementPtr;
@@ -74,6 +80,74 @@ namespace openpeer
 
           static const char *toString(ErrorCodes error);
 
+          enum CreationElementModes
+          {
+            CreationElementMode_Keep,       // typed messages keep the parsed creation element
+            CreationElementMode_Compact,    // typed messages keep only the JSON text
+            CreationElementMode_Release,    // typed messages drop the creation element
+            CreationElementMode_Arena,      // typed messages keep only the frame they were parsed from
+          };
+
+          static const char *toString(CreationElementModes mode);
+          static CreationElementModes toCreationElementMode(const char *mode);
+
+          typedef size_t Hash;
+
+          //-------------------------------------------------------------------
+          #pragma mark
+          #pragma mark MessageFactoryManager::Registry
+          #pragma mark
+
+          // NOTE: immutable open addressing table from (handler, method) to
+          //       factory and method code; a "handler only" entry (empty
+          //       method) exists per factory to tell unknown handlers from
+          //       unknown methods. The registry of every built-in factory is
+          //       built and published once (frozen) and read without a lock;
+          //       factories registered afterwards go into a separate copy on
+          //       write registry that is only consulted (under the registry
+          //       lock) when the frozen registry has no match.
+          struct Registry
+          {
+            struct Entry
+            {
+              Hash mHash;
+              String mHandler;
+              String mMethod;
+              IMessageFactoryPtr mFactory;
+              Message::Methods mMethodCode;
+
+              Entry() : mHash(0), mMethodCode(Message::Method_Invalid) {}
+            };
+
+            typedef std::vector<Entry> EntryVector;
+
+            EntryVector mEntries;
+            size_t mMask;
+            size_t mTotal;
+
+            Registry() : mMask(0), mTotal(0) {}
+
+            const Entry *find(
+                              const char *handler,
+                              const char *method
+                              ) const;
+          };
+
+          typedef std::list<IMessageFactoryPtr> FactoryList;
+          typedef boost::shared_ptr<const Registry> RegistryPtr;
+
+          struct CreationElementStatistics
+          {
+            ULONG mTotal;
+            QWORD mEstimatedBytesBefore;
+            QWORD mEstimatedBytesAfter;
+
+            CreationElementStatistics() : mTotal(0), mEstimatedBytesBefore(0), mEstimatedBytesAfter(0) {}
+          };
+
+          typedef String MessageTypeName;
+          typedef std::map<MessageTypeName, CreationElementStatistics> CreationElementStatisticsMap;
+
         protected:
           MessageFactoryManager();
           void init();
@@ -92,6 +166,16 @@ namespace openpeer
 
           static void registerFactory(IMessageFactoryPtr factory);
 
+          static Message::Methods toMethod(
+                                           const char *handler,
+                                           const char *method
+                                           );
+
+          static ElementPtr getCreationElementStatistics(bool resetAfterSnapshot);
+
+          // NOTE: the same statistics summed over every message type
+          static CreationElementStatistics getCreationElementTotals(bool resetAfterSnapshot);
+
         protected:
           //-------------------------------------------------------------------
           #pragma mark
@@ -100,7 +184,8 @@ namespace openpeer
 
           static MessagePtr create(
                                    ElementPtr root,
-                                   IMessageSourcePtr messageSource
+                                   IMessageSourcePtr messageSource,
+                                   SecureByteBlockPtr creationBuffer = SecureByteBlockPtr()
                                    );
 
         protected:
@@ -123,10 +208,34 @@ namespace openpeer
 
           Log::Params log(const char *message);
 
+          static Hash hash(
+                           const char *handler,
+                           const char *method
+                           );
+          static RegistryPtr buildRegistry(const FactoryList &factories);
+
+          const Registry &frozenRegistry();
+          RegistryPtr freezeRegistry();
+          const Registry::Entry *find(
+                                      const char *handler,
+                                      const char *method,
+                                      RegistryPtr &outLateRegistry
+                                      );
+
+          static ULONG countElements(ElementPtr el);
+          void applyCreationElementMode(
+                                        MessagePtr message,
+                                        ElementPtr root,
+                                        const Registry::Entry &entry,
+                                        Message::MessageTypes msgType,
+                                        SecureByteBlockPtr creationBuffer
+                                        );
+
           void internalRegisterFactory(IMessageFactoryPtr factory);
           MessagePtr internalCreate(
                                     ElementPtr root,
-                                    IMessageSourcePtr messageSource
+                                    IMessageSourcePtr messageSource,
+                                    SecureByteBlockPtr creationBuffer
                                     );
 
           bool internalGetMethod(
@@ -145,8 +254,14 @@ namespace openpeer
           PUID mID;
           MessageFactoryManagerWeakPtr mThisWeak;
 
-          typedef std::list<IMessageFactoryPtr> FactoryList;
           FactoryList mFactories;
+          bool mFrozen;
+          FactoryList mLateFactories;
+
+          mutable RecursiveLock mRegistryLock;  // guards only mLateRegistry
+          RegistryPtr mLateRegistry;
+
+          CreationElementStatisticsMap mCreationElementStatistics;
         };
       }
     }
@@ -80,6 +80,8 @@ namespace openpeer
           static ElementPtr createElement(const NamespaceInfo &info);
           static ElementPtr createElement(const RolodexInfo &info);
 
+          static ElementPtr createEncodingsElement(const StringList &encodings);
+
           static ElementPtr createElement(
                                           const PublishToRelationshipsMap &relationships,
                                           const char *elementName
@@ -122,6 +124,7 @@ namespace openpeer
           static AgentInfo                    createAgent(ElementPtr elem);
           static NamespaceGrantChallengeInfo  createNamespaceGrantChallenge(ElementPtr elem);
           static RolodexInfo                  createRolodex(ElementPtr elem);
+          static StringList                   createEncodings(ElementPtr elem);
         };
       }
     }
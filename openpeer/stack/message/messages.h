@@ -32,6 +32,12 @@
 #pragma once
 
 #include <openpeer/stack/message/Message.h>
+#include <openpeer/stack/message/MessageEnvelope.h>
+#include <openpeer/stack/message/MessageWriter.h>
+#include <openpeer/stack/message/MessageBatch.h>
+#include <openpeer/stack/message/MessageBinary.h>
+#include <openpeer/stack/message/MessageCompression.h>
+#include <openpeer/stack/message/MessageNames.h>
 #include <openpeer/stack/message/MessageRequest.h>
 #include <openpeer/stack/message/MessageResult.h>
 #include <openpeer/stack/message/MessageNotify.h>
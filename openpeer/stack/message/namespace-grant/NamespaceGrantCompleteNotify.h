@@ -69,7 +69,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const NamespaceGranthallengeBundleList &bundles() const    {return mBundles;}
-          void bundles(const NamespaceGranthallengeBundleList &val)  {mBundles = val;}
+          void bundles(const NamespaceGranthallengeBundleList &val)  {mBundles = val; invalidateEncoded();}
 
         protected:
           NamespaceGrantCompleteNotify();
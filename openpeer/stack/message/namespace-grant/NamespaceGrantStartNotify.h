@@ -85,19 +85,19 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const AgentInfo &agentInfo() const                {return mAgentInfo;}
-          void agentInfo(const AgentInfo &val)              {mAgentInfo = val;}
+          void agentInfo(const AgentInfo &val)              {mAgentInfo = val; invalidateEncoded();}
 
           const NamespaceGrantChallengeInfoAndNamespacesList &challenges() const    {return mChallenges;}
-          void challenges(const NamespaceGrantChallengeInfoAndNamespacesList &val)  {mChallenges = val;}
+          void challenges(const NamespaceGrantChallengeInfoAndNamespacesList &val)  {mChallenges = val; invalidateEncoded();}
 
           BrowserVisibilities browserVisibility() const     {return mVisibility;}
-          void browserVisibility(BrowserVisibilities val)   {mVisibility = val;}
+          void browserVisibility(BrowserVisibilities val)   {mVisibility = val; invalidateEncoded();}
 
           bool popup() const                                {return (mPopup > 0);}
-          void popup(bool val)                              {mPopup = (val ? 1 : 0);}
+          void popup(bool val)                              {mPopup = (val ? 1 : 0); invalidateEncoded();}
 
           const String &outerFrameURL() const               {return mOuterFrameURL;}
-          void outerFrameURL(const String &val)             {mOuterFrameURL = val;}
+          void outerFrameURL(const String &val)             {mOuterFrameURL = val; invalidateEncoded();}
 
         protected:
           NamespaceGrantStartNotify();
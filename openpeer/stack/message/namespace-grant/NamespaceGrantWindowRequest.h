@@ -69,10 +69,10 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           bool ready() const                          {return (mReady > 0);}
-          void ready(bool &val)                       {mReady = (val ? 1: 0);}
+          void ready(bool &val)                       {mReady = (val ? 1: 0); invalidateEncoded();}
 
           bool visible() const                        {return (mVisible > 0);}
-          void visible(bool &val)                     {mVisible = (val ? 1: 0);}
+          void visible(bool &val)                     {mVisible = (val ? 1: 0); invalidateEncoded();}
 
         protected:
           NamespaceGrantWindowRequest();
@@ -70,7 +70,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           IPublicationMetaDataPtr publicationMetaData() const                   {return mPublicationMetaData;}
-          void publicationMetaData(IPublicationMetaDataPtr publicationMetaData) {mPublicationMetaData = publicationMetaData;}
+          void publicationMetaData(IPublicationMetaDataPtr publicationMetaData) {mPublicationMetaData = publicationMetaData; invalidateEncoded();}
 
         protected:
           PeerGetRequest();
@@ -68,10 +68,10 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           IPublicationMetaDataPtr originalRequestPublicationMetaData() const      {return mOriginalRequestPublicationMetaData;}
-          void originalRequestPublicationMetaData(IPublicationMetaDataPtr value)  {mOriginalRequestPublicationMetaData = value;}
+          void originalRequestPublicationMetaData(IPublicationMetaDataPtr value)  {mOriginalRequestPublicationMetaData = value; invalidateEncoded();}
 
           IPublicationPtr publication() const                                     {return mPublication;}
-          void publication(IPublicationPtr publication)                           {mPublication = publication;}
+          void publication(IPublicationPtr publication)                           {mPublication = publication; invalidateEncoded();}
 
         protected:
           PeerGetResult();
@@ -65,6 +65,7 @@ namespace openpeer
                                              );
 
           virtual DocumentPtr encode();
+          virtual bool encodeTo(MessageWriter &writer);
 
           virtual Methods method() const                            {return (Message::Methods)MessageFactoryPeerCommon::Method_PeerPublishNotify;}
 
@@ -73,10 +74,10 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const PublicationList &publicationList() const            {return mPublicationList;}
-          void publicationList(PublicationList &publicationList)    {mPublicationList = publicationList;}
+          void publicationList(PublicationList &publicationList)    {mPublicationList = publicationList; invalidateEncoded();}
 
           IPublicationRepositoryPeerCachePtr peerCache() const      {return mPeerCache;}
-          void peerCache(IPublicationRepositoryPeerCachePtr value)  {mPeerCache = value;}
+          void peerCache(IPublicationRepositoryPeerCachePtr value)  {mPeerCache = value; invalidateEncoded();}
 
         protected:
           PeerPublishNotify();
@@ -71,13 +71,13 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           IPublicationPtr publication() const             {return mPublication;}
-          void publication(IPublicationPtr publication)   {mPublication = publication;}
+          void publication(IPublicationPtr publication)   {mPublication = publication; invalidateEncoded();}
 
           ULONG publishedFromVersion() const              {return mPublishedFromVersion;}
-          void publishedFromVersion(ULONG value)          {mPublishedFromVersion = value;}
+          void publishedFromVersion(ULONG value)          {mPublishedFromVersion = value; invalidateEncoded();}
 
           ULONG publishedToVersion() const                {return mPublishedToVersion;}
-          void publishedToVersion(ULONG value)            {mPublishedToVersion = value;}
+          void publishedToVersion(ULONG value)            {mPublishedToVersion = value; invalidateEncoded();}
 
         protected:
           PeerPublishRequest();
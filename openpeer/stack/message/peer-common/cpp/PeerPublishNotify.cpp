@@ -31,6 +31,7 @@
 
 #include <openpeer/stack/message/peer-common/PeerPublishNotify.h>
 #include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
+#include <openpeer/stack/message/MessageWriter.h>
 
 #include <zsLib/XML.h>
 
@@ -85,7 +86,7 @@ namespace openpeer
             documentsEl->orphan();
 
             do {
-              ElementPtr documentEl = documentsEl->findFirstChildElement("document");
+              ElementPtr documentEl = documentsEl->findFirstChildElement(MessageNames::document());
               if (!documentEl)
                 break;
 
@@ -123,7 +124,7 @@ namespace openpeer
             maxDataSize -= (filledSize < maxDataSize ? filledSize : maxDataSize);
             try {
               ElementPtr rootEl = doc->getFirstChildElementChecked();
-              ElementPtr documentEl = rootEl->findFirstChildElementChecked("document");
+              ElementPtr documentEl = rootEl->findFirstChildElementChecked(MessageNames::document());
 
               documentEl->orphan();
 
@@ -148,6 +149,49 @@ namespace openpeer
           return current;
         }
 
+        //---------------------------------------------------------------------
+        bool PeerPublishNotify::encodeTo(MessageWriter &writer)
+        {
+          size_t maxDataSize = OPENPEER_STACK_MESSAGE_PEER_PUBLISH_NOTIFY_MAX_DOCUMENT_PUBLICATION_SIZE_IN_BYTES;
+
+          bool began = false;
+          for (PeerPublishNotify::PublicationList::iterator iter = mPublicationList.begin(); iter != mPublicationList.end(); ++iter)
+          {
+            IPublicationMetaDataPtr metaData = (*iter);
+
+            size_t filledSize = 0;
+            DocumentPtr doc = internal::MessageHelper::createDocument(*this, metaData, &maxDataSize, mPeerCache);
+            maxDataSize -= (filledSize < maxDataSize ? filledSize : maxDataSize);
+
+            ElementPtr documentEl;
+            try {
+              ElementPtr rootEl = doc->getFirstChildElementChecked();
+              documentEl = rootEl->findFirstChildElementChecked(MessageNames::document());
+            } catch (CheckFailed &) {
+              ZS_LOG_ERROR(Detail, slog("expected element is missing"))
+              return false;
+            }
+
+            if (!began) {
+              // each document is spliced straight into the output rather than
+              // being re-parented into a combined document first
+              if (!writer.beginMessage(*this)) return false;
+              writer.beginObject("documents");
+              writer.beginArray("document");
+              began = true;
+            }
+
+            writer.writeElementValue(documentEl);
+          }
+
+          if (!began) return false;
+
+          writer.endArray();
+          writer.endObject();
+          writer.endMessage();
+          return true;
+        }
+
         //---------------------------------------------------------------------
         bool PeerPublishNotify::hasAttribute(AttributeTypes type) const
         {
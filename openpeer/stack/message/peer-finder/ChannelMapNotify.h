@@ -72,25 +72,25 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const ChannelNumber &channelNumber() const                    {return mChannelNumber;}
-          void channelNumber(const ChannelNumber &value)                {mChannelNumber = value;}
+          void channelNumber(const ChannelNumber &value)                {mChannelNumber = value; invalidateEncoded();}
 
           const String &nonce() const                                   {return mNonce;}
-          void nonce(const String &value)                               {mNonce = value;}
+          void nonce(const String &value)                               {mNonce = value; invalidateEncoded();}
 
           const String &localContext() const                            {return mLocalContext;}
-          void localContext(const String &value)                        {mLocalContext = value;}
+          void localContext(const String &value)                        {mLocalContext = value; invalidateEncoded();}
 
           const String &remoteContext() const                           {return mRemoteContext;}
-          void remoteContext(const String &value)                       {mRemoteContext = value;}
+          void remoteContext(const String &value)                       {mRemoteContext = value; invalidateEncoded();}
 
           const String &relayAccessToken() const                        {return mRelayAccessToken;}
-          void relayAccessToken(const String &value)                    {mRelayAccessToken = value;}
+          void relayAccessToken(const String &value)                    {mRelayAccessToken = value; invalidateEncoded();}
 
           const String &relayAccessSecretProof() const                  {return mRelayAccessSecretProof;}
-          void relayAccessSecretProof(const String &value)              {mRelayAccessSecretProof = value;}
+          void relayAccessSecretProof(const String &value)              {mRelayAccessSecretProof = value; invalidateEncoded();}
 
           const Time &relayAccessSecretProofExpires() const             {return mRelayAccessSecretProofExpires;}
-          void relayAccessSecretProofExpires(const Time &value)         {mRelayAccessSecretProofExpires = value;}
+          void relayAccessSecretProofExpires(const Time &value)         {mRelayAccessSecretProofExpires = value; invalidateEncoded();}
 
         protected:
           ChannelMapNotify();
@@ -66,6 +66,7 @@ namespace openpeer
           static ChannelMapRequestPtr create();
 
           virtual DocumentPtr encode();
+          virtual bool encodeTo(MessageWriter &writer);
 
           virtual Methods method() const                                  {return (Message::Methods)MessageFactoryPeerFinder::Method_ChannelMap;}
 
@@ -74,23 +75,29 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           ChannelNumber channelNumber() const                             {return mChannelNumber;}
-          void channelNumber(const ChannelNumber &val)                    {get(mChannelNumber) = val;}
+          void channelNumber(const ChannelNumber &val)                    {get(mChannelNumber) = val; invalidateEncoded();}
 
           const String &localContextID() const                            {return mLocalContextID;}
-          void localContextID(const String &val)                          {mLocalContextID = val;}
+          void localContextID(const String &val)                          {mLocalContextID = val; invalidateEncoded();}
 
           const String &remoteContextID() const                           {return mRemoteContextID;}
-          void remoteContextID(const String &val)                         {mRemoteContextID = val;}
+          void remoteContextID(const String &val)                         {mRemoteContextID = val; invalidateEncoded();}
 
           const String &relayAccessToken() const                          {return mRelayAccessToken;}
-          void relayAccessToken(const String &val)                        {mRelayAccessToken = val;}
+          void relayAccessToken(const String &val)                        {mRelayAccessToken = val; invalidateEncoded();}
 
           const String &relayAccessSecretProof() const                    {return mRelayAccessSecretProof;}
-          void relayAccessSecretProof(const String &val)                  {mRelayAccessSecretProof = val;}
+          void relayAccessSecretProof(const String &val)                  {mRelayAccessSecretProof = val; invalidateEncoded();}
 
         protected:
           ChannelMapRequest();
 
+          bool hasProof() const;
+          String calculateProof(
+                                const String &clientNonce,
+                                Time expires
+                                ) const;
+
           AutoChannelNumber mChannelNumber;
 
           String mLocalContextID;
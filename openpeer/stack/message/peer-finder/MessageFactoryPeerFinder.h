@@ -66,7 +66,9 @@ namespace openpeer
 
             Method_PeerLocationFind,
 
-            Method_Last = Method_PeerLocationFind,
+            Method_ChannelWindow,
+
+            Method_Last = Method_ChannelWindow,
           };
 
         protected:
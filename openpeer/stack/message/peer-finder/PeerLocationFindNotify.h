@@ -66,6 +66,7 @@ namespace openpeer
                                                  );
 
           virtual DocumentPtr encode();
+          virtual bool encodeTo(MessageWriter &writer);
 
           virtual Methods method() const                                {return (Message::Methods)MessageFactoryPeerFinder::Method_PeerLocationFind;}
           virtual IMessageFactoryPtr factory() const                    {return MessageFactoryPeerFinder::singleton();}
@@ -73,32 +74,34 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const String &context() const                                 {return mContext;}
-          void context(const String &secret)                            {mContext = secret;}
+          void context(const String &secret)                            {mContext = secret; invalidateEncoded();}
 
           bool validated() const                                        {return mValidated;}
-          void validated(bool val)                                      {get(mValidated) = val;}
+          void validated(bool val)                                      {get(mValidated) = val; invalidateEncoded();}
 
           const String &iceUsernameFrag() const                         {return mICEUsernameFrag;}
-          void iceUsernameFrag(const String &val)                       {mICEUsernameFrag = val;}
+          void iceUsernameFrag(const String &val)                       {mICEUsernameFrag = val; invalidateEncoded();}
 
           const String &icePassword() const                             {return mICEPassword;}
-          void icePassword(const String &val)                           {mICEPassword = val;}
+          void icePassword(const String &val)                           {mICEPassword = val; invalidateEncoded();}
 
           bool final() const                                            {return mFinal;}
-          void final(bool val)                                          {get(mFinal) = val;}
+          void final(bool val)                                          {get(mFinal) = val; invalidateEncoded();}
 
           const String &requestFindProofBundleDigestValue() const       {return mRequestFindProofBundleDigestValue;}
-          void requestFindProofBundleDigestValue(const String &secret)  {mRequestFindProofBundleDigestValue = secret;}
+          void requestFindProofBundleDigestValue(const String &secret)  {mRequestFindProofBundleDigestValue = secret; invalidateEncoded();}
 
           LocationInfoPtr locationInfo() const                          {return mLocationInfo;}
-          void locationInfo(LocationInfoPtr locationInfo)               {mLocationInfo = locationInfo;}
+          void locationInfo(LocationInfoPtr locationInfo)               {mLocationInfo = locationInfo; invalidateEncoded();}
 
           IPeerFilesPtr peerFiles() const                               {return mPeerFiles;}
-          void peerFiles(IPeerFilesPtr peerFiles)                       {mPeerFiles = peerFiles;}
+          void peerFiles(IPeerFilesPtr peerFiles)                       {mPeerFiles = peerFiles; invalidateEncoded();}
 
         protected:
           PeerLocationFindNotify();
 
+          ElementPtr createFindProofBundle();
+
           String mContext;
 
           AutoBool mValidated;
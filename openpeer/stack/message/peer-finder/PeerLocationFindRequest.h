@@ -80,6 +80,7 @@ namespace openpeer
                                                    );
 
           virtual DocumentPtr encode();
+          virtual bool encodeTo(MessageWriter &writer);
 
           virtual Methods method() const                                  {return (Message::Methods)MessageFactoryPeerFinder::Method_PeerLocationFind;}
 
@@ -88,52 +89,54 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const String &requestFindProofBundleDigestValue() const         {return mRequestFindProofBundleDigestValue;}
-          void requestFindProofBundleDigestValue(const String &secret)    {mRequestFindProofBundleDigestValue = secret;}
+          void requestFindProofBundleDigestValue(const String &secret)    {mRequestFindProofBundleDigestValue = secret; invalidateEncoded();}
 
           Time created() const                                            {return mCreated;}
-          void created(const Time &value)                                 {mCreated = value;}
+          void created(const Time &value)                                 {mCreated = value; invalidateEncoded();}
 
           const IPeerPtr &findPeer() const                                {return mFindPeer;}
-          void findPeer(const IPeerPtr &peer)                             {mFindPeer = peer;}
+          void findPeer(const IPeerPtr &peer)                             {mFindPeer = peer; invalidateEncoded();}
 
           const String &context() const                                   {return mContext;}
-          void context(const String &val)                                 {mContext = val;}
+          void context(const String &val)                                 {mContext = val; invalidateEncoded();}
 
           const String &peerSecret() const                                {return mPeerSecret;}
-          void peerSecret(const String &secret)                           {mPeerSecret = secret;}
+          void peerSecret(const String &secret)                           {mPeerSecret = secret; invalidateEncoded();}
 
           IDHKeyDomainPtr dhKeyDomain() const;
-          void dhKeyDomain(IDHKeyDomainPtr value)                         {mDHKeyDomain = value;}
+          void dhKeyDomain(IDHKeyDomainPtr value)                         {mDHKeyDomain = value; invalidateEncoded();}
 
           IDHPrivateKeyPtr dhPrivateKey() const                           {return mDHPrivateKey;}
-          void dhPrivateKey(IDHPrivateKeyPtr value)                       {mDHPrivateKey = value;}
+          void dhPrivateKey(IDHPrivateKeyPtr value)                       {mDHPrivateKey = value; invalidateEncoded();}
 
           IDHPublicKeyPtr dhPublicKey() const                             {return mDHPublicKey;}
-          void dhPublicKey(IDHPublicKeyPtr value)                         {mDHPublicKey = value;}
+          void dhPublicKey(IDHPublicKeyPtr value)                         {mDHPublicKey = value; invalidateEncoded();}
 
           const String &iceUsernameFrag() const                           {return mICEUsernameFrag;}
-          void iceUsernameFrag(const String &val)                         {mICEUsernameFrag = val;}
+          void iceUsernameFrag(const String &val)                         {mICEUsernameFrag = val; invalidateEncoded();}
 
           const String &icePassword() const                               {return mICEPassword;}
-          void icePassword(const String &val)                             {mICEPassword = val;}
+          void icePassword(const String &val)                             {mICEPassword = val; invalidateEncoded();}
 
           bool final() const                                              {return mFinal > 0;}
-          void final(bool value)                                          {mFinal = (value ? 1 : 0);}
+          void final(bool value)                                          {mFinal = (value ? 1 : 0); invalidateEncoded();}
 
           const ExcludedLocationList &excludeLocations() const            {return mExcludedLocations;}
-          void excludeLocations(const ExcludedLocationList &excludeList)  {mExcludedLocations = excludeList;}
+          void excludeLocations(const ExcludedLocationList &excludeList)  {mExcludedLocations = excludeList; invalidateEncoded();}
 
           LocationInfoPtr locationInfo() const                            {return mLocationInfo;}
-          void locationInfo(LocationInfoPtr location)                     {mLocationInfo = location;}
+          void locationInfo(LocationInfoPtr location)                     {mLocationInfo = location; invalidateEncoded();}
 
           IPeerFilesPtr peerFiles() const                                 {return mPeerFiles;}
-          void peerFiles(IPeerFilesPtr peerFiles)                         {mPeerFiles = peerFiles;}
+          void peerFiles(IPeerFilesPtr peerFiles)                         {mPeerFiles = peerFiles; invalidateEncoded();}
 
           bool didVerifySignature() const                                 {return mDidVerifySignature;}
 
         protected:
           PeerLocationFindRequest();
 
+          ElementPtr createFindProofBundle();
+
           String mRequestFindProofBundleDigestValue;
 
           Time mCreated;
@@ -65,7 +65,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const LocationInfoList &locations() const       {return mLocations;}
-          void locations(const LocationInfoList &val)     {mLocations = val;}
+          void locations(const LocationInfoList &val)     {mLocations = val; invalidateEncoded();}
 
         protected:
           PeerLocationFindResult();
@@ -50,6 +50,7 @@ namespace openpeer
             AttributeType_FinderID,
             AttributeType_LocationInfo,
             AttributeType_PeerFiles,
+            AttributeType_Encodings,
           };
 
         public:
@@ -66,13 +67,16 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const String &finderID() const              {return mFinderID;}
-          void finderID(const String &val)            {mFinderID = val;}
+          void finderID(const String &val)            {mFinderID = val; invalidateEncoded();}
 
           LocationInfoPtr locationInfo() const        {return mLocationInfo;}
-          void locationInfo(LocationInfoPtr val)      {mLocationInfo = val;}
+          void locationInfo(LocationInfoPtr val)      {mLocationInfo = val; invalidateEncoded();}
 
           IPeerFilesPtr peerFiles() const             {return mPeerFiles;}
-          void peerFiles(IPeerFilesPtr peerFiles)     {mPeerFiles = peerFiles;}
+          void peerFiles(IPeerFilesPtr peerFiles)     {mPeerFiles = peerFiles; invalidateEncoded();}
+
+          const StringList &encodings() const         {return mEncodings;}
+          void encodings(const StringList &val)       {mEncodings = val; invalidateEncoded();}
 
         protected:
           SessionCreateRequest();
@@ -81,6 +85,8 @@ namespace openpeer
           LocationInfoPtr mLocationInfo;
 
           IPeerFilesPtr mPeerFiles;
+
+          StringList mEncodings;
         };
       }
     }
@@ -52,6 +52,9 @@ namespace openpeer
             AttributeType_RelayAccessSecret,
             AttributeType_ServerAgent,
             AttributeType_Expires,
+            AttributeType_Encoding,
+            AttributeType_Compression,
+            AttributeType_Batching,
           };
 
         public:
@@ -69,16 +72,25 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const String &relayAccessToken()            {return mRelayAccessToken;}
-          void relayAccessToken(const String &val)    {mRelayAccessToken = val;}
+          void relayAccessToken(const String &val)    {mRelayAccessToken = val; invalidateEncoded();}
 
           const String &relayAccessSecret()           {return mRelayAccessSecret;}
-          void relayAccessSecret(const String &val)   {mRelayAccessSecret = val;}
+          void relayAccessSecret(const String &val)   {mRelayAccessSecret = val; invalidateEncoded();}
 
           const String &serverAgent() const           {return mServerAgent;}
-          void serverAgent(const String &val)         {mServerAgent = val;}
+          void serverAgent(const String &val)         {mServerAgent = val; invalidateEncoded();}
 
           Time expires() const                        {return mExpires;}
-          void expires(Time val)                      {mExpires = val;}
+          void expires(Time val)                      {mExpires = val; invalidateEncoded();}
+
+          const String &encoding() const              {return mEncoding;}
+          void encoding(const String &val)            {mEncoding = val; invalidateEncoded();}
+
+          const String &compression() const           {return mCompression;}
+          void compression(const String &val)         {mCompression = val; invalidateEncoded();}
+
+          const String &batching() const              {return mBatching;}
+          void batching(const String &val)            {mBatching = val; invalidateEncoded();}
 
         protected:
           SessionCreateResult();
@@ -88,6 +100,10 @@ namespace openpeer
 
           String mServerAgent;
           Time mExpires;
+
+          String mEncoding;
+          String mCompression;
+          String mBatching;
         };
       }
     }
@@ -64,7 +64,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const StringList &locations() const         {return mLocations;}
-          void locations(const StringList &val)       {mLocations = val;}
+          void locations(const StringList &val)       {mLocations = val; invalidateEncoded();}
 
         protected:
           SessionDeleteRequest();
@@ -56,6 +56,7 @@ namespace openpeer
           static SessionKeepAliveRequestPtr create();
 
           virtual DocumentPtr encode();
+          virtual bool encodeTo(MessageWriter &writer);
 
           virtual Methods method() const {return (Message::Methods)MessageFactoryPeerFinder::Method_SessionKeepAlive;}
 
@@ -67,7 +67,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           Time expires() const    {return mExpires;}
-          void expires(Time val)  {mExpires = val;}
+          void expires(Time val)  {mExpires = val; invalidateEncoded();}
 
         protected:
           SessionKeepAliveResult();
@@ -84,22 +84,22 @@ namespace openpeer
           try {
 
             try {
-              String channelNumber = IMessageHelper::getElementTextAndDecode(root->findFirstChildElementChecked("channel"));
+              String channelNumber = IMessageHelper::getElementTextAndDecode(root->findFirstChildElementChecked(MessageNames::channel()));
               ret->mChannelNumber = Numeric<ChannelNumber>(channelNumber);
             } catch(Numeric<ChannelNumber>::ValueOutOfRange &) {
               ZS_LOG_WARNING(Detail, slog("missing channel number"))
               return ChannelMapNotifyPtr();
             }
 
-            ret->mNonce = IMessageHelper::getElementTextAndDecode(root->findFirstChildElementChecked("nonce"));
+            ret->mNonce = IMessageHelper::getElementTextAndDecode(root->findFirstChildElementChecked(MessageNames::nonce()));
 
-            ElementPtr relayEl = root->findFirstChildElementChecked("relay");
+            ElementPtr relayEl = root->findFirstChildElementChecked(MessageNames::relay());
 
-            ret->mLocalContext = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked("localContext"));
-            ret->mRemoteContext = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked("remoteContext"));
-            ret->mRelayAccessToken = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked("accessToken"));
-            ret->mRelayAccessSecretProof = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked("accessSecretProof"));
-            ret->mRelayAccessSecretProofExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked("accessSecretProofExpires")));
+            ret->mLocalContext = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked(MessageNames::localContext()));
+            ret->mRemoteContext = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked(MessageNames::remoteContext()));
+            ret->mRelayAccessToken = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked(MessageNames::accessToken()));
+            ret->mRelayAccessSecretProof = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked(MessageNames::accessSecretProof()));
+            ret->mRelayAccessSecretProofExpires = IHelper::stringToTime(IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElementChecked(MessageNames::accessSecretProofExpires())));
 
           } catch(CheckFailed &) {
             ZS_LOG_WARNING(Detail, slog("expected element is missing"))
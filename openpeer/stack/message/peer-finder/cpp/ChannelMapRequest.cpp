@@ -31,6 +31,7 @@
 
 #include <openpeer/stack/message/peer-finder/ChannelMapRequest.h>
 #include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
+#include <openpeer/stack/message/MessageWriter.h>
 
 #include <openpeer/services/IHelper.h>
 
@@ -98,34 +99,26 @@ namespace openpeer
           DocumentPtr ret = IMessageHelper::createDocumentWithRoot(*this);
           ElementPtr rootEl = ret->getFirstChildElement();
 
-          ElementPtr relayEl = Element::create("relay");
+          ElementPtr relayEl = Element::create(MessageNames::relay());
 
           if (hasAttribute(AttributeType_ChannelNumber)) {
-            rootEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("channel", string(mChannelNumber)));
+            rootEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::channel(), string(mChannelNumber)));
           }
 
-          rootEl->adoptAsLastChild(IMessageHelper::createElementWithText("nonce", clientNonce));
+          rootEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::nonce(), clientNonce));
 
           if (hasAttribute(AttributeType_LocalContextID)) {
-            relayEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("localContext", mLocalContextID));
+            relayEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::localContext(), mLocalContextID));
           }
           if (hasAttribute(AttributeType_RemoteContextID)) {
-            relayEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("remoteContext", mRemoteContextID));
+            relayEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::remoteContext(), mRemoteContextID));
           }
           if (hasAttribute(AttributeType_RelayAccessToken)) {
-            relayEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("accessToken", mRelayAccessToken));
+            relayEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::accessToken(), mRelayAccessToken));
           }
-          if ((hasAttribute(AttributeType_RelayAccessSecretProof)) &&
-              (hasAttribute(AttributeType_LocalContextID)) &&
-              (hasAttribute(AttributeType_ChannelNumber))) {
-
-            String hashInput = String("proof:") + clientNonce + ":" + mLocalContextID + ":" + string(mChannelNumber) + ":" + IHelper::timeToString(expires) + ":" + mRelayAccessSecretProof;
-            String proof = IHelper::convertToHex(*IHelper::hash(hashInput));
-
-            ZS_LOG_TRACE(slog("relay access secret hash") + ZS_PARAM("id", mID) + ZS_PARAM("input", hashInput) + ZS_PARAM("result", proof))
-
-            relayEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("accessSecretProof", proof));
-            relayEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("accessSecretProofExpires", IHelper::timeToString(expires)));
+          if (hasProof()) {
+            relayEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::accessSecretProof(), calculateProof(clientNonce, expires)));
+            relayEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::accessSecretProofExpires(), IHelper::timeToString(expires)));
           }
 
           if (relayEl->hasChildren()) {
@@ -135,6 +128,72 @@ namespace openpeer
           return ret;
         }
 
+        //---------------------------------------------------------------------
+        bool ChannelMapRequest::encodeTo(MessageWriter &writer)
+        {
+          String clientNonce = IHelper::convertToHex(*IHelper::random(32));
+
+          Time expires = zsLib::now() + Duration(Seconds(OPENPEER_STACK_MESSAGE_CHANNEL_MAP_REQUEST_PROOF_EXPIRES_IN_SECONDS));
+
+          if (!writer.beginMessage(*this)) return false;
+
+          if (hasAttribute(AttributeType_ChannelNumber)) {
+            writer.writeNumber("channel", string(mChannelNumber));
+          }
+
+          writer.writeText("nonce", clientNonce);
+
+          bool hasRelay = ((hasAttribute(AttributeType_LocalContextID)) ||
+                           (hasAttribute(AttributeType_RemoteContextID)) ||
+                           (hasAttribute(AttributeType_RelayAccessToken)) ||
+                           (hasProof()));
+
+          if (hasRelay) {
+            writer.beginObject("relay");
+
+            if (hasAttribute(AttributeType_LocalContextID)) {
+              writer.writeText("localContext", mLocalContextID);
+            }
+            if (hasAttribute(AttributeType_RemoteContextID)) {
+              writer.writeText("remoteContext", mRemoteContextID);
+            }
+            if (hasAttribute(AttributeType_RelayAccessToken)) {
+              writer.writeText("accessToken", mRelayAccessToken);
+            }
+            if (hasProof()) {
+              writer.writeText("accessSecretProof", calculateProof(clientNonce, expires));
+              writer.writeNumber("accessSecretProofExpires", IHelper::timeToString(expires));
+            }
+
+            writer.endObject();
+          }
+
+          writer.endMessage();
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        bool ChannelMapRequest::hasProof() const
+        {
+          return ((hasAttribute(AttributeType_RelayAccessSecretProof)) &&
+                  (hasAttribute(AttributeType_LocalContextID)) &&
+                  (hasAttribute(AttributeType_ChannelNumber)));
+        }
+
+        //---------------------------------------------------------------------
+        String ChannelMapRequest::calculateProof(
+                                                 const String &clientNonce,
+                                                 Time expires
+                                                 ) const
+        {
+          String hashInput = String("proof:") + clientNonce + ":" + mLocalContextID + ":" + string(mChannelNumber) + ":" + IHelper::timeToString(expires) + ":" + mRelayAccessSecretProof;
+          String proof = IHelper::convertToHex(*IHelper::hash(hashInput));
+
+          ZS_LOG_TRACE(slog("relay access secret hash") + ZS_PARAM("id", mID) + ZS_PARAM("input", hashInput) + ZS_PARAM("result", proof))
+
+          return proof;
+        }
+
         //---------------------------------------------------------------------
         ChannelMapRequestPtr ChannelMapRequest::create()
         {
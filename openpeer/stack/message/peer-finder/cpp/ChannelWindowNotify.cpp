@@ -0,0 +1,162 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+#include <openpeer/stack/message/peer-finder/ChannelWindowNotify.h>
+#include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
+#include <openpeer/stack/message/MessageWriter.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/helpers.h>
+#include <zsLib/Numeric.h>
+#include <zsLib/Stringize.h>
+
+namespace openpeer { namespace stack { namespace message { ZS_DECLARE_SUBSYSTEM(openpeer_stack_message) } } }
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace message
+    {
+      namespace peer_finder
+      {
+        using zsLib::Numeric;
+
+        typedef zsLib::XML::Exceptions::CheckFailed CheckFailed;
+
+        //---------------------------------------------------------------------
+        static Log::Params slog(const char *message)
+        {
+          return Log::Params(message, "ChannelWindowNotify");
+        }
+
+        //---------------------------------------------------------------------
+        ChannelWindowNotifyPtr ChannelWindowNotify::convert(MessagePtr message)
+        {
+          return dynamic_pointer_cast<ChannelWindowNotify>(message);
+        }
+
+        //---------------------------------------------------------------------
+        ChannelWindowNotify::ChannelWindowNotify() :
+          mChannelNumber(0),
+          mWindow(0)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        ChannelWindowNotifyPtr ChannelWindowNotify::create()
+        {
+          ChannelWindowNotifyPtr ret(new ChannelWindowNotify);
+          return ret;
+        }
+
+        //---------------------------------------------------------------------
+        ChannelWindowNotifyPtr ChannelWindowNotify::create(
+                                                           ElementPtr root,
+                                                           IMessageSourcePtr messageSource
+                                                           )
+        {
+          ChannelWindowNotifyPtr ret(new ChannelWindowNotify);
+          IMessageHelper::fill(*ret, root, messageSource);
+
+          try {
+
+            try {
+              String channelNumber = IMessageHelper::getElementTextAndDecode(root->findFirstChildElementChecked(MessageNames::channel()));
+              ret->mChannelNumber = Numeric<ChannelNumber>(channelNumber);
+            } catch(Numeric<ChannelNumber>::ValueOutOfRange &) {
+              ZS_LOG_WARNING(Detail, slog("missing channel number"))
+              return ChannelWindowNotifyPtr();
+            }
+
+            try {
+              String window = IMessageHelper::getElementTextAndDecode(root->findFirstChildElementChecked(MessageNames::window()));
+              ret->mWindow = Numeric<QWORD>(window);
+            } catch(Numeric<QWORD>::ValueOutOfRange &) {
+              ZS_LOG_WARNING(Detail, slog("window is not valid"))
+              return ChannelWindowNotifyPtr();
+            }
+
+          } catch(CheckFailed &) {
+            ZS_LOG_WARNING(Detail, slog("expected element is missing"))
+            return ChannelWindowNotifyPtr();
+          }
+
+          return ret;
+        }
+
+        //---------------------------------------------------------------------
+        DocumentPtr ChannelWindowNotify::encode()
+        {
+          DocumentPtr ret = IMessageHelper::createDocumentWithRoot(*this);
+          ElementPtr rootEl = ret->getFirstChildElement();
+
+          if (hasAttribute(AttributeType_ChannelNumber)) {
+            rootEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::channel(), string(mChannelNumber)));
+          }
+          if (hasAttribute(AttributeType_Window)) {
+            rootEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::window(), string(mWindow)));
+          }
+
+          return ret;
+        }
+
+        //---------------------------------------------------------------------
+        bool ChannelWindowNotify::encodeTo(MessageWriter &writer)
+        {
+          if (!writer.beginMessage(*this)) return false;
+
+          if (hasAttribute(AttributeType_ChannelNumber)) {
+            writer.writeNumber("channel", string(mChannelNumber));
+          }
+          if (hasAttribute(AttributeType_Window)) {
+            writer.writeNumber("window", string(mWindow));
+          }
+
+          writer.endMessage();
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        bool ChannelWindowNotify::hasAttribute(AttributeTypes type) const
+        {
+          switch (type)
+          {
+            case AttributeType_ChannelNumber:             return (0 != mChannelNumber);
+            case AttributeType_Window:                    return (0 != mWindow);
+          }
+          return false;
+        }
+
+      }
+    }
+  }
+}
@@ -37,6 +37,7 @@
 
 #include <openpeer/stack/message/peer-finder/ChannelMapResult.h>
 #include <openpeer/stack/message/peer-finder/ChannelMapNotify.h>
+#include <openpeer/stack/message/peer-finder/ChannelWindowNotify.h>
 
 #include <openpeer/stack/message/peer-finder/SessionCreateResult.h>
 #include <openpeer/stack/message/peer-finder/SessionDeleteResult.h>
@@ -96,16 +97,7 @@ namespace openpeer
         //---------------------------------------------------------------------
         Message::Methods MessageFactoryPeerFinder::toMethod(const char *inMethod) const
         {
-          typedef zsLib::ULONG ULONG;
-          String methodStr(inMethod ? inMethod : "");
-
-          for (ULONG loop = (ULONG)(MessageFactoryPeerFinder::Method_Invalid+1); loop <= ((ULONG)MessageFactoryPeerFinder::Method_Last); ++loop)
-          {
-            if (methodStr == toString((Message::Methods)loop)) {
-              return (Message::Methods)loop;
-            }
-          }
-          return Message::Method_Invalid;
+          return IMessageFactoryManager::toMethod(getHandler(), inMethod);
         }
 
         //---------------------------------------------------------------------
@@ -122,6 +114,8 @@ namespace openpeer
             case Method_SessionDelete:            return "session-delete";
 
             case Method_PeerLocationFind:         return "peer-location-find";
+
+            case Method_ChannelWindow:            return "channel-window";
           }
           return "";
         }
@@ -135,7 +129,7 @@ namespace openpeer
           if (!root) return MessagePtr();
 
           Message::MessageTypes msgType = IMessageHelper::getMessageType(root);
-          Methods msgMethod = (MessageFactoryPeerFinder::Methods)toMethod(IMessageHelper::getAttribute(root, "method"));
+          Methods msgMethod = (MessageFactoryPeerFinder::Methods)toMethod(IMessageHelper::getAttribute(root, MessageNames::method()));
 
           switch (msgType) {
             case Message::MessageType_Invalid:                return MessagePtr();
@@ -152,6 +146,8 @@ namespace openpeer
                 case Method_SessionDelete:                    return MessagePtr();
 
                 case Method_PeerLocationFind:                 return PeerLocationFindRequest::create(root, messageSource);
+
+                case Method_ChannelWindow:                    return MessagePtr();
               }
               break;
             }
@@ -167,6 +163,8 @@ namespace openpeer
                 case Method_SessionDelete:                    return SessionDeleteResult::create(root, messageSource);
 
                 case Method_PeerLocationFind:                 return PeerLocationFindResult::create(root, messageSource);
+
+                case Method_ChannelWindow:                    return MessagePtr();
               }
               break;
             }
@@ -182,6 +180,8 @@ namespace openpeer
                 case Method_SessionDelete:                    return MessagePtr();
 
                 case Method_PeerLocationFind:                 return PeerLocationFindNotify::create(root, messageSource);
+
+                case Method_ChannelWindow:                    return ChannelWindowNotify::create(root, messageSource);
               }
               break;
             }
@@ -32,6 +32,7 @@
 #include <openpeer/stack/message/peer-finder/PeerLocationFindNotify.h>
 #include <openpeer/stack/message/peer-finder/PeerLocationFindRequest.h>
 #include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
+#include <openpeer/stack/message/MessageWriter.h>
 #include <openpeer/stack/internal/stack_Location.h>
 #include <openpeer/stack/internal/stack_Peer.h>
 #include <openpeer/stack/IPeerFiles.h>
@@ -90,11 +91,11 @@ namespace openpeer
 
           try {
 
-            ElementPtr findProofEl = root->findFirstChildElementChecked("findProofBundle")->findFirstChildElementChecked("findProof");
+            ElementPtr findProofEl = root->findFirstChildElementChecked(MessageNames::findProofBundle())->findFirstChildElementChecked(MessageNames::findProof());
 
-            ret->mRequestFindProofBundleDigestValue = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("requestFindProofBundleDigestValue"));
+            ret->mRequestFindProofBundleDigestValue = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked(MessageNames::requestFindProofBundleDigestValue()));
 
-            ret->mContext = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("context"));
+            ret->mContext = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked(MessageNames::context()));
 
             try {
               get(ret->mValidated) = Numeric<bool>(IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("validated")));
@@ -102,16 +103,16 @@ namespace openpeer
               ZS_LOG_WARNING(Detail, slog("final value missing"))
             }
 
-            ret->mICEUsernameFrag = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("iceUsernameFrag"));
-            ret->mICEPassword = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("icePassword"));
+            ret->mICEUsernameFrag = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked(MessageNames::iceUsernameFrag()));
+            ret->mICEPassword = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked(MessageNames::icePassword()));
 
             try {
-              get(ret->mFinal) = Numeric<bool>(IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("iceFinal")));
+              get(ret->mFinal) = Numeric<bool>(IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked(MessageNames::iceFinal())));
             } catch (Numeric<bool>::ValueOutOfRange &) {
               ZS_LOG_WARNING(Detail, slog("final value missing"))
             }
 
-            ElementPtr locationEl = findProofEl->findFirstChildElement("location");
+            ElementPtr locationEl = findProofEl->findFirstChildElement(MessageNames::location());
             if (locationEl) {
               ret->mLocationInfo = internal::MessageHelper::createLocation(locationEl, messageSource);
             }
@@ -183,48 +184,74 @@ namespace openpeer
         //---------------------------------------------------------------------
         DocumentPtr PeerLocationFindNotify::encode()
         {
+          ElementPtr findProofBundleEl = createFindProofBundle();
+          if (!findProofBundleEl) return DocumentPtr();
+
           DocumentPtr ret = IMessageHelper::createDocumentWithRoot(*this);
           ElementPtr root = ret->getFirstChildElement();
 
+          root->adoptAsLastChild(findProofBundleEl);
+
+          return ret;
+        }
+
+        //---------------------------------------------------------------------
+        bool PeerLocationFindNotify::encodeTo(MessageWriter &writer)
+        {
+          // the signed proof bundle still needs a DOM, the rest is streamed
+          ElementPtr findProofBundleEl = createFindProofBundle();
+          if (!findProofBundleEl) return false;
+
+          if (!writer.beginMessage(*this)) return false;
+
+          writer.writeElement(findProofBundleEl);
+
+          writer.endMessage();
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        ElementPtr PeerLocationFindNotify::createFindProofBundle()
+        {
           if (!mPeerFiles) {
             ZS_LOG_ERROR(Detail, slog("peer files was null"))
-            return DocumentPtr();
+            return ElementPtr();
           }
 
           IPeerFilePrivatePtr peerFilePrivate = mPeerFiles->getPeerFilePrivate();
           if (!peerFilePrivate) {
             ZS_LOG_ERROR(Detail, slog("peer file private was null"))
-            return DocumentPtr();
+            return ElementPtr();
           }
           IPeerFilePublicPtr peerFilePublic = mPeerFiles->getPeerFilePublic();
           if (!peerFilePublic) {
             ZS_LOG_ERROR(Detail, slog("peer file public was null"))
-            return DocumentPtr();
+            return ElementPtr();
           }
 
-          ElementPtr findProofBundleEl = Element::create("findProofBundle");
-          ElementPtr findProofEl = Element::create("findProof");
+          ElementPtr findProofBundleEl = Element::create(MessageNames::findProofBundle());
+          ElementPtr findProofEl = Element::create(MessageNames::findProof());
 
           if (hasAttribute(AttributeType_RequestfindProofBundleDigestValue))
           {
-            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("requestFindProofBundleDigestValue", mRequestFindProofBundleDigestValue));
+            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::requestFindProofBundleDigestValue(), mRequestFindProofBundleDigestValue));
           }
 
           if (hasAttribute(AttributeType_Context)) {
-            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("context", mContext));
+            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::context(), mContext));
           }
 
           findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("validated", mValidated ? "true":"false"));
 
           if (hasAttribute(AttributeType_ICEUsernameFrag)) {
-            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("iceUsernameFrag", mICEUsernameFrag));
+            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::iceUsernameFrag(), mICEUsernameFrag));
           }
 
           if (hasAttribute(AttributeType_ICEPassword)) {
-            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("icePassword", mICEPassword));
+            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::icePassword(), mICEPassword));
           }
 
-          findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("iceFinal", mFinal ? "true":"false"));
+          findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::iceFinal(), mFinal ? "true":"false"));
 
           if (hasAttribute(AttributeType_LocationInfo)) {
             findProofEl->adoptAsLastChild(MessageHelper::createElement(*mLocationInfo));
@@ -232,9 +259,8 @@ namespace openpeer
 
           findProofBundleEl->adoptAsLastChild(findProofEl);
           peerFilePrivate->signElement(findProofEl);
-          root->adoptAsLastChild(findProofBundleEl);
 
-          return ret;
+          return findProofBundleEl;
         }
 
       }
@@ -31,6 +31,7 @@
 
 #include <openpeer/stack/message/peer-finder/PeerLocationFindRequest.h>
 #include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
+#include <openpeer/stack/message/MessageWriter.h>
 #include <openpeer/stack/internal/stack_Location.h>
 #include <openpeer/stack/internal/stack_Peer.h>
 #include <openpeer/stack/internal/stack_Account.h>
@@ -139,14 +140,14 @@ namespace openpeer
           }
 
           try {
-            ElementPtr findProofEl = root->findFirstChildElementChecked("findProofBundle")->findFirstChildElementChecked("findProof");
+            ElementPtr findProofEl = root->findFirstChildElementChecked(MessageNames::findProofBundle())->findFirstChildElementChecked(MessageNames::findProof());
 
-            String clientNonce = findProofEl->findFirstChildElementChecked("nonce")->getText();
+            String clientNonce = findProofEl->findFirstChildElementChecked(MessageNames::nonce())->getText();
 
-            ret->mCreated = IHelper::stringToTime(findProofEl->findFirstChildElementChecked("created")->getText());
+            ret->mCreated = IHelper::stringToTime(findProofEl->findFirstChildElementChecked(MessageNames::created())->getText());
 
             try {
-              ElementPtr finalEl = findProofEl->findFirstChildElement("iceFinal");
+              ElementPtr finalEl = findProofEl->findFirstChildElement(MessageNames::iceFinal());
               if (finalEl) {
                 ret->mFinal = ((Numeric<bool>(IMessageHelper::getElementTextAndDecode(finalEl))) ? 1 : 0);
               } else {
@@ -163,8 +164,8 @@ namespace openpeer
               return PeerLocationFindRequestPtr();
             }
 
-            String findSecretProof = findProofEl->findFirstChildElementChecked("findSecretProof")->getText();
-            Time expires = IHelper::stringToTime(findProofEl->findFirstChildElementChecked("findSecretProofExpires")->getText());
+            String findSecretProof = findProofEl->findFirstChildElementChecked(MessageNames::findSecretProof())->getText();
+            Time expires = IHelper::stringToTime(findProofEl->findFirstChildElementChecked(MessageNames::findSecretProofExpires())->getText());
 
             String findSecret = peerFilePublic->getFindSecret();
             String calculatedFindSecretProof = IHelper::convertToHex(*IHelper::hmac(*IHelper::hmacKeyFromPassphrase(findSecret), "proof:" + clientNonce + ":" + IHelper::timeToString(expires)));
@@ -179,9 +180,9 @@ namespace openpeer
               return PeerLocationFindRequestPtr();
             }
 
-            ret->mContext = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("context"));
+            ret->mContext = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked(MessageNames::context()));
 
-            String peerSecretEncrypted = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElement("peerSecretEncrypted"));
+            String peerSecretEncrypted = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElement(MessageNames::peerSecretEncrypted()));
 
             if (peerSecretEncrypted.hasData()) {
               SplitMap splits;
@@ -230,8 +231,8 @@ namespace openpeer
 
             ZS_LOG_TRACE(slog("decrypted peer secret") + ZS_PARAM("secret", ret->mPeerSecret))
 
-            ret->mICEUsernameFrag = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("iceUsernameFrag"));
-            String icePasswordEncrypted = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked("icePasswordEncrypted"));
+            ret->mICEUsernameFrag = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked(MessageNames::iceUsernameFrag()));
+            String icePasswordEncrypted = IMessageHelper::getElementTextAndDecode(findProofEl->findFirstChildElementChecked(MessageNames::icePasswordEncrypted()));
             if (icePasswordEncrypted.hasData()) {
               SecureByteBlockPtr icePassword = stack::IHelper::splitDecrypt(*IHelper::hash(ret->mPeerSecret, IHelper::HashAlgorthm_SHA256), icePasswordEncrypted);
               if (icePassword) {
@@ -239,7 +240,7 @@ namespace openpeer
               }
             }
 
-            ElementPtr locationEl = findProofEl->findFirstChildElement("location");
+            ElementPtr locationEl = findProofEl->findFirstChildElement(MessageNames::location());
             if (locationEl) {
               ret->mLocationInfo = internal::MessageHelper::createLocation(locationEl, messageSource, ret->mPeerSecret);
             }
@@ -286,18 +287,18 @@ namespace openpeer
               get(ret->mDidVerifySignature) = true;
             }
 
-            ElementPtr excludeEl = root->findFirstChildElement("exclude");
+            ElementPtr excludeEl = root->findFirstChildElement(MessageNames::exclude());
             if (excludeEl) {
-              ElementPtr locationsEl = excludeEl->findFirstChildElement("locations");
+              ElementPtr locationsEl = excludeEl->findFirstChildElement(MessageNames::locations());
               if (locationsEl) {
                 ExcludedLocationList excludeList;
-                ElementPtr locationEl = locationsEl->findFirstChildElement("location");
+                ElementPtr locationEl = locationsEl->findFirstChildElement(MessageNames::location());
                 while (locationEl)
                 {
                   String id = IMessageHelper::getAttributeID(locationEl);
                   excludeList.push_back(id);
 
-                  locationEl = locationEl->findNextSiblingElement("location");
+                  locationEl = locationEl->findNextSiblingElement(MessageNames::location());
                 }
 
                 if (excludeList.size() > 0)
@@ -344,37 +345,97 @@ namespace openpeer
 
         //---------------------------------------------------------------------
         DocumentPtr PeerLocationFindRequest::encode()
+        {
+          ElementPtr findProofBundleEl = createFindProofBundle();
+          if (!findProofBundleEl) return DocumentPtr();
+
+          DocumentPtr ret = IMessageHelper::createDocumentWithRoot(*this);
+          ElementPtr root = ret->getFirstChildElement();
+
+          root->adoptAsLastChild(findProofBundleEl);
+
+          if (hasAttribute(AttributeType_ExcludedLocations))
+          {
+            ElementPtr excludeEl = IMessageHelper::createElement(MessageNames::exclude());
+            ElementPtr locationsEl = IMessageHelper::createElement(MessageNames::locations());
+            excludeEl->adoptAsLastChild(locationsEl);
+            root->adoptAsLastChild(excludeEl);
+
+            for (ExcludedLocationList::const_iterator it = mExcludedLocations.begin(); it != mExcludedLocations.end(); ++it)
+            {
+              const String &location = (*it);
+              locationsEl->adoptAsLastChild(IMessageHelper::createElementWithID(MessageNames::location(), location));
+            }
+          }
+
+          return ret;
+        }
+
+        //---------------------------------------------------------------------
+        bool PeerLocationFindRequest::encodeTo(MessageWriter &writer)
+        {
+          // the signed proof bundle still needs a DOM, the rest is streamed
+          ElementPtr findProofBundleEl = createFindProofBundle();
+          if (!findProofBundleEl) return false;
+
+          if (!writer.beginMessage(*this)) return false;
+
+          writer.writeElement(findProofBundleEl);
+
+          if (hasAttribute(AttributeType_ExcludedLocations))
+          {
+            writer.beginObject("exclude");
+            writer.beginObject("locations");
+
+            if (mExcludedLocations.size() > 0) {
+              writer.beginArray("location");
+              for (ExcludedLocationList::const_iterator it = mExcludedLocations.begin(); it != mExcludedLocations.end(); ++it)
+              {
+                writer.beginObject();
+                writer.writeAttribute("id", (*it));
+                writer.endObject();
+              }
+              writer.endArray();
+            }
+
+            writer.endObject();
+            writer.endObject();
+          }
+
+          writer.endMessage();
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        ElementPtr PeerLocationFindRequest::createFindProofBundle()
         {
           if (!mPeerFiles) {
             ZS_LOG_ERROR(Detail, slog("peer files was null"))
-            return DocumentPtr();
+            return ElementPtr();
           }
 
           IPeerFilePrivatePtr peerFilePrivate = mPeerFiles->getPeerFilePrivate();
           if (!peerFilePrivate) {
             ZS_LOG_ERROR(Detail, slog("peer file private was null"))
-            return DocumentPtr();
+            return ElementPtr();
           }
           IPeerFilePublicPtr peerFilePublic = mPeerFiles->getPeerFilePublic();
           if (!peerFilePublic) {
             ZS_LOG_ERROR(Detail, slog("peer file public was null"))
-            return DocumentPtr();
+            return ElementPtr();
           }
 
           String clientNonce = IHelper::convertToHex(*IHelper::random(16));
 
           Time expires = zsLib::now() + Duration(Seconds(OPENPEER_STACK_MESSAGE_PEER_LOCATION_FIND_REQUEST_LIFETIME_IN_SECONDS));
 
-          DocumentPtr ret = IMessageHelper::createDocumentWithRoot(*this);
-          ElementPtr root = ret->getFirstChildElement();
-
-          ElementPtr findProofBundleEl = Element::create("findProofBundle");
-          ElementPtr findProofEl = Element::create("findProof");
+          ElementPtr findProofBundleEl = Element::create(MessageNames::findProofBundle());
+          ElementPtr findProofEl = Element::create(MessageNames::findProof());
 
-          findProofEl->adoptAsLastChild(IMessageHelper::createElementWithText("nonce", clientNonce));
+          findProofEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::nonce(), clientNonce));
 
           if (hasAttribute(AttributeType_CreatedTimestamp)) {
-            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("created", IHelper::timeToString(mCreated)));
+            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::created(), IHelper::timeToString(mCreated)));
           }
 
           if (mFindPeer) {
@@ -387,12 +448,12 @@ namespace openpeer
               String findSecret = remotePeerFilePublic->getFindSecret();
               if (findSecret.length() > 0) {
                 String findSecretProof = IHelper::convertToHex(*IHelper::hmac(*IHelper::hmacKeyFromPassphrase(findSecret), "proof:" + clientNonce + ":" + IHelper::timeToString(expires)));
-                findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("findSecretProof", findSecretProof));
-                findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("findSecretProofExpires", IHelper::timeToString(expires)));
+                findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::findSecretProof(), findSecretProof));
+                findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::findSecretProofExpires(), IHelper::timeToString(expires)));
               }
 
               if (hasAttribute(AttributeType_Context)) {
-                findProofEl->adoptAsLastChild(IMessageHelper::createElementWithText("context", mContext));
+                findProofEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::context(), mContext));
               }
 
               if (hasAttribute(AttributeType_PeerSecret)) {
@@ -420,21 +481,21 @@ namespace openpeer
                   }
                 }
 
-                findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("peerSecretEncrypted", peerSecretEncrypted));
+                findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::peerSecretEncrypted(), peerSecretEncrypted));
               }
             }
           }
 
           if (hasAttribute(AttributeType_ICEUsernameFrag)) {
-            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("iceUsernameFrag", mICEUsernameFrag));
+            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::iceUsernameFrag(), mICEUsernameFrag));
           }
           if (hasAttribute(AttributeType_ICEPassword)) {
             String icePassword = stack::IHelper::splitEncrypt(*IHelper::hash(mPeerSecret, IHelper::HashAlgorthm_SHA256), *IHelper::convertToBuffer(mICEPassword));
-            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode("icePasswordEncrypted", icePassword));
+            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithTextAndJSONEncode(MessageNames::icePasswordEncrypted(), icePassword));
           }
 
           if (hasAttribute(AttributeType_Final)) {
-            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("iceFinal", mFinal > 0 ? "true" : "false"));
+            findProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::iceFinal(), mFinal > 0 ? "true" : "false"));
           }
 
           if (hasAttribute(AttributeType_LocationInfo)) {
@@ -444,7 +505,6 @@ namespace openpeer
 
           findProofBundleEl->adoptAsLastChild(findProofEl);
           peerFilePrivate->signElement(findProofEl);
-          root->adoptAsLastChild(findProofBundleEl);
 
           ElementPtr signatureEl;
           IHelper::getSignatureInfo(findProofEl, &signatureEl);
@@ -453,21 +513,7 @@ namespace openpeer
             mRequestFindProofBundleDigestValue = signatureEl->findFirstChildElementChecked("digestValue")->getTextDecoded();
           }
 
-          if (hasAttribute(AttributeType_ExcludedLocations))
-          {
-            ElementPtr excludeEl = IMessageHelper::createElement("exclude");
-            ElementPtr locationsEl = IMessageHelper::createElement("locations");
-            excludeEl->adoptAsLastChild(locationsEl);
-            root->adoptAsLastChild(excludeEl);
-
-            for (ExcludedLocationList::const_iterator it = mExcludedLocations.begin(); it != mExcludedLocations.end(); ++it)
-            {
-              const String &location = (*it);
-              locationsEl->adoptAsLastChild(IMessageHelper::createElementWithID("location", location));
-            }
-          }
-
-          return ret;
+          return findProofBundleEl;
         }
 
         //---------------------------------------------------------------------
@@ -62,9 +62,9 @@ namespace openpeer
           PeerLocationFindResultPtr ret(new PeerLocationFindResult);
           IMessageHelper::fill(*ret, root, messageSource);
 
-          ElementPtr locationsEl = root->findFirstChildElement("locations");
+          ElementPtr locationsEl = root->findFirstChildElement(MessageNames::locations());
           if (locationsEl) {
-            ElementPtr locationEl = locationsEl->findFirstChildElement("location");
+            ElementPtr locationEl = locationsEl->findFirstChildElement(MessageNames::location());
             while (locationEl)
             {
               LocationInfoPtr locationInfo = internal::MessageHelper::createLocation(locationEl, messageSource);
@@ -74,7 +74,7 @@ namespace openpeer
                 }
               }
 
-              locationEl = locationEl->findNextSiblingElement("location");
+              locationEl = locationEl->findNextSiblingElement(MessageNames::location());
             }
           }
 
@@ -93,6 +93,7 @@ namespace openpeer
             case AttributeType_FinderID:      return (!mFinderID.isEmpty());
             case AttributeType_LocationInfo:  return (mLocationInfo ? mLocationInfo->hasData(): false);
             case AttributeType_PeerFiles:     return (bool)mPeerFiles;
+            case AttributeType_Encodings:     return (mEncodings.size() > 0);
             default:                          break;
           }
           return false;
@@ -127,11 +128,11 @@ namespace openpeer
             sessionProofEl->adoptAsLastChild(IMessageHelper::createElementWithID("finder", mFinderID));
           }
 
-          sessionProofEl->adoptAsLastChild(IMessageHelper::createElementWithText("nonce", IHelper::convertToHex(*IHelper::random(16))));
+          sessionProofEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::nonce(), IHelper::convertToHex(*IHelper::random(16))));
 
           Time expires = zsLib::now() + Seconds(OPENPEER_STACK_MESSAGE_PEER_FINDER_SESSION_CREATE_REQUEST_EXPIRES_TIME_IN_SECONDS);
 
-          sessionProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber("expires", IHelper::timeToString(expires)));
+          sessionProofEl->adoptAsLastChild(IMessageHelper::createElementWithNumber(MessageNames::expires(), IHelper::timeToString(expires)));
 
           if (hasAttribute(AttributeType_LocationInfo)) {
             sessionProofEl->adoptAsLastChild(MessageHelper::createElement(*mLocationInfo));
@@ -144,6 +145,10 @@ namespace openpeer
 
           root->adoptAsLastChild(sessionProofBundleEl);
 
+          if (hasAttribute(AttributeType_Encodings)) {
+            root->adoptAsLastChild(MessageHelper::createEncodingsElement(mEncodings));
+          }
+
           return ret;
         }
       }
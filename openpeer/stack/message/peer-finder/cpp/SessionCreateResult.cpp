@@ -95,7 +95,7 @@ namespace openpeer
             ElementPtr serverProofBundleEl = rootEl->findFirstChildElementChecked("serverProofBundle");
             ElementPtr serverProofEl = serverProofBundleEl->findFirstChildElementChecked("serverProof");
 
-            relayEl = serverProofEl->findFirstChildElementChecked("relay");
+            relayEl = serverProofEl->findFirstChildElementChecked(MessageNames::relay());
           } catch(CheckFailed &) {
             ZS_LOG_WARNING(Detail, slog("session create relay token missing"))
             return SessionCreateResultPtr();
@@ -135,17 +135,20 @@ namespace openpeer
 #define WARNING_NEED_TO_VERIFY_SERVER_SIGNATURE 2
 
           if (relayEl) {
-            ret->mRelayAccessToken = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElement("accessToken"));
+            ret->mRelayAccessToken = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElement(MessageNames::accessToken()));
             String accessSecretEncrypted = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElement("accessSecretEncrypted"));
             if (accessSecretEncrypted.hasData()) {
               ret->mRelayAccessSecret = IHelper::convertToString(*peerFilePrivate->decrypt(*IHelper::convertFromBase64(accessSecretEncrypted)));
             } else {
-              ret->mRelayAccessSecret = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElement("accessSecret"));
+              ret->mRelayAccessSecret = IMessageHelper::getElementTextAndDecode(relayEl->findFirstChildElement(MessageNames::accessSecret()));
             }
           }
 
           ret->mServerAgent = IMessageHelper::getElementTextAndDecode(rootEl->findFirstChildElement("server"));
-          ret->mExpires = IHelper::stringToTime(IMessageHelper::getElementText(rootEl->findFirstChildElement("expires")));
+          ret->mExpires = IHelper::stringToTime(IMessageHelper::getElementText(rootEl->findFirstChildElement(MessageNames::expires())));
+          ret->mEncoding = IMessageHelper::getElementTextAndDecode(rootEl->findFirstChildElement(MessageNames::encoding()));
+          ret->mCompression = IMessageHelper::getElementTextAndDecode(rootEl->findFirstChildElement(MessageNames::compression()));
+          ret->mBatching = IMessageHelper::getElementTextAndDecode(rootEl->findFirstChildElement(MessageNames::batching()));
 
           return ret;
         }
@@ -159,6 +162,9 @@ namespace openpeer
             case AttributeType_RelayAccessSecret:   return mRelayAccessSecret.hasData();
             case AttributeType_ServerAgent:         return mServerAgent.hasData();
             case AttributeType_Expires:             return (Time() != mExpires);
+            case AttributeType_Encoding:            return mEncoding.hasData();
+            case AttributeType_Compression:         return mCompression.hasData();
+            case AttributeType_Batching:            return mBatching.hasData();
             default:                                break;
           }
           return MessageResult::hasAttribute((MessageResult::AttributeTypes)type);
@@ -79,13 +79,13 @@ namespace openpeer
 
           if (hasAttribute(AttributeType_Locations))
           {
-            ElementPtr locationsEl = IMessageHelper::createElement("locations");
+            ElementPtr locationsEl = IMessageHelper::createElement(MessageNames::locations());
             root->adoptAsLastChild(locationsEl);
 
             for(StringList::const_iterator it = mLocations.begin(); it != mLocations.end(); ++it)
             {
               const String &loc = (*it);
-              locationsEl->adoptAsLastChild(IMessageHelper::createElementWithID("location", loc));
+              locationsEl->adoptAsLastChild(IMessageHelper::createElementWithID(MessageNames::location(), loc));
             }
           }
 
@@ -62,11 +62,11 @@ namespace openpeer
           SessionDeleteResultPtr ret(new SessionDeleteResult);
           IMessageHelper::fill(*ret, root, messageSource);
 
-          ElementPtr locations = root->findFirstChildElement("locations");
+          ElementPtr locations = root->findFirstChildElement(MessageNames::locations());
           if(locations)
           {
             StringList ll;
-            ElementPtr loc = locations->findFirstChildElement("location");
+            ElementPtr loc = locations->findFirstChildElement(MessageNames::location());
             while (loc)
             {
               ll.push_back(IMessageHelper::getAttributeID(loc));
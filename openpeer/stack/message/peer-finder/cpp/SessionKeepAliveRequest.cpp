@@ -31,6 +31,7 @@
 
 #include <openpeer/stack/message/peer-finder/SessionKeepAliveRequest.h>
 #include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
+#include <openpeer/stack/message/MessageWriter.h>
 
 
 namespace openpeer
@@ -72,6 +73,14 @@ namespace openpeer
           return ret;
         }
 
+        //---------------------------------------------------------------------
+        bool SessionKeepAliveRequest::encodeTo(MessageWriter &writer)
+        {
+          if (!writer.beginMessage(*this)) return false;
+          writer.endMessage();
+          return true;
+        }
+
       }
     }
   }
@@ -69,7 +69,7 @@ namespace openpeer
           SessionKeepAliveResultPtr ret(new SessionKeepAliveResult);
           IMessageHelper::fill(*ret, root, messageSource);
 
-          ret->mExpires = IHelper::stringToTime(IMessageHelper::getElementText(root->findFirstChildElement("expires")));
+          ret->mExpires = IHelper::stringToTime(IMessageHelper::getElementText(root->findFirstChildElement(MessageNames::expires())));
 
           return ret;
         }
@@ -82,7 +82,7 @@ namespace openpeer
           ElementPtr root = ret->getFirstChildElement();
 
           if (hasAttribute(AttributeType_Expires)) {
-            root->adoptAsFirstChild(IMessageHelper::createElementWithNumber("expires", IHelper::timeToString(mExpires)));
+            root->adoptAsFirstChild(IMessageHelper::createElementWithNumber(MessageNames::expires(), IHelper::timeToString(mExpires)));
           }
 
           return ret;
@@ -64,7 +64,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           UINT salts() const              {return mSalts;}
-          void salts(UINT val)            {mSalts = val;}
+          void salts(UINT val)            {mSalts = val; invalidateEncoded();}
 
         protected:
           SignedSaltGetRequest();
@@ -65,7 +65,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const SaltBundleList &saltBundles() const   {return mSaltBundles;}
-          void saltBundles(const SaltBundleList &val) {mSaltBundles = val;}
+          void saltBundles(const SaltBundleList &val) {mSaltBundles = val; invalidateEncoded();}
 
         protected:
           SignedSaltGetResult();
@@ -54,6 +54,7 @@ namespace openpeer
             AttributeType_FindSecret,
             AttributeType_PeerFilePublic,
             AttributeType_PeerFiles,
+            AttributeType_Encodings,
           };
 
         public:
@@ -75,16 +76,19 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const String &findSecret() const                  {return mFindSecret;}
-          void findSecret(const String &val)                {mFindSecret = val;}
+          void findSecret(const String &val)                {mFindSecret = val; invalidateEncoded();}
 
           LocationInfoPtr locationInfo() const              {return mLocationInfo;}
-          void location(LocationInfoPtr locationInfo)       {mLocationInfo = locationInfo;}
+          void location(LocationInfoPtr locationInfo)       {mLocationInfo = locationInfo; invalidateEncoded();}
 
           IPeerFilePublicPtr peerFilePublic() const         {return mPeerFilePublic;}
-          void peerFilesPublic(IPeerFilePublicPtr val)      {mPeerFilePublic = val;}
+          void peerFilesPublic(IPeerFilePublicPtr val)      {mPeerFilePublic = val; invalidateEncoded();}
 
           IPeerFilesPtr peerFiles() const                   {return mPeerFiles;}
-          void peerFiles(IPeerFilesPtr peerFiles)           {mPeerFiles = peerFiles;}
+          void peerFiles(IPeerFilesPtr peerFiles)           {mPeerFiles = peerFiles; invalidateEncoded();}
+
+          const StringList &encodings() const               {return mEncodings;}
+          void encodings(const StringList &val)             {mEncodings = val; invalidateEncoded();}
 
         protected:
           PeerIdentifyRequest();
@@ -96,6 +100,8 @@ namespace openpeer
           IPeerFilePublicPtr mPeerFilePublic;
 
           IPeerFilesPtr mPeerFiles;
+
+          StringList mEncodings;
         };
       }
     }
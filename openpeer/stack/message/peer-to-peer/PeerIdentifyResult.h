@@ -48,6 +48,9 @@ namespace openpeer
           enum AttributeTypes
           {
             AttributeType_LocationInfo = MessageResult::AttributeType_Last + 1,
+            AttributeType_Encoding,
+            AttributeType_Compression,
+            AttributeType_Batching,
           };
 
         public:
@@ -68,12 +71,24 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           LocationInfoPtr locationInfo() const        {return mLocationInfo;}
-          void locationInfo(LocationInfoPtr val)      {mLocationInfo = val;}
+          void locationInfo(LocationInfoPtr val)      {mLocationInfo = val; invalidateEncoded();}
+
+          const String &encoding() const              {return mEncoding;}
+          void encoding(const String &val)            {mEncoding = val; invalidateEncoded();}
+
+          const String &compression() const           {return mCompression;}
+          void compression(const String &val)         {mCompression = val; invalidateEncoded();}
+
+          const String &batching() const              {return mBatching;}
+          void batching(const String &val)            {mBatching = val; invalidateEncoded();}
 
         protected:
           PeerIdentifyResult();
 
           LocationInfoPtr mLocationInfo;
+          String mEncoding;
+          String mCompression;
+          String mBatching;
         };
       }
     }
@@ -60,6 +60,7 @@ namespace openpeer
                                                 );
 
           virtual DocumentPtr encode();
+          virtual bool encodeTo(MessageWriter &writer);
 
           virtual Methods method() const {return (Message::Methods)MessageFactoryPeerToPeer::Method_PeerKeepAlive;}
 
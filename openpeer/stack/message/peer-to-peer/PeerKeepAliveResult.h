@@ -60,6 +60,7 @@ namespace openpeer
                                                );
 
           virtual DocumentPtr encode();
+          virtual bool encodeTo(MessageWriter &writer);
 
           virtual Methods method() const {return (Message::Methods)MessageFactoryPeerToPeer::Method_PeerKeepAlive;}
 
@@ -68,7 +69,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           Time expires() const    {return mExpires;}
-          void expires(Time val)  {mExpires = val;}
+          void expires(Time val)  {mExpires = val; invalidateEncoded();}
 
         protected:
           PeerKeepAliveResult();
@@ -100,16 +100,7 @@ namespace openpeer
         //---------------------------------------------------------------------
         Message::Methods MessageFactoryPeerToPeer::toMethod(const char *inMethod) const
         {
-          typedef zsLib::ULONG ULONG;
-          String methodStr(inMethod ? inMethod : "");
-
-          for (ULONG loop = (ULONG)(MessageFactoryPeerToPeer::Method_Invalid+1); loop <= ((ULONG)MessageFactoryPeerToPeer::Method_Last); ++loop)
-          {
-            if (methodStr == toString((Message::Methods)loop)) {
-              return (Message::Methods)loop;
-            }
-          }
-          return Message::Method_Invalid;
+          return IMessageFactoryManager::toMethod(getHandler(), inMethod);
         }
 
         //---------------------------------------------------------------------
@@ -134,7 +125,7 @@ namespace openpeer
           if (!root) return MessagePtr();
 
           Message::MessageTypes msgType = IMessageHelper::getMessageType(root);
-          Methods msgMethod = (MessageFactoryPeerToPeer::Methods)toMethod(IMessageHelper::getAttribute(root, "method"));
+          Methods msgMethod = (MessageFactoryPeerToPeer::Methods)toMethod(IMessageHelper::getAttribute(root, MessageNames::method()));
 
           switch (msgType) {
             case Message::MessageType_Invalid:                return MessagePtr();
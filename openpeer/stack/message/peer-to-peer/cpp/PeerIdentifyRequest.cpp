@@ -104,10 +104,10 @@ namespace openpeer
           {
             ret->mID = IMessageHelper::getAttributeID(root);
 
-            ElementPtr peerIdentityProofBundleEl = root->findFirstChildElementChecked("peerIdentityProofBundle");
-            ElementPtr peerIdentityProofEl = peerIdentityProofBundleEl->findFirstChildElementChecked("peerIdentityProof");
+            ElementPtr peerIdentityProofBundleEl = root->findFirstChildElementChecked(MessageNames::peerIdentityProofBundle());
+            ElementPtr peerIdentityProofEl = peerIdentityProofBundleEl->findFirstChildElementChecked(MessageNames::peerIdentityProof());
 
-            ElementPtr peerEl = peerIdentityProofEl->findFirstChildElementChecked("peer");
+            ElementPtr peerEl = peerIdentityProofEl->findFirstChildElementChecked(MessageNames::peer());
             ret->mPeerFilePublic = IPeerFilePublic::loadFromElement(peerEl);
             if (!ret->mPeerFilePublic) {
               ZS_LOG_WARNING(Detail, slog("missing remote peer information"))
@@ -132,14 +132,15 @@ namespace openpeer
               return PeerIdentifyRequestPtr();
             }
 
-            Time expires = IHelper::stringToTime(peerIdentityProofEl->findFirstChildElementChecked("expires")->getText());
+            Time expires = IHelper::stringToTime(peerIdentityProofEl->findFirstChildElementChecked(MessageNames::expires())->getText());
             if (zsLib::now() > expires) {
               ZS_LOG_WARNING(Detail, slog("request expired") + ZS_PARAM("expires", expires) + ZS_PARAM("now", ::zsLib::now()))
               return PeerIdentifyRequestPtr();
             }
 
-            ret->mFindSecret = IMessageHelper::getElementTextAndDecode(peerIdentityProofEl->findFirstChildElement("findSecret"));
-            ret->mLocationInfo = MessageHelper::createLocation(peerIdentityProofEl->findFirstChildElement("location"), messageSource);
+            ret->mFindSecret = IMessageHelper::getElementTextAndDecode(peerIdentityProofEl->findFirstChildElement(MessageNames::findSecret()));
+            ret->mLocationInfo = MessageHelper::createLocation(peerIdentityProofEl->findFirstChildElement(MessageNames::location()), messageSource);
+            ret->mEncodings = MessageHelper::createEncodings(root->findFirstChildElement(MessageNames::encodings()));
 
             UsePeerPtr remotePeer = IPeerForMessages::create(account, ret->mPeerFilePublic);
             if (!remotePeer) {
@@ -194,6 +195,7 @@ namespace openpeer
             case AttributeType_FindSecret:      return (!mFindSecret.isEmpty());
             case AttributeType_PeerFilePublic:  return (bool)mPeerFilePublic;
             case AttributeType_PeerFiles:       return (bool)mPeerFiles;
+            case AttributeType_Encodings:       return (mEncodings.size() > 0);
             default:                            break;
           }
           return false;
@@ -221,16 +223,16 @@ namespace openpeer
           DocumentPtr ret = IMessageHelper::createDocumentWithRoot(*this);
           ElementPtr root = ret->getFirstChildElement();
 
-          ElementPtr peerIdentityProofBundleEl = Element::create("peerIdentityProofBundle");
-          ElementPtr peerIdentityProofEl = Element::create("peerIdentityProof");
+          ElementPtr peerIdentityProofBundleEl = Element::create(MessageNames::peerIdentityProofBundle());
+          ElementPtr peerIdentityProofEl = Element::create(MessageNames::peerIdentityProof());
 
-          peerIdentityProofEl->adoptAsLastChild(IMessageHelper::createElementWithText("nonce", IHelper::randomString(32)));
+          peerIdentityProofEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::nonce(), IHelper::randomString(32)));
 
           Time expires = zsLib::now() + Duration(Seconds(OPENPEER_STACK_MESSAGE_PEER_IDENTIFY_REQUEST_LIFETIME_IN_SECONDS));
-          peerIdentityProofEl->adoptAsLastChild(IMessageHelper::createElementWithText("expires", IHelper::timeToString(expires)));
+          peerIdentityProofEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::expires(), IHelper::timeToString(expires)));
 
           if (hasAttribute(AttributeType_FindSecret)) {
-            peerIdentityProofEl->adoptAsLastChild(IMessageHelper::createElementWithText("findSecret", mFindSecret));
+            peerIdentityProofEl->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::findSecret(), mFindSecret));
           }
 
           if (hasAttribute(AttributeType_LocationInfo)) {
@@ -242,6 +244,11 @@ namespace openpeer
           peerIdentityProofBundleEl->adoptAsLastChild(peerIdentityProofEl);
           peerFilePrivate->signElement(peerIdentityProofEl);
           root->adoptAsLastChild(peerIdentityProofBundleEl);
+
+          if (hasAttribute(AttributeType_Encodings)) {
+            root->adoptAsLastChild(MessageHelper::createEncodingsElement(mEncodings));
+          }
+
           return ret;
         }
 
@@ -82,7 +82,10 @@ namespace openpeer
           ret->mID = IMessageHelper::getAttributeID(root);
           ret->mTime = IMessageHelper::getAttributeEpoch(root);
 
-          ret->mLocationInfo = MessageHelper::createLocation(root->findFirstChildElement("location"), messageSource);
+          ret->mLocationInfo = MessageHelper::createLocation(root->findFirstChildElement(MessageNames::location()), messageSource);
+          ret->mEncoding = IMessageHelper::getElementTextAndDecode(root->findFirstChildElement(MessageNames::encoding()));
+          ret->mCompression = IMessageHelper::getElementTextAndDecode(root->findFirstChildElement(MessageNames::compression()));
+          ret->mBatching = IMessageHelper::getElementTextAndDecode(root->findFirstChildElement(MessageNames::batching()));
 
           return ret;
         }
@@ -93,6 +96,9 @@ namespace openpeer
           switch (type)
           {
             case AttributeType_LocationInfo:    return mLocationInfo ? mLocationInfo->hasData() : false;
+            case AttributeType_Encoding:        return mEncoding.hasData();
+            case AttributeType_Compression:     return mCompression.hasData();
+            case AttributeType_Batching:        return mBatching.hasData();
             default:                            break;
           }
           return MessageResult::hasAttribute((MessageResult::AttributeTypes)type);
@@ -108,6 +114,18 @@ namespace openpeer
             root->adoptAsLastChild(MessageHelper::createElement(*mLocationInfo));
           }
 
+          if (hasAttribute(AttributeType_Encoding)) {
+            root->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::encoding(), mEncoding));
+          }
+
+          if (hasAttribute(AttributeType_Compression)) {
+            root->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::compression(), mCompression));
+          }
+
+          if (hasAttribute(AttributeType_Batching)) {
+            root->adoptAsLastChild(IMessageHelper::createElementWithText(MessageNames::batching(), mBatching));
+          }
+
           return ret;
         }
 
@@ -31,6 +31,7 @@
 
 #include <openpeer/stack/message/peer-to-peer/PeerKeepAliveRequest.h>
 #include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
+#include <openpeer/stack/message/MessageWriter.h>
 
 
 namespace openpeer
@@ -86,6 +87,14 @@ namespace openpeer
           return ret;
         }
 
+        //---------------------------------------------------------------------
+        bool PeerKeepAliveRequest::encodeTo(MessageWriter &writer)
+        {
+          if (!writer.beginMessage(*this)) return false;
+          writer.endMessage();
+          return true;
+        }
+
       }
     }
   }
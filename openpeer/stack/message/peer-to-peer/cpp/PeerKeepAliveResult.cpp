@@ -32,6 +32,7 @@
 #include <openpeer/stack/message/peer-to-peer/PeerKeepAliveResult.h>
 #include <openpeer/stack/message/peer-to-peer/PeerKeepAliveRequest.h>
 #include <openpeer/stack/message/internal/stack_message_MessageHelper.h>
+#include <openpeer/stack/message/MessageWriter.h>
 
 #include <openpeer/services/IHelper.h>
 
@@ -83,7 +84,7 @@ namespace openpeer
           ret->mID = IMessageHelper::getAttributeID(root);
           ret->mTime = IMessageHelper::getAttributeEpoch(root);
 
-          ret->mExpires = IHelper::stringToTime(IMessageHelper::getElementText(root->findFirstChildElement("expires")));
+          ret->mExpires = IHelper::stringToTime(IMessageHelper::getElementText(root->findFirstChildElement(MessageNames::expires())));
 
           return ret;
         }
@@ -97,12 +98,26 @@ namespace openpeer
 
           if (hasAttribute(AttributeType_Expires))
           {
-            root->adoptAsFirstChild(IMessageHelper::createElementWithText("expires", IHelper::timeToString(mExpires)));
+            root->adoptAsFirstChild(IMessageHelper::createElementWithText(MessageNames::expires(), IHelper::timeToString(mExpires)));
           }
 
           return ret;
         }
 
+        //---------------------------------------------------------------------
+        bool PeerKeepAliveResult::encodeTo(MessageWriter &writer)
+        {
+          if (!writer.beginMessage(*this)) return false;
+
+          if (hasAttribute(AttributeType_Expires))
+          {
+            writer.writeText("expires", IHelper::timeToString(mExpires));
+          }
+
+          writer.endMessage();
+          return true;
+        }
+
         //---------------------------------------------------------------------
         bool PeerKeepAliveResult::hasAttribute(AttributeTypes type) const
         {
@@ -67,7 +67,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const LockboxInfo &lockboxInfo() const              {return mLockboxInfo;}
-          void lockboxInfo(const LockboxInfo &val)            {mLockboxInfo = val;}
+          void lockboxInfo(const LockboxInfo &val)            {mLockboxInfo = val; invalidateEncoded();}
 
         protected:
           PeerServicesGetRequest();
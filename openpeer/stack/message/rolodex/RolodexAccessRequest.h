@@ -78,16 +78,16 @@ namespace openpeer
           // mAccessSecret
 
           const IdentityInfo &identityInfo() const        {return mIdentityInfo;}
-          void identityInfo(const IdentityInfo &val)      {mIdentityInfo = val;}
+          void identityInfo(const IdentityInfo &val)      {mIdentityInfo = val; invalidateEncoded();}
 
           const RolodexInfo &rolodexInfo() const          {return mRolodexInfo;}
-          void rolodexInfo(const RolodexInfo &val)        {mRolodexInfo = val;}
+          void rolodexInfo(const RolodexInfo &val)        {mRolodexInfo = val; invalidateEncoded();}
 
           const AgentInfo &agentInfo() const              {return mAgentInfo;}
-          void agentInfo(const AgentInfo &val)            {mAgentInfo = val;}
+          void agentInfo(const AgentInfo &val)            {mAgentInfo = val; invalidateEncoded();}
 
           const String &grantID() const                   {return mGrantID;}
-          void grantID(const String &val)                 {mGrantID = val;}
+          void grantID(const String &val)                 {mGrantID = val; invalidateEncoded();}
 
         protected:
           RolodexAccessRequest();
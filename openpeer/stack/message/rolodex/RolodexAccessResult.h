@@ -67,10 +67,10 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const RolodexInfo &rolodexInfo() const            {return mRolodexInfo;}
-          void rolodexInfo(const RolodexInfo &val)          {mRolodexInfo = val;}
+          void rolodexInfo(const RolodexInfo &val)          {mRolodexInfo = val; invalidateEncoded();}
 
           const NamespaceGrantChallengeInfo &namespaceGrantChallengeInfo() const    {return mNamespaceGrantChallengeInfo;}
-          void namespaceGrantChallengeInfo(const NamespaceGrantChallengeInfo &val)  {mNamespaceGrantChallengeInfo = val;}
+          void namespaceGrantChallengeInfo(const NamespaceGrantChallengeInfo &val)  {mNamespaceGrantChallengeInfo = val; invalidateEncoded();}
 
         protected:
           RolodexAccessResult();
@@ -67,7 +67,7 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const RolodexInfo &rolodexInfo() const      {return mRolodexInfo;}
-          void rolodexInfo(const RolodexInfo &val)    {mRolodexInfo = val;}
+          void rolodexInfo(const RolodexInfo &val)    {mRolodexInfo = val; invalidateEncoded();}
 
         protected:
           RolodexContactsGetRequest();
@@ -68,10 +68,10 @@ namespace openpeer
           bool hasAttribute(AttributeTypes type) const;
 
           const IdentityInfoList &identities() const      {return mIdentities;}
-          void identities(const IdentityInfoList &val)    {mIdentities = val;}
+          void identities(const IdentityInfoList &val)    {mIdentities = val; invalidateEncoded();}
 
           const RolodexInfo &rolodexInfo() const            {return mRolodexInfo;}
-          void rolodexInfo(const RolodexInfo &val)          {mRolodexInfo = val;}
+          void rolodexInfo(const RolodexInfo &val)          {mRolodexInfo = val; invalidateEncoded();}
 
         protected:
           RolodexContactsGetResult();
@@ -91,16 +91,7 @@ namespace openpeer
         //---------------------------------------------------------------------
         Message::Methods MessageFactoryRolodex::toMethod(const char *inMethod) const
         {
-          typedef zsLib::ULONG ULONG;
-          String methodStr(inMethod ? inMethod : "");
-
-          for (ULONG loop = (ULONG)(MessageFactoryRolodex::Method_Invalid+1); loop <= ((ULONG)MessageFactoryRolodex::Method_Last); ++loop)
-          {
-            if (methodStr == toString((Message::Methods)loop)) {
-              return (Message::Methods)loop;
-            }
-          }
-          return Message::Method_Invalid;
+          return IMessageFactoryManager::toMethod(getHandler(), inMethod);
         }
 
         //---------------------------------------------------------------------
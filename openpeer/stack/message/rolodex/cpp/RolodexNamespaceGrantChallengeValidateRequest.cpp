@@ -119,6 +119,8 @@ namespace openpeer
 
         void RolodexNamespaceGrantChallengeValidateRequest::namespaceGrantChallengeBundle(ElementPtr val)
         {
+          invalidateEncoded();
+
           if (!val) {
             mNamespaceGrantChallengeBundle.reset();
             return;
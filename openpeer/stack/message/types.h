@@ -45,6 +45,7 @@ namespace openpeer
     {
       using zsLib::string;
       using zsLib::DWORD;
+      using zsLib::QWORD;
       using zsLib::XML::Document;
       using zsLib::XML::Element;
       using zsLib::XML::Text;
@@ -409,6 +410,8 @@ namespace openpeer
       #pragma mark
 
       ZS_DECLARE_CLASS_PTR(Message)
+      ZS_DECLARE_STRUCT_PTR(MessageEnvelope)
+      ZS_DECLARE_CLASS_PTR(MessageWriter)
       ZS_DECLARE_CLASS_PTR(MessageRequest)
       ZS_DECLARE_CLASS_PTR(MessageResult)
       ZS_DECLARE_CLASS_PTR(MessageNotify)
@@ -528,6 +531,7 @@ namespace openpeer
         ZS_DECLARE_CLASS_PTR(ChannelMapRequest)
         ZS_DECLARE_CLASS_PTR(ChannelMapResult)
         ZS_DECLARE_CLASS_PTR(ChannelMapNotify)
+        ZS_DECLARE_CLASS_PTR(ChannelWindowNotify)
         ZS_DECLARE_CLASS_PTR(PeerLocationFindRequest)
         ZS_DECLARE_CLASS_PTR(PeerLocationFindResult)
         ZS_DECLARE_CLASS_PTR(PeerLocationFindNotify)
@@ -0,0 +1,199 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/internal/stack_ChannelSendScheduler.h>
+
+#include <zsLib/helpers.h>
+
+#include "config.h"
+#include "boost_replacement.h"
+
+#include <list>
+#include <iostream>
+
+using zsLib::ULONG;
+using openpeer::SecureByteBlock;
+using openpeer::SecureByteBlockPtr;
+using openpeer::stack::internal::ChannelSendScheduler;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      typedef ChannelSendScheduler::QueuePtr QueuePtr;
+      typedef std::list<std::pair<ULONG, SecureByteBlockPtr> > WireList;
+
+      //-----------------------------------------------------------------------
+      static SecureByteBlockPtr makeBuffer(size_t size)
+      {
+        return SecureByteBlockPtr(new SecureByteBlock(size));
+      }
+
+      //-----------------------------------------------------------------------
+      static size_t bytesAheadOf(
+                                 const WireList &wire,
+                                 ULONG channelNumber
+                                 )
+      {
+        // bytes that went out on the wire before the channel's first buffer
+        size_t total = 0;
+        for (WireList::const_iterator iter = wire.begin(); iter != wire.end(); ++iter) {
+          if ((*iter).first == channelNumber) return total;
+          total += (*iter).second->SizeInBytes();
+        }
+        return total;
+      }
+    }
+  }
+}
+
+using openpeer::stack::test::QueuePtr;
+using openpeer::stack::test::WireList;
+using openpeer::stack::test::makeBuffer;
+using openpeer::stack::test::bytesAheadOf;
+
+void doTestChannelSendScheduler()
+{
+  if (!OPENPEER_STACK_TEST_DO_CHANNEL_SEND_SCHEDULER_TEST) return;
+
+  const size_t quantum = OPENPEER_STACK_TEST_CHANNEL_SEND_SCHEDULER_QUANTUM;
+  const ULONG bulkBuffers = OPENPEER_STACK_TEST_CHANNEL_SEND_SCHEDULER_BULK_BUFFERS;
+  const size_t bulkSize = 16*1024;
+
+  // scope: control traffic always goes first
+  {
+    ChannelSendScheduler scheduler(quantum);
+
+    QueuePtr control = scheduler.open(0, true);
+    QueuePtr bulk = scheduler.open(7);
+
+    scheduler.enqueue(bulk, makeBuffer(bulkSize));
+    scheduler.enqueue(bulk, makeBuffer(bulkSize));
+    scheduler.enqueue(control, makeBuffer(1));
+
+    ULONG channelNumber = 99;
+    SecureByteBlockPtr buffer = scheduler.next(channelNumber);
+    BOOST_EQUAL(channelNumber, 0)
+    BOOST_EQUAL(buffer->SizeInBytes(), 1)
+
+    buffer = scheduler.next(channelNumber);
+    BOOST_EQUAL(channelNumber, 7)
+
+    // a ping queued between two bulk buffers overtakes the second one
+    scheduler.enqueue(control, makeBuffer(1));
+    buffer = scheduler.next(channelNumber);
+    BOOST_EQUAL(channelNumber, 0)
+
+    buffer = scheduler.next(channelNumber);
+    BOOST_EQUAL(channelNumber, 7)
+
+    BOOST_CHECK(!scheduler.hasData())
+    BOOST_CHECK(!scheduler.next(channelNumber))
+
+    BOOST_EQUAL(bulk->mTotalBuffersQueued, 2)
+    BOOST_EQUAL(bulk->mTotalBuffersSent, 2)
+    BOOST_EQUAL(bulk->mTotalBytesSent, bulkSize * 2)
+    BOOST_EQUAL(bulk->mMaxQueuedBuffers, 2)
+    BOOST_EQUAL(control->mTotalBuffersSent, 2)
+    BOOST_EQUAL(scheduler.totalQueuedBytes(), 0)
+  }
+
+  // scope: byte share between busy channels and discarding
+  {
+    ChannelSendScheduler scheduler(quantum);
+
+    QueuePtr large = scheduler.open(1);
+    QueuePtr small = scheduler.open(2);
+    QueuePtr gone = scheduler.open(3);
+
+    for (ULONG index = 0; index < 64; ++index) {
+      scheduler.enqueue(large, makeBuffer(quantum));
+      for (int loop = 0; loop < 4; ++loop) {
+        scheduler.enqueue(small, makeBuffer(quantum / 4));
+      }
+    }
+    scheduler.enqueue(gone, makeBuffer(quantum));
+    scheduler.enqueue(gone, makeBuffer(quantum));
+
+    scheduler.discard(gone);
+    BOOST_EQUAL(gone->mTotalBuffersDiscarded, 2)
+    BOOST_EQUAL(scheduler.totalQueuedBytes(), 64 * quantum * 2)
+
+    // after the first half of the data both channels got the same bytes
+    for (ULONG index = 0; index < 64 * 5 / 2; ++index) {
+      ULONG channelNumber = 0;
+      scheduler.next(channelNumber);
+      BOOST_CHECK(3 != channelNumber)
+    }
+
+    size_t difference = (large->mTotalBytesSent > small->mTotalBytesSent ? large->mTotalBytesSent - small->mTotalBytesSent : small->mTotalBytesSent - large->mTotalBytesSent);
+    BOOST_CHECK(difference <= quantum)
+  }
+
+  // scope: small message latency behind a bulk transfer
+  {
+    ChannelSendScheduler scheduler(quantum);
+
+    QueuePtr bulk = scheduler.open(1);
+    QueuePtr chat = scheduler.open(2);
+
+    WireList fifo;
+    for (ULONG index = 0; index < bulkBuffers; ++index) {
+      SecureByteBlockPtr buffer = makeBuffer(bulkSize);
+      scheduler.enqueue(bulk, buffer);
+      fifo.push_back(std::make_pair(ULONG(1), buffer));
+    }
+
+    SecureByteBlockPtr message = makeBuffer(200);
+    scheduler.enqueue(chat, message);
+    fifo.push_back(std::make_pair(ULONG(2), message));
+
+    WireList scheduled;
+    while (scheduler.hasData()) {
+      ULONG channelNumber = 0;
+      SecureByteBlockPtr buffer = scheduler.next(channelNumber);
+      scheduled.push_back(std::make_pair(channelNumber, buffer));
+    }
+
+    BOOST_EQUAL(scheduled.size(), fifo.size())
+    BOOST_EQUAL(bulk->mTotalBytesSent, bulkSize * bulkBuffers)
+
+    size_t fifoAhead = bytesAheadOf(fifo, 2);
+    size_t scheduledAhead = bytesAheadOf(scheduled, 2);
+
+    BOOST_CHECK(scheduledAhead <= bulkSize)
+
+    if (OPENPEER_STACK_TEST_DO_BENCHMARKS) std::cout << "BENCHMARK:    bytes ahead of a small message behind a bulk channel: deficit round robin=" << scheduledAhead << ", FIFO (baseline)=" << fifoAhead << " (" << bulkBuffers << " bulk buffers)\n";
+  }
+}
@@ -0,0 +1,220 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/internal/stack_ChannelTable.h>
+
+#include <zsLib/helpers.h>
+
+#include "config.h"
+#include "helpers.h"
+#include "boost_replacement.h"
+
+#include <map>
+#include <vector>
+
+using zsLib::ULONG;
+using zsLib::Time;
+using zsLib::Duration;
+using openpeer::stack::internal::ChannelTable;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      typedef boost::shared_ptr<ULONG> ValuePtr;
+      typedef ChannelTable<ValuePtr> Channels;
+      typedef Channels::Handle ChannelHandle;
+      typedef std::vector<ULONG> ChannelNumberVector;
+
+      //-----------------------------------------------------------------------
+      static void fillChannelNumbers(
+                                     ChannelNumberVector &outNumbers,
+                                     ULONG total
+                                     )
+      {
+        outNumbers.reserve(total);
+        for (ULONG index = 0; index < total; ++index) {
+          // sparse like numbers handed out by a finder across many sessions
+          outNumbers.push_back(scatterIndex(index, 0x7FFFFFFF) + 1);
+        }
+      }
+    }
+  }
+}
+
+using openpeer::stack::test::ValuePtr;
+using openpeer::stack::test::Channels;
+using openpeer::stack::test::ChannelHandle;
+using openpeer::stack::test::ChannelNumberVector;
+using openpeer::stack::test::fillChannelNumbers;
+using openpeer::stack::test::reportBenchmark;
+
+void doTestChannelTable()
+{
+  if (!OPENPEER_STACK_TEST_DO_CHANNEL_TABLE_TEST) return;
+
+  // scope: slots, generations and state lists
+  {
+    Channels channels;
+
+    ChannelHandle master = channels.insert(0, ValuePtr(new ULONG(0)));
+    ChannelHandle first = channels.insert(1001, ValuePtr(new ULONG(1001)));
+    ChannelHandle second = channels.insert(77, ValuePtr(new ULONG(77)));
+
+    BOOST_EQUAL(channels.size(), 3)
+    BOOST_CHECK(channels.find(1001) == first)
+    BOOST_CHECK(channels.find(5).isEmpty())
+    BOOST_EQUAL(channels.channelNumber(second), 77)
+    BOOST_EQUAL(*(*(channels.get(master))), 0)
+
+    channels.link(first, Channels::List_Pending);
+    channels.link(second, Channels::List_Pending);
+    channels.link(second, Channels::List_Pending);
+    BOOST_EQUAL(channels.size(Channels::List_Pending), 2)
+    BOOST_CHECK(channels.front(Channels::List_Pending) == first)
+
+    channels.link(first, Channels::List_Remove);
+    BOOST_CHECK(channels.isLinked(first, Channels::List_Pending))
+    BOOST_CHECK(channels.isLinked(first, Channels::List_Remove))
+
+    // erasing a slot drops it from every list it was on
+    BOOST_CHECK(channels.erase(first))
+    BOOST_EQUAL(channels.size(Channels::List_Pending), 1)
+    BOOST_EQUAL(channels.size(Channels::List_Remove), 0)
+    BOOST_CHECK(channels.front(Channels::List_Pending) == second)
+    BOOST_CHECK(!channels.get(first))
+
+    // the reused slot does not answer to the old handle
+    ChannelHandle reused = channels.insert(1001, ValuePtr(new ULONG(2)));
+    BOOST_EQUAL(reused.mIndex, first.mIndex)
+    BOOST_CHECK(reused != first)
+    BOOST_CHECK(!channels.link(first, Channels::List_Remove))
+    BOOST_CHECK(!channels.erase(first))
+    BOOST_EQUAL(*(*(channels.get(1001))), 2)
+
+    ULONG visited = 0;
+    for (ChannelHandle handle = channels.first(); !handle.isEmpty(); handle = channels.next(handle)) {
+      ++visited;
+    }
+    BOOST_EQUAL(visited, 3)
+
+    // a list walks in link order and only visits its own members
+    channels.link(reused, Channels::List_Mapping);
+    channels.link(master, Channels::List_Mapping);
+
+    visited = 0;
+    for (ChannelHandle handle = channels.front(Channels::List_Mapping); !handle.isEmpty(); handle = channels.next(handle, Channels::List_Mapping)) {
+      BOOST_CHECK(handle == (0 == visited ? reused : master))
+      ++visited;
+    }
+    BOOST_EQUAL(visited, 2)
+    BOOST_CHECK(channels.next(second, Channels::List_Mapping).isEmpty())
+
+    channels.clear();
+    BOOST_EQUAL(channels.size(), 0)
+    BOOST_EQUAL(channels.size(Channels::List_Pending), 0)
+    BOOST_CHECK(!channels.get(reused))
+  }
+
+  const ULONG totalChannels = OPENPEER_STACK_TEST_CHANNEL_TABLE_CHANNELS;
+  const ULONG totalPackets = OPENPEER_STACK_TEST_CHANNEL_TABLE_PACKETS;
+  const ULONG burst = 4;
+
+  ChannelNumberVector numbers;
+  fillChannelNumbers(numbers, totalChannels);
+
+  // scope: relay receive path (lookup per packet, bursts per channel)
+  {
+    Channels channels;
+    for (ULONG index = 0; index < totalChannels; ++index) {
+      channels.insert(numbers[index], ValuePtr(new ULONG(index)));
+    }
+    BOOST_EQUAL(channels.size(), totalChannels)
+
+    ULONG delivered = 0;
+    Time start = zsLib::now();
+    for (ULONG packet = 0; packet < totalPackets; ++packet) {
+      ULONG channelNumber = numbers[((packet / burst) * 7) % totalChannels];
+      ValuePtr *found = channels.get(channelNumber);
+      if (!found) continue;
+      ValuePtr channel = *found;
+      if (channel) ++delivered;
+    }
+    reportBenchmark("channel table relay receive", zsLib::now() - start, totalPackets, "packet");
+
+    BOOST_EQUAL(delivered, totalPackets)
+
+    // channels closing and re-opening while traffic continues
+    start = zsLib::now();
+    for (ULONG index = 0; index < totalChannels; ++index) {
+      ChannelHandle handle = channels.find(numbers[index]);
+      channels.link(handle, Channels::List_Remove);
+    }
+    while (channels.size(Channels::List_Remove) > 0) {
+      ChannelHandle handle = channels.front(Channels::List_Remove);
+      ULONG channelNumber = channels.channelNumber(handle);
+      channels.erase(handle);
+      ChannelHandle added = channels.insert(channelNumber | 0x80000000, ValuePtr(new ULONG(channelNumber)));
+      channels.link(added, Channels::List_Incoming);
+    }
+    reportBenchmark("channel table close/re-open", zsLib::now() - start, totalChannels, "channel");
+
+    BOOST_EQUAL(channels.size(), totalChannels)
+    BOOST_EQUAL(channels.size(Channels::List_Incoming), totalChannels)
+    BOOST_EQUAL(channels.capacity(), totalChannels)
+  }
+
+  // scope: baseline (previous std::map per channel state)
+  if (OPENPEER_STACK_TEST_DO_BENCHMARKS) {
+    typedef std::map<ULONG, ValuePtr> ChannelMap;
+
+    ChannelMap channels;
+    for (ULONG index = 0; index < totalChannels; ++index) {
+      channels[numbers[index]] = ValuePtr(new ULONG(index));
+    }
+
+    ULONG delivered = 0;
+    Time start = zsLib::now();
+    for (ULONG packet = 0; packet < totalPackets; ++packet) {
+      ULONG channelNumber = numbers[((packet / burst) * 7) % totalChannels];
+      ChannelMap::iterator found = channels.find(channelNumber);
+      if (found == channels.end()) continue;
+      ValuePtr channel = (*found).second;
+      if (channel) ++delivered;
+    }
+    reportBenchmark("std::map relay receive (baseline)", zsLib::now() - start, totalPackets, "packet");
+
+    BOOST_EQUAL(delivered, totalPackets)
+  }
+}
@@ -0,0 +1,226 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/internal/stack_ChannelWindow.h>
+
+#include "config.h"
+#include "boost_replacement.h"
+
+#include <iostream>
+
+using zsLib::ULONG;
+using zsLib::QWORD;
+using openpeer::stack::internal::ChannelWindow;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      //-----------------------------------------------------------------------
+      // NOTE: both ends of one relay channel; the wire drains instantly and
+      //       window updates only reach the sender if the finder forwards
+      //       them
+      struct WindowedLink
+      {
+        ChannelWindow mSender;
+        ChannelWindow mReceiver;
+
+        bool mFinderForwards;
+
+        size_t mUnread;
+        QWORD mDelivered;
+        ULONG mUpdates;
+        bool mRefused;
+
+        WindowedLink(
+                     size_t window,
+                     size_t maxReceiveBuffered,
+                     bool finderForwards
+                     ) :
+          mSender(window),
+          mReceiver(window, maxReceiveBuffered),
+          mFinderForwards(finderForwards),
+          mUnread(0),
+          mDelivered(0),
+          mUpdates(0),
+          mRefused(false)
+        {
+          advertise();
+        }
+
+        //---------------------------------------------------------------------
+        void advertise()
+        {
+          QWORD window = 0;
+          if (!mReceiver.needsWindowUpdate(mUnread, window)) return;
+
+          ++mUpdates;
+          if (mFinderForwards) mSender.notifyWindow(window);
+        }
+
+        //---------------------------------------------------------------------
+        // sends as long as the sender has credit (or up to a limit)
+        size_t pump(
+                    size_t chunk,
+                    size_t limit
+                    )
+        {
+          size_t sent = 0;
+          while ((sent < limit) &&
+                 (mSender.hasSendCredit(0))) {
+            mSender.notifySent(chunk);
+            sent += chunk;
+
+            if (!mReceiver.notifyReceived(chunk, mUnread)) {
+              mRefused = true;
+              break;
+            }
+            mUnread += chunk;
+          }
+          return sent;
+        }
+
+        //---------------------------------------------------------------------
+        void consume(size_t bytes)
+        {
+          if (bytes > mUnread) bytes = mUnread;
+          mUnread -= bytes;
+          mDelivered += bytes;
+          advertise();
+        }
+      };
+    }
+  }
+}
+
+using openpeer::stack::test::WindowedLink;
+
+void doTestChannelWindow()
+{
+  if (!OPENPEER_STACK_TEST_DO_CHANNEL_WINDOW_TEST) return;
+
+  const size_t window = OPENPEER_STACK_TEST_CHANNEL_WINDOW_SIZE;
+  const size_t chunk = 4*1024;
+  const size_t unlimited = window * 1024;
+
+  // scope: the sender stalls on an exhausted window and resumes on credit
+  {
+    WindowedLink link(window, window * 4, true);
+
+    BOOST_EQUAL(link.mUpdates, 1)
+    BOOST_CHECK(link.mSender.isSendLimitKnown())
+    BOOST_EQUAL(link.mSender.sendLimit(), window)
+
+    BOOST_EQUAL(link.pump(chunk, unlimited), window)
+    BOOST_CHECK(!link.mSender.hasSendCredit(0))
+    BOOST_EQUAL(link.mUnread, window)
+
+    // less than half a window consumed is not worth an update
+    link.consume(window / 4);
+    BOOST_EQUAL(link.mUpdates, 1)
+    BOOST_EQUAL(link.pump(chunk, unlimited), 0)
+
+    link.consume(window / 4);
+    BOOST_EQUAL(link.mUpdates, 2)
+    BOOST_EQUAL(link.mSender.sendLimit(), window + (window / 2))
+    BOOST_CHECK(link.mSender.hasSendCredit(0))
+
+    BOOST_EQUAL(link.pump(chunk, unlimited), window / 2)
+    BOOST_CHECK(!link.mSender.hasSendCredit(0))
+
+    // an update that crossed a newer one on the wire is ignored
+    BOOST_CHECK(!link.mSender.notifyWindow(window))
+    BOOST_CHECK(!link.mSender.hasSendCredit(0))
+
+    // a slow reader paces the sender without ever buffering beyond a window
+    size_t maxUnread = 0;
+    for (ULONG round = 0; round < 1000; ++round) {
+      link.pump(chunk, unlimited);
+      if (link.mUnread > maxUnread) maxUnread = link.mUnread;
+      link.consume(chunk * (1 + (round % 5)));
+    }
+
+    BOOST_CHECK(!link.mRefused)
+    BOOST_CHECK(maxUnread <= window)
+    BOOST_CHECK(link.mDelivered > window * 10)
+    BOOST_CHECK(!link.mReceiver.isBeyondAdvertisedWindow())
+  }
+
+  // scope: a sender that was never given a window is held by its queue only
+  {
+    ChannelWindow sender(window);
+
+    BOOST_CHECK(!sender.isSendLimitKnown())
+    BOOST_CHECK(sender.hasSendCredit(0))
+    BOOST_CHECK(sender.hasSendCredit(window - 1))
+    BOOST_CHECK(!sender.hasSendCredit(window))
+
+    sender.notifySent(unlimited);
+    BOOST_CHECK(sender.hasSendCredit(0))
+
+    // no window at all means no flow control
+    ChannelWindow disabled(0);
+    BOOST_CHECK(disabled.hasSendCredit(unlimited))
+  }
+
+  // scope: the receiver bounds its buffering when updates are not forwarded
+  {
+    WindowedLink link(window, window * 4, false);
+
+    BOOST_CHECK(!link.mSender.isSendLimitKnown())
+
+    link.pump(chunk, unlimited);
+
+    BOOST_CHECK(link.mRefused)
+    BOOST_EQUAL(link.mUnread, window * 4)
+    BOOST_EQUAL(link.mReceiver.receivedBytes(), window * 4)
+    BOOST_CHECK(link.mReceiver.isBeyondAdvertisedWindow())
+
+    // draining makes room again
+    link.consume(window);
+    BOOST_CHECK(link.mReceiver.notifyReceived(chunk, link.mUnread))
+  }
+
+  // scope: the bound is never tighter than the window and zero is unbounded
+  {
+    ChannelWindow tight(window, window / 2);
+    BOOST_EQUAL(tight.maxReceiveBuffered(), window)
+    BOOST_CHECK(tight.notifyReceived(window, 0))
+    BOOST_CHECK(!tight.notifyReceived(1, window))
+
+    ChannelWindow unbounded(window, 0);
+    BOOST_CHECK(unbounded.notifyReceived(unlimited, unlimited))
+  }
+}
@@ -0,0 +1,211 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+
+#include <openpeer/stack/message/Message.h>
+#include <openpeer/stack/message/MessageBinary.h>
+#include <openpeer/stack/message/MessageEnvelope.h>
+#include <openpeer/stack/message/internal/stack_message_MessageFactoryManager.h>
+#include <openpeer/stack/message/peer-finder/MessageFactoryPeerFinder.h>
+
+#include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/helpers.h>
+
+#include "config.h"
+#include "boost_replacement.h"
+
+#include <list>
+#include <iostream>
+
+using zsLib::ULONG;
+using zsLib::string;
+using zsLib::String;
+using zsLib::XML::Document;
+using zsLib::XML::DocumentPtr;
+using zsLib::XML::ElementPtr;
+using openpeer::SecureByteBlockPtr;
+using openpeer::services::IHelper;
+using openpeer::services::ISettings;
+using openpeer::stack::message::Message;
+using openpeer::stack::message::MessagePtr;
+using openpeer::stack::message::MessageBinary;
+using openpeer::stack::message::MessageEnvelope;
+using openpeer::stack::message::internal::MessageFactoryManager;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      typedef std::list<SecureByteBlockPtr> FrameList;
+      typedef std::list<MessagePtr> MessageList;
+      typedef MessageFactoryManager::CreationElementStatistics CreationElementStatistics;
+
+      //-----------------------------------------------------------------------
+      static void getFinderTraffic(FrameList &outFrames)
+      {
+        const char *keepAlive =
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"6b6a2a3e8c\",\"$handler\":\"peer-finder\",\"$method\":\"session-keep-alive\",\"$timestamp\":1386000000,"
+          "\"expires\":1386003600}}";
+
+        const char *channelMapNotify =
+          "{\"notify\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"0c1c9a2fd8\",\"$handler\":\"peer-finder\",\"$method\":\"channel-map\",\"$timestamp\":1386000000,"
+          "\"channel\":42,\"nonce\":\"e4c8f61bd5a0\","
+          "\"relay\":{\"localContext\":\"4a5bce07\",\"remoteContext\":\"92ff01c3\",\"accessToken\":\"b8a1d4c6e2f0\",\"accessSecretProof\":\"7d1e5a9c3b0f2e8d\",\"accessSecretProofExpires\":1386003600}}}";
+
+        const char *channelMapResult =
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"0c1c9a2fd9\",\"$handler\":\"peer-finder\",\"$method\":\"channel-map\",\"$timestamp\":1386000000}}";
+
+        outFrames.push_back(IHelper::convertToBuffer(keepAlive));
+        outFrames.push_back(IHelper::convertToBuffer(channelMapNotify));
+        outFrames.push_back(IHelper::convertToBuffer(channelMapResult));
+
+        // the same notify as a binary frame
+        DocumentPtr doc = Document::createFromParsedJSON(channelMapNotify);
+        outFrames.push_back(MessageBinary::encode(doc));
+      }
+
+      //-----------------------------------------------------------------------
+      // NOTE: measured on the decode path itself (the factory manager's
+      //       creation element statistics), so nothing global is hooked
+      static CreationElementStatistics measureRetained(
+                                                       const char *mode,
+                                                       const FrameList &frames,
+                                                       ULONG iterations
+                                                       )
+      {
+        ISettings::setString(OPENPEER_STACK_SETTING_MESSAGE_CREATION_ELEMENT_MODE, mode);
+
+        MessageFactoryManager::getCreationElementTotals(true);
+
+        // parse and hold the messages like a receive queue would
+        MessageList messages;
+        for (ULONG loop = 0; loop < iterations; ++loop) {
+          for (FrameList::const_iterator iter = frames.begin(); iter != frames.end(); ++iter) {
+            MessageEnvelope envelope;
+            if (!MessageEnvelope::scan(*iter, envelope)) continue;
+
+            MessagePtr message = envelope.decode(IMessageSourcePtr());
+            if (message) messages.push_back(message);
+          }
+        }
+
+        return MessageFactoryManager::getCreationElementTotals(true);
+      }
+
+      //-----------------------------------------------------------------------
+      static void reportRetained(
+                                 const char *what,
+                                 const CreationElementStatistics &stats
+                                 )
+      {
+        if (!OPENPEER_STACK_TEST_DO_BENCHMARKS) return;
+        std::cout << "BENCHMARK:    " << what
+                  << " before=" << (stats.mTotal > 0 ? stats.mEstimatedBytesBefore / stats.mTotal : 0)
+                  << " after=" << (stats.mTotal > 0 ? stats.mEstimatedBytesAfter / stats.mTotal : 0)
+                  << " (estimated bytes retained per message)\n";
+      }
+    }
+  }
+}
+
+using openpeer::stack::test::FrameList;
+using openpeer::stack::test::CreationElementStatistics;
+using openpeer::stack::test::getFinderTraffic;
+using openpeer::stack::test::measureRetained;
+using openpeer::stack::test::reportRetained;
+
+void doTestMessageArena()
+{
+  if (!OPENPEER_STACK_TEST_DO_MESSAGE_ARENA_TEST) return;
+
+  openpeer::stack::message::peer_finder::MessageFactoryPeerFinder::singleton();
+
+  FrameList frames;
+  getFinderTraffic(frames);
+  BOOST_EQUAL(frames.size(), 4)
+
+  // every frame still decodes to a typed message whose creation element can
+  // be rebuilt from the frame it kept
+  ISettings::setString(OPENPEER_STACK_SETTING_MESSAGE_CREATION_ELEMENT_MODE, "arena");
+
+  ULONG mismatches = 0;
+  for (FrameList::iterator iter = frames.begin(); iter != frames.end(); ++iter) {
+    MessageEnvelope envelope;
+    BOOST_CHECK(MessageEnvelope::scan(*iter, envelope))
+
+    MessagePtr message = envelope.decode(openpeer::stack::IMessageSourcePtr());
+    BOOST_CHECK(message)
+    if (!message) continue;
+
+    BOOST_CHECK(message->creationBuffer() == (*iter))
+    BOOST_EQUAL(message->creationRawSize(), (*iter)->SizeInBytes())
+
+    ElementPtr rootEl = message->creationElement();
+    BOOST_CHECK(rootEl)
+    if (!rootEl) continue;
+
+    if (message->messageID() != rootEl->getAttributeValue("id")) ++mismatches;
+    if (String("peer-finder") != rootEl->getAttributeValue("handler")) ++mismatches;
+
+    // a kept JSON frame is handed back as is (e.g. to the cache)
+    if (!MessageBinary::isBinary((*iter)->BytePtr(), (*iter)->SizeInBytes())) {
+      if (message->creationJSON() != String((const char *)((*iter)->BytePtr()))) ++mismatches;
+    }
+  }
+  BOOST_EQUAL(mismatches, 0)
+
+  const ULONG iterations = OPENPEER_STACK_TEST_MESSAGE_ARENA_ITERATIONS;
+  const ULONG total = iterations * static_cast<ULONG>(frames.size());
+
+  CreationElementStatistics keep = measureRetained("keep", frames, iterations);
+  BOOST_EQUAL(keep.mTotal, 0)   // keep never touches (or counts) the tree
+
+  CreationElementStatistics compact = measureRetained("compact", frames, iterations);
+  reportRetained("finder traffic compact", compact);
+
+  CreationElementStatistics arena = measureRetained("arena", frames, iterations);
+  reportRetained("finder traffic arena", arena);
+
+  BOOST_EQUAL(compact.mTotal, total)
+  BOOST_EQUAL(arena.mTotal, total)
+
+  BOOST_CHECK(compact.mEstimatedBytesAfter < compact.mEstimatedBytesBefore)
+  BOOST_CHECK(arena.mEstimatedBytesAfter < arena.mEstimatedBytesBefore)
+
+  ISettings::setString(OPENPEER_STACK_SETTING_MESSAGE_CREATION_ELEMENT_MODE, "keep");
+}
@@ -0,0 +1,139 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/message/MessageBatch.h>
+#include <openpeer/stack/message/MessageCompression.h>
+
+#include <openpeer/services/ISettings.h>
+
+#include <zsLib/helpers.h>
+
+#include "config.h"
+#include "boost_replacement.h"
+
+#include <cstring>
+#include <iostream>
+
+using zsLib::ULONG;
+using zsLib::BYTE;
+using zsLib::String;
+using zsLib::string;
+using openpeer::SecureByteBlockPtr;
+using openpeer::services::ISettings;
+using openpeer::stack::message::MessageBatch;
+using openpeer::stack::message::MessageCompression;
+
+void doTestMessageBatch()
+{
+  if (!OPENPEER_STACK_TEST_DO_MESSAGE_BATCH_TEST) return;
+
+  ISettings::setUInt(OPENPEER_STACK_SETTING_MESSAGE_BATCHING_MAX_SIZE_IN_BYTES, OPENPEER_STACK_TEST_MESSAGE_BATCH_MAX_SIZE);
+
+  MessageBatch batch;
+
+  // a single frame goes out untouched
+  {
+    const char *frame = "{\"request\":{\"$id\":\"1\"}}";
+    batch.append((const BYTE *)frame, strlen(frame));
+    BOOST_EQUAL(batch.getTotalFrames(), 1)
+
+    SecureByteBlockPtr output = batch.take();
+    BOOST_CHECK(output)
+    BOOST_CHECK(batch.isEmpty())
+    if (output) {
+      BOOST_EQUAL(output->SizeInBytes(), strlen(frame))
+      BOOST_CHECK(!MessageBatch::isBatch(output->BytePtr(), output->SizeInBytes()))
+    }
+  }
+
+  // several frames come back out in the order they went in
+  {
+    const ULONG total = 50;
+    for (ULONG loop = 0; loop < total; ++loop) {
+      String frame = "{\"notify\":{\"$id\":\"" + string(loop) + "\"}}";
+      batch.append((const BYTE *)frame.c_str(), frame.length());
+    }
+    BOOST_EQUAL(batch.getTotalFrames(), total)
+    BOOST_CHECK(!batch.isFull())
+
+    SecureByteBlockPtr output = batch.take();
+    BOOST_CHECK(output)
+    if (output) {
+      BOOST_CHECK(MessageBatch::isBatch(output->BytePtr(), output->SizeInBytes()))
+
+      MessageBatch::FrameList frames;
+      BOOST_CHECK(MessageBatch::unpack(output, frames))
+      BOOST_EQUAL(frames.size(), total)
+
+      ULONG outOfOrder = 0;
+      ULONG index = 0;
+      for (MessageBatch::FrameList::iterator iter = frames.begin(); iter != frames.end(); ++iter, ++index) {
+        String expecting = "{\"notify\":{\"$id\":\"" + string(index) + "\"}}";
+        if (expecting != String((const char *)((*iter)->BytePtr()))) ++outOfOrder;
+      }
+      BOOST_EQUAL(outOfOrder, 0)
+
+      // the same batch compressed as a whole unpacks identically
+      ISettings::setUInt(OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES, 0);
+      SecureByteBlockPtr compressed = MessageCompression::compress(output->BytePtr(), output->SizeInBytes());
+      BOOST_CHECK(compressed)
+      if (compressed) {
+        MessageBatch::FrameList inflatedFrames;
+        BOOST_CHECK(MessageBatch::unpack(compressed, inflatedFrames))
+        BOOST_EQUAL(inflatedFrames.size(), total)
+        if (inflatedFrames.size() > 0) {
+          BOOST_EQUAL(String((const char *)(inflatedFrames.back()->BytePtr())), "{\"notify\":{\"$id\":\"" + string(total - 1) + "\"}}")
+        }
+      }
+
+      // a truncated batch is rejected as a whole
+      BYTE *truncated = output->BytePtr();
+      MessageBatch::FrameList partial;
+      SecureByteBlockPtr cut(new openpeer::SecureByteBlock(truncated, output->SizeInBytes() - 3));
+      BOOST_CHECK(!MessageBatch::unpack(cut, partial))
+      BOOST_EQUAL(partial.size(), 0)
+    }
+  }
+
+  // the byte budget bounds a batch
+  {
+    String frame(OPENPEER_STACK_TEST_MESSAGE_BATCH_MAX_SIZE / 4, 'x');
+    ULONG appended = 0;
+    while (!batch.isFull()) {
+      batch.append((const BYTE *)frame.c_str(), frame.length());
+      ++appended;
+    }
+    BOOST_EQUAL(appended, 4)
+    batch.take();
+  }
+}
@@ -0,0 +1,828 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/message/IMessageFactory.h>
+#include <openpeer/stack/message/IMessageHelper.h>
+#include <openpeer/stack/message/MessageBinary.h>
+#include <openpeer/stack/message/MessageEnvelope.h>
+#include <openpeer/stack/message/peer-finder/ChannelMapRequest.h>
+#include <openpeer/stack/message/peer-finder/ChannelWindowNotify.h>
+#include <openpeer/stack/message/peer-finder/SessionKeepAliveRequest.h>
+#include <openpeer/stack/message/peer-to-peer/PeerKeepAliveRequest.h>
+#include <openpeer/stack/message/peer-to-peer/PeerKeepAliveResult.h>
+
+#include <openpeer/stack/message/bootstrapped-finder/MessageFactoryBootstrappedFinder.h>
+#include <openpeer/stack/message/bootstrapper/MessageFactoryBootstrapper.h>
+#include <openpeer/stack/message/certificates/MessageFactoryCertificates.h>
+#include <openpeer/stack/message/identity/MessageFactoryIdentity.h>
+#include <openpeer/stack/message/identity-lookup/MessageFactoryIdentityLookup.h>
+#include <openpeer/stack/message/identity-lockbox/MessageFactoryIdentityLockbox.h>
+#include <openpeer/stack/message/namespace-grant/MessageFactoryNamespaceGrant.h>
+#include <openpeer/stack/message/rolodex/MessageFactoryRolodex.h>
+#include <openpeer/stack/message/peer/MessageFactoryPeer.h>
+#include <openpeer/stack/message/peer-common/MessageFactoryPeerCommon.h>
+#include <openpeer/stack/message/peer-finder/MessageFactoryPeerFinder.h>
+#include <openpeer/stack/message/peer-salt/MessageFactoryPeerSalt.h>
+#include <openpeer/stack/message/peer-to-peer/MessageFactoryPeerToPeer.h>
+
+#include <openpeer/services/IHelper.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/helpers.h>
+
+#include "config.h"
+#include "boost_replacement.h"
+
+#include <list>
+#include <set>
+#include <iostream>
+#include <string.h>
+
+using zsLib::ULONG;
+using zsLib::QWORD;
+using zsLib::string;
+using zsLib::String;
+using zsLib::XML::Document;
+using zsLib::XML::DocumentPtr;
+using zsLib::XML::Element;
+using zsLib::XML::ElementPtr;
+using zsLib::XML::Text;
+using zsLib::XML::TextPtr;
+using openpeer::SecureByteBlock;
+using openpeer::SecureByteBlockPtr;
+using openpeer::services::IHelper;
+using openpeer::stack::IMessageSourcePtr;
+using openpeer::stack::message::Message;
+using openpeer::stack::message::MessagePtr;
+using openpeer::stack::message::IMessageFactoryPtr;
+using openpeer::stack::message::IMessageHelper;
+using openpeer::stack::message::MessageBinary;
+using openpeer::stack::message::MessageEnvelope;
+using openpeer::stack::message::peer_finder::ChannelMapRequest;
+using openpeer::stack::message::peer_finder::ChannelMapRequestPtr;
+using openpeer::stack::message::peer_finder::ChannelWindowNotify;
+using openpeer::stack::message::peer_finder::ChannelWindowNotifyPtr;
+using openpeer::stack::message::peer_finder::SessionKeepAliveRequest;
+using openpeer::stack::message::peer_finder::SessionKeepAliveRequestPtr;
+using openpeer::stack::message::peer_to_peer::PeerKeepAliveRequest;
+using openpeer::stack::message::peer_to_peer::PeerKeepAliveRequestPtr;
+using openpeer::stack::message::peer_to_peer::PeerKeepAliveResult;
+using openpeer::stack::message::peer_to_peer::PeerKeepAliveResultPtr;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      typedef std::list<IMessageFactoryPtr> BinaryFactoryList;
+
+      //-----------------------------------------------------------------------
+      static void getBinaryFactories(BinaryFactoryList &outFactories)
+      {
+        outFactories.push_back(message::bootstrapped_finder::MessageFactoryBootstrappedFinder::singleton());
+        outFactories.push_back(message::bootstrapper::MessageFactoryBootstrapper::singleton());
+        outFactories.push_back(message::certificates::MessageFactoryCertificates::singleton());
+        outFactories.push_back(message::identity::MessageFactoryIdentity::singleton());
+        outFactories.push_back(message::identity_lookup::MessageFactoryIdentityLookup::singleton());
+        outFactories.push_back(message::identity_lockbox::MessageFactoryIdentityLockbox::singleton());
+        outFactories.push_back(message::namespace_grant::MessageFactoryNamespaceGrant::singleton());
+        outFactories.push_back(message::rolodex::MessageFactoryRolodex::singleton());
+        outFactories.push_back(message::peer::MessageFactoryPeer::singleton());
+        outFactories.push_back(message::peer_common::MessageFactoryPeerCommon::singleton());
+        outFactories.push_back(message::peer_finder::MessageFactoryPeerFinder::singleton());
+        outFactories.push_back(message::peer_salt::MessageFactoryPeerSalt::singleton());
+        outFactories.push_back(message::peer_to_peer::MessageFactoryPeerToPeer::singleton());
+      }
+
+      //-----------------------------------------------------------------------
+      struct BinaryFrame
+      {
+        const char *mJSON;
+        bool mNeedsAccount;   // decoding verifies against the receiving account's peer files
+      };
+
+      // one recorded frame for every (type, handler, method) the factories
+      // decode, shaped the way the services send them
+      static const BinaryFrame gBinaryFrames[] =
+      {
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a1\","
+          "\"$handler\":\"bootstrapped-finders\",\"$method\":\"finders-get\",\"$timestamp\":1386003600,"
+          "\"finders\":{\"finderBundle\":[{\"finder\":{\"$id\":\"4bf7fff50ef9bb07428af6294ae41434da175538\","
+          "\"protocols\":{\"protocol\":[{\"transport\":\"multiplexed-json-tcp\",\"host\":\"finder1.example.com:4032\"},"
+          "{\"transport\":\"multiplexed-json-tcp\",\"host\":\"198.51.100.7:4032\"}]},\"region\":\"1\","
+          "\"created\":1386000000,\"expires\":1388592000}},"
+          "{\"finder\":{\"$id\":\"a7f0c5df6d6a1b7d1f6b3f1a3b9c7e2d4f5a6b7c\","
+          "\"protocols\":{\"protocol\":{\"transport\":\"multiplexed-json-tcp\",\"host\":\"finder2.example.com:4032\"}},"
+          "\"region\":\"2\",\"created\":1386000000,\"expires\":1388592000}}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$id\":\"a2\",\"$handler\":\"bootstrapper\","
+          "\"$method\":\"services-get\",\"services\":{\"service\":[{\"$id\":\"9bdf9c1e23e9b7f1\","
+          "\"type\":\"bootstrapped-finders\",\"version\":\"1.0\",\"methods\":{\"method\":{\"name\":\"finders-get\","
+          "\"uri\":\"https://finders.example.com/finders-get\"}}},{\"$id\":\"c2b0e7ff3a1d4e55\","
+          "\"type\":\"identity-lockbox\",\"version\":\"1.0\",\"methods\":{\"method\":[{\"name\":\"lockbox-access\","
+          "\"uri\":\"https://lockbox.example.com/lockbox-access\"},{\"name\":\"lockbox-content-get\","
+          "\"uri\":\"https://lockbox.example.com/lockbox-content-get\"}]}},{\"$id\":\"77e1\",\"type\":\"turn\","
+          "\"version\":\"RFC5766\",\"methods\":{\"method\":{\"name\":\"turn\",\"host\":\"turn.example.com:3478\","
+          "\"username\":\"user\",\"password\":\"p4ss\\\\word\"}}}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a3\","
+          "\"$handler\":\"certificates\",\"$method\":\"certificates-get\",\"$timestamp\":1386003600,"
+          "\"certificates\":{\"certificateBundle\":[{\"certificate\":{\"$id\":\"4bf7fff50ef9bb07\","
+          "\"service\":\"bootstrapper\",\"expires\":1388592000}},{\"certificate\":{\"$id\":\"a3c1\","
+          "\"service\":\"identity\",\"expires\":1388592000}}]}}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a4\",\"$handler\":\"identity\","
+          "\"$method\":\"identity-access-window\",\"$timestamp\":1386003600,\"browser\":{\"ready\":\"true\","
+          "\"visibility\":\"false\"}}}",
+          false
+        },
+        {
+          "{\"notify\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a5\",\"$handler\":\"identity\","
+          "\"$method\":\"identity-access-complete\",\"$timestamp\":1386003600,"
+          "\"identity\":{\"accessToken\":\"a913c2c3314ce71aee554986204a349b\","
+          "\"accessSecret\":\"b7277a5e49b3f5ffa9a8cb1feb86125f75511988\",\"accessSecretExpires\":1386007200,"
+          "\"uri\":\"identity://example.com/zoe\",\"provider\":\"example.com\","
+          "\"reloginKey\":\"d2922f33a804c5f164a55210fe193327de7b2449-5007999b7734560b2c23fe81171af3e3-4c216c23\"},"
+          "\"lockbox\":{\"domain\":\"lockbox.example.com\",\"key\":\"V1:Y2ZkMWRiMDk5MDZjNTZlOTQ5N2E0NDkzYjhkMjE3\","
+          "\"reset\":\"false\"}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a6\",\"$handler\":\"identity\","
+          "\"$method\":\"identity-access-lockbox-update\",\"$timestamp\":1386003600}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a7\",\"$handler\":\"identity\","
+          "\"$method\":\"identity-access-rolodex-credentials-get\",\"$timestamp\":1386003600,"
+          "\"rolodex\":{\"serverToken\":\"b3ff46bae8cacd1e572ee5e158bcb04ed9297f20-9619e3bc-4cd41c9c64ab2ed2a03b45ace82c546d\"}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a8\",\"$handler\":\"identity\","
+          "\"$method\":\"identity-lookup-update\",\"$timestamp\":1386003600,\"error\":{\"$id\":403,"
+          "\"#text\":\"Forbidden\"}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a9\","
+          "\"$handler\":\"identity-lookup\",\"$method\":\"identity-lookup-check\",\"$timestamp\":1386003600,"
+          "\"identities\":{\"identity\":[{\"uri\":\"identity://example.com/alice\",\"updated\":1386000000},"
+          "{\"uri\":\"identity://example.com/bob\",\"updated\":1386000500}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a10\","
+          "\"$handler\":\"identity-lookup\",\"$method\":\"identity-lookup\",\"$timestamp\":1386003600,"
+          "\"identities\":{\"identity\":[{\"$disposition\":\"update\",\"uri\":\"identity://example.com/zoe\","
+          "\"provider\":\"example.com\",\"stableID\":\"0acc990c7b6e7d5cb9a3183d432e37776fb182bf\",\"priority\":5,"
+          "\"weight\":1,\"updated\":1386000000,\"expires\":1388592000,\"name\":\"Zo\xC3""\xAB"" \\\"Z\\\" O'Neil\","
+          "\"profile\":\"http://example.com/profile/zoe\",\"avatars\":{\"avatar\":[{\"name\":\"small\","
+          "\"url\":\"http://example.com/a/s.png\",\"width\":32,\"height\":32},{\"name\":\"large\","
+          "\"url\":\"http://example.com/a/l.png\",\"width\":128,\"height\":128}]}},{\"$disposition\":\"remove\","
+          "\"uri\":\"identity://example.com/ann\",\"provider\":\"example.com\","
+          "\"stableID\":\"0acc990c7b6e7d5cb9a3183d432e37776fb182bf\",\"priority\":5,\"weight\":1,"
+          "\"updated\":1386000000,\"expires\":1388592000,\"name\":\"Zo\xC3""\xAB"" \\\"Z\\\" O'Neil\","
+          "\"profile\":\"http://example.com/profile/zoe\",\"avatars\":{\"avatar\":[{\"name\":\"small\","
+          "\"url\":\"http://example.com/a/s.png\",\"width\":32,\"height\":32},{\"name\":\"large\","
+          "\"url\":\"http://example.com/a/l.png\",\"width\":128,\"height\":128}]}}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a11\","
+          "\"$handler\":\"identity-lockbox\",\"$method\":\"lockbox-access\",\"$timestamp\":1386003600,"
+          "\"lockbox\":{\"accessToken\":\"a913c2c3314ce71aee554986204a349b\","
+          "\"accessSecret\":\"b7277a5e49b3f5ffa9a8cb1feb86125f75511988\",\"accessSecretExpires\":1386007200,"
+          "\"key\":\"V1:Y2ZkMWRiMDk5MDZjNTZlOTQ5N2E0NDkzYjhkMjE3\",\"domain\":\"lockbox.example.com\"},"
+          "\"namespaceGrantChallenge\":{\"$id\":\"20651257fecbe8436cea6bfd3277fec1223ebd63\","
+          "\"name\":\"Provider Lockbox Service\",\"image\":\"https://lockbox.example.com/lockbox.png\","
+          "\"url\":\"https://lockbox.example.com/lockbox.html\",\"domains\":\"trust.example.com,"
+          "trust.example.org\"},\"identities\":{\"identity\":[{\"uri\":\"identity://example.com/zoe\","
+          "\"provider\":\"example.com\"},{\"uri\":\"identity://example.org/zoe\",\"provider\":\"example.org\"}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a12\","
+          "\"$handler\":\"identity-lockbox\",\"$method\":\"lockbox-namespace-grant-challenge-validate\","
+          "\"$timestamp\":1386003600}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a13\","
+          "\"$handler\":\"identity-lockbox\",\"$method\":\"lockbox-identities-update\",\"$timestamp\":1386003600,"
+          "\"identities\":{\"identity\":{\"uri\":\"identity://example.com/zoe\",\"provider\":\"example.com\"}}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a14\","
+          "\"$handler\":\"identity-lockbox\",\"$method\":\"lockbox-content-get\",\"$timestamp\":1386003600,"
+          "\"namespaces\":{\"namespace\":[{\"$id\":\"https://meta.openpeer.org/permission/private-peer-file\","
+          "\"$updated\":1386000000,\"privatePeerFile\":\"Y2ZkMWRiMDk5MDZjNTZlOTQ5N2E0NDkzYjhkMjE3=\","
+          "\"privatePeerFileSecret\":\"ZmM1YjIzOTM4ZmMxOTE5YTc1N2YzY2IwYjEyMg==\"},"
+          "{\"$id\":\"https://meta.openpeer.org/permission/some-other\",\"$updated\":1386000200,"
+          "\"value1\":\"bGluZQpicmVhaw==\"}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a15\","
+          "\"$handler\":\"identity-lockbox\",\"$method\":\"lockbox-content-set\",\"$timestamp\":1386003600}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a16\","
+          "\"$handler\":\"namespace-grant\",\"$method\":\"namespace-grant-window\",\"$timestamp\":1386003600,"
+          "\"browser\":{\"ready\":\"true\",\"visibility\":\"true\"}}}",
+          false
+        },
+        {
+          "{\"notify\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a17\","
+          "\"$handler\":\"namespace-grant\",\"$method\":\"namespace-grant-complete\",\"$timestamp\":1386003600,"
+          "\"namespaceGrantChallengeBundles\":{\"namespaceGrantChallengeBundle\":[{\"namespaceGrantChallenge\":{\"$id\":\"20651257fecbe8436cea6bfd3277fec1223ebd63\","
+          "\"name\":\"Provider Lockbox Service\","
+          "\"namespaces\":{\"namespace\":[{\"$id\":\"https://meta.openpeer.org/permission/everything\"},"
+          "{\"$id\":\"https://meta.openpeer.org/permission/private-peer-file\"}]}},"
+          "\"signature\":{\"reference\":\"#20651257fecbe8436cea6bfd3277fec1223ebd63\","
+          "\"algorithm\":\"https://meta.openpeer.org/2012/12/14/jsonsig#rsa-sha1\","
+          "\"digestValue\":\"IUe324k...oV5/A8Q38Gj45i4jddX=\",\"digestSigned\":\"DE...fGM~C0/Ez=\","
+          "\"key\":{\"$id\":\"8d9a46a9c8ec5c14\",\"domain\":\"example.com\",\"service\":\"namespace-grant\"}}}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a18\",\"$handler\":\"rolodex\","
+          "\"$method\":\"rolodex-access\",\"$timestamp\":1386003600,"
+          "\"rolodex\":{\"accessToken\":\"a913c2c3314ce71aee554986204a349b\","
+          "\"accessSecret\":\"b7277a5e49b3f5ffa9a8cb1feb86125f75511988\",\"accessSecretExpires\":1386007200,"
+          "\"updateNext\":1386000900},"
+          "\"namespaceGrantChallenge\":{\"$id\":\"20651257fecbe8436cea6bfd3277fec1223ebd63\","
+          "\"name\":\"Provider Rolodex Service\",\"image\":\"https://rolodex.example.com/rolodex.png\","
+          "\"url\":\"https://rolodex.example.com/rolodex.html\",\"domains\":\"trust.example.com\"}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a19\",\"$handler\":\"rolodex\","
+          "\"$method\":\"rolodex-namespace-grant-challenge-validate\",\"$timestamp\":1386003600}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a20\",\"$handler\":\"rolodex\","
+          "\"$method\":\"rolodex-contacts-get\",\"$timestamp\":1386003600,\"rolodex\":{\"version\":\"4341443-54343a\","
+          "\"updateNext\":1386000900},\"identities\":{\"identity\":[{\"$disposition\":\"update\","
+          "\"uri\":\"identity://facebook.com/id48483\",\"provider\":\"example.com\","
+          "\"stableID\":\"0acc990c7b6e7d5cb9a3183d432e37776fb182bf\",\"priority\":5,\"weight\":1,"
+          "\"updated\":1386000000,\"expires\":1388592000,\"name\":\"Zo\xC3""\xAB"" \\\"Z\\\" O'Neil\","
+          "\"profile\":\"http://example.com/profile/zoe\",\"avatars\":{\"avatar\":[{\"name\":\"small\","
+          "\"url\":\"http://example.com/a/s.png\",\"width\":32,\"height\":32},{\"name\":\"large\","
+          "\"url\":\"http://example.com/a/l.png\",\"width\":128,\"height\":128}]}},{\"$disposition\":\"remove\","
+          "\"uri\":\"identity://twitter.com/zoe\",\"provider\":\"example.com\","
+          "\"stableID\":\"0acc990c7b6e7d5cb9a3183d432e37776fb182bf\",\"priority\":5,\"weight\":1,"
+          "\"updated\":1386000000,\"expires\":1388592000,\"name\":\"Zo\xC3""\xAB"" \\\"Z\\\" O'Neil\","
+          "\"profile\":\"http://example.com/profile/zoe\",\"avatars\":{\"avatar\":[{\"name\":\"small\","
+          "\"url\":\"http://example.com/a/s.png\",\"width\":32,\"height\":32},{\"name\":\"large\","
+          "\"url\":\"http://example.com/a/l.png\",\"width\":128,\"height\":128}]}}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a21\",\"$handler\":\"peer\","
+          "\"$method\":\"peer-services-get\",\"$timestamp\":1386003600,\"services\":{\"service\":{\"$id\":\"3c1a\","
+          "\"type\":\"turn\",\"version\":\"RFC5766\",\"methods\":{\"method\":{\"name\":\"turn\","
+          "\"host\":\"turn.example.com:3478\",\"username\":\"user\",\"password\":\"secret\"}}}}}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a22\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-publish\",\"$timestamp\":1386003600,"
+          "\"document\":{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"},"
+          "\"publishToRelationships\":{\"relationships\":[{\"$name\":\"/hookflash.com/authorization-list/1.0/whitelist\","
+          "\"$allow\":\"all\"},{\"$name\":\"/hookflash.com/authorization-list/1.0/adhoc-list\",\"$allow\":\"some\","
+          "\"contact\":[\"peer://example.com/5a693b7d\",\"peer://example.com/3e84c2a1\"]}]},"
+          "\"data\":{\"presence\":{\"status\":{\"$id\":\"f4d0\",\"#text\":\"available\"},"
+          "\"note\":\"At the \\\"office\\\"\\\\desk \xE2""\x98""\xBA""\",\"priority\":-2}}}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a23\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-publish\",\"$timestamp\":1386003600,"
+          "\"document\":{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"}}}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a24\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-get\",\"$timestamp\":1386003600,"
+          "\"document\":{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"}}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a25\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-get\",\"$timestamp\":1386003600,"
+          "\"document\":{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"},"
+          "\"publishToRelationships\":{\"relationships\":[{\"$name\":\"/hookflash.com/authorization-list/1.0/whitelist\","
+          "\"$allow\":\"all\"},{\"$name\":\"/hookflash.com/authorization-list/1.0/adhoc-list\",\"$allow\":\"some\","
+          "\"contact\":[\"peer://example.com/5a693b7d\",\"peer://example.com/3e84c2a1\"]}]},"
+          "\"data\":{\"presence\":{\"status\":{\"$id\":\"f4d0\",\"#text\":\"available\"},"
+          "\"note\":\"At the \\\"office\\\"\\\\desk \xE2""\x98""\xBA""\",\"priority\":-2}}}}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a26\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-delete\",\"$timestamp\":1386003600,"
+          "\"document\":{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"}}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a27\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-delete\",\"$timestamp\":1386003600,\"error\":{\"$id\":404,"
+          "\"#text\":\"Not Found\"}}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a28\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-subscribe\",\"$timestamp\":1386003600,"
+          "\"document\":{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"},"
+          "\"subscribeToRelationships\":{\"relationships\":{\"$name\":\"/hookflash.com/authorization-list/1.0/whitelist\","
+          "\"$allow\":\"all\"}}}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a29\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-subscribe\",\"$timestamp\":1386003600,"
+          "\"document\":{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"}}}}",
+          false
+        },
+        {
+          "{\"notify\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a30\","
+          "\"$handler\":\"peer-common\",\"$method\":\"peer-publish-notify\",\"$timestamp\":1386003600,"
+          "\"documents\":{\"document\":[{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"}},"
+          "{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+          "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+          "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+          "\"location\":\"883fa7...9533609131\"}}]}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$id\":\"a31\",\"$handler\":\"peer-finder\",\"$method\":\"channel-map\","
+          "\"$timestamp\":1386003600}}",
+          false
+        },
+        {
+          "{\"notify\":{\"$domain\":\"example.com\",\"$id\":\"a32\",\"$handler\":\"peer-finder\",\"$method\":\"channel-map\","
+          "\"$timestamp\":1386003600,\"channel\":3,\"nonce\":\"b5f1a3b2c8f7d4e6\",\"relay\":{\"localContext\":\"e2b4c6\","
+          "\"remoteContext\":\"d1a3f5\",\"accessToken\":\"a913c2c3314ce71aee554986204a349b\","
+          "\"accessSecretProof\":\"a5cfc4b8d6e7f9a0b1c2d3e4f5a6b7c8d9e0f1a2\","
+          "\"accessSecretProofExpires\":1386007200}}}",
+          false
+        },
+        {
+          "{\"notify\":{\"$domain\":\"example.com\",\"$id\":\"a33\",\"$handler\":\"peer-finder\","
+          "\"$method\":\"channel-window\",\"$timestamp\":1386003600,\"channel\":3,\"window\":1048576}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a34\","
+          "\"$handler\":\"peer-finder\",\"$method\":\"session-keep-alive\",\"$timestamp\":1386003600,"
+          "\"expires\":1386007200}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a35\","
+          "\"$handler\":\"peer-finder\",\"$method\":\"session-create\",\"$timestamp\":1386003600,"
+          "\"server\":\"finder/1.0 (example)\",\"expires\":1386007200,"
+          "\"serverProofBundle\":{\"serverProof\":{\"relay\":{\"accessToken\":\"a913c2c3314ce71aee554986204a349b\","
+          "\"accessSecretEncrypted\":\"ZmM1YjIzOTM4ZmMxOTE5YTc1N2YzY2IwYjEyMg==\"}},"
+          "\"signature\":{\"reference\":\"#server\","
+          "\"algorithm\":\"https://meta.openpeer.org/2012/12/14/jsonsig#rsa-sha1\","
+          "\"digestValue\":\"IUe324k...oV5/A8Q38Gj45i4jddX=\",\"digestSigned\":\"DE...fGM~C0/Ez=\"}},"
+          "\"encoding\":\"binary\",\"compression\":\"deflate\",\"batching\":\"1\"}}",
+          true
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a36\","
+          "\"$handler\":\"peer-finder\",\"$method\":\"session-create\",\"$timestamp\":1386003600,\"error\":{\"$id\":401,"
+          "\"#text\":\"Unauthorized\"}}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a37\","
+          "\"$handler\":\"peer-finder\",\"$method\":\"session-delete\",\"$timestamp\":1386003600,"
+          "\"locations\":{\"location\":[{\"$id\":\"170f5d7f6ad2293bb339e788c8f2ff6c\"},"
+          "{\"$id\":\"4e9d1bb7e4c7a4a7aa0a6a3f35b0b0c3\"}]}}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a38\","
+          "\"$handler\":\"peer-finder\",\"$method\":\"peer-location-find\",\"$timestamp\":1386003600,"
+          "\"findProofBundle\":{\"findProof\":{\"nonce\":\"3b3d6b8e9f1e4c2a\","
+          "\"find\":\"peer://example.com/ea00ede4405c99be9ae45739ebfe57d5\","
+          "\"findSecretProof\":\"85d2f8f2b20e55de0f9642d3f14483567c1971d3\","
+          "\"findSecretProofExpires\":1386007200,\"context\":\"8a8b5f3e\","
+          "\"peerSecretEncrypted\":\"ZmM1YjIzOTM4ZmMxOTE5YTc1N2YzY2IwYjEyMg==\",\"iceUsernameFrag\":\"c1e2\","
+          "\"icePassword\":\"9f1e2d3c4b5a\",\"final\":\"true\",\"location\":{\"$id\":\"5a693b7d\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\"},"
+          "\"exclude\":{\"locations\":{\"location\":[\"5a693b7d\",\"3e84c2a1\"]}}},"
+          "\"signature\":{\"reference\":\"#findProof\","
+          "\"algorithm\":\"https://meta.openpeer.org/2012/12/14/jsonsig#rsa-sha1\","
+          "\"digestValue\":\"IUe324k...oV5/A8Q38Gj45i4jddX=\",\"digestSigned\":\"DE...fGM~C0/Ez=\","
+          "\"key\":{\"uri\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\"}}}}}",
+          true
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a39\","
+          "\"$handler\":\"peer-finder\",\"$method\":\"peer-location-find\",\"$timestamp\":1386003600}}",
+          false
+        },
+        {
+          "{\"notify\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a40\","
+          "\"$handler\":\"peer-finder\",\"$method\":\"peer-location-find\",\"$timestamp\":1386003600,"
+          "\"findProofBundle\":{\"findProof\":{\"requestFindProofBundleDigestValue\":\"IUe324k...oV5/A8Q38Gj45i4jddX=\","
+          "\"context\":\"8a8b5f3e\",\"validated\":\"true\",\"iceUsernameFrag\":\"c1e2\",\"icePassword\":\"9f1e2d3c4b5a\","
+          "\"final\":\"false\",\"location\":{\"$id\":\"3e84c2a1\","
+          "\"contact\":\"peer://example.com/ea00ede4405c99be9ae45739ebfe57d5\"}},"
+          "\"signature\":{\"reference\":\"#findProof\","
+          "\"algorithm\":\"https://meta.openpeer.org/2012/12/14/jsonsig#rsa-sha1\","
+          "\"digestValue\":\"IUe324k...oV5/A8Q38Gj45i4jddX=\",\"digestSigned\":\"DE...fGM~C0/Ez=\"}}}}",
+          true
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a41\","
+          "\"$handler\":\"peer-salt\",\"$method\":\"signed-salt-get\",\"$timestamp\":1386003600,"
+          "\"salts\":{\"saltBundle\":[{\"salt\":{\"$id\":\"68b54c1a\","
+          "\"#text\":\"Y2ZkMWRiMDk5MDZjNTZlOTQ5N2E0NDkzYjhkMjE3\"},\"signature\":{\"reference\":\"#68b54c1a\","
+          "\"algorithm\":\"https://meta.openpeer.org/2012/12/14/jsonsig#rsa-sha1\","
+          "\"digestValue\":\"IUe324k...oV5/A8Q38Gj45i4jddX=\",\"digestSigned\":\"DE...fGM~C0/Ez=\"}},"
+          "{\"salt\":{\"$id\":\"7c02\",\"#text\":\"ZmM1YjIzOTM4ZmMxOTE5YTc1N2Y=\"}}]}}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$id\":\"a42\",\"$handler\":\"p2p\",\"$method\":\"peer-keep-alive\","
+          "\"$timestamp\":1386003600}}",
+          false
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$id\":\"a43\",\"$handler\":\"p2p\",\"$method\":\"peer-keep-alive\","
+          "\"$timestamp\":1386003600,\"expires\":1386007200}}",
+          false
+        },
+        {
+          "{\"request\":{\"$domain\":\"example.com\",\"$id\":\"a44\",\"$handler\":\"p2p\",\"$method\":\"peer-identify\","
+          "\"$timestamp\":1386003600,\"peerIdentityProofBundle\":{\"peerIdentityProof\":{\"nonce\":\"7f3c1b2a\","
+          "\"peer\":{\"$version\":\"1\",\"sectionBundle\":{\"section\":{\"$id\":\"A\",\"cipher\":\"sha256/aes256\","
+          "\"created\":1386000000,\"expires\":1388592000}}},\"findSecret\":\"YjgwMDhk\","
+          "\"location\":{\"$id\":\"5a693b7d\","
+          "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\"}}}}}",
+          true
+        },
+        {
+          "{\"result\":{\"$domain\":\"example.com\",\"$id\":\"a45\",\"$handler\":\"p2p\",\"$method\":\"peer-identify\","
+          "\"$timestamp\":1386003600,\"location\":{\"$id\":\"3e84c2a1\","
+          "\"contact\":\"peer://example.com/ea00ede4405c99be9ae45739ebfe57d5\"}}}",
+          false
+        },
+        {NULL, false}
+      };
+
+      //-----------------------------------------------------------------------
+      static SecureByteBlockPtr toFrame(const char *json)
+      {
+        // received frames are NUL terminated
+        size_t length = strlen(json);
+        SecureByteBlockPtr buffer(new SecureByteBlock(length + 1));
+        memcpy(buffer->BytePtr(), json, length + 1);
+        return buffer;
+      }
+
+      //-----------------------------------------------------------------------
+      static String toKey(
+                          const String &type,
+                          const String &handler,
+                          const String &method
+                          )
+      {
+        return type + "/" + handler + "/" + method;
+      }
+
+      //-----------------------------------------------------------------------
+      static String toKey(ElementPtr rootEl)
+      {
+        if (!rootEl) return String();
+        return toKey(rootEl->getValue(), IMessageHelper::getAttribute(rootEl, "handler"), IMessageHelper::getAttribute(rootEl, "method"));
+      }
+
+      //-----------------------------------------------------------------------
+      static String toJSON(DocumentPtr doc)
+      {
+        if (!doc) return String();
+        size_t length = 0;
+        return String((CSTR)(doc->writeAsJSON(&length).get()));
+      }
+
+      //-----------------------------------------------------------------------
+      static bool roundTrips(
+                             DocumentPtr doc,
+                             size_t &outJSONSize,
+                             size_t &outBinarySize
+                             )
+      {
+        String json = toJSON(doc);
+        SecureByteBlockPtr binary = MessageBinary::encode(doc);
+        if (!binary) return false;
+
+        outJSONSize += json.length();
+        outBinarySize += binary->SizeInBytes();
+
+        if (!MessageBinary::isBinary(binary->BytePtr(), binary->SizeInBytes())) return false;
+
+        DocumentPtr decoded = MessageBinary::decode(binary->BytePtr(), binary->SizeInBytes());
+        return (json == toJSON(decoded));
+      }
+
+      //-----------------------------------------------------------------------
+      static bool decodesAlike(
+                               MessagePtr fromJSON,
+                               MessagePtr fromBinary
+                               )
+      {
+        if ((!fromJSON) || (!fromBinary)) return false;
+
+        if (fromJSON->messageType() != fromBinary->messageType()) return false;
+        if (fromJSON->method() != fromBinary->method()) return false;
+        if (fromJSON->factory() != fromBinary->factory()) return false;
+
+        if (IHelper::toString(Message::toDebug(fromJSON)) != IHelper::toString(Message::toDebug(fromBinary))) return false;
+        return (IHelper::toString(fromJSON->creationElement()) == IHelper::toString(fromBinary->creationElement()));
+      }
+
+      //-----------------------------------------------------------------------
+      static bool conforms(
+                           const BinaryFrame &frame,
+                           size_t &outJSONSize,
+                           size_t &outBinarySize
+                           )
+      {
+        DocumentPtr doc = Document::createFromParsedJSON(frame.mJSON);
+        if (!roundTrips(doc, outJSONSize, outBinarySize)) return false;
+
+        MessagePtr fromJSON = Message::create(toFrame(frame.mJSON), IMessageSourcePtr());
+        MessagePtr fromBinary = Message::create(MessageBinary::encode(doc), IMessageSourcePtr());
+
+        // without an account both forms must be refused alike
+        if (frame.mNeedsAccount) return ((!fromJSON) && (!fromBinary));
+
+        return decodesAlike(fromJSON, fromBinary);
+      }
+    }
+  }
+}
+
+using openpeer::stack::test::BinaryFactoryList;
+using openpeer::stack::test::getBinaryFactories;
+using openpeer::stack::test::BinaryFrame;
+using openpeer::stack::test::gBinaryFrames;
+using openpeer::stack::test::toFrame;
+using openpeer::stack::test::toKey;
+using openpeer::stack::test::toJSON;
+using openpeer::stack::test::roundTrips;
+using openpeer::stack::test::decodesAlike;
+using openpeer::stack::test::conforms;
+
+void doTestMessageBinary()
+{
+  if (!OPENPEER_STACK_TEST_DO_MESSAGE_BINARY_TEST) return;
+
+  BinaryFactoryList factories;
+  getBinaryFactories(factories);
+
+  size_t jsonSize = 0;
+  size_t binarySize = 0;
+
+  // every recorded frame decodes to the same message from binary as from JSON
+  typedef std::set<String> KeySet;
+  KeySet recorded;
+
+  ULONG mismatches = 0;
+  for (int index = 0; NULL != gBinaryFrames[index].mJSON; ++index) {
+    const BinaryFrame &frame = gBinaryFrames[index];
+
+    DocumentPtr doc = Document::createFromParsedJSON(frame.mJSON);
+    BOOST_CHECK(doc)
+    if (!doc) continue;
+
+    recorded.insert(toKey(doc->getFirstChildElement()));
+    if (!conforms(frame, jsonSize, binarySize)) {
+      std::cout << "MISMATCH:     " << toKey(doc->getFirstChildElement()) << "\n";
+      ++mismatches;
+    }
+  }
+  BOOST_EQUAL(mismatches, 0)
+
+  // ...and no type a factory decodes is missing a frame
+  ULONG uncovered = 0;
+  for (BinaryFactoryList::iterator iter = factories.begin(); iter != factories.end(); ++iter)
+  {
+    IMessageFactoryPtr &factory = (*iter);
+    for (int loop = ((int)Message::Method_Invalid) + 1; true; ++loop)
+    {
+      const char *method = factory->toString((Message::Methods)loop);
+      if ((!method) || ('\0' == *method)) break;
+
+      const char *types[] = {"request", "result", "notify", NULL};
+      for (int index = 0; NULL != types[index]; ++index) {
+        String key = toKey(types[index], factory->getHandler(), method);
+        if (recorded.end() != recorded.find(key)) continue;
+
+        DocumentPtr doc = Document::createFromParsedJSON(("{\"" + String(types[index]) + "\":{\"$id\":\"abc123\",\"$handler\":\"" + factory->getHandler() + "\",\"$method\":\"" + method + "\"}}").c_str());
+        if (!factory->create(doc->getFirstChildElement(), IMessageSourcePtr())) continue;
+
+        std::cout << "UNCOVERED:    " << key << "\n";
+        ++uncovered;
+      }
+    }
+  }
+  BOOST_EQUAL(uncovered, 0)
+
+  // messages built through their own setters decode to the same values
+  {
+    ChannelWindowNotifyPtr notify = ChannelWindowNotify::create();
+    notify->domain("example.com");
+    notify->channelNumber(7);
+    notify->window((((QWORD)1) << 32) + 4096);   // past 32 bits
+
+    DocumentPtr doc = notify->encode();
+    size_t length = 0;
+    MessagePtr fromJSON = Message::create(toFrame((CSTR)(doc->writeAsJSON(&length).get())), IMessageSourcePtr());
+    MessagePtr fromBinary = Message::create(MessageBinary::encode(doc), IMessageSourcePtr());
+    BOOST_CHECK(decodesAlike(fromJSON, fromBinary))
+
+    ChannelWindowNotifyPtr decoded = ChannelWindowNotify::convert(fromBinary);
+    BOOST_CHECK(decoded)
+    if (decoded) {
+      BOOST_EQUAL(decoded->messageID(), notify->messageID())
+      BOOST_EQUAL(decoded->channelNumber(), notify->channelNumber())
+      BOOST_CHECK(decoded->window() == notify->window())
+    }
+  }
+  {
+    PeerKeepAliveRequestPtr request = PeerKeepAliveRequest::create();
+    request->domain("example.com");
+
+    PeerKeepAliveResultPtr result = PeerKeepAliveResult::create(request);
+    result->expires(zsLib::now() + zsLib::Seconds(60));
+
+    DocumentPtr doc = result->encode();
+    size_t length = 0;
+    MessagePtr fromJSON = Message::create(toFrame((CSTR)(doc->writeAsJSON(&length).get())), IMessageSourcePtr());
+    MessagePtr fromBinary = Message::create(MessageBinary::encode(doc), IMessageSourcePtr());
+    BOOST_CHECK(decodesAlike(fromJSON, fromBinary))
+
+    PeerKeepAliveResultPtr decoded = PeerKeepAliveResult::convert(fromBinary);
+    BOOST_CHECK(decoded)
+    if (decoded) {
+      BOOST_EQUAL(decoded->messageID(), request->messageID())
+      BOOST_EQUAL(IHelper::timeToString(decoded->expires()), IHelper::timeToString(result->expires()))
+    }
+  }
+
+  // real messages round trip and the envelope is read without a DOM
+  {
+    ChannelMapRequestPtr request = ChannelMapRequest::create();
+    request->domain("example.com");
+    request->channelNumber(42);
+    request->localContextID("local");
+    request->remoteContextID("remote");
+    request->relayAccessToken("token");
+    request->relayAccessSecretProof("secret");
+
+    DocumentPtr doc = request->encode();
+    BOOST_CHECK(roundTrips(doc, jsonSize, binarySize))
+
+    SecureByteBlockPtr binary = MessageBinary::encode(doc);
+    MessageEnvelope envelope;
+    BOOST_CHECK(MessageEnvelope::scan(binary, envelope))
+    BOOST_CHECK(envelope.mBinary)
+    BOOST_EQUAL(envelope.mType, Message::MessageType_Request)
+    BOOST_EQUAL(envelope.mID, request->messageID())
+    BOOST_EQUAL(envelope.mHandler, "peer-finder")
+    BOOST_EQUAL(envelope.mMethod, "channel-map")
+  }
+
+  // "appid" is dropped peer to peer
+  {
+    SessionKeepAliveRequestPtr request = SessionKeepAliveRequest::create();
+    request->appID("app");
+
+    SecureByteBlockPtr binary = MessageBinary::encode(request->encode(), true);
+    BOOST_CHECK(binary)
+
+    MessageEnvelope envelope;
+    BOOST_CHECK(MessageEnvelope::scan(binary, envelope))
+    BOOST_CHECK(envelope.mAppID.isEmpty())
+  }
+
+  // a frame the scanner gives up on part way carries no routing information
+  // so callers fall back to decoding it in full
+  {
+    const char *keepAlive =
+      "{\"result\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.\\\"app\\\"\",\"$id\":\"6b6a2a3e8c\",\"$handler\":\"peer-finder\",\"$method\":\"session-keep-alive\","
+      "\"expires\":1386003600}}";
+
+    SecureByteBlockPtr frame = IHelper::convertToBuffer(keepAlive);
+
+    MessageEnvelope envelope;
+    BOOST_CHECK(!MessageEnvelope::scan(frame, envelope))
+    BOOST_CHECK(!envelope.hasData())
+    BOOST_CHECK(envelope.mID.isEmpty())
+    BOOST_CHECK(envelope.mRaw == frame)
+
+    MessagePtr message = envelope.decode(IMessageSourcePtr());
+    BOOST_CHECK(message)
+    if (message) {
+      BOOST_EQUAL(message->messageID(), "6b6a2a3e8c")
+    }
+  }
+
+  // truncated or corrupt frames are rejected rather than misread
+  {
+    SecureByteBlockPtr binary = MessageBinary::encode(Document::createFromParsedJSON(gBinaryFrames[0].mJSON));
+    BOOST_CHECK(binary)
+
+    ULONG accepted = 0;
+    for (size_t length = 0; length < binary->SizeInBytes(); ++length) {
+      if (MessageBinary::decode(binary->BytePtr(), length)) ++accepted;
+    }
+    BOOST_EQUAL(accepted, 0)
+
+    BYTE json[] = {'{', '}'};
+    BOOST_CHECK(!MessageBinary::isBinary(json, sizeof(json)))
+  }
+
+  if (OPENPEER_STACK_TEST_DO_BENCHMARKS) std::cout << "BENCHMARK:    binary encoding total=" << binarySize << " bytes, JSON encoding (baseline) total=" << jsonSize << " bytes (" << (jsonSize > 0 ? ((binarySize * 100) / jsonSize) : 0) << "% of JSON)\n";
+}
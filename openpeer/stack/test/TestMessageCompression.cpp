@@ -0,0 +1,130 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/message/MessageCompression.h>
+#include <openpeer/stack/message/MessageEnvelope.h>
+#include <openpeer/stack/message/MessageWriter.h>
+#include <openpeer/stack/message/peer-finder/ChannelMapRequest.h>
+
+#include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
+
+#include <zsLib/helpers.h>
+
+#include "config.h"
+#include "boost_replacement.h"
+
+#include <cstring>
+#include <iostream>
+
+using zsLib::ULONG;
+using zsLib::BYTE;
+using zsLib::String;
+using openpeer::SecureByteBlock;
+using openpeer::SecureByteBlockPtr;
+using openpeer::services::IHelper;
+using openpeer::services::ISettings;
+using openpeer::stack::message::Message;
+using openpeer::stack::message::MessageCompression;
+using openpeer::stack::message::MessageEnvelope;
+using openpeer::stack::message::MessageWriter;
+using openpeer::stack::message::peer_finder::ChannelMapRequest;
+using openpeer::stack::message::peer_finder::ChannelMapRequestPtr;
+
+void doTestMessageCompression()
+{
+  if (!OPENPEER_STACK_TEST_DO_MESSAGE_COMPRESSION_TEST) return;
+
+  ISettings::setUInt(OPENPEER_STACK_SETTING_MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES, OPENPEER_STACK_TEST_MESSAGE_COMPRESSION_THRESHOLD);
+
+  MessageCompression::getStatistics(true);
+
+  // a large repetitive frame (like a publication) shrinks and round trips
+  {
+    String payload;
+    for (ULONG loop = 0; loop < 200; ++loop) {
+      payload += "{\"contact\":{\"$id\":\"peer://example.com/abcdef0123456789\",\"disposition\":\"update\"}},";
+    }
+
+    SecureByteBlockPtr compressed = MessageCompression::compress((const BYTE *)payload.c_str(), payload.length());
+    BOOST_CHECK(compressed)
+    if (compressed) {
+      BOOST_CHECK(compressed->SizeInBytes() < payload.length())
+      BOOST_CHECK(MessageCompression::isCompressed(compressed->BytePtr(), compressed->SizeInBytes()))
+
+      SecureByteBlockPtr inflated = MessageCompression::decompress(compressed->BytePtr(), compressed->SizeInBytes());
+      BOOST_CHECK(inflated)
+      if (inflated) {
+        BOOST_EQUAL(inflated->SizeInBytes(), payload.length() + sizeof(char))
+        BOOST_CHECK(0 == memcmp(inflated->BytePtr(), payload.c_str(), payload.length()))
+      }
+
+      // truncated frames never inflate
+      ULONG accepted = 0;
+      for (size_t length = 0; length < compressed->SizeInBytes(); ++length) {
+        if (MessageCompression::decompress(compressed->BytePtr(), length)) ++accepted;
+      }
+      BOOST_EQUAL(accepted, 0)
+    }
+  }
+
+  // small frames are left alone
+  {
+    const char *small = "{\"request\":{}}";
+    BOOST_CHECK(!MessageCompression::compress((const BYTE *)small, strlen(small)))
+  }
+
+  // a compressed message scans and decodes like the plain one
+  {
+    ChannelMapRequestPtr request = ChannelMapRequest::create();
+    request->domain("example.com");
+    request->channelNumber(42);
+    request->localContextID(String(OPENPEER_STACK_TEST_MESSAGE_COMPRESSION_THRESHOLD, 'a'));
+    request->remoteContextID(String(OPENPEER_STACK_TEST_MESSAGE_COMPRESSION_THRESHOLD, 'b'));
+
+    MessageWriter writer;
+    BOOST_CHECK(request->encodeTo(writer))
+
+    SecureByteBlockPtr compressed = MessageCompression::compress((const BYTE *)writer.data(), writer.size());
+    BOOST_CHECK(compressed)
+
+    MessageEnvelope envelope;
+    BOOST_CHECK(MessageEnvelope::scan(compressed, envelope))
+    BOOST_CHECK(envelope.mCompressed)
+    BOOST_EQUAL(envelope.mType, Message::MessageType_Request)
+    BOOST_EQUAL(envelope.mID, request->messageID())
+    BOOST_EQUAL(envelope.mMethod, "channel-map")
+  }
+
+  if (OPENPEER_STACK_TEST_DO_BENCHMARKS) std::cout << "BENCHMARK:    " << IHelper::toString(MessageCompression::getStatistics()) << "\n";
+}
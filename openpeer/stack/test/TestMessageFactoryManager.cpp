@@ -0,0 +1,206 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/message/IMessageFactory.h>
+#include <openpeer/stack/message/IMessageFactoryManager.h>
+
+#include <openpeer/stack/message/bootstrapped-finder/MessageFactoryBootstrappedFinder.h>
+#include <openpeer/stack/message/bootstrapper/MessageFactoryBootstrapper.h>
+#include <openpeer/stack/message/certificates/MessageFactoryCertificates.h>
+#include <openpeer/stack/message/identity/MessageFactoryIdentity.h>
+#include <openpeer/stack/message/identity-lookup/MessageFactoryIdentityLookup.h>
+#include <openpeer/stack/message/identity-lockbox/MessageFactoryIdentityLockbox.h>
+#include <openpeer/stack/message/namespace-grant/MessageFactoryNamespaceGrant.h>
+#include <openpeer/stack/message/rolodex/MessageFactoryRolodex.h>
+#include <openpeer/stack/message/peer/MessageFactoryPeer.h>
+#include <openpeer/stack/message/peer-common/MessageFactoryPeerCommon.h>
+#include <openpeer/stack/message/peer-finder/MessageFactoryPeerFinder.h>
+#include <openpeer/stack/message/peer-salt/MessageFactoryPeerSalt.h>
+#include <openpeer/stack/message/peer-to-peer/MessageFactoryPeerToPeer.h>
+
+#include <zsLib/helpers.h>
+
+#include "config.h"
+#include "helpers.h"
+#include "boost_replacement.h"
+
+#include <list>
+
+using zsLib::ULONG;
+using zsLib::String;
+using zsLib::Time;
+using zsLib::Duration;
+using openpeer::stack::message::Message;
+using openpeer::stack::message::IMessageFactoryPtr;
+using openpeer::stack::message::IMessageFactoryManager;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      typedef std::list<IMessageFactoryPtr> FactoryList;
+
+      struct HandlerMethod
+      {
+        String mHandler;
+        String mMethod;
+        Message::Methods mMethodCode;
+      };
+
+      typedef std::list<HandlerMethod> HandlerMethodList;
+
+      //-----------------------------------------------------------------------
+      static void getFactories(FactoryList &outFactories)
+      {
+        outFactories.push_back(message::bootstrapped_finder::MessageFactoryBootstrappedFinder::singleton());
+        outFactories.push_back(message::bootstrapper::MessageFactoryBootstrapper::singleton());
+        outFactories.push_back(message::certificates::MessageFactoryCertificates::singleton());
+        outFactories.push_back(message::identity::MessageFactoryIdentity::singleton());
+        outFactories.push_back(message::identity_lookup::MessageFactoryIdentityLookup::singleton());
+        outFactories.push_back(message::identity_lockbox::MessageFactoryIdentityLockbox::singleton());
+        outFactories.push_back(message::namespace_grant::MessageFactoryNamespaceGrant::singleton());
+        outFactories.push_back(message::rolodex::MessageFactoryRolodex::singleton());
+        outFactories.push_back(message::peer::MessageFactoryPeer::singleton());
+        outFactories.push_back(message::peer_common::MessageFactoryPeerCommon::singleton());
+        outFactories.push_back(message::peer_finder::MessageFactoryPeerFinder::singleton());
+        outFactories.push_back(message::peer_salt::MessageFactoryPeerSalt::singleton());
+        outFactories.push_back(message::peer_to_peer::MessageFactoryPeerToPeer::singleton());
+      }
+
+      //-----------------------------------------------------------------------
+      static void getHandlerMethods(
+                                    const FactoryList &factories,
+                                    HandlerMethodList &outPairs
+                                    )
+      {
+        for (FactoryList::const_iterator iter = factories.begin(); iter != factories.end(); ++iter)
+        {
+          const IMessageFactoryPtr &factory = (*iter);
+          for (int loop = ((int)Message::Method_Invalid) + 1; true; ++loop)
+          {
+            const char *method = factory->toString((Message::Methods)loop);
+            if ((!method) || ('\0' == *method)) break;
+
+            HandlerMethod pair;
+            pair.mHandler = factory->getHandler();
+            pair.mMethod = method;
+            pair.mMethodCode = (Message::Methods)loop;
+            outPairs.push_back(pair);
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static Message::Methods linearToMethod(
+                                             const FactoryList &factories,
+                                             const String &handler,
+                                             const String &method
+                                             )
+      {
+        // previous dispatch: walk factories by handler then walk methods
+        for (FactoryList::const_iterator iter = factories.begin(); iter != factories.end(); ++iter)
+        {
+          const IMessageFactoryPtr &factory = (*iter);
+          if (handler != factory->getHandler()) continue;
+
+          for (int loop = ((int)Message::Method_Invalid) + 1; true; ++loop)
+          {
+            const char *name = factory->toString((Message::Methods)loop);
+            if ((!name) || ('\0' == *name)) break;
+            if (method == name) return (Message::Methods)loop;
+          }
+        }
+        return Message::Method_Invalid;
+      }
+    }
+  }
+}
+
+using openpeer::stack::test::FactoryList;
+using openpeer::stack::test::HandlerMethod;
+using openpeer::stack::test::HandlerMethodList;
+using openpeer::stack::test::getFactories;
+using openpeer::stack::test::getHandlerMethods;
+using openpeer::stack::test::linearToMethod;
+using openpeer::stack::test::reportBenchmark;
+
+void doTestMessageFactoryManager()
+{
+  if (!OPENPEER_STACK_TEST_DO_MESSAGE_FACTORY_MANAGER_TEST) return;
+
+  FactoryList factories;
+  getFactories(factories);
+
+  HandlerMethodList pairs;
+  getHandlerMethods(factories, pairs);
+
+  BOOST_CHECK(pairs.size() > 0)
+
+  // every registered (handler, method) resolves to the same method code
+  ULONG mismatches = 0;
+  for (HandlerMethodList::iterator iter = pairs.begin(); iter != pairs.end(); ++iter)
+  {
+    HandlerMethod &pair = (*iter);
+    if (pair.mMethodCode != IMessageFactoryManager::toMethod(pair.mHandler, pair.mMethod)) ++mismatches;
+  }
+  BOOST_EQUAL(mismatches, 0)
+
+  BOOST_EQUAL(IMessageFactoryManager::toMethod("peer-finder", "bogus-method"), Message::Method_Invalid)
+  BOOST_EQUAL(IMessageFactoryManager::toMethod("bogus-handler", "session-create"), Message::Method_Invalid)
+
+  const ULONG iterations = OPENPEER_STACK_TEST_MESSAGE_FACTORY_MANAGER_ITERATIONS;
+  const ULONG total = iterations * static_cast<ULONG>(pairs.size());
+
+  ULONG found = 0;
+  Time start = zsLib::now();
+  for (ULONG loop = 0; loop < iterations; ++loop) {
+    for (HandlerMethodList::iterator iter = pairs.begin(); iter != pairs.end(); ++iter) {
+      if (Message::Method_Invalid != IMessageFactoryManager::toMethod((*iter).mHandler, (*iter).mMethod)) ++found;
+    }
+  }
+  reportBenchmark("registry dispatch", zsLib::now() - start, total);
+  BOOST_EQUAL(found, total)
+
+  if (!OPENPEER_STACK_TEST_DO_BENCHMARKS) return;
+
+  found = 0;
+  start = zsLib::now();
+  for (ULONG loop = 0; loop < iterations; ++loop) {
+    for (HandlerMethodList::iterator iter = pairs.begin(); iter != pairs.end(); ++iter) {
+      if (Message::Method_Invalid != linearToMethod(factories, (*iter).mHandler, (*iter).mMethod)) ++found;
+    }
+  }
+  reportBenchmark("linear dispatch (baseline)", zsLib::now() - start, total);
+  BOOST_EQUAL(found, total)
+}
@@ -0,0 +1,167 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+#include <openpeer/stack/internal/stack_MessageMonitorTable.h>
+
+#include <zsLib/helpers.h>
+#include <zsLib/Stringize.h>
+
+#include "config.h"
+#include "helpers.h"
+#include "boost_replacement.h"
+
+#include <map>
+#include <vector>
+
+using zsLib::ULONG;
+using zsLib::String;
+using zsLib::Time;
+using zsLib::Duration;
+using openpeer::stack::internal::MessageMonitorTable;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      typedef std::vector<String> MessageIDVector;
+
+      //-----------------------------------------------------------------------
+      static void fillMessageIDs(
+                                 MessageIDVector &outIDs,
+                                 ULONG total
+                                 )
+      {
+        outIDs.reserve(total);
+        for (ULONG index = 0; index < total; ++index) {
+          // same shape as IHelper::randomString() based message IDs
+          outIDs.push_back(String("m") + zsLib::string(index) + "-" + zsLib::string(scatterIndex(index, 1000003)));
+        }
+      }
+    }
+  }
+}
+
+using openpeer::stack::test::MessageIDVector;
+using openpeer::stack::test::fillMessageIDs;
+using openpeer::stack::test::reportBenchmark;
+
+void doTestMessageMonitorTable()
+{
+  if (!OPENPEER_STACK_TEST_DO_MESSAGE_MONITOR_TABLE_TEST) return;
+
+  const ULONG total = OPENPEER_STACK_TEST_MESSAGE_MONITOR_TABLE_OUTSTANDING;
+
+  MessageIDVector ids;
+  fillMessageIDs(ids, total);
+
+  // scope: hash table
+  {
+    MessageMonitorTable table;
+
+    Time start = zsLib::now();
+    for (ULONG index = 0; index < total; ++index) {
+      MessageMonitorTable::Entry *entry = table.insert(ids[index]);
+      entry->addMonitor(index + 1, MessageMonitorTable::UseMessageMonitorWeakPtr());
+    }
+    reportBenchmark("monitor table insert", zsLib::now() - start, total);
+
+    BOOST_EQUAL(table.size(), total)
+
+    ULONG found = 0;
+    start = zsLib::now();
+    for (ULONG index = 0; index < total; ++index) {
+      MessageMonitorTable::Entry *entry = table.find(ids[index]);
+      if (entry) found += entry->totalMonitors();
+    }
+    reportBenchmark("monitor table lookup (hit)", zsLib::now() - start, total);
+
+    BOOST_EQUAL(found, total)
+
+    ULONG missed = 0;
+    start = zsLib::now();
+    for (ULONG index = 0; index < total; ++index) {
+      if (!table.find(ids[index] + "x")) ++missed;
+    }
+    reportBenchmark("monitor table lookup (miss)", zsLib::now() - start, total);
+
+    BOOST_EQUAL(missed, total)
+
+    // second monitor on a subset forces the overflow map
+    for (ULONG index = 0; index < total; index += 10) {
+      table.find(ids[index])->addMonitor(total + index + 1, MessageMonitorTable::UseMessageMonitorWeakPtr());
+    }
+    BOOST_EQUAL(table.find(ids[0])->totalMonitors(), 2)
+    BOOST_CHECK(table.find(ids[0])->removeMonitor(total + 1))
+    BOOST_CHECK(!table.find(ids[0])->mOverflow)
+    BOOST_EQUAL(table.find(ids[0])->mMonitorID, 1)
+
+    start = zsLib::now();
+    for (ULONG index = 0; index < total; ++index) {
+      MessageMonitorTable::Entry *entry = table.find(ids[index]);
+      entry->removeMonitor(index + 1);
+      entry->removeMonitor(total + index + 1);
+      table.eraseIfUnused(entry);
+    }
+    reportBenchmark("monitor table remove", zsLib::now() - start, total);
+
+    BOOST_EQUAL(table.size(), 0)
+  }
+
+  // scope: baseline (previous std::map of maps layout)
+  if (OPENPEER_STACK_TEST_DO_BENCHMARKS) {
+    typedef std::map<ULONG, MessageMonitorTable::UseMessageMonitorWeakPtr> MonitorMap;
+    typedef boost::shared_ptr<MonitorMap> MonitorMapPtr;
+    typedef std::map<String, MonitorMapPtr> MonitorsMap;
+
+    MonitorsMap monitors;
+
+    Time start = zsLib::now();
+    for (ULONG index = 0; index < total; ++index) {
+      MonitorMapPtr inner(new MonitorMap);
+      (*inner)[index + 1] = MessageMonitorTable::UseMessageMonitorWeakPtr();
+      monitors[ids[index]] = inner;
+    }
+    reportBenchmark("std::map insert (baseline)", zsLib::now() - start, total);
+
+    ULONG found = 0;
+    start = zsLib::now();
+    for (ULONG index = 0; index < total; ++index) {
+      MonitorsMap::iterator iter = monitors.find(ids[index]);
+      if (iter != monitors.end()) found += (*iter).second->size();
+    }
+    reportBenchmark("std::map lookup (baseline)", zsLib::now() - start, total);
+
+    BOOST_EQUAL(found, total)
+  }
+}
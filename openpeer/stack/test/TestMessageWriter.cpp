@@ -0,0 +1,529 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/message/IMessageHelper.h>
+#include <openpeer/stack/message/Message.h>
+#include <openpeer/stack/message/MessageWriter.h>
+#include <openpeer/stack/message/bootstrapper/ServicesGetRequest.h>
+#include <openpeer/stack/message/peer-common/PeerPublishNotify.h>
+#include <openpeer/stack/message/peer-finder/ChannelMapRequest.h>
+#include <openpeer/stack/message/peer-finder/ChannelWindowNotify.h>
+#include <openpeer/stack/message/peer-finder/PeerLocationFindNotify.h>
+#include <openpeer/stack/message/peer-finder/PeerLocationFindRequest.h>
+#include <openpeer/stack/message/peer-finder/SessionKeepAliveRequest.h>
+#include <openpeer/stack/message/peer-to-peer/PeerKeepAliveRequest.h>
+#include <openpeer/stack/message/peer-to-peer/PeerKeepAliveResult.h>
+#include <openpeer/stack/IPeerFiles.h>
+
+#include <openpeer/services/IHelper.h>
+
+#include <zsLib/XML.h>
+#include <zsLib/helpers.h>
+
+#include "config.h"
+#include "boost_replacement.h"
+
+#include <iostream>
+
+using zsLib::ULONG;
+using zsLib::QWORD;
+using zsLib::String;
+using zsLib::Time;
+using zsLib::Duration;
+using zsLib::Seconds;
+using zsLib::XML::Document;
+using zsLib::XML::DocumentPtr;
+using zsLib::XML::ElementPtr;
+using zsLib::XML::NodePtr;
+using zsLib::XML::AttributePtr;
+using zsLib::XML::TextPtr;
+using openpeer::SecureByteBlockPtr;
+using openpeer::services::IHelper;
+using openpeer::stack::IMessageSourcePtr;
+using openpeer::stack::IPeerFiles;
+using openpeer::stack::IPeerFilesPtr;
+using openpeer::stack::message::IMessageHelper;
+using openpeer::stack::message::Message;
+using openpeer::stack::message::MessagePtr;
+using openpeer::stack::message::MessageWriter;
+using openpeer::stack::message::bootstrapper::ServicesGetRequest;
+using openpeer::stack::message::bootstrapper::ServicesGetRequestPtr;
+using openpeer::stack::message::peer_finder::ChannelMapRequest;
+using openpeer::stack::message::peer_finder::ChannelMapRequestPtr;
+using openpeer::stack::message::peer_finder::ChannelWindowNotify;
+using openpeer::stack::message::peer_finder::ChannelWindowNotifyPtr;
+using openpeer::stack::message::peer_finder::SessionKeepAliveRequest;
+using openpeer::stack::message::peer_finder::SessionKeepAliveRequestPtr;
+using openpeer::stack::message::peer_finder::PeerLocationFindRequest;
+using openpeer::stack::message::peer_finder::PeerLocationFindRequestPtr;
+using openpeer::stack::message::peer_finder::PeerLocationFindNotify;
+using openpeer::stack::message::peer_finder::PeerLocationFindNotifyPtr;
+using openpeer::stack::message::peer_common::PeerPublishNotify;
+using openpeer::stack::message::peer_common::PeerPublishNotifyPtr;
+using openpeer::stack::message::peer_to_peer::PeerKeepAliveRequest;
+using openpeer::stack::message::peer_to_peer::PeerKeepAliveRequestPtr;
+using openpeer::stack::message::peer_to_peer::PeerKeepAliveResult;
+using openpeer::stack::message::peer_to_peer::PeerKeepAliveResultPtr;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      //-----------------------------------------------------------------------
+      static ElementPtr parseRoot(const MessageWriter &writer)
+      {
+        DocumentPtr doc = Document::createFromParsedJSON(writer.data());
+        if (!doc) return ElementPtr();
+        return doc->getFirstChildElement();
+      }
+
+      //-----------------------------------------------------------------------
+      static String childText(
+                              ElementPtr el,
+                              const char *name
+                              )
+      {
+        if (!el) return String();
+        ElementPtr childEl = el->findFirstChildElement(name);
+        if (!childEl) return String();
+        return childEl->getTextDecoded();
+      }
+
+      //-----------------------------------------------------------------------
+      // NOTE: values that differ on every encode (random nonces, the
+      //       random ID a signed element is given and the signature over
+      //       it, randomly salted encryptions and the proof expiry taken
+      //       from the clock)
+      static bool isVolatile(
+                             const String &path,
+                             const String &name
+                             )
+      {
+        if ((name == "nonce") ||
+            (name == "reference") ||
+            (name == "digestValue") ||
+            (name == "digestSigned") ||
+            (name == "icePasswordEncrypted")) return true;
+
+        return ((name == "expires") && (String::npos != path.find("/findProof")));
+      }
+
+      //-----------------------------------------------------------------------
+      static bool isSigned(ElementPtr el)
+      {
+        return (bool)el->findNextSiblingElement("signature");
+      }
+
+      //-----------------------------------------------------------------------
+      // NOTE: one line per attribute and text node (including the text
+      //       format so a number written as a string is caught)
+      static void flatten(
+                          ElementPtr el,
+                          const String &path,
+                          String &outTree
+                          )
+      {
+        String elPath = path + "/" + el->getValue();
+
+        for (NodePtr node = el->getFirstAttribute(); node; node = node->getNextSibling()) {
+          AttributePtr attribute = node->toAttribute();
+
+          // taken when each form is encoded
+          if (attribute->getName() == "timestamp") continue;
+
+          bool maskedID = ((attribute->getName() == "id") && (isSigned(el)));
+
+          outTree += elPath + "@" + attribute->getName() + "=" + (maskedID ? String("*") : attribute->getValue()) + "\n";
+        }
+
+        bool masked = isVolatile(path, el->getValue());
+
+        for (NodePtr node = el->getFirstChild(); node; node = node->getNextSibling()) {
+          if (node->isElement()) {
+            flatten(node->toElement(), elPath, outTree);
+            continue;
+          }
+          if (node->isText()) {
+            TextPtr text = node->toText();
+            outTree += elPath + "=" + zsLib::string((int)text->getFormat()) + ":" + (masked ? String("*") : text->getValue()) + "\n";
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      // NOTE: the streamed form against the DOM encode() it replaced, both
+      //       parsed back and compared as full trees
+      static void flattenEncodings(
+                                   MessagePtr message,
+                                   String &outStreamed,
+                                   String &outDOM
+                                   )
+      {
+        outStreamed.clear();
+        outDOM.clear();
+
+        if (!message) return;
+
+        MessageWriter streamedWriter;
+        if (message->encodeTo(streamedWriter)) {
+          ElementPtr streamedEl = parseRoot(streamedWriter);
+          if (streamedEl) flatten(streamedEl, String(), outStreamed);
+        }
+
+        DocumentPtr doc = message->encode();
+        MessageWriter domWriter;
+        if ((doc) && (domWriter.writeDocument(doc))) {
+          ElementPtr domEl = parseRoot(domWriter);
+          if (domEl) flatten(domEl, String(), outDOM);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static IPeerFilesPtr generatePeerFiles()
+      {
+        const char *signedSaltBundle =
+          "{\"saltBundle\":{\"salt\":{\"$id\":\"68b54c1a\",\"#text\":\"Y2ZkMWRiMDk5MDZjNTZlOTQ5N2E0NDkzYjhkMjE3\"},"
+          "\"signature\":{\"reference\":\"#68b54c1a\",\"algorithm\":\"https://meta.openpeer.org/2012/12/14/jsonsig#rsa-sha1\","
+          "\"digestValue\":\"IUe324k...oV5/A8Q38Gj45i4jddX=\",\"digestSigned\":\"DE...fGM~C0/Ez=\","
+          "\"key\":{\"$id\":\"b7ef37\",\"domain\":\"example.com\",\"service\":\"salt\"}}}}";
+
+        DocumentPtr doc = Document::createFromParsedJSON(signedSaltBundle);
+        if (!doc) return IPeerFilesPtr();
+
+        ElementPtr saltBundleEl = doc->getFirstChildElement();
+        if (!saltBundleEl) return IPeerFilesPtr();
+
+        return IPeerFiles::generate("writer-test", saltBundleEl);
+      }
+    }
+  }
+}
+
+using openpeer::stack::test::parseRoot;
+using openpeer::stack::test::childText;
+using openpeer::stack::test::flattenEncodings;
+using openpeer::stack::test::generatePeerFiles;
+
+void doTestMessageWriter()
+{
+  if (!OPENPEER_STACK_TEST_DO_MESSAGE_WRITER_TEST) return;
+
+  MessageWriter writer;
+
+  // keep-alive is only the envelope
+  {
+    SessionKeepAliveRequestPtr request = SessionKeepAliveRequest::create();
+    request->domain("example.com");
+
+    writer.reset();
+    BOOST_CHECK(request->encodeTo(writer))
+
+    ElementPtr rootEl = parseRoot(writer);
+    BOOST_CHECK(rootEl)
+    if (rootEl) {
+      BOOST_EQUAL(rootEl->getValue(), "request")
+      BOOST_EQUAL(IMessageHelper::getAttribute(rootEl, "handler"), "peer-finder")
+      BOOST_EQUAL(IMessageHelper::getAttribute(rootEl, "method"), "session-keep-alive")
+      BOOST_EQUAL(IMessageHelper::getAttribute(rootEl, "id"), request->messageID())
+      BOOST_EQUAL(IMessageHelper::getAttribute(rootEl, "domain"), "example.com")
+    }
+  }
+
+  // channel map carries nested objects and values needing escapes
+  {
+    ChannelMapRequestPtr request = ChannelMapRequest::create();
+    request->channelNumber(42);
+    request->localContextID("local \"context\"\n");
+    request->remoteContextID("remote\\context");
+    request->relayAccessToken("token");
+    request->relayAccessSecretProof("secret");
+
+    writer.reset();
+    BOOST_CHECK(request->encodeTo(writer))
+
+    ElementPtr rootEl = parseRoot(writer);
+    BOOST_CHECK(rootEl)
+    if (rootEl) {
+      BOOST_EQUAL(IMessageHelper::getAttribute(rootEl, "method"), "channel-map")
+      BOOST_EQUAL(childText(rootEl, "channel"), "42")
+      BOOST_CHECK(childText(rootEl, "nonce").hasData())
+
+      ElementPtr relayEl = rootEl->findFirstChildElement("relay");
+      BOOST_CHECK(relayEl)
+      BOOST_EQUAL(childText(relayEl, "localContext"), "local \"context\"\n")
+      BOOST_EQUAL(childText(relayEl, "remoteContext"), "remote\\context")
+      BOOST_EQUAL(childText(relayEl, "accessToken"), "token")
+      BOOST_CHECK(childText(relayEl, "accessSecretProof").hasData())
+      BOOST_CHECK(childText(relayEl, "accessSecretProofExpires").hasData())
+    }
+  }
+
+  // channel window carries a 64 bit offset and parses back
+  {
+    const QWORD window = (((QWORD)5) << 32) + 256*1024;
+
+    ChannelWindowNotifyPtr notify = ChannelWindowNotify::create();
+    notify->channelNumber(0x8000002A);
+    notify->window(window);
+
+    writer.reset();
+    BOOST_CHECK(notify->encodeTo(writer))
+
+    ElementPtr rootEl = parseRoot(writer);
+    BOOST_CHECK(rootEl)
+    if (rootEl) {
+      BOOST_EQUAL(rootEl->getValue(), "notify")
+      BOOST_EQUAL(IMessageHelper::getAttribute(rootEl, "method"), "channel-window")
+      BOOST_EQUAL(childText(rootEl, "channel"), "2147483690")
+      BOOST_EQUAL(childText(rootEl, "window"), "21475098624")
+
+      ChannelWindowNotifyPtr parsed = ChannelWindowNotify::create(rootEl, IMessageSourcePtr());
+      BOOST_CHECK(parsed)
+      if (parsed) {
+        BOOST_EQUAL(parsed->channelNumber(), notify->channelNumber())
+        BOOST_CHECK(window == parsed->window())
+      }
+    }
+  }
+
+  // the DOM fallback and the streamed form decode to the same envelope
+  {
+    SessionKeepAliveRequestPtr request = SessionKeepAliveRequest::create();
+
+    MessageWriter fallbackWriter;
+    BOOST_CHECK(fallbackWriter.writeDocument(request->encode()))
+
+    writer.reset();
+    BOOST_CHECK(request->encodeTo(writer))
+
+    ElementPtr streamedEl = parseRoot(writer);
+    ElementPtr fallbackEl = parseRoot(fallbackWriter);
+    BOOST_CHECK(streamedEl)
+    BOOST_CHECK(fallbackEl)
+    if ((streamedEl) && (fallbackEl)) {
+      BOOST_EQUAL(IMessageHelper::getAttribute(streamedEl, "id"), IMessageHelper::getAttribute(fallbackEl, "id"))
+      BOOST_EQUAL(IMessageHelper::getAttribute(streamedEl, "handler"), IMessageHelper::getAttribute(fallbackEl, "handler"))
+      BOOST_EQUAL(IMessageHelper::getAttribute(streamedEl, "method"), IMessageHelper::getAttribute(fallbackEl, "method"))
+    }
+  }
+
+  // every streamed peer message matches its DOM encode() as a full tree
+  {
+    String streamed;
+    String dom;
+
+    PeerKeepAliveRequestPtr keepAliveRequest = PeerKeepAliveRequest::create();
+    keepAliveRequest->domain("example.com");
+
+    flattenEncodings(keepAliveRequest, streamed, dom);
+    BOOST_CHECK(streamed.hasData())
+    BOOST_EQUAL(streamed, dom)
+
+    PeerKeepAliveResultPtr keepAliveResult = PeerKeepAliveResult::create(keepAliveRequest);
+    keepAliveResult->expires(zsLib::now() + Duration(Seconds(60)));
+
+    flattenEncodings(keepAliveResult, streamed, dom);
+    BOOST_CHECK(streamed.hasData())
+    BOOST_EQUAL(streamed, dom)
+
+    // a recorded notify carrying two documents (no peer cache so only the
+    // details of each publication are written)
+    const char *publishNotify =
+      "{\"notify\":{\"$domain\":\"example.com\",\"$appid\":\"com.example.app\",\"$id\":\"a30\","
+      "\"$handler\":\"peer-common\",\"$method\":\"peer-publish-notify\",\"$timestamp\":1386003600,"
+      "\"documents\":{\"document\":[{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/883fa7...9533609131\","
+      "\"version\":12,\"baseVersion\":11,\"lineage\":5849943,\"scope\":\"location\",\"lifetime\":\"session\","
+      "\"expires\":1386007200,\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+      "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+      "\"location\":\"883fa7...9533609131\"}},"
+      "{\"details\":{\"name\":\"/hookflash.com/presence/1.0/bd520f1dbaa13c0cc9b7ff528e83470e/status\","
+      "\"version\":3,\"lineage\":5849944,\"scope\":\"location\",\"lifetime\":\"session\","
+      "\"mime\":\"text/x-json-openpeer\",\"encoding\":\"json\","
+      "\"contact\":\"peer://example.com/bd520f1dbaa13c0cc9b7ff528e83470e\","
+      "\"location\":\"883fa7...9533609131\"}}]}}}";
+
+    PeerPublishNotifyPtr notify = PeerPublishNotify::convert(Message::create(IHelper::convertToBuffer(publishNotify), IMessageSourcePtr()));
+    BOOST_CHECK(notify)
+
+    flattenEncodings(notify, streamed, dom);
+    BOOST_CHECK(streamed.hasData())
+    BOOST_EQUAL(streamed, dom)
+
+    // the find request and notify sign their proof bundle
+    IPeerFilesPtr peerFiles = generatePeerFiles();
+    BOOST_CHECK(peerFiles)
+
+    if (peerFiles) {
+      PeerLocationFindRequestPtr findRequest = PeerLocationFindRequest::create();
+      findRequest->domain("example.com");
+      findRequest->peerFiles(peerFiles);
+      findRequest->created(zsLib::now());
+      findRequest->context("8a8b5f3e");
+      findRequest->peerSecret("secret");
+      findRequest->iceUsernameFrag("c1e2");
+      findRequest->icePassword("9f1e2d3c4b5a");
+      findRequest->final(true);
+
+      PeerLocationFindRequest::ExcludedLocationList excluded;
+      excluded.push_back("3e84c2a1");
+      excluded.push_back("5d0f7b29");
+      findRequest->excludeLocations(excluded);
+
+      flattenEncodings(findRequest, streamed, dom);
+      BOOST_CHECK(streamed.hasData())
+      BOOST_CHECK(String::npos != streamed.find("/exclude/locations/location@id=5d0f7b29"))
+      BOOST_EQUAL(streamed, dom)
+
+      PeerLocationFindNotifyPtr findNotify = PeerLocationFindNotify::create(findRequest);
+      findNotify->domain("example.com");
+      findNotify->peerFiles(peerFiles);
+      findNotify->context("8a8b5f3e");
+      findNotify->validated(true);
+      findNotify->iceUsernameFrag("d4f5");
+      findNotify->icePassword("0a1b2c3d4e5f");
+      findNotify->final(false);
+
+      flattenEncodings(findNotify, streamed, dom);
+      BOOST_CHECK(streamed.hasData())
+      BOOST_EQUAL(streamed, dom)
+    }
+  }
+
+  // a warm writer no longer grows
+  {
+    ChannelMapRequestPtr request = ChannelMapRequest::create();
+    request->channelNumber(7);
+    request->localContextID("local");
+
+    writer.reset();
+    request->encodeTo(writer);
+    size_t capacity = writer.capacity();
+
+    const ULONG iterations = OPENPEER_STACK_TEST_MESSAGE_WRITER_ITERATIONS;
+
+    Time start = zsLib::now();
+    for (ULONG loop = 0; loop < iterations; ++loop) {
+      writer.reset();
+      request->encodeTo(writer);
+    }
+    Duration streamed = zsLib::now() - start;
+
+    BOOST_EQUAL(writer.capacity(), capacity)
+
+    if (OPENPEER_STACK_TEST_DO_BENCHMARKS) {
+      start = zsLib::now();
+      for (ULONG loop = 0; loop < iterations; ++loop) {
+        size_t length = 0;
+        DocumentPtr doc = request->encode();
+        doc->writeAsJSON(&length);
+      }
+      Duration dom = zsLib::now() - start;
+
+      std::cout << "BENCHMARK:    streamed encode total=" << streamed.total_microseconds() << "us, DOM encode (baseline) total=" << dom.total_microseconds() << "us (" << iterations << " messages)\n";
+    }
+  }
+  // a resend reuses the bytes of the first send until the message changes
+  {
+    ChannelMapRequestPtr request = ChannelMapRequest::create();
+    request->domain("example.com");
+    request->channelNumber(9);
+    request->localContextID("local");
+
+    SecureByteBlockPtr first = request->encoded(Message::EncodedForm_JSON, writer);
+    BOOST_CHECK(first)
+    if (first) {
+      String json((const char *)(first->BytePtr()), first->SizeInBytes());
+      BOOST_EQUAL(json, String(writer.data()))
+    }
+
+    SecureByteBlockPtr second = request->encoded(Message::EncodedForm_JSON, writer);
+    BOOST_CHECK(first == second)
+
+    SecureByteBlockPtr withoutAppID = request->encoded(Message::EncodedForm_JSONWithoutAppID, writer);
+    BOOST_CHECK(withoutAppID)
+    BOOST_CHECK(withoutAppID != first)
+
+    request->channelNumber(10);
+    SecureByteBlockPtr changed = request->encoded(Message::EncodedForm_JSON, writer);
+    BOOST_CHECK(changed)
+    BOOST_CHECK(changed != first)
+    if (changed) {
+      DocumentPtr doc = Document::createFromParsedJSON(String((const char *)(changed->BytePtr()), changed->SizeInBytes()));
+      BOOST_CHECK(doc)
+      if (doc) {
+        BOOST_EQUAL(childText(doc->getFirstChildElement(), "channel"), "10")
+      }
+    }
+
+    if (OPENPEER_STACK_TEST_DO_BENCHMARKS) {
+      const ULONG iterations = OPENPEER_STACK_TEST_MESSAGE_WRITER_ITERATIONS;
+
+      Time start = zsLib::now();
+      for (ULONG loop = 0; loop < iterations; ++loop) {
+        request->encoded(Message::EncodedForm_JSON, writer);
+      }
+      Duration reused = zsLib::now() - start;
+
+      start = zsLib::now();
+      for (ULONG loop = 0; loop < iterations; ++loop) {
+        writer.reset();
+        request->encodeTo(writer);
+      }
+      Duration reencoded = zsLib::now() - start;
+
+      std::cout << "BENCHMARK:    reused encoded bytes total=" << reused.total_microseconds() << "us, re-encode (baseline) total=" << reencoded.total_microseconds() << "us (" << iterations << " sends)\n";
+    }
+  }
+
+  // a redirected services get re-posts the request its monitor holds, so the
+  // second post sends the bytes encoded for the first
+  {
+    ServicesGetRequestPtr request = ServicesGetRequest::create();
+    request->domain("example.com");
+
+    SecureByteBlockPtr posted = request->encoded(Message::EncodedForm_JSON, writer);
+    BOOST_CHECK(posted)
+
+    // what IMessageMonitor::getMonitoredMessage() hands back with the error result
+    MessagePtr monitored = request;
+
+    ServicesGetRequestPtr redirected = ServicesGetRequest::convert(monitored);
+    BOOST_CHECK(redirected)
+    if (redirected) {
+      SecureByteBlockPtr reposted = redirected->encoded(Message::EncodedForm_JSON, writer);
+      BOOST_CHECK(reposted == posted)
+    }
+  }
+}
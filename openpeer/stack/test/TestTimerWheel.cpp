@@ -0,0 +1,370 @@
+/*
+
+ Copyright (c) 2013, SMB Phone Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+
+ */
+
+
+
+#include <openpeer/stack/internal/stack_TimerWheel.h>
+
+#include <zsLib/MessageQueueThread.h>
+
+#include "config.h"
+#include "boost_replacement.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using zsLib::ULONG;
+using zsLib::QWORD;
+using zsLib::PUID;
+using zsLib::Time;
+using zsLib::IMessageQueuePtr;
+using zsLib::AutoRecursiveLock;
+using openpeer::stack::internal::TimerWheel;
+using openpeer::stack::internal::TimerWheelEntryPtr;
+using openpeer::stack::internal::ITimerWheelDelegate;
+using openpeer::stack::internal::ITimerWheelDelegatePtr;
+
+namespace openpeer
+{
+  namespace stack
+  {
+    namespace test
+    {
+      class SteppedTimerWheel;
+      typedef boost::shared_ptr<SteppedTimerWheel> SteppedTimerWheelPtr;
+
+      typedef TimerWheel::EntryList EntryList;
+      typedef std::map<PUID, ULONG> TickMap;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SteppedTimerWheel
+      #pragma mark
+
+      // NOTE: a wheel whose clock only moves when the test steps it; each
+      //       step runs exactly what the wheel timer would at that time
+      class SteppedTimerWheel : public TimerWheel
+      {
+      protected:
+        SteppedTimerWheel(IMessageQueuePtr queue) :
+          TimerWheel(queue)
+        {
+          // long enough that the real wheel timer never comes due while
+          // the test is stepping
+          mResolution = zsLib::Seconds(60);
+          mNow = mStartTime;
+        }
+
+      public:
+        //---------------------------------------------------------------------
+        static SteppedTimerWheelPtr create(IMessageQueuePtr queue)
+        {
+          SteppedTimerWheelPtr pThis(new SteppedTimerWheel(queue));
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        TimerWheelEntryPtr armAt(
+                                 ITimerWheelDelegatePtr delegate,
+                                 ULONG tick
+                                 )
+        {
+          AutoRecursiveLock lock(mLock);
+          ULONG ticks = tick - toTick(mNow, false);
+          return arm(delegate, zsLib::Milliseconds(static_cast<QWORD>(ticks) * static_cast<QWORD>(mResolution.total_milliseconds())));
+        }
+
+        //---------------------------------------------------------------------
+        void stepTo(
+                    ULONG tick,
+                    EntryList &outExpired
+                    )
+        {
+          AutoRecursiveLock lock(mLock);
+
+          outExpired.clear();
+
+          mNow = mStartTime + zsLib::Milliseconds(static_cast<QWORD>(tick) * static_cast<QWORD>(mResolution.total_milliseconds()));
+          advance(toTick(mNow, false), outExpired);
+          scheduleTimer();
+        }
+
+        //---------------------------------------------------------------------
+        size_t totalArmed() const
+        {
+          AutoRecursiveLock lock(mLock);
+          return mTotalArmed;
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        virtual Time currentTime() const
+        {
+          AutoRecursiveLock lock(mLock);
+          return mNow;
+        }
+
+      protected:
+        Time mNow;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark NullTimerWheelDelegate
+      #pragma mark
+
+      // NOTE: expiries are collected from the steps, never delivered
+      class NullTimerWheelDelegate : public ITimerWheelDelegate
+      {
+      public:
+        virtual void onTimerWheelExpired(TimerWheelEntryPtr entry) {}
+      };
+
+      //-----------------------------------------------------------------------
+      static bool firedAt(
+                          const EntryList &expired,
+                          const TickMap &armed,
+                          ULONG tick,
+                          size_t total
+                          )
+      {
+        if (expired.size() != total) return false;
+
+        for (EntryList::const_iterator iter = expired.begin(); iter != expired.end(); ++iter) {
+          TickMap::const_iterator found = armed.find((*iter)->getID());
+          if (found == armed.end()) return false;
+          if ((*found).second != tick) return false;
+        }
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      static TimerWheelEntryPtr armAt(
+                                      SteppedTimerWheelPtr wheel,
+                                      ITimerWheelDelegatePtr delegate,
+                                      ULONG tick,
+                                      TickMap &armed
+                                      )
+      {
+        TimerWheelEntryPtr entry = wheel->armAt(delegate, tick);
+        armed[entry->getID()] = tick;
+        return entry;
+      }
+    }
+  }
+}
+
+using openpeer::stack::test::SteppedTimerWheel;
+using openpeer::stack::test::SteppedTimerWheelPtr;
+using openpeer::stack::test::NullTimerWheelDelegate;
+using openpeer::stack::test::EntryList;
+using openpeer::stack::test::TickMap;
+using openpeer::stack::test::firedAt;
+using openpeer::stack::test::armAt;
+using openpeer::stack::test::scatterIndex;
+
+void doTestTimerWheel()
+{
+  if (!OPENPEER_STACK_TEST_DO_TIMER_WHEEL_TEST) return;
+
+  zsLib::MessageQueueThreadPtr thread(zsLib::MessageQueueThread::createBasic());
+
+  ITimerWheelDelegatePtr delegate(new NullTimerWheelDelegate);
+
+  // scope: first level rollover (256 ticks) into the first 64 slot level
+  {
+    SteppedTimerWheelPtr wheel = SteppedTimerWheel::create(thread);
+    TickMap armed;
+    EntryList expired;
+
+    armAt(wheel, delegate, 255, armed);
+    armAt(wheel, delegate, 256, armed);
+    armAt(wheel, delegate, 257, armed);
+    armAt(wheel, delegate, 300, armed);
+    armAt(wheel, delegate, 511, armed);
+    armAt(wheel, delegate, 512, armed);
+
+    wheel->stepTo(254, expired);
+    BOOST_CHECK(firedAt(expired, armed, 254, 0))
+    wheel->stepTo(255, expired);
+    BOOST_CHECK(firedAt(expired, armed, 255, 1))
+    wheel->stepTo(256, expired);
+    BOOST_CHECK(firedAt(expired, armed, 256, 1))
+    wheel->stepTo(257, expired);
+    BOOST_CHECK(firedAt(expired, armed, 257, 1))
+    wheel->stepTo(299, expired);
+    BOOST_CHECK(firedAt(expired, armed, 299, 0))
+    wheel->stepTo(300, expired);
+    BOOST_CHECK(firedAt(expired, armed, 300, 1))
+    wheel->stepTo(510, expired);
+    BOOST_CHECK(firedAt(expired, armed, 510, 0))
+    wheel->stepTo(511, expired);
+    BOOST_CHECK(firedAt(expired, armed, 511, 1))
+    wheel->stepTo(512, expired);
+    BOOST_CHECK(firedAt(expired, armed, 512, 1))
+
+    BOOST_EQUAL(wheel->totalArmed(), 0)
+  }
+
+  // scope: 64 slot level rollovers (256*64 and 256*64*64 ticks)
+  {
+    SteppedTimerWheelPtr wheel = SteppedTimerWheel::create(thread);
+    TickMap armed;
+    EntryList expired;
+
+    const ULONG secondLevel = (1 << (TimerWheel::Sizes_FirstLevelBits + TimerWheel::Sizes_OtherLevelBits));
+    const ULONG thirdLevel = (1 << (TimerWheel::Sizes_FirstLevelBits + (2*TimerWheel::Sizes_OtherLevelBits)));
+
+    armAt(wheel, delegate, secondLevel - 1, armed);
+    armAt(wheel, delegate, secondLevel, armed);
+    armAt(wheel, delegate, secondLevel + 1, armed);
+    armAt(wheel, delegate, secondLevel + 256, armed);
+    armAt(wheel, delegate, thirdLevel - 1, armed);
+    armAt(wheel, delegate, thirdLevel, armed);
+
+    wheel->stepTo(secondLevel - 2, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel - 2, 0))
+    wheel->stepTo(secondLevel - 1, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel - 1, 1))
+    wheel->stepTo(secondLevel, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel, 1))
+    wheel->stepTo(secondLevel + 1, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel + 1, 1))
+    wheel->stepTo(secondLevel + 255, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel + 255, 0))
+    wheel->stepTo(secondLevel + 256, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel + 256, 1))
+    wheel->stepTo(thirdLevel - 2, expired);
+    BOOST_CHECK(firedAt(expired, armed, thirdLevel - 2, 0))
+    wheel->stepTo(thirdLevel - 1, expired);
+    BOOST_CHECK(firedAt(expired, armed, thirdLevel - 1, 1))
+    wheel->stepTo(thirdLevel, expired);
+    BOOST_CHECK(firedAt(expired, armed, thirdLevel, 1))
+
+    BOOST_EQUAL(wheel->totalArmed(), 0)
+  }
+
+  // scope: cancelling entries after they cascaded down a level
+  {
+    SteppedTimerWheelPtr wheel = SteppedTimerWheel::create(thread);
+    TickMap armed;
+    EntryList expired;
+
+    const ULONG secondLevel = (1 << (TimerWheel::Sizes_FirstLevelBits + TimerWheel::Sizes_OtherLevelBits));
+
+    TimerWheelEntryPtr cascaded = armAt(wheel, delegate, 600, armed);
+    armAt(wheel, delegate, 601, armed);
+    TimerWheelEntryPtr cascadedTwice = armAt(wheel, delegate, secondLevel + 1000, armed);
+    armAt(wheel, delegate, secondLevel + 1001, armed);
+
+    // the slot holding 600 cascades into the first level at tick 512
+    wheel->stepTo(512, expired);
+    BOOST_CHECK(firedAt(expired, armed, 512, 0))
+
+    cascaded->cancel();
+    cascaded->cancel();
+    BOOST_EQUAL(wheel->totalArmed(), 3)
+
+    wheel->stepTo(600, expired);
+    BOOST_CHECK(firedAt(expired, armed, 600, 0))
+    wheel->stepTo(601, expired);
+    BOOST_CHECK(firedAt(expired, armed, 601, 1))
+
+    // the second level slot cascades into the first 64 slot level
+    wheel->stepTo(secondLevel, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel, 0))
+
+    cascadedTwice->cancel();
+    BOOST_EQUAL(wheel->totalArmed(), 1)
+
+    wheel->stepTo(secondLevel + 1000, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel + 1000, 0))
+    wheel->stepTo(secondLevel + 1001, expired);
+    BOOST_CHECK(firedAt(expired, armed, secondLevel + 1001, 1))
+
+    BOOST_EQUAL(wheel->totalArmed(), 0)
+  }
+
+  // scope: every entry fires on its own tick, in expiry order and in
+  // arming order within a tick
+  {
+    SteppedTimerWheelPtr wheel = SteppedTimerWheel::create(thread);
+    TickMap armed;
+    EntryList expired;
+
+    const ULONG total = OPENPEER_STACK_TEST_TIMER_WHEEL_ENTRIES;
+    const ULONG span = OPENPEER_STACK_TEST_TIMER_WHEEL_SPAN;
+
+    typedef std::pair<ULONG, PUID> TickIDPair;
+    typedef std::vector<TickIDPair> TickIDArray;
+
+    TickIDArray expecting;
+
+    for (ULONG index = 0; index < total; ++index) {
+      // every eighth entry shares a tick with the one before it
+      ULONG tick = 1 + scatterIndex(((0 != index) && (0 == (index % 8))) ? index - 1 : index, span);
+
+      TimerWheelEntryPtr entry = armAt(wheel, delegate, tick, armed);
+      expecting.push_back(TickIDPair(tick, entry->getID()));
+    }
+
+    // IDs increase with arming order thus break ties by arming order
+    std::sort(expecting.begin(), expecting.end());
+
+    TickIDArray fired;
+    bool onTime = true;
+
+    for (ULONG tick = 1; tick <= span; ++tick) {
+      wheel->stepTo(tick, expired);
+      for (EntryList::iterator iter = expired.begin(); iter != expired.end(); ++iter) {
+        PUID id = (*iter)->getID();
+        if (armed[id] != tick) onTime = false;
+        fired.push_back(TickIDPair(tick, id));
+      }
+    }
+
+    BOOST_CHECK(onTime)
+    BOOST_EQUAL(fired.size(), expecting.size())
+    BOOST_CHECK(fired == expecting)
+    BOOST_EQUAL(wheel->totalArmed(), 0)
+  }
+
+  thread->waitForShutdown();
+}
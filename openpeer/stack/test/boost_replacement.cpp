@@ -43,6 +43,17 @@ typedef openpeer::services::ILogger ILogger;
 void doTestStack();
 void doTestLockboxSession();
 void doTestAccount();
+void doTestMessageMonitorTable();
+void doTestMessageFactoryManager();
+void doTestMessageWriter();
+void doTestMessageBinary();
+void doTestMessageCompression();
+void doTestMessageBatch();
+void doTestMessageArena();
+void doTestChannelTable();
+void doTestChannelSendScheduler();
+void doTestChannelWindow();
+void doTestTimerWheel();
 
 
 namespace BoostReplacement
@@ -120,6 +131,17 @@ namespace BoostReplacement
   void runAllTests()
   {
     doTestStack();
+    doTestMessageMonitorTable();
+    doTestMessageFactoryManager();
+    doTestMessageWriter();
+    doTestMessageBinary();
+    doTestMessageCompression();
+    doTestMessageBatch();
+    doTestMessageArena();
+    doTestChannelTable();
+    doTestChannelSendScheduler();
+    doTestChannelWindow();
+    doTestTimerWheel();
 //    doTestPeerContactSession();
 //    doTestAccount();
   }
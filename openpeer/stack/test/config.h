@@ -42,11 +42,48 @@
 
 #define OPENPEER_STACK_TEST_TELNET_LOGGING_PORT    (59999)
 
+#define OPENPEER_STACK_TEST_DO_BENCHMARKS    (false)
+
 #define OPENPEER_STACK_TEST_DO_STACK_TEST    (true)
 
 #define OPENPEER_STACK_TEST_DO_PEER_CONTACT_SESSION_TEST    (true)
 
 #define OPENPEER_STACK_TEST_DO_ACCOUNT_TEST    (true)
 
+#define OPENPEER_STACK_TEST_DO_MESSAGE_MONITOR_TABLE_TEST    (true)
+#define OPENPEER_STACK_TEST_MESSAGE_MONITOR_TABLE_OUTSTANDING (100000)
+
+#define OPENPEER_STACK_TEST_DO_MESSAGE_FACTORY_MANAGER_TEST    (true)
+#define OPENPEER_STACK_TEST_MESSAGE_FACTORY_MANAGER_ITERATIONS (10000)
+
+#define OPENPEER_STACK_TEST_DO_MESSAGE_WRITER_TEST    (true)
+#define OPENPEER_STACK_TEST_MESSAGE_WRITER_ITERATIONS (10000)
+
+#define OPENPEER_STACK_TEST_DO_MESSAGE_BINARY_TEST    (true)
+
+#define OPENPEER_STACK_TEST_DO_MESSAGE_COMPRESSION_TEST    (true)
+#define OPENPEER_STACK_TEST_MESSAGE_COMPRESSION_THRESHOLD (256)
+
+#define OPENPEER_STACK_TEST_DO_MESSAGE_BATCH_TEST    (true)
+#define OPENPEER_STACK_TEST_MESSAGE_BATCH_MAX_SIZE   (4*1024)
+
+#define OPENPEER_STACK_TEST_DO_MESSAGE_ARENA_TEST    (true)
+#define OPENPEER_STACK_TEST_MESSAGE_ARENA_ITERATIONS (1000)
+
+#define OPENPEER_STACK_TEST_DO_CHANNEL_TABLE_TEST    (true)
+#define OPENPEER_STACK_TEST_CHANNEL_TABLE_CHANNELS   (4096)
+#define OPENPEER_STACK_TEST_CHANNEL_TABLE_PACKETS    (1000000)
+
+#define OPENPEER_STACK_TEST_DO_CHANNEL_SEND_SCHEDULER_TEST    (true)
+#define OPENPEER_STACK_TEST_CHANNEL_SEND_SCHEDULER_QUANTUM    (4*1024)
+#define OPENPEER_STACK_TEST_CHANNEL_SEND_SCHEDULER_BULK_BUFFERS (256)
+
+#define OPENPEER_STACK_TEST_DO_CHANNEL_WINDOW_TEST    (true)
+#define OPENPEER_STACK_TEST_CHANNEL_WINDOW_SIZE       (64*1024)
+
+#define OPENPEER_STACK_TEST_DO_TIMER_WHEEL_TEST    (true)
+#define OPENPEER_STACK_TEST_TIMER_WHEEL_ENTRIES    (1000)
+#define OPENPEER_STACK_TEST_TIMER_WHEEL_SPAN       (20000)
+
 
 #endif //OPENPEER_STACK_TEST_CONFIG_H_85376d39b5c552d82bf605630d7be295db59875a
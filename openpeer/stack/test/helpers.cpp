@@ -30,6 +30,7 @@
  */
 
 #include "helpers.h"
+#include "config.h"
 
 using namespace zsLib;
 
@@ -113,6 +114,28 @@ namespace openpeer
           return false;
         }
       }
+
+#pragma mark
+#pragma mark Benchmark helpers
+#pragma mark
+      //-----------------------------------------------------------------------
+      ULONG scatterIndex(ULONG index, ULONG modulus)
+      {
+        if (0 == modulus) return 0;
+        return static_cast<ULONG>((index * 2654435761U) % modulus);
+      }
+
+      //-----------------------------------------------------------------------
+      void reportBenchmark(
+                           const char *what,
+                           Duration duration,
+                           ULONG total,
+                           const char *per
+                           )
+      {
+        if (!OPENPEER_STACK_TEST_DO_BENCHMARKS) return;
+        std::cout << "BENCHMARK:    " << what << " total=" << duration.total_microseconds() << "us (" << (total > 0 ? (duration.total_nanoseconds() / total) : 0) << "ns per " << per << ")\n";
+      }
     } // namespace test
   } // namespace stack
 } // namespace openpeer
@@ -49,6 +49,18 @@ namespace openpeer
       String convertToString(const XML::ElementPtr &element);
       bool writeToFile(zsLib::String text, zsLib::String filename);
       bool readFromFile(String &outPassword, String &outText);
+
+      // spreads a sequential index across [0, modulus) the way randomly
+      // assigned IDs land in a table (Knuth multiplicative hash)
+      ULONG scatterIndex(ULONG index, ULONG modulus);
+
+      // prints a timing line when OPENPEER_STACK_TEST_DO_BENCHMARKS is enabled
+      void reportBenchmark(
+                           const char *what,
+                           Duration duration,
+                           ULONG total,
+                           const char *per = "op"
+                           );
     } // namespace test
   } // namespace stack
 } // namespace openpeer
\ No newline at end of file
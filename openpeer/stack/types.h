@@ -62,6 +62,7 @@ namespace openpeer
     using zsLib::UINT;
     using zsLib::LONG;
     using zsLib::ULONG;
+    using zsLib::QWORD;
     using zsLib::Time;
     using zsLib::Duration;
     using zsLib::String;
@@ -41,16 +41,20 @@ LOCAL_SRC_FILES := $(SOURCE_PATH)/stack.cpp \
 		   $(SOURCE_PATH)/stack_BootstrappedNetwork.cpp \
 		   $(SOURCE_PATH)/stack_BootstrappedNetworkManager.cpp \
 		  $(SOURCE_PATH)/stack_Cache.cpp \
+		   $(SOURCE_PATH)/stack_ChannelSendScheduler.cpp \
+		   $(SOURCE_PATH)/stack_ChannelWindow.cpp \
 		   $(SOURCE_PATH)/stack_Diff.cpp \
 		   $(SOURCE_PATH)/stack_Factory.cpp \
 		   $(SOURCE_PATH)/stack_FinderConnection.cpp \
 		   $(SOURCE_PATH)/stack_FinderRelayChannel.cpp \
 		   $(SOURCE_PATH)/stack_Helper.cpp \
+		   $(SOURCE_PATH)/stack_InstrumentedMessageQueue.cpp \
 		   $(SOURCE_PATH)/stack_KeyGenerator.cpp \
 		   $(SOURCE_PATH)/stack_Location.cpp \
 		   $(SOURCE_PATH)/stack_MessageIncoming.cpp \
 		   $(SOURCE_PATH)/stack_MessageMonitor.cpp \
 		   $(SOURCE_PATH)/stack_MessageMonitorManager.cpp \
+		   $(SOURCE_PATH)/stack_MessageMonitorTable.cpp \
 		   $(SOURCE_PATH)/stack_Peer.cpp \
 		   $(SOURCE_PATH)/stack_PeerFilePrivate.cpp \
 		   $(SOURCE_PATH)/stack_PeerFilePublic.cpp \
@@ -74,15 +78,23 @@ LOCAL_SRC_FILES := $(SOURCE_PATH)/stack.cpp \
 		   $(SOURCE_PATH)/stack_Settings.cpp \
                    $(SOURCE_PATH)/stack_javascript.cpp \
 		   $(SOURCE_PATH)/stack_stack.cpp \
+		   $(SOURCE_PATH)/stack_TimerWheel.cpp \
+		   $(SOURCE_PATH)/stack_WakeOnce.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_Message.cpp \
+		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageBatch.cpp \
+		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageBinary.cpp \
+		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageCompression.cpp \
+		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageEnvelope.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageFactoryManager.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageFactoryUnknown.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageHelper.cpp \
+		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageNames.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageNotify.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageNotifyUnknown.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageRequest.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageRequestUnknown.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageResult.cpp \
+		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_MessageWriter.cpp \
 		   $(MESSAGE_SOURCE_PATH)/cpp/stack_message_messages.cpp \
 		   $(MESSAGE_SOURCE_PATH)/bootstrapped-finder/cpp/FindersGetRequest.cpp \
 		   $(MESSAGE_SOURCE_PATH)/bootstrapped-finder/cpp/FindersGetResult.cpp \
@@ -141,6 +153,7 @@ LOCAL_SRC_FILES := $(SOURCE_PATH)/stack.cpp \
 		   $(MESSAGE_SOURCE_PATH)/peer-finder/cpp/ChannelMapNotify.cpp \
 		   $(MESSAGE_SOURCE_PATH)/peer-finder/cpp/ChannelMapRequest.cpp \
 		   $(MESSAGE_SOURCE_PATH)/peer-finder/cpp/ChannelMapResult.cpp \
+		   $(MESSAGE_SOURCE_PATH)/peer-finder/cpp/ChannelWindowNotify.cpp \
 		   $(MESSAGE_SOURCE_PATH)/peer-finder/cpp/MessageFactoryPeerFinder.cpp \
 		   $(MESSAGE_SOURCE_PATH)/peer-finder/cpp/PeerLocationFindNotify.cpp \
 		   $(MESSAGE_SOURCE_PATH)/peer-finder/cpp/PeerLocationFindRequest.cpp \